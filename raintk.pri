@@ -40,6 +40,14 @@ android {
     DEFINES += RAINTK_ENV_ANDROID
 }
 
+# Use GL fence syncs to limit the number of frames in
+# flight. Needs OpenGL 3.2 or OpenGL ES 3.0 headers; if the
+# context is older at runtime glFinish is used instead.
+# Android builds can enable it when targeting OpenGL ES 3.0.
+linux_x11 {
+    DEFINES += RAINTK_GL_FENCE_SYNC
+}
+
 
 
 
@@ -68,27 +76,42 @@ HEADERS += \
     $${PATH_RAINTK}/raintk/RainTkProperty.hpp \
     $${PATH_RAINTK}/raintk/RainTkSceneKey.hpp \
     $${PATH_RAINTK}/raintk/RainTkComponents.hpp \
+    $${PATH_RAINTK}/raintk/RainTkDenseComponentList.hpp \
+    $${PATH_RAINTK}/raintk/RainTkFrameArena.hpp \
     $${PATH_RAINTK}/raintk/RainTkDrawKey.hpp \
     $${PATH_RAINTK}/raintk/RainTkAnimation.hpp \
+    $${PATH_RAINTK}/raintk/RainTkAnimationGroup.hpp \
     $${PATH_RAINTK}/raintk/RainTkTween.hpp \
     $${PATH_RAINTK}/raintk/RainTkPropertyAnimation.hpp \
+    $${PATH_RAINTK}/raintk/RainTkCompositorAnimation.hpp \
     $${PATH_RAINTK}/raintk/RainTkMainDrawStage.hpp \
+    $${PATH_RAINTK}/raintk/RainTkFramePacer.hpp \
+    $${PATH_RAINTK}/raintk/RainTkTextureShadow.hpp \
+    $${PATH_RAINTK}/raintk/RainTkGlyphPageStore.hpp \
     $${PATH_RAINTK}/raintk/RainTkInputListener.hpp \
     $${PATH_RAINTK}/raintk/RainTkInputRecorder.hpp \
     $${PATH_RAINTK}/raintk/RainTkInputSystem.hpp \
     $${PATH_RAINTK}/raintk/RainTkAnimationSystem.hpp \
     $${PATH_RAINTK}/raintk/RainTkTransformSystem.hpp \
+    $${PATH_RAINTK}/raintk/RainTkDrawSnapshot.hpp \
     $${PATH_RAINTK}/raintk/RainTkDrawSystem.hpp \
     $${PATH_RAINTK}/raintk/RainTkScene.hpp
 
 SOURCES += \
     $${PATH_RAINTK}/raintk/RainTkUnits.cpp \
+    $${PATH_RAINTK}/raintk/RainTkProperty.cpp \
     $${PATH_RAINTK}/raintk/RainTkComponents.cpp \
+    $${PATH_RAINTK}/raintk/RainTkFrameArena.cpp \
     $${PATH_RAINTK}/raintk/RainTkDrawKey.cpp \
     $${PATH_RAINTK}/raintk/RainTkAnimation.cpp \
+    $${PATH_RAINTK}/raintk/RainTkAnimationGroup.cpp \
     $${PATH_RAINTK}/raintk/RainTkTween.cpp \
+    $${PATH_RAINTK}/raintk/RainTkPropertyAnimation.cpp \
     $${PATH_RAINTK}/raintk/RainTkLog.cpp \
     $${PATH_RAINTK}/raintk/RainTkMainDrawStage.cpp \
+    $${PATH_RAINTK}/raintk/RainTkFramePacer.cpp \
+    $${PATH_RAINTK}/raintk/RainTkTextureShadow.cpp \
+    $${PATH_RAINTK}/raintk/RainTkGlyphPageStore.cpp \
     $${PATH_RAINTK}/raintk/RainTkInputListener.cpp \
     $${PATH_RAINTK}/raintk/RainTkInputRecorder.cpp \
     $${PATH_RAINTK}/raintk/RainTkInputSystem.cpp \
@@ -101,19 +124,25 @@ SOURCES += \
 HEADERS += \
     $${PATH_RAINTK}/raintk/RainTkListModel.hpp \
     $${PATH_RAINTK}/raintk/RainTkListModelSTLVector.hpp \
+    $${PATH_RAINTK}/raintk/RainTkListModelSortFilterProxy.hpp \
+    $${PATH_RAINTK}/raintk/RainTkListModelPaged.hpp \
+    $${PATH_RAINTK}/raintk/RainTkListModelMapped.hpp \
     $${PATH_RAINTK}/raintk/RainTkListDelegate.hpp
 
 SOURCES += \
-    $${PATH_RAINTK}/raintk/RainTkListModel.cpp
+    $${PATH_RAINTK}/raintk/RainTkListModel.cpp \
+    $${PATH_RAINTK}/raintk/RainTkListModelMapped.cpp
 
 # helpers
 HEADERS += \
     $${PATH_RAINTK}/raintk/RainTkAlignment.hpp \
+    $${PATH_RAINTK}/raintk/RainTkAnchorLayout.hpp \
     $${PATH_RAINTK}/raintk/RainTkColorConv.hpp \
     $${PATH_RAINTK}/raintk/RainTkImageAtlas.hpp
 
 SOURCES += \
     $${PATH_RAINTK}/raintk/RainTkAlignment.cpp \
+    $${PATH_RAINTK}/raintk/RainTkAnchorLayout.cpp \
     $${PATH_RAINTK}/raintk/RainTkColorConv.cpp \
     $${PATH_RAINTK}/raintk/RainTkImageAtlas.cpp
 
@@ -189,7 +218,8 @@ SOURCES += \
 
 # individual tests
 HEADERS += \
-    $${PATH_RAINTK}/raintk/test/RainTkTestContext.hpp
+    $${PATH_RAINTK}/raintk/test/RainTkTestContext.hpp \
+    $${PATH_RAINTK}/raintk/test/RainTkTestAllocationCounter.hpp
 
 SOURCES += \
 #    $${PATH_RAINTK}/raintk/test/RainTkTestDrawSystemOpaqueSingle.cpp
@@ -223,5 +253,30 @@ SOURCES += \
 #    $${PATH_RAINTK}/raintk/test/RainTkTestDrag.cpp
 #    $${PATH_RAINTK}/raintk/test/RainTkTestImageAtlas.cpp
 #    $${PATH_RAINTK}/raintk/test/RainTkTestOpacityHierarchy.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestPropertyTransaction.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestWidgetFootprint.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestIncrementalLayout.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestPropertyAnimation.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestAnimationGroup.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestCompositorAnimation.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestFramePacer.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestDrawSnapshot.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestTextureShadow.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestGlyphPageStore.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestTextEdit.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestTextVirtualized.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestOpacityIncremental.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestCachedLayer.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestDamageRegions.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestListViewPrefetch.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestListModelChanges.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestListModelSortFilterProxy.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestListModelPaged.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestListModelMapped.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestListViewGrid.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestAnchorLayout.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestInputCoalescing.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestDenseComponentList.cpp
+#    $${PATH_RAINTK}/raintk/test/RainTkTestFrameArena.cpp
 
 
@@ -16,6 +16,9 @@
 
 #include <raintk/RainTkWidget.hpp>
 #include <raintk/RainTkAlignment.hpp>
+#include <raintk/RainTkAnchorLayout.hpp>
+#include <raintk/RainTkScene.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
 #include <raintk/RainTkLog.hpp>
 
 namespace raintk
@@ -48,6 +51,18 @@ namespace raintk
                                 "Anchor must be sibling or parent");
                 }
             }
+
+            void AddAnchor(
+                    Widget* widget,
+                    AnchorLayout::Edge edge,
+                    Widget* anchor,
+                    AnchorLayout::Edge anchor_edge)
+            {
+                EnforceParentOrSibling(widget,anchor);
+                widget->GetScene()->GetTransformSystem()->
+                        GetAnchorLayout()->Add(
+                            widget,edge,anchor,anchor_edge);
+            }
         }
 
         // =========================================================== //
@@ -391,5 +406,93 @@ namespace raintk
                 widget->y = [widget,anchor](){ return (anchor->y.Get() + anchor->height.Get()); };
             }
         }
+
+        // =========================================================== //
+
+        void AnchorCenterToAnchorCenter(
+                Widget* widget,
+                Widget* anchor)
+        {
+            AddAnchor(widget,AnchorLayout::Edge::HCenter,anchor,AnchorLayout::Edge::HCenter);
+            AddAnchor(widget,AnchorLayout::Edge::VCenter,anchor,AnchorLayout::Edge::VCenter);
+        }
+
+        // Horizontal
+        void AnchorHCenterToAnchorHCenter(
+                Widget* widget,
+                Widget* anchor)
+        {
+            AddAnchor(widget,AnchorLayout::Edge::HCenter,anchor,AnchorLayout::Edge::HCenter);
+        }
+
+        void AnchorRightToAnchorLeft(
+                Widget* widget,
+                Widget* anchor)
+        {
+            AddAnchor(widget,AnchorLayout::Edge::Right,anchor,AnchorLayout::Edge::Left);
+        }
+
+        void AnchorLeftToAnchorLeft(
+                Widget* widget,
+                Widget* anchor)
+        {
+            AddAnchor(widget,AnchorLayout::Edge::Left,anchor,AnchorLayout::Edge::Left);
+        }
+
+        void AnchorLeftToAnchorRight(
+                Widget* widget,
+                Widget* anchor)
+        {
+            AddAnchor(widget,AnchorLayout::Edge::Left,anchor,AnchorLayout::Edge::Right);
+        }
+
+        void AnchorRightToAnchorRight(
+                Widget* widget,
+                Widget* anchor)
+        {
+            AddAnchor(widget,AnchorLayout::Edge::Right,anchor,AnchorLayout::Edge::Right);
+        }
+
+        // Vertical
+        void AnchorVCenterToAnchorVCenter(
+                Widget* widget,
+                Widget* anchor)
+        {
+            AddAnchor(widget,AnchorLayout::Edge::VCenter,anchor,AnchorLayout::Edge::VCenter);
+        }
+
+        void AnchorBottomToAnchorTop(
+                Widget* widget,
+                Widget* anchor)
+        {
+            AddAnchor(widget,AnchorLayout::Edge::Bottom,anchor,AnchorLayout::Edge::Top);
+        }
+
+        void AnchorTopToAnchorTop(
+                Widget* widget,
+                Widget* anchor)
+        {
+            AddAnchor(widget,AnchorLayout::Edge::Top,anchor,AnchorLayout::Edge::Top);
+        }
+
+        void AnchorBottomToAnchorBottom(
+                Widget* widget,
+                Widget* anchor)
+        {
+            AddAnchor(widget,AnchorLayout::Edge::Bottom,anchor,AnchorLayout::Edge::Bottom);
+        }
+
+        void AnchorTopToAnchorBottom(
+                Widget* widget,
+                Widget* anchor)
+        {
+            AddAnchor(widget,AnchorLayout::Edge::Top,anchor,AnchorLayout::Edge::Bottom);
+        }
+
+        void ClearAnchors(Widget* widget)
+        {
+            widget->GetScene()->GetTransformSystem()->
+                    GetAnchorLayout()->Remove(widget);
+        }
     }
 }
@@ -132,6 +132,62 @@ namespace raintk
         void BindTopToAnchorBottom(
                 Widget* widget,
                 Widget* anchor);
+
+        // Anchors
+        // * Like the bindings but resolved by the AnchorLayout
+        //   once per frame in dependency order instead of through
+        //   chained property bindings (see RainTkAnchorLayout.hpp)
+        // * Replace any anchor previously set on the same axis
+
+        void AnchorCenterToAnchorCenter(
+                Widget* widget,
+                Widget* anchor);
+
+        // Horizontal
+        void AnchorHCenterToAnchorHCenter(
+                Widget* widget,
+                Widget* anchor);
+
+        void AnchorRightToAnchorLeft(
+                Widget* widget,
+                Widget* anchor);
+
+        void AnchorLeftToAnchorLeft(
+                Widget* widget,
+                Widget* anchor);
+
+        void AnchorLeftToAnchorRight(
+                Widget* widget,
+                Widget* anchor);
+
+        void AnchorRightToAnchorRight(
+                Widget* widget,
+                Widget* anchor);
+
+        // Vertical
+        void AnchorVCenterToAnchorVCenter(
+                Widget* widget,
+                Widget* anchor);
+
+        void AnchorBottomToAnchorTop(
+                Widget* widget,
+                Widget* anchor);
+
+        void AnchorTopToAnchorTop(
+                Widget* widget,
+                Widget* anchor);
+
+        void AnchorBottomToAnchorBottom(
+                Widget* widget,
+                Widget* anchor);
+
+        void AnchorTopToAnchorBottom(
+                Widget* widget,
+                Widget* anchor);
+
+        // Removes the anchors of @widget and the anchors
+        // of widgets that use @widget as their anchor
+        void ClearAnchors(Widget* widget);
     }
 
     // =========================================================== //
@@ -0,0 +1,306 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <raintk/RainTkAnchorLayout.hpp>
+#include <raintk/RainTkAlignment.hpp>
+#include <raintk/RainTkWidget.hpp>
+
+namespace raintk
+{
+    namespace
+    {
+        uint GetAxis(AnchorLayout::Edge edge)
+        {
+            return (edge >= AnchorLayout::Edge::Top) ? 1 : 0;
+        }
+
+        float GetFraction(AnchorLayout::Edge edge)
+        {
+            switch(edge)
+            {
+                case AnchorLayout::Edge::HCenter:
+                case AnchorLayout::Edge::VCenter:
+                    return 0.5f;
+
+                case AnchorLayout::Edge::Right:
+                case AnchorLayout::Edge::Bottom:
+                    return 1.0f;
+
+                default:
+                    return 0.0f;
+            }
+        }
+
+        Property<float>& GetSize(Widget* widget, uint axis)
+        {
+            return (axis == 0) ? widget->width : widget->height;
+        }
+
+        Property<float>& GetPosition(Widget* widget, uint axis)
+        {
+            return (axis == 0) ? widget->x : widget->y;
+        }
+    }
+
+    // =========================================================== //
+
+    AnchorLayout::AnchorLayout()
+    {}
+
+    AnchorLayout::~AnchorLayout()
+    {}
+
+    void AnchorLayout::Add(Widget* widget,
+                           Edge edge,
+                           Widget* anchor,
+                           Edge anchor_edge)
+    {
+        uint const axis = GetAxis(edge);
+        if(GetAxis(anchor_edge) != axis)
+        {
+            throw WidgetAlignmentInvalid(
+                        "AnchorLayout: "
+                        "Edges must be on the same axis");
+        }
+
+        bool const anchor_is_parent = (widget->GetParent().get() == anchor);
+
+        // A sibling anchor can't depend on @widget,
+        // either directly or through other siblings
+        if(!anchor_is_parent)
+        {
+            Widget* dependency = anchor;
+            while(true)
+            {
+                if(dependency == widget)
+                {
+                    throw WidgetAlignmentInvalid(
+                                "AnchorLayout: "
+                                "Circular dependency for " + widget->name);
+                }
+
+                auto it = m_lkup_constraints.find(dependency);
+                if(it == m_lkup_constraints.end())
+                {
+                    break;
+                }
+
+                auto const &constraint = it->second.list_axes[axis];
+                if(constraint.anchor == nullptr || constraint.anchor_is_parent)
+                {
+                    break;
+                }
+
+                dependency = constraint.anchor;
+            }
+        }
+
+        auto& constraint = m_lkup_constraints[widget].list_axes[axis];
+        if(constraint.anchor)
+        {
+            disconnect(widget,axis,constraint);
+        }
+
+        constraint = Constraint();
+        constraint.anchor = anchor;
+        constraint.anchor_is_parent = anchor_is_parent;
+        constraint.anchor_fraction = GetFraction(anchor_edge);
+        constraint.fraction = GetFraction(edge);
+
+        constraint.cid_size =
+                GetSize(widget,axis).signal_changed.Connect(
+                    [this](){ onChanged(); },
+                    nullptr,
+                    ks::ConnectionType::Direct);
+
+        constraint.cid_anchor_size =
+                GetSize(anchor,axis).signal_changed.Connect(
+                    [this](){ onChanged(); },
+                    nullptr,
+                    ks::ConnectionType::Direct);
+
+        if(!anchor_is_parent)
+        {
+            constraint.cid_anchor_position =
+                    GetPosition(anchor,axis).signal_changed.Connect(
+                        [this](){ onChanged(); },
+                        nullptr,
+                        ks::ConnectionType::Direct);
+        }
+
+        widget->m_anchored = true;
+        anchor->m_anchored = true;
+
+        m_dirty = true;
+    }
+
+    void AnchorLayout::Remove(Widget* widget)
+    {
+        auto it = m_lkup_constraints.find(widget);
+        if(it != m_lkup_constraints.end())
+        {
+            for(uint axis=0; axis < 2; axis++)
+            {
+                auto& constraint = it->second.list_axes[axis];
+                if(constraint.anchor)
+                {
+                    disconnect(widget,axis,constraint);
+                }
+            }
+
+            m_lkup_constraints.erase(it);
+        }
+
+        // Constraints that use @widget as their anchor
+        for(it = m_lkup_constraints.begin();
+            it != m_lkup_constraints.end();)
+        {
+            bool active = false;
+            for(uint axis=0; axis < 2; axis++)
+            {
+                auto& constraint = it->second.list_axes[axis];
+                if(constraint.anchor == widget)
+                {
+                    disconnect(it->first,axis,constraint);
+                    constraint = Constraint();
+                }
+
+                active = active || (constraint.anchor != nullptr);
+            }
+
+            if(active)
+            {
+                ++it;
+            }
+            else
+            {
+                it = m_lkup_constraints.erase(it);
+            }
+        }
+    }
+
+    uint AnchorLayout::GetConstraintCount() const
+    {
+        uint count=0;
+        for(auto const &widget_constraints : m_lkup_constraints)
+        {
+            for(auto const &constraint : widget_constraints.second.list_axes)
+            {
+                if(constraint.anchor)
+                {
+                    count++;
+                }
+            }
+        }
+
+        return count;
+    }
+
+    void AnchorLayout::Resolve()
+    {
+        if(!m_dirty)
+        {
+            return;
+        }
+
+        // Changes made while resolving don't need
+        // another pass since they're resolved in order
+        m_dirty = false;
+        m_resolving = true;
+        m_pass++;
+
+        for(auto& widget_constraints : m_lkup_constraints)
+        {
+            for(uint axis=0; axis < 2; axis++)
+            {
+                auto& constraint = widget_constraints.second.list_axes[axis];
+                if(constraint.anchor)
+                {
+                    resolve(widget_constraints.first,axis,constraint);
+                }
+            }
+        }
+
+        m_resolving = false;
+    }
+
+    void AnchorLayout::onChanged()
+    {
+        if(!m_resolving)
+        {
+            m_dirty = true;
+        }
+    }
+
+    void AnchorLayout::disconnect(Widget* widget,
+                                  uint axis,
+                                  Constraint& constraint)
+    {
+        GetSize(widget,axis).signal_changed.Disconnect(
+                    constraint.cid_size);
+
+        GetSize(constraint.anchor,axis).signal_changed.Disconnect(
+                    constraint.cid_anchor_size);
+
+        if(!constraint.anchor_is_parent)
+        {
+            GetPosition(constraint.anchor,axis).signal_changed.Disconnect(
+                        constraint.cid_anchor_position);
+        }
+    }
+
+    void AnchorLayout::resolve(Widget* widget,
+                               uint axis,
+                               Constraint& constraint)
+    {
+        if(constraint.pass == m_pass)
+        {
+            return;
+        }
+
+        constraint.pass = m_pass;
+
+        // Positions are relative to the parent, so a parent
+        // anchor's own position doesn't matter
+        float anchor_position = 0.0f;
+
+        if(!constraint.anchor_is_parent)
+        {
+            auto it = m_lkup_constraints.find(constraint.anchor);
+            if(it != m_lkup_constraints.end())
+            {
+                auto& anchor_constraint = it->second.list_axes[axis];
+                if(anchor_constraint.anchor)
+                {
+                    resolve(constraint.anchor,axis,anchor_constraint);
+                }
+            }
+
+            anchor_position = GetPosition(constraint.anchor,axis).Get();
+        }
+
+        float const position =
+                anchor_position+
+                constraint.anchor_fraction*GetSize(constraint.anchor,axis).Get()-
+                constraint.fraction*GetSize(widget,axis).Get();
+
+        auto& widget_position = GetPosition(widget,axis);
+        if(widget_position.Get() != position)
+        {
+            widget_position = position;
+        }
+    }
+}
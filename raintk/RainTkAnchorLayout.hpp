@@ -0,0 +1,123 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef RAINTK_ANCHOR_LAYOUT_HPP
+#define RAINTK_ANCHOR_LAYOUT_HPP
+
+#include <unordered_map>
+#include <raintk/RainTkGlobal.hpp>
+
+namespace raintk
+{
+    class Widget;
+
+    // AnchorLayout
+    // * Keeps an edge of a widget at an edge of its parent or
+    //   of a sibling (its anchor)
+    // * Unlike the Align::Bind functions, changes don't cascade
+    //   through property bindings. Changes to the properties a
+    //   constraint depends on just mark the layout as dirty, and
+    //   the TransformSystem resolves all of the constraints once
+    //   per frame with each anchor resolved before the widgets
+    //   that depend on it.
+    // * Owned by the TransformSystem; use the Align::Anchor
+    //   functions to add constraints
+    class AnchorLayout final
+    {
+    public:
+        enum class Edge : u8
+        {
+            Left,
+            HCenter,
+            Right,
+            Top,
+            VCenter,
+            Bottom
+        };
+
+        AnchorLayout();
+        ~AnchorLayout();
+
+        // * Keeps @edge of @widget at @anchor_edge of @anchor,
+        //   replacing any constraint on the same axis of @widget
+        // * @anchor must be the parent or a sibling of @widget
+        // * Throws WidgetAlignmentInvalid if the edges are on
+        //   different axes or the constraint would make widgets
+        //   depend on each other in a cycle
+        void Add(Widget* widget,
+                 Edge edge,
+                 Widget* anchor,
+                 Edge anchor_edge);
+
+        // Removes the constraints of @widget and the
+        // constraints that use @widget as an anchor
+        void Remove(Widget* widget);
+
+        bool GetDirty() const
+        {
+            return m_dirty;
+        }
+
+        uint GetConstraintCount() const;
+
+        // Resolves all of the constraints if any of them have
+        // changed since the last time
+        void Resolve();
+
+    private:
+        struct Constraint
+        {
+            Widget* anchor{nullptr};
+            bool anchor_is_parent{false};
+
+            // The position of an edge along its axis as a
+            // fraction of the width or height (ie. 0.5 for
+            // the center)
+            float anchor_fraction{0.0f};
+            float fraction{0.0f};
+
+            uint pass{0};
+
+            Id cid_size{0};
+            Id cid_anchor_size{0};
+            Id cid_anchor_position{0};
+        };
+
+        // Constraints for the horizontal and vertical axes
+        struct WidgetConstraints
+        {
+            Constraint list_axes[2];
+        };
+
+        void onChanged();
+
+        void disconnect(Widget* widget,
+                        uint axis,
+                        Constraint& constraint);
+
+        void resolve(Widget* widget,
+                     uint axis,
+                     Constraint& constraint);
+
+        std::unordered_map<Widget*,WidgetConstraints> m_lkup_constraints;
+
+        bool m_dirty{false};
+        bool m_resolving{false};
+        uint m_pass{0};
+    };
+}
+
+#endif // RAINTK_ANCHOR_LAYOUT_HPP
@@ -31,7 +31,13 @@ namespace raintk
         m_keep(false),
         m_ready(false),
         m_complete(false),
-        m_scene(scene)
+        m_scene(scene),
+        m_delay_ms(0.0f),
+        m_delay_remaining_ms(0.0f),
+        m_group(nullptr),
+        m_active_index(AnimationSystem::k_inactive_index),
+        m_waiting(false),
+        m_wake_tick(0)
     {}
 
     void Animation::Init(ks::Object::Key const &,
@@ -53,15 +59,42 @@ namespace raintk
         {
             m_ready = false;
             m_complete = false;
+
+            // Animations in a group are started by the group
+            if(m_group)
+            {
+                return;
+            }
+
+            if(m_delay_ms > 0.0f && m_scene)
+            {
+                // start() is called when the delay ends
+                m_state = State::Running;
+                m_scene->GetAnimationSystem()->scheduleStart(this,m_delay_ms);
+                return;
+            }
+
             this->start();
 
             m_state = State::Running;
+
+            if(m_scene)
+            {
+                m_scene->GetAnimationSystem()->activate(this);
+            }
         }
     }
 
     void Animation::Stop()
     {
         m_state = State::Stopped;
+        m_delay_remaining_ms = 0.0f;
+
+        if(m_scene && !m_group)
+        {
+            m_scene->GetAnimationSystem()->cancelStart(this);
+            m_scene->GetAnimationSystem()->deactivate(this);
+        }
     }
 
     void Animation::Pause()
@@ -69,6 +102,16 @@ namespace raintk
         if(m_state == State::Running)
         {
             m_state = State::Paused;
+
+            if(m_scene && !m_group)
+            {
+                if(m_waiting)
+                {
+                    m_delay_remaining_ms =
+                            m_scene->GetAnimationSystem()->cancelStart(this);
+                }
+                m_scene->GetAnimationSystem()->deactivate(this);
+            }
         }
     }
 
@@ -77,14 +120,42 @@ namespace raintk
         if(m_state == State::Paused)
         {
             m_state = State::Running;
+
+            if(m_scene && !m_group)
+            {
+                if(m_delay_remaining_ms > 0.0f)
+                {
+                    m_scene->GetAnimationSystem()->scheduleStart(
+                                this,m_delay_remaining_ms);
+
+                    m_delay_remaining_ms = 0.0f;
+                }
+                else
+                {
+                    m_scene->GetAnimationSystem()->activate(this);
+                }
+            }
         }
     }
 
     void Animation::Complete()
     {
+        if(m_waiting && m_scene)
+        {
+            // Never started
+            m_scene->GetAnimationSystem()->cancelStart(this);
+            this->start();
+        }
+
         this->complete();
         m_complete = true;
         m_state = State::Stopped;
+        m_delay_remaining_ms = 0.0f;
+
+        if(m_scene && !m_group)
+        {
+            m_scene->GetAnimationSystem()->deactivate(this);
+        }
 
         if(!m_keep)
         {
@@ -101,6 +172,11 @@ namespace raintk
                 m_state = State::Stopped;
                 m_complete = true;
 
+                if(m_scene && !m_group)
+                {
+                    m_scene->GetAnimationSystem()->deactivate(this);
+                }
+
                 if(!m_keep)
                 {
                     Remove();
@@ -148,4 +224,14 @@ namespace raintk
     {
         return m_keep;
     }
+
+    void Animation::SetDelay(float delay_ms)
+    {
+        m_delay_ms = delay_ms;
+    }
+
+    float Animation::GetDelay() const
+    {
+        return m_delay_ms;
+    }
 }
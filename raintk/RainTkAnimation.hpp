@@ -23,11 +23,13 @@
 namespace raintk
 {
     class Scene;
+    class AnimationGroup;
 
     class Animation : public ks::Object
     {
         friend class AnimationSystem;
         friend class TransformSystem;
+        friend class AnimationGroup;
 
     public:
         using base_type = ks::Object;
@@ -65,6 +67,15 @@ namespace raintk
         void SetKeepOnComplete(bool keep);
         bool GetKeepOnComplete() const;
 
+        // * Delay between calling Start() and the animation
+        //   actually starting
+        // * While waiting, the animation is parked by the
+        //   AnimationSystem and isn't visited every frame
+        // * If the animation is part of an AnimationGroup, the
+        //   delay is relative to when the group would start it
+        void SetDelay(float delay_ms);
+        float GetDelay() const;
+
     protected:
         virtual void start()=0;
 
@@ -80,6 +91,20 @@ namespace raintk
     private:
         Scene* m_scene;
         bool m_ready;
+
+        float m_delay_ms;
+
+        // Remaining delay when paused while waiting to start
+        float m_delay_remaining_ms;
+
+        // Set if this animation is driven by a group
+        // instead of the AnimationSystem
+        AnimationGroup* m_group;
+
+        // AnimationSystem bookkeeping
+        std::size_t m_active_index;
+        bool m_waiting;
+        u64 m_wake_tick;
     };
 }
 
@@ -0,0 +1,253 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <limits>
+#include <algorithm>
+#include <raintk/RainTkAnimationGroup.hpp>
+
+namespace raintk
+{
+    namespace
+    {
+        // Start time for sequential animations that are waiting
+        // on the previous animation to complete
+        float const k_start_unknown = std::numeric_limits<float>::max();
+    }
+
+    // ============================================================= //
+
+    AnimationInGroup::AnimationInGroup(std::string msg) :
+        ks::Exception(ks::Exception::ErrorLevel::ERROR,std::move(msg),false)
+    {}
+
+    // ============================================================= //
+
+    AnimationGroup::AnimationGroup(ks::Object::Key const &key,
+                                   Scene* scene,
+                                   Mode mode,
+                                   float stagger_ms) :
+        Animation(key,scene),
+        m_mode(mode),
+        m_stagger_ms(stagger_ms),
+        m_elapsed_ms(0.0f)
+    {}
+
+    void AnimationGroup::Init(ks::Object::Key const &,
+                              shared_ptr<AnimationGroup> const &)
+    {}
+
+    AnimationGroup::~AnimationGroup()
+    {
+        Clear();
+    }
+
+    void AnimationGroup::Add(shared_ptr<Animation> const &animation)
+    {
+        if(animation->m_group)
+        {
+            throw AnimationInGroup(
+                        "AnimationGroup: Animation is already "
+                        "part of a group");
+        }
+
+        // Take the animation away from the AnimationSystem
+        animation->Stop();
+        animation->m_group = this;
+
+        std::size_t const index = m_list_animations.size();
+        float start_ms = k_start_unknown;
+
+        if(m_mode == Mode::Parallel)
+        {
+            start_ms = animation->m_delay_ms;
+        }
+        else if(m_mode == Mode::Staggered)
+        {
+            start_ms = (index*m_stagger_ms)+animation->m_delay_ms;
+        }
+        else if(index == 0)
+        {
+            start_ms = animation->m_delay_ms;
+        }
+        else if(m_list_child_states.back() == ChildState::Done)
+        {
+            // Adding to a sequence that has already
+            // run to its end
+            start_ms = m_elapsed_ms+animation->m_delay_ms;
+        }
+
+        // Animations added to a running group after their
+        // start time begin on the next update
+        if(m_state != State::Stopped && start_ms != k_start_unknown)
+        {
+            start_ms = std::max(start_ms,m_elapsed_ms);
+        }
+
+        m_list_animations.push_back(animation);
+        m_list_child_states.push_back(ChildState::Waiting);
+        m_list_start_ms.push_back(start_ms);
+    }
+
+    void AnimationGroup::Clear()
+    {
+        for(auto& animation : m_list_animations)
+        {
+            animation->m_group = nullptr;
+            animation->m_state = State::Stopped;
+        }
+
+        m_list_animations.clear();
+        m_list_child_states.clear();
+        m_list_start_ms.clear();
+    }
+
+    std::size_t AnimationGroup::GetSize() const
+    {
+        return m_list_animations.size();
+    }
+
+    AnimationGroup::Mode AnimationGroup::GetMode() const
+    {
+        return m_mode;
+    }
+
+    void AnimationGroup::start()
+    {
+        m_elapsed_ms = 0.0f;
+
+        for(std::size_t i=0; i < m_list_animations.size(); i++)
+        {
+            auto& animation = m_list_animations[i];
+            animation->m_state = State::Stopped;
+            m_list_child_states[i] = ChildState::Waiting;
+
+            if(m_mode == Mode::Parallel)
+            {
+                m_list_start_ms[i] = animation->m_delay_ms;
+            }
+            else if(m_mode == Mode::Staggered)
+            {
+                m_list_start_ms[i] = (i*m_stagger_ms)+animation->m_delay_ms;
+            }
+            else
+            {
+                m_list_start_ms[i] =
+                        (i==0) ? animation->m_delay_ms : k_start_unknown;
+            }
+        }
+    }
+
+    bool AnimationGroup::update(float delta_ms)
+    {
+        m_elapsed_ms += delta_ms;
+
+        bool all_done = true;
+
+        for(std::size_t i=0; i < m_list_animations.size(); i++)
+        {
+            auto& child_state = m_list_child_states[i];
+            if(child_state == ChildState::Done)
+            {
+                continue;
+            }
+
+            float child_delta_ms = delta_ms;
+
+            if(child_state == ChildState::Waiting)
+            {
+                if(m_elapsed_ms < m_list_start_ms[i])
+                {
+                    all_done = false;
+                    continue;
+                }
+
+                // Only advance by the time since the child's
+                // start, which may be partway into this frame
+                startChild(i);
+                child_delta_ms = m_elapsed_ms-m_list_start_ms[i];
+            }
+
+            auto& animation = m_list_animations[i];
+
+            if(animation->m_state == State::Stopped)
+            {
+                // Stopped externally
+                completeChild(i);
+            }
+            else if(animation->m_state == State::Running)
+            {
+                if(animation->update(child_delta_ms))
+                {
+                    completeChild(i);
+                }
+            }
+
+            if(child_state != ChildState::Done)
+            {
+                all_done = false;
+            }
+        }
+
+        return all_done;
+    }
+
+    void AnimationGroup::complete()
+    {
+        for(std::size_t i=0; i < m_list_animations.size(); i++)
+        {
+            if(m_list_child_states[i] == ChildState::Waiting)
+            {
+                startChild(i);
+            }
+
+            if(m_list_child_states[i] == ChildState::Running)
+            {
+                m_list_animations[i]->complete();
+                completeChild(i);
+            }
+        }
+    }
+
+    void AnimationGroup::startChild(std::size_t index)
+    {
+        auto& animation = m_list_animations[index];
+        animation->m_complete = false;
+        animation->m_ready = true;
+        animation->start();
+        animation->m_state = State::Running;
+
+        m_list_child_states[index] = ChildState::Running;
+    }
+
+    void AnimationGroup::completeChild(std::size_t index)
+    {
+        auto& animation = m_list_animations[index];
+        animation->m_state = State::Stopped;
+        animation->m_complete = true;
+
+        m_list_child_states[index] = ChildState::Done;
+
+        // Schedule the next animation in a sequence
+        std::size_t const next = index+1;
+        if(m_mode == Mode::Sequential && next < m_list_animations.size())
+        {
+            m_list_start_ms[next] =
+                    m_elapsed_ms+m_list_animations[next]->m_delay_ms;
+        }
+    }
+
+    // ============================================================= //
+}
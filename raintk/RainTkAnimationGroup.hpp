@@ -0,0 +1,124 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef RAINTK_ANIMATION_GROUP_HPP
+#define RAINTK_ANIMATION_GROUP_HPP
+
+#include <vector>
+#include <ks/KsException.hpp>
+#include <raintk/RainTkAnimation.hpp>
+
+namespace raintk
+{
+    // ============================================================= //
+
+    class AnimationInGroup : public ks::Exception
+    {
+    public:
+        AnimationInGroup(std::string msg);
+        ~AnimationInGroup() = default;
+    };
+
+    // ============================================================= //
+
+    // AnimationGroup
+    // * Runs a set of Animations off the group's own clock
+    // * Sequential: each animation starts when the previous
+    //   one completes
+    // * Parallel: all animations start with the group
+    // * Staggered: animation i starts i*stagger_ms after
+    //   the group starts
+    // * An animation's delay (Animation::SetDelay) is added
+    //   to the time the group would otherwise start it
+    // * Animations added to a group are only updated by the
+    //   group, so calling Start() on them directly has no
+    //   effect. Groups can be nested.
+    // * The group completes once all of its animations
+    //   have completed
+
+    // Usage example:
+    // auto fade_in = ks::MakeObject<AnimationGroup>(
+    //             scene,AnimationGroup::Mode::Staggered,50.0f);
+    // for(auto& anim : list_item_anims) {
+    //     fade_in->Add(anim);
+    // }
+    // fade_in->Start();
+
+    class AnimationGroup : public Animation
+    {
+    public:
+        using base_type = raintk::Animation;
+
+        enum class Mode
+        {
+            Sequential,
+            Parallel,
+            Staggered
+        };
+
+        AnimationGroup(ks::Object::Key const &key,
+                       Scene* scene,
+                       Mode mode,
+                       float stagger_ms=0.0f);
+
+        void Init(ks::Object::Key const &key,
+                  shared_ptr<AnimationGroup> const &this_group);
+
+        ~AnimationGroup();
+
+        // * Adds @animation to the end of this group
+        // * The group keeps a reference to @animation
+        // * Throws AnimationInGroup if @animation is already
+        //   part of a group
+        void Add(shared_ptr<Animation> const &animation);
+
+        // Removes all animations from this group
+        void Clear();
+
+        std::size_t GetSize() const;
+        Mode GetMode() const;
+
+    private:
+        void start() override;
+        bool update(float delta_ms) override;
+        void complete() override;
+
+        void startChild(std::size_t index);
+        void completeChild(std::size_t index);
+
+        enum class ChildState : u8
+        {
+            Waiting,
+            Running,
+            Done
+        };
+
+        Mode const m_mode;
+        float const m_stagger_ms;
+
+        std::vector<shared_ptr<Animation>> m_list_animations;
+        std::vector<ChildState> m_list_child_states;
+
+        // Group time at which each child starts
+        std::vector<float> m_list_start_ms;
+
+        float m_elapsed_ms;
+    };
+
+    // ============================================================= //
+}
+
+#endif // RAINTK_ANIMATION_GROUP_HPP
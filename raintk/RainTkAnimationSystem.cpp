@@ -15,7 +15,10 @@
 */
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
+#include <raintk/RainTkProperty.hpp>
 #include <raintk/RainTkAnimation.hpp>
 #include <raintk/RainTkAnimationSystem.hpp>
 
@@ -29,7 +32,20 @@ namespace raintk
         ks::Exception(ks::Exception::ErrorLevel::FATAL,"",true)
     {}
 
-    AnimationSystem::AnimationSystem()
+    std::size_t const AnimationSystem::k_inactive_index =
+            std::numeric_limits<std::size_t>::max();
+
+    float const AnimationSystem::k_timer_tick_ms = 16.0f;
+
+    uint const AnimationSystem::k_timer_slot_count = 64;
+
+    AnimationSystem::AnimationSystem() :
+        m_active_count(0),
+        m_active_has_gaps(false),
+        m_list_timer_slots(k_timer_slot_count),
+        m_timer_count(0),
+        m_timer_tick(0),
+        m_time_ms(0.0)
     {
 
     }
@@ -52,13 +68,32 @@ namespace raintk
                     std::chrono::microseconds>(
                         curr_time-prev_time).count()/1000.0;
 
-        for(Animation* animation : m_list_animations)
+        m_last_update_time = curr_time;
+
+        // Start any delayed animations that are due. They
+        // aren't ready until the next layout, so they get
+        // their first update next frame
+        advanceTimers(elapsed_ms);
+
+        // Animations often modify several properties of the same
+        // widget (ie. x and y), so batch the resulting change
+        // notifications for all animations into one transaction
+        PropertyTransaction transaction;
+
+        // Animations can be started, stopped or removed while
+        // we iterate, so index instead of using iterators.
+        // Deactivated animations leave a nullptr entry that's
+        // cleaned up after.
+        for(std::size_t i=0; i < m_list_active.size(); i++)
         {
-            if(animation->m_ready)
+            Animation* animation = m_list_active[i];
+            if(animation && animation->m_ready)
             {
                 animation->Update(elapsed_ms);
             }
         }
+
+        compactActive();
     }
 
     void AnimationSystem::AddAnimation(Animation* animation)
@@ -90,6 +125,9 @@ namespace raintk
             throw AnimationNotFound();
         }
 
+        cancelStart(animation);
+        deactivate(animation);
+
         m_list_animations.erase(it);
     }
 
@@ -97,4 +135,196 @@ namespace raintk
     {
         return m_list_animations;
     }
+
+    std::vector<Animation*> const & AnimationSystem::GetListActiveAnimations() const
+    {
+        return m_list_active;
+    }
+
+    bool AnimationSystem::GetNextWakeUpTime(TimePoint& wake_time) const
+    {
+        if(m_active_count > 0)
+        {
+            wake_time = m_last_update_time;
+            return true;
+        }
+
+        if(m_timer_count == 0)
+        {
+            return false;
+        }
+
+        double min_wake_ms = std::numeric_limits<double>::max();
+        for(auto const &slot : m_list_timer_slots)
+        {
+            for(auto const &timer : slot)
+            {
+                min_wake_ms = std::min(min_wake_ms,timer.wake_ms);
+            }
+        }
+
+        wake_time =
+                m_last_update_time +
+                std::chrono::duration_cast<TimePoint::duration>(
+                    Microseconds(
+                        static_cast<s64>(
+                            std::max(0.0,min_wake_ms-m_time_ms)*1000.0)));
+
+        return true;
+    }
+
+    void AnimationSystem::activate(Animation* animation)
+    {
+        if(animation->m_active_index != k_inactive_index)
+        {
+            return;
+        }
+
+        animation->m_active_index = m_list_active.size();
+        m_list_active.push_back(animation);
+        m_active_count++;
+    }
+
+    void AnimationSystem::deactivate(Animation* animation)
+    {
+        if(animation->m_active_index == k_inactive_index)
+        {
+            return;
+        }
+
+        m_list_active[animation->m_active_index] = nullptr;
+        animation->m_active_index = k_inactive_index;
+        m_active_count--;
+        m_active_has_gaps = true;
+    }
+
+    void AnimationSystem::scheduleStart(Animation* animation, float delay_ms)
+    {
+        cancelStart(animation);
+        deactivate(animation);
+
+        double const wake_ms = m_time_ms+delay_ms;
+
+        // Timers are only checked for ticks after the
+        // current one, so round up
+        u64 wake_tick = static_cast<u64>(std::ceil(wake_ms/k_timer_tick_ms));
+        wake_tick = std::max(wake_tick,m_timer_tick+1);
+
+        m_list_timer_slots[wake_tick%k_timer_slot_count].push_back(
+                    Timer{animation,wake_ms});
+
+        animation->m_waiting = true;
+        animation->m_wake_tick = wake_tick;
+        m_timer_count++;
+    }
+
+    float AnimationSystem::cancelStart(Animation* animation)
+    {
+        if(!animation->m_waiting)
+        {
+            return 0.0f;
+        }
+
+        auto& slot =
+                m_list_timer_slots[
+                    animation->m_wake_tick%k_timer_slot_count];
+
+        float remaining_ms = 0.0f;
+
+        for(auto it = slot.begin(); it != slot.end(); ++it)
+        {
+            if(it->animation == animation)
+            {
+                remaining_ms = std::max(0.0,it->wake_ms-m_time_ms);
+                slot.erase(it);
+                m_timer_count--;
+                break;
+            }
+        }
+
+        animation->m_waiting = false;
+
+        return remaining_ms;
+    }
+
+    void AnimationSystem::advanceTimers(float elapsed_ms)
+    {
+        m_time_ms += elapsed_ms;
+
+        u64 const curr_tick =
+                static_cast<u64>(std::floor(m_time_ms/k_timer_tick_ms));
+
+        if(m_timer_count == 0)
+        {
+            m_timer_tick = curr_tick;
+            return;
+        }
+
+        // Collect the due animations first since starting
+        // them may schedule or cancel other timers
+        auto& list_due = m_list_due;
+        list_due.clear();
+
+        // If a full revolution has passed, every slot is
+        // visited once
+        u64 const last_tick =
+                std::min(curr_tick,m_timer_tick+k_timer_slot_count);
+
+        for(u64 tick=m_timer_tick+1; tick <= last_tick; tick++)
+        {
+            auto& slot = m_list_timer_slots[tick%k_timer_slot_count];
+
+            for(std::size_t i=0; i < slot.size();)
+            {
+                if(slot[i].animation->m_wake_tick <= curr_tick)
+                {
+                    list_due.push_back(slot[i].animation);
+                    slot[i] = slot.back();
+                    slot.pop_back();
+                    m_timer_count--;
+                }
+                else
+                {
+                    i++;
+                }
+            }
+        }
+
+        m_timer_tick = curr_tick;
+
+        for(Animation* animation : list_due)
+        {
+            animation->m_waiting = false;
+
+            if(animation->m_state == Animation::State::Running)
+            {
+                animation->m_ready = false;
+                animation->start();
+                activate(animation);
+            }
+        }
+    }
+
+    void AnimationSystem::compactActive()
+    {
+        if(!m_active_has_gaps)
+        {
+            return;
+        }
+
+        std::size_t count=0;
+        for(std::size_t i=0; i < m_list_active.size(); i++)
+        {
+            Animation* animation = m_list_active[i];
+            if(animation)
+            {
+                animation->m_active_index = count;
+                m_list_active[count] = animation;
+                count++;
+            }
+        }
+
+        m_list_active.resize(count);
+        m_active_has_gaps = false;
+    }
 }
@@ -42,7 +42,13 @@ namespace raintk
 
     class AnimationSystem : public ks::draw::System
     {
+        friend class Animation;
+
     public:
+        // Animation::m_active_index for animations that
+        // aren't in the active list
+        static std::size_t const k_inactive_index;
+
         AnimationSystem();
 
         ~AnimationSystem();
@@ -55,14 +61,71 @@ namespace raintk
         void AddAnimation(Animation* animation);
         void RemoveAnimation(Animation* animation);
 
+        // All animations that have been added, regardless
+        // of their state
         std::vector<Animation*> const & GetListAnimations() const;
 
+        // Animations that are currently running and updated
+        // each frame. Stopped, paused and delayed animations
+        // (and animations that are part of a group) aren't
+        // in this list. May contain nullptr entries for
+        // animations that were deactivated since the last
+        // Update.
+        std::vector<Animation*> const & GetListActiveAnimations() const;
+
+        // Returns false if there are no running or delayed
+        // animations, otherwise sets @wake_time to the time
+        // the next Update is needed. If any animations are
+        // running, this is the time of the last Update (ie.
+        // as soon as possible), otherwise it's when the
+        // next delayed animation starts.
+        bool GetNextWakeUpTime(TimePoint& wake_time) const;
+
     private:
+        // Called by Animation
+        void activate(Animation* animation);
+        void deactivate(Animation* animation);
+        void scheduleStart(Animation* animation, float delay_ms);
+
+        // Returns the remaining delay
+        float cancelStart(Animation* animation);
+
+        void advanceTimers(float elapsed_ms);
+        void compactActive();
+
         std::vector<Animation*> m_list_animations;
+
+        std::vector<Animation*> m_list_active;
+        std::size_t m_active_count;
+        bool m_active_has_gaps;
+
+        // Timer wheel for delayed animations
+        // * Time is divided into ticks of k_timer_tick_ms and a
+        //   timer is placed in slot (wake_tick % slot count)
+        // * Each Update only visits the slots for the ticks
+        //   that have passed, so waiting animations cost
+        //   nothing until they're due
+        struct Timer
+        {
+            Animation* animation;
+            double wake_ms;
+        };
+
+        static float const k_timer_tick_ms;
+        static uint const k_timer_slot_count;
+
+        std::vector<std::vector<Timer>> m_list_timer_slots;
+        std::size_t m_timer_count;
+        u64 m_timer_tick;
+
+        // Due animations collected by advanceTimers, kept
+        // to reuse its memory between frames
+        std::vector<Animation*> m_list_due;
+
+        // Time accumulated from Update calls
+        double m_time_ms;
+        TimePoint m_last_update_time;
     };
 }
 
 #endif // RAINTK_ANIMATION_SYSTEM_HPP
-
-
-
@@ -106,6 +106,12 @@ namespace raintk
         draw_data.key.SetClip(m_clip_id);
     }
 
+    void AtlasImage::onLayerIdUpdated()
+    {
+        auto& draw_data = m_cmlist_draw_data->GetComponent(m_entity_id);
+        draw_data.key.SetLayer(m_layer_id);
+    }
+
     void AtlasImage::onTransformUpdated()
     {
         m_upd_geometry = true;
@@ -116,7 +122,7 @@ namespace raintk
 
     void AtlasImage::onAccOpacityUpdated()
     {
-        m_upd_geometry = true;
+        m_upd_opacity = true;
 
         m_cmlist_update_data->GetComponent(m_entity_id).
                 update |= UpdateData::UpdateDrawables;
@@ -125,7 +131,7 @@ namespace raintk
     void AtlasImage::createDrawables()
     {
         // Destroy drawable resources if they already exist
-        if(m_scene->GetEntityHasComponents<DrawData>(m_entity_id))
+        if(m_cmlist_draw_data->GetHasComponent(m_entity_id))
         {
             destroyDrawables();
         }
@@ -136,7 +142,8 @@ namespace raintk
                     texture_set_id);
 
         // DrawData
-        m_cmlist_draw_data->Create(
+        auto& draw_data =
+                m_cmlist_draw_data->Create(
                     m_entity_id,
                     DrawData{
                         g_draw_key,
@@ -144,6 +151,8 @@ namespace raintk
                         visible.Get()
                     });
 
+        draw_data.key.SetLayer(m_layer_id);
+
         // UpdateData
         m_cmlist_update_data->GetComponent(m_entity_id).
                 update |= UpdateData::UpdateDrawables;
@@ -161,7 +170,31 @@ namespace raintk
         if(m_upd_geometry)
         {
             updateGeometry();
-            m_upd_geometry = false;
+        }
+        else if(m_upd_opacity)
+        {
+            updateOpacity();
+        }
+
+        m_upd_geometry = false;
+        m_upd_opacity = false;
+    }
+
+    // Rewrites the opacity of the existing vertices
+    void AtlasImage::updateOpacity()
+    {
+        auto& draw_data = m_cmlist_draw_data->
+                GetComponent(m_entity_id);
+
+        Vertex* vx_buffer =
+                reinterpret_cast<Vertex*>(
+                    &(draw_data.vx_buffer->front()));
+
+        uint const vx_count = draw_data.vx_buffer->size()/sizeof(Vertex);
+
+        for(uint i=0; i < vx_count; i++)
+        {
+            vx_buffer[i].a_v3_tex0_opacity.z = m_accumulated_opacity;
         }
     }
 
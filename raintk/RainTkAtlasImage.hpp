@@ -43,18 +43,21 @@ namespace raintk
         void onWidthChanged() override;
         void onHeightChanged() override;
         void onClipIdUpdated() override;
+        void onLayerIdUpdated() override;
         void onTransformUpdated() override;
         void onAccOpacityUpdated() override;
         void createDrawables() override;
         void destroyDrawables() override;
         void updateDrawables() override;
         void updateGeometry();
+        void updateOpacity();
         static void setupTypeInit(Scene* scene);
 
         DrawDataComponentList* const m_cmlist_draw_data;
         shared_ptr<ImageAtlas> const m_image_atlas;
         Id const m_atlas_image_id;
         bool m_upd_geometry;
+        bool m_upd_opacity{false};
     };
 }
 
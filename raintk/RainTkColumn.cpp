@@ -22,7 +22,10 @@ namespace raintk
     Column::Column(ks::Object::Key const &key,
                    Scene* scene,
                    shared_ptr<Widget> parent) :
-        Widget(key,scene,parent)
+        Widget(key,scene,parent),
+        m_list_offsets(1,0.0f),
+        m_dirty_index(0),
+        m_rescan_width(false)
     {
 
     }
@@ -39,35 +42,45 @@ namespace raintk
 
     Column::~Column()
     {
-
+        // The child connections capture this Column so they
+        // must be removed in case the children outlive it
+        for(auto& item : m_list_items)
+        {
+            item.widget->height.signal_changed.Disconnect(item.cid_height);
+            item.widget->width.signal_changed.Disconnect(item.cid_width);
+        }
     }
 
     void Column::AddChild(shared_ptr<Widget> const &child)
     {
         Widget::AddChild(child);
 
-        shared_ptr<Column> this_col =
-                std::static_pointer_cast<Column>(
-                    shared_from_this());
+        Widget* child_ptr = child.get();
 
         Item new_item;
-        new_item.widget = child.get();
+        new_item.widget = child_ptr;
+        new_item.width = 0.0f;
+        new_item.height = 0.0f;
 
         new_item.cid_height =
                 child->height.signal_changed.Connect(
-                    this_col,
-                    &Column::onChildDimsChanged,
-                    ks::ConnectionType::Direct);
+                    [this,child_ptr](){
+                        onChildDimsChanged(child_ptr);
+                    });
 
         new_item.cid_width =
                 child->width.signal_changed.Connect(
-                    this_col,
-                    &Column::onChildDimsChanged,
-                    ks::ConnectionType::Direct);
+                    [this,child_ptr](){
+                        onChildDimsChanged(child_ptr);
+                    });
 
         // Save
-        auto it = m_list_items.insert(m_list_items.end(),new_item);
-        m_lkup_id_item_it.emplace(child->GetId(),it);
+        std::size_t const index = m_list_items.size();
+        m_list_items.push_back(new_item);
+        m_list_offsets.push_back(m_list_offsets.back());
+        m_lkup_id_index.emplace(child->GetId(),index);
+
+        m_dirty_index = std::min(m_dirty_index,index);
 
         // Mark this widget as updated
         m_cmlist_update_data->GetComponent(m_entity_id).
@@ -76,16 +89,34 @@ namespace raintk
 
     void Column::RemoveChild(shared_ptr<Widget> const &child)
     {
-        auto lkup_it = m_lkup_id_item_it.find(child->GetId());
-        if(lkup_it != m_lkup_id_item_it.end())
+        auto lkup_it = m_lkup_id_index.find(child->GetId());
+        if(lkup_it != m_lkup_id_index.end())
         {
-            auto it = lkup_it->second;
+            std::size_t const index = lkup_it->second;
+            auto& item = m_list_items[index];
+
+            item.widget->height.signal_changed.Disconnect(item.cid_height);
+            item.widget->width.signal_changed.Disconnect(item.cid_width);
+
+            // If the removed item was the widest one,
+            // children_width has to be recalculated
+            if(item.width >= children_width.Get())
+            {
+                m_rescan_width = true;
+            }
+
+            m_list_items.erase(m_list_items.begin()+index);
+            m_lkup_id_index.erase(lkup_it);
+
+            // Offsets after @index are recalculated in update()
+            m_list_offsets.pop_back();
 
-            it->widget->width.signal_changed.Disconnect(it->cid_width);
-            it->widget->height.signal_changed.Disconnect(it->cid_height);
+            for(std::size_t i=index; i < m_list_items.size(); i++)
+            {
+                m_lkup_id_index[m_list_items[i].widget->GetId()] = i;
+            }
 
-            m_list_items.erase(it);
-            m_lkup_id_item_it.erase(lkup_it);
+            m_dirty_index = std::min(m_dirty_index,index);
 
             m_cmlist_update_data->GetComponent(m_entity_id).
                     update |= UpdateData::UpdateWidget;
@@ -96,33 +127,82 @@ namespace raintk
 
     void Column::onSpacingChanged()
     {
+        m_dirty_index = 0;
+
         m_cmlist_update_data->GetComponent(m_entity_id).
                 update |= UpdateData::UpdateWidget;
     }
 
-    void Column::onChildDimsChanged()
+    void Column::onChildDimsChanged(Widget* child)
     {
+        auto lkup_it = m_lkup_id_index.find(child->GetId());
+        if(lkup_it != m_lkup_id_index.end())
+        {
+            m_dirty_index = std::min(m_dirty_index,lkup_it->second);
+        }
+
         m_cmlist_update_data->GetComponent(m_entity_id).
                 update |= UpdateData::UpdateWidget;
     }
 
     void Column::update()
     {
-        uint count = 0;
-        float bottom = 0;
-        float col_width = 0;
-        float spacing_val = spacing.Get();
+        // Notify children once (see PropertyTransaction)
+        PropertyTransaction transaction;
 
-        for(auto& item : m_list_items)
+        float const spacing_val = spacing.Get();
+        std::size_t const item_count = m_list_items.size();
+        std::size_t const dirty_index = m_dirty_index;
+        m_dirty_index = item_count;
+
+        // Only items from the first dirty index onward can have
+        // new dims, and only their offsets need to be recalculated
+        float col_width = (dirty_index == 0) ? 0.0f : children_width.Get();
+        bool rescan_width = m_rescan_width;
+        m_rescan_width = false;
+
+        for(std::size_t i=dirty_index; i < item_count; i++)
         {
-            item.widget->y = count*spacing_val + bottom;
+            auto& item = m_list_items[i];
+            float const width = item.widget->width.Get();
+
+            if(width > col_width)
+            {
+                col_width = width;
+            }
+            else if(item.width == col_width && width < item.width)
+            {
+                // The widest item shrank
+                rescan_width = true;
+            }
+
+            item.width = width;
+            item.height = item.widget->height.Get();
+
+            m_list_offsets[i+1] = m_list_offsets[i]+item.height+spacing_val;
+        }
 
-            count++;
-            bottom += item.widget->height.Get();
-            col_width = std::max(item.widget->width.Get(),col_width);
+        if(rescan_width)
+        {
+            col_width = 0.0f;
+            for(auto const &item : m_list_items)
+            {
+                col_width = std::max(item.width,col_width);
+            }
         }
 
         children_width = col_width;
-        children_height = bottom-spacing_val;
+        children_height = m_list_offsets[item_count]-spacing_val;
+
+        for(std::size_t i=dirty_index; i < item_count; i++)
+        {
+            auto const &item = m_list_items[i];
+            float const y = m_list_offsets[i];
+
+            if(item.widget->y.Get() != y)
+            {
+                item.widget->y = y;
+            }
+        }
     }
 }
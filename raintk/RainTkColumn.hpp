@@ -17,8 +17,8 @@
 #ifndef RAINTK_COLUMN_HPP
 #define RAINTK_COLUMN_HPP
 
-#include <map>
-#include <list>
+#include <vector>
+#include <unordered_map>
 #include <raintk/RainTkWidget.hpp>
 
 namespace raintk
@@ -55,7 +55,7 @@ namespace raintk
 
     protected:
         void onSpacingChanged();
-        void onChildDimsChanged();
+        void onChildDimsChanged(Widget* child);
 
         Id m_cid_spacing;
 
@@ -67,10 +67,28 @@ namespace raintk
             Widget* widget;
             Id cid_height;
             Id cid_width;
+
+            // Child dims as of the last update
+            float width;
+            float height;
         };
 
-        std::list<Item> m_list_items;
-        std::map<Id,std::list<Item>::iterator> m_lkup_id_item_it;
+        std::vector<Item> m_list_items;
+
+        // Prefix sums of item heights (plus spacing); the top
+        // edge of item i is m_list_offsets[i] and the size is
+        // always m_list_items.size()+1
+        std::vector<float> m_list_offsets;
+
+        std::unordered_map<Id,std::size_t> m_lkup_id_index;
+
+        // Index of the first item whose position may have
+        // changed since the last update (items before it are
+        // left alone)
+        std::size_t m_dirty_index;
+
+        // Set when the widest item is removed
+        bool m_rescan_width;
     };
 }
 
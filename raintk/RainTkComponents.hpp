@@ -23,6 +23,7 @@
 #include <raintk/RainTkGlobal.hpp>
 #include <raintk/RainTkDrawKey.hpp>
 #include <raintk/RainTkSceneKey.hpp>
+#include <raintk/RainTkDenseComponentList.hpp>
 
 // Forward declarations
 namespace ks
@@ -136,6 +137,7 @@ namespace raintk
         static u8 const UpdateTransform = (1 << 1);
         static u8 const UpdateDrawables = (1 << 2);
         static u8 const UpdateClip      = (1 << 3);
+        static u8 const UpdateOpacity   = (1 << 4);
 
         UpdateData() :
             update(NoUpdates),
@@ -159,11 +161,10 @@ namespace raintk
         InputArea* input_area;
     };
 
-    // TODO: We should use another container (ie one that
-    // isn't sparse) for InputData, because its likely only
-    // a few entities will be input areas
+    // Only a few entities are input areas so InputData
+    // is kept in a dense list
     using InputDataComponentList =
-        ks::ecs::ComponentList<SceneKey,InputData>;
+        DenseComponentList<InputData>;
 
     // ============================================================= //
 
@@ -181,8 +182,10 @@ namespace raintk
         bool visible;
     };
 
+    // Many widgets (ie layout containers) don't draw
+    // anything so DrawData is kept in a dense list
     using DrawDataComponentList =
-        ks::ecs::ComponentList<SceneKey,DrawData>;
+        DenseComponentList<DrawData>;
 
     // ============================================================= //
 }
@@ -0,0 +1,85 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef RAINTK_COMPOSITOR_ANIMATION_HPP
+#define RAINTK_COMPOSITOR_ANIMATION_HPP
+
+#include <glm/vec2.hpp>
+#include <raintk/RainTkGlobal.hpp>
+#include <raintk/RainTkTween.hpp>
+
+namespace raintk
+{
+    // ============================================================= //
+
+    // CompositorAnimation
+    // * Describes a transform and opacity animation that is
+    //   applied to a compositor layer (see DrawSystem::CreateLayer)
+    // * The animation is sent to the render thread once and is
+    //   evaluated by MainDrawStage every frame, so the widgets
+    //   in the layer aren't updated or redrawn while it runs
+    // * The translation, scale and rotation are applied in
+    //   world space on top of the layer's existing geometry;
+    //   scale and rotation are about the center of the layer's
+    //   root widget
+    // * The final values are held once the animation completes
+    //   until the animation is stopped or the layer is removed
+    struct CompositorAnimation
+    {
+        Tween::Curve curve{Tween::Curve::Linear};
+        Tween::Easing easing{Tween::Easing::InOut};
+
+        float duration_ms{0.0f};
+        float delay_ms{0.0f};
+
+        glm::vec2 translation_from{0.0f};
+        glm::vec2 translation_to{0.0f};
+
+        glm::vec2 scale_from{1.0f};
+        glm::vec2 scale_to{1.0f};
+
+        // The rotation angle in rads
+        float rotation_from{0.0f};
+        float rotation_to{0.0f};
+
+        float opacity_from{1.0f};
+        float opacity_to{1.0f};
+
+        // Set by DrawSystem::StartLayerAnimation
+        glm::vec2 origin{0.0f};
+    };
+
+    // ============================================================= //
+
+    // Commands that are queued by the DrawSystem and passed
+    // to MainDrawStage during Sync
+    struct CompositorLayerUpdate
+    {
+        enum class Type : u8
+        {
+            Start,
+            Stop
+        };
+
+        Id layer_id;
+        Type type;
+        CompositorAnimation animation;
+    };
+
+    // ============================================================= //
+}
+
+#endif // RAINTK_COMPOSITOR_ANIMATION_HPP
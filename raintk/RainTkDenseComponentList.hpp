@@ -0,0 +1,196 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef RAINTK_DENSE_COMPONENT_LIST_HPP
+#define RAINTK_DENSE_COMPONENT_LIST_HPP
+
+#include <vector>
+#include <limits>
+#include <functional>
+#include <raintk/RainTkGlobal.hpp>
+
+namespace raintk
+{
+    // =========================================================== //
+
+    class DenseComponentListBase
+    {
+    public:
+        virtual ~DenseComponentListBase() = default;
+
+        // Does nothing if @ent_id doesn't have a component
+        virtual void Remove(Id ent_id) = 0;
+
+        // * Called by Create for each entity that gets a component
+        // * Set by Scene::RegisterDenseComponentList so the Scene
+        //   can remove the component along with its entity
+        void SetCreatedCallback(std::function<void(Id)> callback)
+        {
+            m_created_callback = std::move(callback);
+        }
+
+    protected:
+        std::function<void(Id)> m_created_callback;
+    };
+
+    // =========================================================== //
+
+    // DenseComponentList
+    // * A sparse set of components: the components are packed
+    //   into a dense list and a lookup indexed by entity id
+    //   holds each component's index in that list
+    // * Unlike ks::ecs::ComponentList, which keeps a component
+    //   slot for every entity id, the memory used per entity
+    //   without a component is a single index and systems can
+    //   iterate over just the entities that have one
+    // * Removing a component moves the last component into its
+    //   place, so the dense list isn't in entity id order and
+    //   pointers to components are invalidated by Create and
+    //   Remove
+    // * These lists aren't part of the ks::ecs::Scene's component
+    //   masks. They're registered with the raintk::Scene so that
+    //   components are removed along with their entities no
+    //   matter how the entity is removed
+    //   (see Scene::RegisterDenseComponentList)
+    template<typename T>
+    class DenseComponentList final : public DenseComponentListBase
+    {
+    public:
+        DenseComponentList() = default;
+        ~DenseComponentList() = default;
+
+        // Replaces any existing component for @ent_id
+        T& Create(Id ent_id, T component)
+        {
+            if(ent_id >= m_lkup_index.size())
+            {
+                m_lkup_index.resize(ent_id+1,k_invalid_index);
+            }
+
+            uint& index = m_lkup_index[ent_id];
+            if(index != k_invalid_index)
+            {
+                m_list_components[index] = std::move(component);
+                return m_list_components[index];
+            }
+
+            index = m_list_components.size();
+            m_list_components.push_back(std::move(component));
+            m_list_ids.push_back(ent_id);
+
+            if(m_created_callback)
+            {
+                m_created_callback(ent_id);
+            }
+
+            return m_list_components.back();
+        }
+
+        void Remove(Id ent_id) override
+        {
+            if(!GetHasComponent(ent_id))
+            {
+                return;
+            }
+
+            uint const index = m_lkup_index[ent_id];
+            uint const last_index = m_list_components.size()-1;
+
+            if(index != last_index)
+            {
+                Id const last_ent_id = m_list_ids[last_index];
+                m_list_components[index] = std::move(m_list_components[last_index]);
+                m_list_ids[index] = last_ent_id;
+                m_lkup_index[last_ent_id] = index;
+            }
+
+            m_list_components.pop_back();
+            m_list_ids.pop_back();
+            m_lkup_index[ent_id] = k_invalid_index;
+        }
+
+        bool GetHasComponent(Id ent_id) const
+        {
+            return (ent_id < m_lkup_index.size() &&
+                    m_lkup_index[ent_id] != k_invalid_index);
+        }
+
+        // @ent_id must have a component
+        T& GetComponent(Id ent_id)
+        {
+            return m_list_components[m_lkup_index[ent_id]];
+        }
+
+        T const &GetComponent(Id ent_id) const
+        {
+            return m_list_components[m_lkup_index[ent_id]];
+        }
+
+        // The entity id for a component in the dense list
+        Id GetEntityId(T const *component) const
+        {
+            return m_list_ids[component-m_list_components.data()];
+        }
+
+        // * The components, in no particular order
+        // * GetDenseIds()[i] is the entity id of the
+        //   component at GetDenseList()[i]
+        std::vector<T>& GetDenseList()
+        {
+            return m_list_components;
+        }
+
+        std::vector<T> const &GetDenseList() const
+        {
+            return m_list_components;
+        }
+
+        std::vector<Id> const &GetDenseIds() const
+        {
+            return m_list_ids;
+        }
+
+        uint GetSize() const
+        {
+            return m_list_components.size();
+        }
+
+        // Bytes allocated for the lists, not including
+        // any heap memory owned by the components
+        std::size_t GetSizeBytes() const
+        {
+            return m_list_components.capacity()*sizeof(T)+
+                   m_list_ids.capacity()*sizeof(Id)+
+                   m_lkup_index.capacity()*sizeof(uint);
+        }
+
+    private:
+        static uint const k_invalid_index = std::numeric_limits<uint>::max();
+
+        std::vector<T> m_list_components;
+        std::vector<Id> m_list_ids;
+
+        // Index into m_list_components for each entity id
+        std::vector<uint> m_lkup_index;
+    };
+
+    template<typename T>
+    uint const DenseComponentList<T>::k_invalid_index;
+
+    // =========================================================== //
+}
+
+#endif // RAINTK_DENSE_COMPONENT_LIST_HPP
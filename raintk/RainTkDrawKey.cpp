@@ -29,6 +29,11 @@ namespace raintk
         ks::gl::Primitive::Points           // 6
     };
 
+    Id DrawKey::GetLayer() const
+    {
+        return ((m_key & mask<k_sbit_layer,k_bits_layer>::value) >> k_sbit_layer);
+    }
+
     bool DrawKey::GetTransparency() const
     {
         uint transparency = ((m_key & mask<k_sbit_transparency,k_bits_transparency>::value) >> k_sbit_transparency);
@@ -83,6 +88,11 @@ namespace raintk
 
     // ============================================================= //
 
+    void DrawKey::SetLayer(Id layer)
+    {
+        setData(mask<k_sbit_layer,k_bits_layer>::value, k_sbit_layer, layer);
+    }
+
     void DrawKey::SetTransparency(bool transparency)
     {
         setData(mask<k_sbit_transparency,k_bits_transparency>::value,
@@ -34,6 +34,9 @@ namespace raintk
         // [4]: DepthConfig
         // [5]: Shader
         // [10]: Clip
+        // [6]: GeometryLayout
+        // [1]: Transparency
+        // [8]: Layer
 
         // number of bits
         static const u8 k_bits_primitive        = 3;
@@ -46,6 +49,7 @@ namespace raintk
         static const u8 k_bits_clip             = 8;
         static const u8 k_bits_gm_layout        = 6;
         static const u8 k_bits_transparency     = 1;
+        static const u8 k_bits_layer            = 8;
 
         // starting bit position
         static const u8 k_sbit_primitive        = 0;
@@ -58,6 +62,7 @@ namespace raintk
         static const u8 k_sbit_clip             = k_sbit_shader+k_bits_shader;
         static const u8 k_sbit_gm_layout        = k_sbit_clip+k_bits_clip;
         static const u8 k_sbit_transparency     = k_sbit_gm_layout+k_bits_gm_layout;
+        static const u8 k_sbit_layer            = k_sbit_transparency+k_bits_transparency;
 
         // mask
         template<u8 sbit,u8 bits>
@@ -71,6 +76,7 @@ namespace raintk
     public:
         Id GetKey() const { return m_key; }
 
+        Id GetLayer() const;
         bool GetTransparency() const;
         Id GetGeometryLayout() const;
         Id GetClip() const;
@@ -82,6 +88,7 @@ namespace raintk
         Id GetUniformSet() const;
         ks::gl::Primitive GetPrimitive() const;
 
+        void SetLayer(Id layer);
         void SetTransparency(bool transparency);
         void SetGeometryLayout(Id gm_layout);
         void SetClip(Id clip);
@@ -0,0 +1,91 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef RAINTK_DRAW_SNAPSHOT_HPP
+#define RAINTK_DRAW_SNAPSHOT_HPP
+
+#include <vector>
+#include <raintk/RainTkGlobal.hpp>
+#include <raintk/RainTkComponents.hpp>
+
+namespace raintk
+{
+    // The state of a cached layer (see DrawSystem::SetLayerCached)
+    struct CachedLayerDesc
+    {
+        // The region of the scene that is drawn into the
+        // layer's texture, in whole pixels
+        BoundingBox bbox{0,0,0,0};
+
+        // Incremented every time the layer has to be redrawn
+        u64 version{0};
+
+        // Set if the layer should be drawn from its texture,
+        // otherwise it's drawn like any other layer
+        bool cached{false};
+    };
+
+    struct CachedLayerStats
+    {
+        u64 hits{0};    // frames a layer was drawn from its texture
+        u64 renders{0}; // times a layer's texture was redrawn
+        u64 bytes{0};   // memory used by all layer textures
+    };
+
+    // DrawSnapshot
+    // * The per-frame draw state that the DrawSystem hands
+    //   over to the MainDrawStage
+    // * The DrawSystem writes a list only when its contents
+    //   change and sets the corresponding flag. During Sync
+    //   the MainDrawStage swaps flagged lists with its own
+    //   and clears the flags, so the DrawSystem and the
+    //   MainDrawStage each own one buffer of every list and
+    //   nothing is copied while rendering is blocked
+    struct DrawSnapshot
+    {
+        bool clip_regions_updated{false};
+        bool draw_order_updated{false};
+
+        // Indices correspond to DrawKey clip id
+        std::vector<BoundingBox> list_clip_regions;
+
+        // RenderData entities sorted in draw order
+        std::vector<Id> list_opq_draw_order;
+        std::vector<Id> list_xpr_draw_order;
+
+        // The bounds of each RenderData entity in the draw
+        // order lists. Only set with damage tracking.
+        std::vector<BoundingBox> list_opq_draw_bboxes;
+        std::vector<BoundingBox> list_xpr_draw_bboxes;
+
+        // Damage is accumulated by every DrawSystem Update
+        // until the next Sync, which takes and clears it
+        bool damage_tracking{false};
+        bool damage_updated{false};
+        bool damage_all{false};
+        std::vector<BoundingBox> list_damage_regions;
+
+        bool cached_layers_updated{false};
+
+        // Indices correspond to DrawKey layer id
+        std::vector<CachedLayerDesc> list_cached_layers;
+
+        // Written by the MainDrawStage during Sync
+        CachedLayerStats cached_layer_stats;
+    };
+}
+
+#endif // RAINTK_DRAW_SNAPSHOT_HPP
@@ -14,6 +14,11 @@
    limitations under the License.
 */
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
 #include <raintk/RainTkDrawSystem.hpp>
 #include <raintk/RainTkScene.hpp>
 #include <raintk/RainTkLog.hpp>
@@ -107,6 +112,8 @@ namespace raintk
 
     namespace
     {
+        uint const k_invalid_render_batch = std::numeric_limits<uint>::max();
+
         bool CalcBoundingBoxOverlap(BoundingBox const &a,
                                     BoundingBox const &b)
         {
@@ -141,26 +148,28 @@ namespace raintk
             };
         }
 
-        std::vector<std::vector<DrawData*>>
+        FrameVector<FrameVector<DrawData*>>
         CreateCommonKeyGroups(
-                std::vector<DrawData> &list_draw_data,
-                std::vector<Id> const &list_draw_data_ids)
+                FrameArena* frame_arena,
+                DrawDataComponentList* cmlist_draw_data,
+                FrameVector<Id> const &list_draw_data_ids)
         {
-            std::vector<std::vector<DrawData*>> list_groups;
+            FrameVector<FrameVector<DrawData*>> list_groups(frame_arena);
 
             auto it_start = list_draw_data_ids.begin();
             auto it_end = list_draw_data_ids.begin();
 
             while(it_end != list_draw_data_ids.end())
             {
-                if(list_draw_data[*it_start].key.GetKey() !=
-                   list_draw_data[*it_end].key.GetKey())
+                if(cmlist_draw_data->GetComponent(*it_start).key.GetKey() !=
+                   cmlist_draw_data->GetComponent(*it_end).key.GetKey())
                 {
-                    list_groups.emplace_back();
+                    list_groups.emplace_back(frame_arena);
+                    list_groups.back().reserve(it_end-it_start);
 
                     for(auto it = it_start; it != it_end; ++it)
                     {
-                        list_groups.back().push_back(&(list_draw_data[*it]));
+                        list_groups.back().push_back(&(cmlist_draw_data->GetComponent(*it)));
                     }
 
                     it_start = it_end;
@@ -169,23 +178,26 @@ namespace raintk
             }
 
             // Save the last group
-            list_groups.emplace_back();
+            list_groups.emplace_back(frame_arena);
+            list_groups.back().reserve(it_end-it_start);
 
             for(auto it = it_start; it != it_end; ++it)
             {
-                list_groups.back().push_back(&(list_draw_data[*it]));
+                list_groups.back().push_back(&(cmlist_draw_data->GetComponent(*it)));
             }
 
 
             return list_groups;
         }
 
-        std::vector<std::vector<DrawData*>>
+        FrameVector<FrameVector<DrawData*>>
         CreateMergedGroupsForDrawData(
-                std::vector<DrawData*> &list_draw_data,
+                FrameArena* frame_arena,
+                FrameVector<DrawData*> &list_draw_data,
                 ks::draw::BufferLayout const * buffer_layout)
         {
-            std::vector<std::vector<DrawData*>> list_grouped_draw_data(1);
+            FrameVector<FrameVector<DrawData*>> list_grouped_draw_data(frame_arena);
+            list_grouped_draw_data.emplace_back(frame_arena);
 
             uint const vx_block_size =
                     buffer_layout->GetVertexBufferAllocator(0)->
@@ -211,7 +223,7 @@ namespace raintk
                     }
 
                     // Create a new single geometry list
-                    list_grouped_draw_data.emplace_back();
+                    list_grouped_draw_data.emplace_back(frame_arena);
                     vx_block_used = single_vx_buff_size;
                 }
 
@@ -227,7 +239,7 @@ namespace raintk
         // check (Widget::GetIsDrawable) before writing to DrawData
         void AssignClipIds(Widget* widget,
                            std::vector<TransformData>& list_xf_data,
-                           std::vector<BoundingBox>& clip_stack,
+                           FrameVector<BoundingBox>& clip_stack,
                            std::vector<BoundingBox>& list_final_clips)
         {
             auto const has_clip = widget->clip.Get();
@@ -269,6 +281,97 @@ namespace raintk
                 clip_stack.pop_back();
             }
         }
+
+        bool BoundingBoxesEqual(BoundingBox const &a,
+                                BoundingBox const &b)
+        {
+            return (a.x0 == b.x0 && a.y0 == b.y0 &&
+                    a.x1 == b.x1 && a.y1 == b.y1);
+        }
+
+        bool BoundingBoxListsEqual(std::vector<BoundingBox> const &a,
+                                   std::vector<BoundingBox> const &b)
+        {
+            if(a.size() != b.size())
+            {
+                return false;
+            }
+
+            for(uint i=0; i < a.size(); i++)
+            {
+                if(!BoundingBoxesEqual(a[i],b[i]))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool BoundingBoxIsEmpty(BoundingBox const &bbox)
+        {
+            return (bbox.x1 <= bbox.x0 || bbox.y1 <= bbox.y0);
+        }
+
+        bool BoundingBoxesOverlap(BoundingBox const &a,
+                                  BoundingBox const &b)
+        {
+            return (a.x0 <= b.x1 && b.x0 <= a.x1 &&
+                    a.y0 <= b.y1 && b.y0 <= a.y1);
+        }
+
+        BoundingBox CalcUnion(BoundingBox const &a,
+                              BoundingBox const &b)
+        {
+            return BoundingBox{
+                std::min(a.x0,b.x0),
+                std::min(a.y0,b.y0),
+                std::max(a.x1,b.x1),
+                std::max(a.y1,b.y1)};
+        }
+
+        BoundingBox CalcIntersection(BoundingBox const &a,
+                                     BoundingBox const &b)
+        {
+            return BoundingBox{
+                std::max(a.x0,b.x0),
+                std::max(a.y0,b.y0),
+                std::min(a.x1,b.x1),
+                std::min(a.y1,b.y1)};
+        }
+
+        float CalcArea(BoundingBox const &bbox)
+        {
+            return (bbox.x1-bbox.x0)*(bbox.y1-bbox.y0);
+        }
+
+        // Damage regions past this are merged
+        uint const k_max_damage_regions = 8;
+
+        // FNV-1a, used to detect changes to the DrawData
+        // that make up a cached layer
+        u64 const k_hash_init = 14695981039346656037ull;
+
+        void HashCombine(u64& hash, u64 value)
+        {
+            hash ^= value;
+            hash *= 1099511628211ull;
+        }
+
+        void HashCombine(u64& hash, float value)
+        {
+            u32 bits;
+            std::memcpy(&bits,&value,sizeof(bits));
+            HashCombine(hash,u64(bits));
+        }
+
+        void HashCombine(u64& hash, BoundingBox const &bbox)
+        {
+            HashCombine(hash,bbox.x0);
+            HashCombine(hash,bbox.y0);
+            HashCombine(hash,bbox.x1);
+            HashCombine(hash,bbox.y1);
+        }
     }
 
     // ============================================================= //
@@ -285,16 +388,20 @@ namespace raintk
         m_show_bboxes(false)
     {
         // Create the DrawData component list
-        m_scene->template RegisterComponentList<DrawData>(
-                    make_unique<DrawDataComponentList>(*m_scene));
+        m_cmlist_draw_data = make_unique<DrawDataComponentList>();
+        m_scene->RegisterDenseComponentList(m_cmlist_draw_data.get());
 
-        m_cmlist_draw_data =
-                static_cast<DrawDataComponentList*>(
-                    m_scene->template GetComponentList<DrawData>());
+        // Drawable widgets, to find the ones that need their
+        // drawables updated
+        m_cmlist_drawable_widgets = make_unique<DenseComponentList<DrawableWidget*>>();
+        m_scene->RegisterDenseComponentList(m_cmlist_drawable_widgets.get());
 
         // Reserve index 0 for gm_layout (indicates invalid)
         m_list_gm_layouts.Add(nullptr);
 
+        // Reserve layer id 0 (indicates no layer)
+        m_list_layer_roots.push_back(nullptr);
+
 
         setupDebugRendering();
     }
@@ -314,34 +421,42 @@ namespace raintk
         return m_list_clip_regions;
     }
 
-    std::vector<Id> DrawSystem::GetOpaqueDrawOrderList() const
+    std::vector<Id> const & DrawSystem::GetOpaqueDrawOrderList() const
     {
         return m_list_opq_render_ent_ids;
     }
 
-    std::vector<Id> DrawSystem::GetTransparentDrawOrderList() const
+    std::vector<Id> const & DrawSystem::GetTransparentDrawOrderList() const
     {
         return m_list_xpr_render_ent_ids;
     }
 
+    DrawSnapshot& DrawSystem::GetSnapshot()
+    {
+        return m_snapshot;
+    }
+
     DrawDataComponentList* DrawSystem::GetDrawDataComponentList() const
     {
-        return m_cmlist_draw_data;
+        return m_cmlist_draw_data.get();
     }
 
     void DrawSystem::SetClippingEnabled(bool enabled)
     {
         m_clipping_enabled = enabled;
+        m_scene->RequestUpdate();
     }
 
     void DrawSystem::SetShowBoundingBoxes(bool show_bboxes)
     {
         m_show_bboxes = show_bboxes;
+        m_scene->RequestUpdate();
     }
 
     void DrawSystem::SetShowClipOutlines(bool show_clip_outlines)
     {
         m_show_clip_outlines = show_clip_outlines;
+        m_scene->RequestUpdate();
     }
 
     Id DrawSystem::RegisterGeometryLayout(
@@ -460,22 +575,394 @@ namespace raintk
         m_render_system->RemoveUniformSet(uniform_set_id);
     }
 
-    void DrawSystem::Update(TimePoint const &/*prev_time*/,
-                            TimePoint const &/*curr_time*/)
+    Id DrawSystem::CreateLayer(Widget* widget)
     {
-        // Remove old RenderData for DrawData entities
-        for(auto ent_id : m_list_opq_render_ent_ids)
+        if(widget->m_layer_root_id != 0)
         {
-            m_scene->RemoveEntity(ent_id);
+            return widget->m_layer_root_id;
         }
 
-        for(auto ent_id : m_list_xpr_render_ent_ids)
+        // Find an unused layer id
+        Id layer_id = 1;
+        while(layer_id < m_list_layer_roots.size() &&
+              m_list_layer_roots[layer_id] != nullptr)
         {
-            m_scene->RemoveEntity(ent_id);
+            layer_id++;
+        }
+
+        Id const max_layer_id = (Id(1) << DrawKey::k_bits_layer)-1;
+        if(layer_id > max_layer_id)
+        {
+            throw ks::Exception(
+                        ks::Exception::ErrorLevel::ERROR,
+                        "DrawSystem: Exceeded max compositor "
+                        "layer count: "+ks::ToString(max_layer_id));
+        }
+
+        if(layer_id == m_list_layer_roots.size())
+        {
+            m_list_layer_roots.push_back(nullptr);
+        }
+
+        m_list_layer_roots[layer_id] = widget;
+        widget->m_layer_root_id = layer_id;
+        m_layer_count++;
+        m_layers_dirty = true;
+        m_scene->RequestUpdate();
+
+        return layer_id;
+    }
+
+    void DrawSystem::RemoveLayer(Id layer_id)
+    {
+        auto widget = getLayerRoot(layer_id);
+        widget->m_layer_root_id = 0;
+
+        if(layer_id < m_list_cached_layers.size() &&
+           m_list_cached_layers[layer_id].cached)
+        {
+            // Keep the version so that the MainDrawStage sees a
+            // change if the layer id is cached again
+            auto const version = m_list_cached_layers[layer_id].version;
+            m_list_cached_layers[layer_id] = CachedLayer();
+            m_list_cached_layers[layer_id].version = version;
+            m_cached_layer_count--;
+
+            writeCachedLayers();
+        }
+
+        m_list_layer_roots[layer_id] = nullptr;
+        m_layer_count--;
+        m_layers_dirty = true;
+        m_scene->RequestUpdate();
+
+        m_list_layer_updates.push_back(
+                    CompositorLayerUpdate{
+                        layer_id,
+                        CompositorLayerUpdate::Type::Stop,
+                        CompositorAnimation{}});
+    }
+
+    void DrawSystem::StartLayerAnimation(Id layer_id,
+                                         CompositorAnimation animation)
+    {
+        auto widget = getLayerRoot(layer_id);
+
+        // Scale and rotate about the center of the root widget
+        auto const &bbox =
+                m_cmlist_xf_data->GetComponent(
+                    widget->GetEntityId()).bbox;
+
+        animation.origin =
+                glm::vec2{
+                    0.5f*(bbox.x0+bbox.x1),
+                    0.5f*(bbox.y0+bbox.y1)
+                };
+
+        m_list_layer_updates.push_back(
+                    CompositorLayerUpdate{
+                        layer_id,
+                        CompositorLayerUpdate::Type::Start,
+                        animation});
+
+        m_scene->RequestUpdate();
+    }
+
+    void DrawSystem::StopLayerAnimation(Id layer_id)
+    {
+        getLayerRoot(layer_id);
+
+        m_list_layer_updates.push_back(
+                    CompositorLayerUpdate{
+                        layer_id,
+                        CompositorLayerUpdate::Type::Stop,
+                        CompositorAnimation{}});
+
+        m_scene->RequestUpdate();
+    }
+
+    void DrawSystem::AddDrawableWidget(DrawableWidget* widget)
+    {
+        m_cmlist_drawable_widgets->Create(widget->GetEntityId(),widget);
+    }
+
+    void DrawSystem::OnWidgetParentChanged()
+    {
+        // Every widget has layer id 0 while there are no layers
+        if(m_layer_count > 0)
+        {
+            m_layers_dirty = true;
+        }
+    }
+
+    std::vector<CompositorLayerUpdate> DrawSystem::TakeLayerUpdates()
+    {
+        std::vector<CompositorLayerUpdate> list_layer_updates;
+        list_layer_updates.swap(m_list_layer_updates);
+
+        return list_layer_updates;
+    }
+
+    void DrawSystem::SetLayerCached(Widget* widget, bool cached)
+    {
+        if(cached)
+        {
+            bool const owns_layer = (widget->m_layer_root_id == 0);
+            Id const layer_id = CreateLayer(widget);
+
+            if(layer_id >= m_list_cached_layers.size())
+            {
+                m_list_cached_layers.resize(layer_id+1);
+            }
+
+            auto& cached_layer = m_list_cached_layers[layer_id];
+            if(cached_layer.cached)
+            {
+                return;
+            }
+
+            cached_layer.cached = true;
+            cached_layer.owns_layer = owns_layer;
+            cached_layer.dirty = true;
+            m_cached_layer_count++;
+            m_scene->RequestUpdate();
+
+            // The snapshot is written by the next Update
+            // once the layer's bounds are known
+        }
+        else
+        {
+            Id const layer_id = widget->m_layer_root_id;
+            if(layer_id == 0 ||
+               layer_id >= m_list_cached_layers.size() ||
+               !m_list_cached_layers[layer_id].cached)
+            {
+                return;
+            }
+
+            if(m_list_cached_layers[layer_id].owns_layer)
+            {
+                // Also clears the cached state
+                RemoveLayer(layer_id);
+            }
+            else
+            {
+                auto& cached_layer = m_list_cached_layers[layer_id];
+                cached_layer.cached = false;
+                cached_layer.in_budget = false;
+                m_cached_layer_count--;
+
+                writeCachedLayers();
+                m_scene->RequestUpdate();
+            }
+        }
+    }
+
+    void DrawSystem::SetLayerCacheBudget(uint max_bytes)
+    {
+        m_layer_cache_budget = max_bytes;
+
+        // Force the budget to be applied again
+        for(auto& cached_layer : m_list_cached_layers)
+        {
+            cached_layer.dirty = cached_layer.cached;
+        }
+
+        m_scene->RequestUpdate();
+    }
+
+    void DrawSystem::InvalidateCachedLayers()
+    {
+        if(m_cached_layer_count == 0)
+        {
+            return;
+        }
+
+        for(auto& cached_layer : m_list_cached_layers)
+        {
+            if(cached_layer.cached)
+            {
+                cached_layer.version++;
+            }
+        }
+
+        writeCachedLayers();
+        m_scene->RequestUpdate();
+    }
+
+    void DrawSystem::OnTextureSetUpdated(Id texture_set_id)
+    {
+        bool layers_updated = false;
+
+        for(auto& cached_layer : m_list_cached_layers)
+        {
+            if(!cached_layer.cached)
+            {
+                continue;
+            }
+
+            auto const &list_ids = cached_layer.list_texture_set_ids;
+            if(std::find(list_ids.begin(),list_ids.end(),texture_set_id) !=
+               list_ids.end())
+            {
+                cached_layer.version++;
+                layers_updated = true;
+            }
+        }
+
+        if(layers_updated)
+        {
+            writeCachedLayers();
+        }
+
+        // The drawn states are only kept with damage tracking
+        for(auto const &state : m_list_drawn_states)
+        {
+            if(state.drawn && state.texture_set == texture_set_id)
+            {
+                AddDamage(state.bbox);
+            }
+        }
+    }
+
+    CachedLayerStats const &DrawSystem::GetCachedLayerStats() const
+    {
+        return m_snapshot.cached_layer_stats;
+    }
+
+    void DrawSystem::SetDamageTrackingEnabled(bool enabled)
+    {
+        if(m_damage_tracking == enabled)
+        {
+            return;
+        }
+
+        m_damage_tracking = enabled;
+        m_snapshot.damage_tracking = enabled;
+        m_list_drawn_states.clear();
+
+        DamageAll();
+        m_scene->RequestUpdate();
+    }
+
+    void DrawSystem::AddDamage(BoundingBox const &bbox)
+    {
+        if(!m_damage_tracking ||
+           m_snapshot.damage_all ||
+           BoundingBoxIsEmpty(bbox))
+        {
+            return;
+        }
+
+        auto& list_regions = m_snapshot.list_damage_regions;
+        m_snapshot.damage_updated = true;
+
+        // Merge with any regions that @bbox overlaps. The
+        // merged region may overlap others, so repeat
+        BoundingBox region = bbox;
+        bool merged = true;
+        while(merged)
+        {
+            merged = false;
+
+            for(uint i=0; i < list_regions.size(); i++)
+            {
+                if(BoundingBoxesOverlap(list_regions[i],region))
+                {
+                    region = CalcUnion(list_regions[i],region);
+                    list_regions[i] = list_regions.back();
+                    list_regions.pop_back();
+                    merged = true;
+                    break;
+                }
+            }
+        }
+
+        // Merge with the region that grows the least if there
+        // are too many. Overlapping regions are fine, they're
+        // just redrawn more than once.
+        if(list_regions.size() == k_max_damage_regions)
+        {
+            uint min_index = 0;
+            float min_growth = std::numeric_limits<float>::max();
+
+            for(uint i=0; i < list_regions.size(); i++)
+            {
+                float const growth =
+                        CalcArea(CalcUnion(list_regions[i],region))-
+                        CalcArea(list_regions[i]);
+
+                if(growth < min_growth)
+                {
+                    min_growth = growth;
+                    min_index = i;
+                }
+            }
+
+            region = CalcUnion(list_regions[min_index],region);
+            list_regions[min_index] = list_regions.back();
+            list_regions.pop_back();
+        }
+
+        list_regions.push_back(region);
+    }
+
+    void DrawSystem::InvalidateRenderData()
+    {
+        m_render_data_invalid = true;
+    }
+
+    uint DrawSystem::GetRebuiltRenderDataCount() const
+    {
+        return m_rebuilt_render_data_count;
+    }
+
+    void DrawSystem::DamageAll()
+    {
+        if(!m_damage_tracking)
+        {
+            return;
+        }
+
+        m_snapshot.damage_all = true;
+        m_snapshot.damage_updated = true;
+        m_snapshot.list_damage_regions.clear();
+    }
+
+    void DrawSystem::Update(TimePoint const &/*prev_time*/,
+                            TimePoint const &/*curr_time*/)
+    {
+        // The previous lists are kept to check if the draw
+        // order changed this frame
+        m_list_prev_opq_render_ent_ids.swap(m_list_opq_render_ent_ids);
+        m_list_prev_xpr_render_ent_ids.swap(m_list_xpr_render_ent_ids);
+        m_list_prev_opq_render_bboxes.swap(m_list_opq_render_bboxes);
+        m_list_prev_xpr_render_bboxes.swap(m_list_xpr_render_bboxes);
+
+        // The previous frame's RenderData is looked up by the
+        // first DrawData entity of each batch
+        m_list_prev_render_batches.swap(m_list_render_batches);
+        m_render_batch_count = 0;
+        m_rebuilt_render_data_count = 0;
+
+        for(uint i=0; i < m_list_prev_render_batches.size(); i++)
+        {
+            Id const first_ent_id =
+                    m_list_prev_render_batches[i].list_items[0].draw_data_id;
+
+            if(first_ent_id >= m_lkup_prev_render_batches.size())
+            {
+                m_lkup_prev_render_batches.resize(
+                            first_ent_id+1,k_invalid_render_batch);
+            }
+
+            m_lkup_prev_render_batches[first_ent_id] = i;
         }
 
         m_list_opq_render_ent_ids.clear();
         m_list_xpr_render_ent_ids.clear();
+        m_list_opq_render_bboxes.clear();
+        m_list_xpr_render_bboxes.clear();
 
 
         // Remove old RenderData for bounding box debug
@@ -497,6 +984,9 @@ namespace raintk
             {
                 createClipOutlineDrawData();
             }
+
+            // Debug outlines aren't tracked
+            DamageAll();
         }
 
 
@@ -508,7 +998,7 @@ namespace raintk
             auto& list_xf_data =
                     m_cmlist_xf_data->GetSparseList();
 
-            std::vector<BoundingBox> clip_stack;
+            FrameVector<BoundingBox> clip_stack(m_scene->GetFrameArena());
             clip_stack.push_back(
                         m_cmlist_xf_data->GetComponent(
                             root_widget->GetEntityId()).bbox);
@@ -522,6 +1012,26 @@ namespace raintk
                           m_list_clip_regions);
         }
 
+        // The clip regions may also have been set directly
+        // when clipping is disabled
+        if(!BoundingBoxListsEqual(m_list_clip_regions,
+                                  m_list_prev_clip_regions))
+        {
+            m_list_prev_clip_regions = m_list_clip_regions;
+            m_snapshot.list_clip_regions = m_list_clip_regions;
+            m_snapshot.clip_regions_updated = true;
+        }
+
+
+        // Assign compositor layer ids. This is only needed when
+        // a layer was created or removed or a widget was moved
+        // to another parent since the last Update
+        if(m_layers_dirty)
+        {
+            assignLayerIds(m_scene->GetRootWidget().get(),0);
+            m_layers_dirty = false;
+        }
+
 
         // Get the current list of entities with DrawData and store
         // them in lists separated by transparency / opaque
@@ -531,33 +1041,60 @@ namespace raintk
                 m_scene->template GetComponentMask<
                     UpdateData>();
 
-        auto const drawable_mask =
+        auto const xf_mask =
                 m_scene->template GetComponentMask<
-                    TransformData,DrawData>();
+                    TransformData>();
 
         auto& list_upd_data =
                 m_cmlist_upd_data->GetSparseList();
 
-        auto& list_draw_data =
-                m_cmlist_draw_data->GetSparseList();
+        auto const &list_draw_data =
+                m_cmlist_draw_data->GetDenseList();
+
+        auto const &list_draw_data_ent_ids =
+                m_cmlist_draw_data->GetDenseIds();
+
 
+        // Temporary lists are allocated from the frame arena,
+        // which is reset every frame
+        auto frame_arena = m_scene->GetFrameArena();
 
-        std::vector<Id> list_opq_draw_data_ids;
-        std::vector<Id> list_xpr_draw_data_ids;
+        FrameVector<Id> list_opq_draw_data_ids(frame_arena);
+        FrameVector<Id> list_xpr_draw_data_ids(frame_arena);
+
+        // DrawData entities that were updated this frame
+        FrameVector<bool> list_updated(
+                    list_entities.size(),false,frame_arena);
+
+        // Debug outlines are created again every frame
+        for(auto ent_id : m_list_debug_ent_ids)
+        {
+            list_updated[ent_id] = true;
+        }
 
         // Update the DrawableWidget if required. This should
         // happen in its own pass through all the entities because
         // DrawableWidget::updateDrawables may create or destroy
         // entities and components. This needs to happen before
-        // the drawable_mask entities are collected.
+        // the drawable entities are collected.
 
         // TODO Should creating or destroying entities in
         // DrawableWidget::updateDrawables even be allowed?
         // It can lead to delayed updates for example if a
         // TransformData is created from updateDrawables
 
-        for(uint ent_id=0; ent_id < list_entities.size(); ent_id++)
+        // Only drawable widgets are visited. They can't be created
+        // or destroyed by updateDrawables, so the list is stable.
+        auto const &list_drawable_widgets =
+                m_cmlist_drawable_widgets->GetDenseList();
+
+        auto const &list_drawable_ent_ids =
+                m_cmlist_drawable_widgets->GetDenseIds();
+
+        for(uint i=0; i < list_drawable_widgets.size(); i++)
         {
+            Id const ent_id = list_drawable_ent_ids[i];
+
             // Update the DrawableWidget if required
             if((list_entities[ent_id].mask & updatable_mask) == updatable_mask)
             {
@@ -566,26 +1103,61 @@ namespace raintk
                 if(upd_data.update & UpdateData::UpdateDrawables)
                 {
                     DrawableWidget* drawable_widget =
-                            static_cast<DrawableWidget*>(upd_data.widget);
+                            list_drawable_widgets[i];
 
                     drawable_widget->updateDrawables();
                     upd_data.update &= ~(UpdateData::UpdateDrawables);
+
+                    // The widget's DrawData may be on other
+                    // entities, which may have just been created
+                    m_list_widget_draw_data_ids.clear();
+                    drawable_widget->getDrawDataIds(
+                                m_list_widget_draw_data_ids);
+
+                    for(auto draw_data_ent_id : m_list_widget_draw_data_ids)
+                    {
+                        if(draw_data_ent_id >= list_updated.size())
+                        {
+                            list_updated.resize(draw_data_ent_id+1,false);
+                        }
+
+                        list_updated[draw_data_ent_id] = true;
+                    }
+
+                    // Any change to a drawable in a cached layer
+                    // means the layer has to be redrawn
+                    Id const layer_id = drawable_widget->GetLayerId();
+                    if(layer_id != 0 &&
+                       layer_id < m_list_cached_layers.size())
+                    {
+                        m_list_cached_layers[layer_id].dirty = true;
+                    }
                 }
             }
         }
 
-        // Save drawable entities into opaque / transparent id lists
+        // Save drawable entities into opaque / transparent id lists.
+        // Only entities with DrawData are visited.
         // NOTE: See above comments for why we have two separate
-        // loops through all entities
-        for(uint ent_id=0; ent_id < list_entities.size(); ent_id++)
+        // loops through entities
+        list_opq_draw_data_ids.reserve(list_draw_data.size());
+        list_xpr_draw_data_ids.reserve(list_draw_data.size());
+
+        for(uint i=0; i < list_draw_data.size(); i++)
         {
-            if((list_entities[ent_id].mask & drawable_mask) == drawable_mask)
+            Id const ent_id = list_draw_data_ent_ids[i];
+
+            if((list_entities[ent_id].mask & xf_mask) == xf_mask)
             {
-                auto& draw_data = list_draw_data[ent_id];
+                auto const &draw_data = list_draw_data[i];
 
                 if(draw_data.visible)
                 {
-                    if(draw_data.key.GetTransparency())
+                    // The opacity of a compositor layer can change
+                    // without an update, so layers are always
+                    // drawn with the transparent DrawData
+                    if(draw_data.key.GetTransparency() ||
+                       draw_data.key.GetLayer() != 0)
                     {
                         list_xpr_draw_data_ids.push_back(ent_id);
                     }
@@ -597,61 +1169,377 @@ namespace raintk
             }
         }
 
+        if(m_cached_layer_count > 0)
+        {
+            updateCachedLayers(list_xpr_draw_data_ids);
+        }
+
+        if(m_damage_tracking)
+        {
+            updateDamage(list_updated,
+                         list_opq_draw_data_ids,
+                         list_xpr_draw_data_ids);
+        }
+
         // Sort DrawData lists so that they can be grouped
         sortIntoOpaqueGroups(list_opq_draw_data_ids);
         sortIntoTransparencyGroups(list_xpr_draw_data_ids);
 
         // Create grouped lists from the sorted DrawData and
-        // create RenderData entities for the grouped DrawData
+        // update the RenderData entities for the grouped DrawData
         if(!list_opq_draw_data_ids.empty())
         {
             auto list_grouped_opq_draw_data =
                     CreateCommonKeyGroups(
-                        list_draw_data,
+                        frame_arena,
+                        m_cmlist_draw_data.get(),
                         list_opq_draw_data_ids);
 
-            createRenderDataForCommonKeyGroups(
+            updateRenderDataForCommonKeyGroups(
                         ks::draw::Transparency::Opaque,
                         list_grouped_opq_draw_data,
-                        m_list_opq_render_ent_ids);
+                        list_updated,
+                        m_list_opq_render_ent_ids,
+                        m_damage_tracking ? &m_list_opq_render_bboxes : nullptr);
         }
 
         if(!list_xpr_draw_data_ids.empty())
         {
             auto list_grouped_xpr_draw_data =
                     CreateCommonKeyGroups(
-                        list_draw_data,
+                        frame_arena,
+                        m_cmlist_draw_data.get(),
                         list_xpr_draw_data_ids);
 
-            createRenderDataForCommonKeyGroups(
+            updateRenderDataForCommonKeyGroups(
                         ks::draw::Transparency::Transparent,
                         list_grouped_xpr_draw_data,
-                        m_list_xpr_render_ent_ids);
+                        list_updated,
+                        m_list_xpr_render_ent_ids,
+                        m_damage_tracking ? &m_list_xpr_render_bboxes : nullptr);
+        }
+
+        // Remove the RenderData that no batch was matched to
+        for(auto& prev_batch : m_list_prev_render_batches)
+        {
+            m_lkup_prev_render_batches[
+                    prev_batch.list_items[0].draw_data_id] =
+                        k_invalid_render_batch;
+
+            if(!prev_batch.reused)
+            {
+                m_scene->RemoveEntity(prev_batch.ent_id);
+            }
+        }
+
+        m_list_render_batches.resize(m_render_batch_count);
+        m_render_data_invalid = false;
+
+        // RenderData entities are kept, so the draw order is
+        // usually the same as the previous frame's and doesn't
+        // have to be passed to the MainDrawStage again
+        if(m_list_opq_render_ent_ids != m_list_prev_opq_render_ent_ids ||
+           m_list_xpr_render_ent_ids != m_list_prev_xpr_render_ent_ids ||
+           !BoundingBoxListsEqual(m_list_opq_render_bboxes,
+                                  m_list_prev_opq_render_bboxes) ||
+           !BoundingBoxListsEqual(m_list_xpr_render_bboxes,
+                                  m_list_prev_xpr_render_bboxes))
+        {
+            m_snapshot.list_opq_draw_order = m_list_opq_render_ent_ids;
+            m_snapshot.list_xpr_draw_order = m_list_xpr_render_ent_ids;
+            m_snapshot.list_opq_draw_bboxes = m_list_opq_render_bboxes;
+            m_snapshot.list_xpr_draw_bboxes = m_list_xpr_render_bboxes;
+            m_snapshot.draw_order_updated = true;
+        }
+    }
+
+    void DrawSystem::assignLayerIds(Widget* widget, Id parent_layer_id)
+    {
+        Id const layer_id =
+                (widget->m_layer_root_id != 0) ?
+                    widget->m_layer_root_id : parent_layer_id;
+
+        widget->SetLayerId(layer_id);
+
+        for(auto& child : widget->GetChildren())
+        {
+            assignLayerIds(child.get(),layer_id);
+        }
+    }
+
+    void DrawSystem::updateCachedLayers(FrameVector<Id> const &list_xpr_draw_data_ids)
+    {
+        // Compositor layers are always in the transparent
+        // list, so only it has to be checked. The signature
+        // of a layer changes if any of its DrawData is
+        // added, removed, hidden or moved to another clip.
+        uint const layer_count = m_list_cached_layers.size();
+
+        auto frame_arena = m_scene->GetFrameArena();
+
+        FrameVector<u64> list_signatures(layer_count,k_hash_init,frame_arena);
+
+        FrameVector<BoundingBox> list_bboxes(
+                    layer_count,
+                    BoundingBox{
+                        std::numeric_limits<float>::max(),
+                        std::numeric_limits<float>::max(),
+                        std::numeric_limits<float>::lowest(),
+                        std::numeric_limits<float>::lowest()},
+                    frame_arena);
+
+        auto& list_xf_data = m_cmlist_xf_data->GetSparseList();
+
+        for(auto& cached_layer : m_list_cached_layers)
+        {
+            cached_layer.list_texture_set_ids.clear();
+        }
+
+        for(auto const ent_id : list_xpr_draw_data_ids)
+        {
+            auto const &key = m_cmlist_draw_data->GetComponent(ent_id).key;
+            Id const layer_id = key.GetLayer();
+
+            if(layer_id == 0 ||
+               layer_id >= layer_count ||
+               !m_list_cached_layers[layer_id].cached)
+            {
+                continue;
+            }
+
+            // A layer only uses a few texture sets
+            auto& list_texture_set_ids =
+                    m_list_cached_layers[layer_id].list_texture_set_ids;
+
+            if(std::find(list_texture_set_ids.begin(),
+                         list_texture_set_ids.end(),
+                         key.GetTextureSet()) == list_texture_set_ids.end())
+            {
+                list_texture_set_ids.push_back(key.GetTextureSet());
+            }
+
+            auto& signature = list_signatures[layer_id];
+            HashCombine(signature,u64(ent_id));
+            HashCombine(signature,u64(key.GetShader()));
+            HashCombine(signature,u64(key.GetTextureSet()));
+            HashCombine(signature,u64(key.GetUniformSet()));
+
+            // Clip regions are in world space, so they're part
+            // of the signature rather than the clip id
+            if(key.GetClip() < m_list_clip_regions.size())
+            {
+                HashCombine(signature,m_list_clip_regions[key.GetClip()]);
+            }
+
+            auto const &ent_bbox = list_xf_data[ent_id].bbox;
+            auto& bbox = list_bboxes[layer_id];
+            bbox.x0 = std::min(bbox.x0,ent_bbox.x0);
+            bbox.y0 = std::min(bbox.y0,ent_bbox.y0);
+            bbox.x1 = std::max(bbox.x1,ent_bbox.x1);
+            bbox.y1 = std::max(bbox.y1,ent_bbox.y1);
+        }
+
+        // Layer textures never need to be larger than the scene
+        auto const &scene_bbox =
+                m_cmlist_xf_data->GetComponent(
+                    m_scene->GetRootWidget()->GetEntityId()).bbox;
+
+        bool updated = false;
+        uint budget_bytes = 0;
+
+        for(uint layer_id=1; layer_id < layer_count; layer_id++)
+        {
+            auto& cached_layer = m_list_cached_layers[layer_id];
+            if(!cached_layer.cached)
+            {
+                continue;
+            }
+
+            // Snap to whole pixels so that the texture is
+            // drawn one texel per pixel
+            auto bbox = list_bboxes[layer_id];
+            bbox.x0 = std::floor(std::max(bbox.x0,scene_bbox.x0));
+            bbox.y0 = std::floor(std::max(bbox.y0,scene_bbox.y0));
+            bbox.x1 = std::ceil(std::min(bbox.x1,scene_bbox.x1));
+            bbox.y1 = std::ceil(std::min(bbox.y1,scene_bbox.y1));
+
+            if(bbox.x1 <= bbox.x0 || bbox.y1 <= bbox.y0)
+            {
+                bbox = BoundingBox{0,0,0,0};
+            }
+
+            if(cached_layer.dirty ||
+               cached_layer.signature != list_signatures[layer_id] ||
+               !BoundingBoxesEqual(cached_layer.bbox,bbox))
+            {
+                cached_layer.dirty = false;
+                cached_layer.signature = list_signatures[layer_id];
+                cached_layer.bbox = bbox;
+                cached_layer.version++;
+                updated = true;
+            }
+
+            // Layers are added to the budget in order of their
+            // layer ids; the ones that don't fit are drawn
+            // without a texture
+            uint const bytes =
+                    uint(bbox.x1-bbox.x0)*uint(bbox.y1-bbox.y0)*4;
+
+            bool const in_budget =
+                    (bytes > 0) &&
+                    (budget_bytes+bytes <= m_layer_cache_budget);
+
+            if(in_budget)
+            {
+                budget_bytes += bytes;
+            }
+
+            if(cached_layer.in_budget != in_budget)
+            {
+                cached_layer.in_budget = in_budget;
+                updated = true;
+            }
+        }
+
+        if(updated)
+        {
+            writeCachedLayers();
+        }
+    }
+
+    void DrawSystem::writeCachedLayers()
+    {
+        auto& list_descs = m_snapshot.list_cached_layers;
+        list_descs.clear();
+        list_descs.resize(m_list_cached_layers.size());
+
+        for(uint layer_id=0; layer_id < m_list_cached_layers.size(); layer_id++)
+        {
+            auto const &cached_layer = m_list_cached_layers[layer_id];
+            auto& desc = list_descs[layer_id];
+
+            desc.bbox = cached_layer.bbox;
+            desc.version = cached_layer.version;
+            desc.cached = cached_layer.cached && cached_layer.in_budget;
+        }
+
+        m_snapshot.cached_layers_updated = true;
+    }
+
+    void DrawSystem::updateDamage(FrameVector<bool> const &list_updated,
+                                  FrameVector<Id> const &list_opq_draw_data_ids,
+                                  FrameVector<Id> const &list_xpr_draw_data_ids)
+    {
+        auto& list_xf_data = m_cmlist_xf_data->GetSparseList();
+
+        uint const ent_count = m_scene->GetEntityList().size();
+        if(m_list_drawn_states.size() < ent_count)
+        {
+            m_list_drawn_states.resize(ent_count);
+        }
+
+        FrameVector<bool> list_drawn(
+                    m_list_drawn_states.size(),
+                    false,
+                    m_scene->GetFrameArena());
+
+        auto check_draw_data =
+                [&](Id ent_id)
+                {
+                    auto const &key = m_cmlist_draw_data->GetComponent(ent_id).key;
+
+                    BoundingBox bbox = list_xf_data[ent_id].bbox;
+                    if(key.GetClip() < m_list_clip_regions.size())
+                    {
+                        bbox = CalcIntersection(
+                                    bbox,m_list_clip_regions[key.GetClip()]);
+                    }
+
+                    auto& state = m_list_drawn_states[ent_id];
+
+                    bool const updated =
+                            (ent_id < list_updated.size()) &&
+                            list_updated[ent_id];
+
+                    if(!state.drawn || updated ||
+                       state.key != key.GetKey() ||
+                       !BoundingBoxesEqual(state.bbox,bbox))
+                    {
+                        if(state.drawn)
+                        {
+                            AddDamage(state.bbox);
+                        }
+                        AddDamage(bbox);
+                    }
+
+                    state.bbox = bbox;
+                    state.key = key.GetKey();
+                    state.texture_set = key.GetTextureSet();
+                    state.drawn = true;
+                    list_drawn[ent_id] = true;
+                };
+
+        for(auto const ent_id : list_opq_draw_data_ids)
+        {
+            check_draw_data(ent_id);
+        }
+
+        for(auto const ent_id : list_xpr_draw_data_ids)
+        {
+            check_draw_data(ent_id);
+        }
+
+        // DrawData that was removed or hidden
+        for(uint ent_id=0; ent_id < m_list_drawn_states.size(); ent_id++)
+        {
+            auto& state = m_list_drawn_states[ent_id];
+            if(state.drawn && !list_drawn[ent_id])
+            {
+                AddDamage(state.bbox);
+                state.drawn = false;
+            }
         }
     }
 
+    Widget* DrawSystem::getLayerRoot(Id layer_id) const
+    {
+        if(layer_id == 0 ||
+           layer_id >= m_list_layer_roots.size() ||
+           m_list_layer_roots[layer_id] == nullptr)
+        {
+            throw ks::Exception(
+                        ks::Exception::ErrorLevel::ERROR,
+                        "DrawSystem: Invalid compositor layer id: "+
+                        ks::ToString(layer_id));
+        }
+
+        return m_list_layer_roots[layer_id];
+    }
+
     void DrawSystem::sortIntoOpaqueGroups(
-            std::vector<Id> &list_opq_draw_data_ids)
+            FrameVector<Id> &list_opq_draw_data_ids)
     {
         auto& list_xf_data =
                 m_cmlist_xf_data->GetSparseList();
 
-        auto& list_draw_data =
-                m_cmlist_draw_data->GetSparseList();
+        auto cmlist_draw_data = m_cmlist_draw_data.get();
 
         // Sort primarily by key to minimize state changes,
         // and then by depth within the same key such that
         // objects in front are drawn first
         auto sort_opq =
-                [&list_draw_data,&list_xf_data](Id a, Id b)
+                [cmlist_draw_data,&list_xf_data](Id a, Id b)
                 {
-                    if(!(list_draw_data[a].key == list_draw_data[b].key))
+                    auto const &key_a = cmlist_draw_data->GetComponent(a).key;
+                    auto const &key_b = cmlist_draw_data->GetComponent(b).key;
+
+                    if(!(key_a == key_b))
                     {
                         auto const depth_a = list_xf_data[a].world_xf[3].z;
                         auto const depth_b = list_xf_data[b].world_xf[3].z;
                         return (depth_a > depth_b);
                     }
-                    return (list_draw_data[a].key < list_draw_data[b].key);
+                    return (key_a < key_b);
                 };
 
         std::sort(list_opq_draw_data_ids.begin(),
@@ -660,16 +1548,20 @@ namespace raintk
     }
 
     void DrawSystem::sortIntoTransparencyGroups(
-            std::vector<Id> &list_xpr_draw_data_ids)
+            FrameVector<Id> &list_xpr_draw_data_ids)
     {
         auto& list_xf_data =
                 m_cmlist_xf_data->GetSparseList();
 
-        auto& list_draw_data =
-                m_cmlist_draw_data->GetSparseList();
+        auto cmlist_draw_data = m_cmlist_draw_data.get();
 
+        // The ids are collected from the DrawData list, which isn't
+        // in entity id order, so entity ids are used to break ties
+        // to keep the draw order the same from frame to frame. This
+        // makes the order total, so std::sort gives the same result
+        // as std::stable_sort without its temporary buffer
         auto sort_xpr =
-                [&list_draw_data,&list_xf_data](Id a, Id b)
+                [cmlist_draw_data,&list_xf_data](Id a, Id b)
         {
             auto const depth_a = list_xf_data[a].world_xf[3].z;
             auto const depth_b = list_xf_data[b].world_xf[3].z;
@@ -679,18 +1571,28 @@ namespace raintk
                 return (depth_a < depth_b);
             }
 
-            return (list_draw_data[a].key < list_draw_data[b].key);
+            auto const &key_a = cmlist_draw_data->GetComponent(a).key;
+            auto const &key_b = cmlist_draw_data->GetComponent(b).key;
+
+            if(!(key_a == key_b))
+            {
+                return (key_a < key_b);
+            }
+
+            return (a < b);
         };
 
-        std::stable_sort(list_xpr_draw_data_ids.begin(),
-                         list_xpr_draw_data_ids.end(),
-                         sort_xpr);
+        std::sort(list_xpr_draw_data_ids.begin(),
+                  list_xpr_draw_data_ids.end(),
+                  sort_xpr);
     }
 
-    void DrawSystem::createRenderDataForCommonKeyGroups(
+    void DrawSystem::updateRenderDataForCommonKeyGroups(
             ks::draw::Transparency transparency,
-            std::vector<std::vector<DrawData*>> &list_common_key_groups,
-            std::vector<Id>& list_render_ent_ids)
+            FrameVector<FrameVector<DrawData*>> &list_common_key_groups,
+            FrameVector<bool> const &list_updated,
+            std::vector<Id>& list_render_ent_ids,
+            std::vector<BoundingBox>* list_render_bboxes)
     {
         for(auto& common_key_group : list_common_key_groups)
         {
@@ -704,86 +1606,208 @@ namespace raintk
             // on the size of the geometry buffer block size
             auto list_merged_gm_draw_data =
                     CreateMergedGroupsForDrawData(
+                        m_scene->GetFrameArena(),
                         common_key_group,
                         buffer_layout);
 
             for(auto& merged_gm_draw_data : list_merged_gm_draw_data)
             {
-                createRenderDataForDrawData(
+                updateRenderDataForDrawData(
                             key,
                             buffer_layout,
                             merged_gm_draw_data,
                             transparency,
-                            list_render_ent_ids);
+                            list_updated,
+                            list_render_ent_ids,
+                            list_render_bboxes);
             }
         }
     }
 
-    void DrawSystem::createRenderDataForDrawData(
+    void DrawSystem::updateRenderDataForDrawData(
             DrawKey const &key,
             ks::draw::BufferLayout const * buffer_layout,
-            std::vector<DrawData*> const &list_draw_data,
+            FrameVector<DrawData*> const &list_draw_data,
             ks::draw::Transparency transparency,
-            std::vector<Id>& list_render_ent_ids)
+            FrameVector<bool> const &list_updated,
+            std::vector<Id>& list_render_ent_ids,
+            std::vector<BoundingBox>* list_render_bboxes)
     {
-        // Create an entity and its merged RenderData
-        auto cmlist_render_data =
-                m_render_system->
-                GetRenderDataComponentList();
+        uint vx_size = 0;
+        for(auto draw_data : list_draw_data)
+        {
+            vx_size += draw_data->vx_buffer->size();
+        }
+
+        if(vx_size == 0)
+        {
+            return;
+        }
 
-        auto render_ent_id = m_scene->CreateEntity();
+        // Find the RenderData this batch had last frame
+        RenderBatch* prev_batch = nullptr;
 
-        auto& render_data =
-                cmlist_render_data->Create(
-                    render_ent_id,
-                    key,
-                    buffer_layout,
-                    nullptr,
-                    std::vector<u8>{static_cast<u8>(m_scene->GetMainDrawStageId())},
-                    transparency);
+        Id const first_ent_id =
+                m_cmlist_draw_data->GetEntityId(list_draw_data[0]);
 
-        auto& merged_gm = render_data.GetGeometry();
+        if(first_ent_id < m_lkup_prev_render_batches.size() &&
+           m_lkup_prev_render_batches[first_ent_id] != k_invalid_render_batch)
+        {
+            auto& candidate =
+                    m_list_prev_render_batches[
+                        m_lkup_prev_render_batches[first_ent_id]];
 
-        // NOTE: We set retain geometry to false because we recreate
-        //       RenderData every time DrawData is updated. This also
-        //       ensures that if DrawSystem->Update is called multiple
-        //       times without a corresponding Sync, we don't have to
-        //       keep the corresponding Geometry alive until the Sync
-        //       occurs.
+            if(!candidate.reused &&
+               candidate.key == key &&
+               candidate.transparency == transparency)
+            {
+                prev_batch = &candidate;
+            }
+        }
 
-        merged_gm.SetRetainGeometry(false);
+        if(m_render_batch_count == m_list_render_batches.size())
+        {
+            m_list_render_batches.emplace_back();
+        }
 
-        merged_gm.GetVertexBuffers().
-                push_back(make_unique<std::vector<u8>>());
+        auto& batch = m_list_render_batches[m_render_batch_count++];
+        batch.key = key;
+        batch.transparency = transparency;
+        batch.reused = false;
+        batch.list_items.clear();
 
-        auto& merged_vx_buffer = merged_gm.GetVertexBuffer(0);
+        // The geometry only has to be rebuilt if the batch
+        // has different DrawData or any of it was updated
+        bool rebuild =
+                m_render_data_invalid ||
+                (prev_batch == nullptr) ||
+                (prev_batch->list_items.size() != list_draw_data.size());
 
-        // TODO: use memcpy here instead to speed this up
-        for(auto draw_data : list_draw_data)
+        for(uint i=0; i < list_draw_data.size(); i++)
         {
-            merged_vx_buffer->insert(
-                        merged_vx_buffer->end(),
-                        draw_data->vx_buffer->begin(),
-                        draw_data->vx_buffer->end());
+            auto const draw_data = list_draw_data[i];
+
+            RenderBatchItem const item{
+                m_cmlist_draw_data->GetEntityId(draw_data),
+                draw_data->vx_buffer.get(),
+                static_cast<uint>(draw_data->vx_buffer->size())
+            };
+
+            if(!rebuild)
+            {
+                auto const &prev_item = prev_batch->list_items[i];
+
+                rebuild =
+                        (prev_item.draw_data_id != item.draw_data_id) ||
+                        (prev_item.vx_buffer != item.vx_buffer) ||
+                        (prev_item.vx_size != item.vx_size) ||
+                        (item.draw_data_id >= list_updated.size()) ||
+                        list_updated[item.draw_data_id];
+            }
+
+            batch.list_items.push_back(item);
         }
 
-        if(merged_vx_buffer->empty())
+        auto cmlist_render_data =
+                m_render_system->
+                GetRenderDataComponentList();
+
+        if(prev_batch)
         {
-            m_scene->RemoveEntity(render_ent_id);
+            prev_batch->reused = true;
+            batch.ent_id = prev_batch->ent_id;
         }
         else
         {
+            // Create an entity and its merged RenderData
+            batch.ent_id = m_scene->CreateEntity();
+
+            auto& render_data =
+                    cmlist_render_data->Create(
+                        batch.ent_id,
+                        key,
+                        buffer_layout,
+                        nullptr,
+                        std::vector<u8>{static_cast<u8>(m_scene->GetMainDrawStageId())},
+                        transparency);
+
+            // NOTE: We set retain geometry to false because the
+            //       merged geometry is rebuilt every time any of
+            //       its DrawData is updated. This also ensures that
+            //       if DrawSystem->Update is called multiple times
+            //       without a corresponding Sync, we don't have to
+            //       keep the corresponding Geometry alive until the
+            //       Sync occurs.
+            render_data.GetGeometry().SetRetainGeometry(false);
+        }
+
+        if(rebuild)
+        {
+            auto& merged_gm =
+                    cmlist_render_data->
+                    GetComponent(batch.ent_id).GetGeometry();
+
+            // The buffer is reused if it hasn't been synced yet.
+            // Otherwise the render thread has taken it since the
+            // geometry isn't retained.
+            auto& list_vx_buffers = merged_gm.GetVertexBuffers();
+            if(list_vx_buffers.empty() || !list_vx_buffers[0])
+            {
+                list_vx_buffers.clear();
+                list_vx_buffers.push_back(make_unique<std::vector<u8>>());
+            }
+
+            auto& merged_vx_buffer = merged_gm.GetVertexBuffer(0);
+            merged_vx_buffer->clear();
+            merged_vx_buffer->reserve(vx_size);
+
+            // TODO: use memcpy here instead to speed this up
+            for(auto draw_data : list_draw_data)
+            {
+                merged_vx_buffer->insert(
+                            merged_vx_buffer->end(),
+                            draw_data->vx_buffer->begin(),
+                            draw_data->vx_buffer->end());
+            }
+
             merged_gm.SetAllUpdated();
+            m_rebuilt_render_data_count++;
+        }
+
+        // Save RenderData entity
+        list_render_ent_ids.push_back(batch.ent_id);
+
+        if(list_render_bboxes)
+        {
+            auto const &list_xf_data =
+                    m_cmlist_xf_data->GetSparseList();
+
+            BoundingBox bbox{
+                std::numeric_limits<float>::max(),
+                std::numeric_limits<float>::max(),
+                std::numeric_limits<float>::lowest(),
+                std::numeric_limits<float>::lowest()};
+
+            for(auto const &item : batch.list_items)
+            {
+                bbox = CalcUnion(bbox,list_xf_data[item.draw_data_id].bbox);
+            }
+
+            // All of the DrawData share the same clip
+            if(key.GetClip() < m_list_clip_regions.size())
+            {
+                bbox = CalcIntersection(
+                            bbox,m_list_clip_regions[key.GetClip()]);
+            }
 
-            // Save RenderData entity
-            list_render_ent_ids.push_back(render_ent_id);
+            list_render_bboxes->push_back(bbox);
         }
     }
 
     void DrawSystem::createClipOutlineDrawData()
     {
         // Get widget list
-        std::vector<Widget*> stack_widgets;
+        FrameVector<Widget*> stack_widgets(m_scene->GetFrameArena());
         stack_widgets.push_back(m_scene->GetRootWidget().get());
 
         while(!stack_widgets.empty())
@@ -844,7 +1868,7 @@ namespace raintk
     void DrawSystem::createBoundingBoxDrawData()
     {
         // Get widget list
-        std::vector<Widget*> stack_widgets;
+        FrameVector<Widget*> stack_widgets(m_scene->GetFrameArena());
         stack_widgets.push_back(m_scene->GetRootWidget().get());
 
         while(!stack_widgets.empty())
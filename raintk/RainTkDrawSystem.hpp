@@ -22,10 +22,15 @@
 #include <ks/shared/KsRecycleIndexList.hpp>
 #include <raintk/RainTkGlobal.hpp>
 #include <raintk/RainTkComponents.hpp>
+#include <raintk/RainTkFrameArena.hpp>
+#include <raintk/RainTkCompositorAnimation.hpp>
+#include <raintk/RainTkDrawSnapshot.hpp>
 
 namespace raintk
 {
     class Scene;
+    class Widget;
+    class DrawableWidget;
 
     class DrawSystem : public ks::draw::System
     {
@@ -36,8 +41,12 @@ namespace raintk
         std::string GetDesc() const override;
         std::vector<BoundingBox> const &GetClipRegions() const;
 
-        std::vector<Id> GetOpaqueDrawOrderList() const;
-        std::vector<Id> GetTransparentDrawOrderList() const;
+        std::vector<Id> const &GetOpaqueDrawOrderList() const;
+        std::vector<Id> const &GetTransparentDrawOrderList() const;
+
+        // Holds the lists that have changed since the last
+        // Sync. Used to sync the MainDrawStage.
+        DrawSnapshot& GetSnapshot();
 
         DrawDataComponentList*
         GetDrawDataComponentList() const;
@@ -72,6 +81,92 @@ namespace raintk
         Id RegisterUniformSet(shared_ptr<ks::draw::UniformSet> uniform_set);
         void RemoveUniformSet(Id uniform_set_id);
 
+        // Compositor layers
+        // * CreateLayer makes @widget and its descendants a layer
+        //   whose transform and opacity can be animated on the
+        //   render thread with StartLayerAnimation
+        // * A layer is drawn in its own batches and always with
+        //   blending, so layers should be used sparingly and
+        //   removed once their animations are done
+        // * Returns the existing layer id if @widget is already
+        //   the root of a layer
+        // * Throws if all layer ids are in use
+        Id CreateLayer(Widget* widget);
+        void RemoveLayer(Id layer_id);
+
+        // * Starts @animation on the layer, replacing any
+        //   animation that it already has
+        // * StopLayerAnimation resets the layer to an identity
+        //   transform and full opacity
+        void StartLayerAnimation(Id layer_id,
+                                 CompositorAnimation animation);
+
+        void StopLayerAnimation(Id layer_id);
+
+        // Called by Widget when its children change. Layer ids
+        // are only reassigned in Update after this or after a
+        // layer is created or removed.
+        void OnWidgetParentChanged();
+
+        // Called by DrawableWidget when it's created. Only these
+        // widgets are visited to update drawables. They're removed
+        // along with their entity.
+        void AddDrawableWidget(DrawableWidget* widget);
+
+        // Returns the layer updates that have been queued since
+        // the last call. Used to sync the MainDrawStage.
+        std::vector<CompositorLayerUpdate> TakeLayerUpdates();
+
+        // Cached layers
+        // * SetLayerCached makes the layer rooted at @widget draw
+        //   its subtree into a texture, which is then drawn as a
+        //   single quad until anything in the layer changes. A
+        //   layer is created for @widget if it isn't a layer root
+        //   and removed again when caching is turned off.
+        // * The texture covers the bounding boxes of the layer's
+        //   drawable widgets; anything drawn outside of them
+        //   is cut off
+        // * Layers that don't fit in the budget set with
+        //   SetLayerCacheBudget (in bytes) are drawn uncached
+        void SetLayerCached(Widget* widget, bool cached);
+        void SetLayerCacheBudget(uint max_bytes);
+
+        // Redraws all cached layers, ie after textures that
+        // they may have been drawn with were updated
+        void InvalidateCachedLayers();
+
+        // Called after the contents of @texture_set_id were
+        // updated, ie. when glyphs are uploaded to a text atlas.
+        // Redraws only the cached layers that were drawn with
+        // it and damages only the drawables that use it.
+        void OnTextureSetUpdated(Id texture_set_id);
+
+        // Stats from the MainDrawStage as of the last Sync
+        CachedLayerStats const &GetCachedLayerStats() const;
+
+        // Damage tracking
+        // * When enabled only the regions of the scene that have
+        //   changed are redrawn. The scene is drawn into an
+        //   offscreen buffer that is copied to the window every
+        //   frame, so everything else is preserved.
+        // * A drawable's old and new bounding boxes are damaged
+        //   when it's updated, added, removed or hidden
+        // * AddDamage and DamageAll are for changes that can't
+        //   be seen by the DrawSystem, ie to texture contents
+        void SetDamageTrackingEnabled(bool enabled);
+        void AddDamage(BoundingBox const &bbox);
+        void DamageAll();
+
+        // * RenderData is kept between frames and its geometry
+        //   is only rebuilt when its DrawData changes
+        // * Rebuilds the geometry of all RenderData in the next
+        //   Update, ie. after the graphics context was reset
+        void InvalidateRenderData();
+
+        // The number of RenderData entities whose geometry was
+        // rebuilt by the last Update
+        uint GetRebuiltRenderDataCount() const;
+
         void Reset(); // TODO
 
         void Update(TimePoint const &prev_time,
@@ -82,22 +177,38 @@ namespace raintk
     private:
 #endif
         void sortIntoOpaqueGroups(
-                std::vector<Id> &list_opq_draw_data);
+                FrameVector<Id> &list_opq_draw_data);
 
         void sortIntoTransparencyGroups(
-                std::vector<Id> &list_xpr_draw_data);
+                FrameVector<Id> &list_xpr_draw_data);
 
-        void createRenderDataForCommonKeyGroups(
+        void updateRenderDataForCommonKeyGroups(
                 ks::draw::Transparency transparency,
-                std::vector<std::vector<DrawData*>> &list_common_key_groups,
-                std::vector<Id>& list_render_ent_ids);
+                FrameVector<FrameVector<DrawData*>> &list_common_key_groups,
+                FrameVector<bool> const &list_updated,
+                std::vector<Id>& list_render_ent_ids,
+                std::vector<BoundingBox>* list_render_bboxes);
 
-        void createRenderDataForDrawData(
+        void updateRenderDataForDrawData(
                 DrawKey const &key,
                 ks::draw::BufferLayout const * buffer_layout,
-                std::vector<DrawData*> const &list_draw_data,
+                FrameVector<DrawData*> const &list_draw_data,
                 ks::draw::Transparency transparency,
-                std::vector<Id>& list_render_ent_ids);
+                FrameVector<bool> const &list_updated,
+                std::vector<Id>& list_render_ent_ids,
+                std::vector<BoundingBox>* list_render_bboxes);
+
+        void assignLayerIds(Widget* widget, Id parent_layer_id);
+
+        void updateCachedLayers(FrameVector<Id> const &list_xpr_draw_data_ids);
+
+        void writeCachedLayers();
+
+        void updateDamage(FrameVector<bool> const &list_updated,
+                          FrameVector<Id> const &list_opq_draw_data_ids,
+                          FrameVector<Id> const &list_xpr_draw_data_ids);
+
+        Widget* getLayerRoot(Id layer_id) const;
 
         void createClipOutlineDrawData();
 
@@ -111,7 +222,8 @@ namespace raintk
         UpdateDataComponentList* const m_cmlist_upd_data;
         TransformDataComponentList* const m_cmlist_xf_data;
 
-        DrawDataComponentList* m_cmlist_draw_data;
+        unique_ptr<DrawDataComponentList> m_cmlist_draw_data;
+        unique_ptr<DenseComponentList<DrawableWidget*>> m_cmlist_drawable_widgets;
 
         bool m_show_bboxes{false};
         bool m_show_clip_outlines{false};
@@ -139,9 +251,102 @@ namespace raintk
         // DrawKey clip id
         std::vector<BoundingBox> m_list_clip_regions;
 
+        // The clip regions that were last written to m_snapshot
+        std::vector<BoundingBox> m_list_prev_clip_regions;
+
+        // RenderData entities are kept between frames. Each
+        // one is matched to the previous frame's by its first
+        // DrawData and its geometry is only rebuilt if any of
+        // its DrawData was changed, added or removed.
+        struct RenderBatchItem
+        {
+            Id draw_data_id;
+            std::vector<u8> const * vx_buffer;
+            uint vx_size;
+        };
+
+        struct RenderBatch
+        {
+            Id ent_id{0};
+            DrawKey key;
+            ks::draw::Transparency transparency;
+            bool reused{false};
+            std::vector<RenderBatchItem> list_items;
+        };
+
+        // Elements past m_render_batch_count are kept so that
+        // their lists don't have to be allocated again
+        std::vector<RenderBatch> m_list_render_batches;
+        std::vector<RenderBatch> m_list_prev_render_batches;
+        uint m_render_batch_count{0};
+        bool m_render_data_invalid{false};
+        uint m_rebuilt_render_data_count{0};
+
+        // Index into m_list_prev_render_batches for the first
+        // DrawData entity of each batch, where indices
+        // correspond to entity id
+        std::vector<uint> m_lkup_prev_render_batches;
+
+        // Filled by DrawableWidget::getDrawDataIds
+        std::vector<Id> m_list_widget_draw_data_ids;
+
         // RenderData entities sorted in the correct draw order
         std::vector<Id> m_list_opq_render_ent_ids;
         std::vector<Id> m_list_xpr_render_ent_ids;
+        std::vector<Id> m_list_prev_opq_render_ent_ids;
+        std::vector<Id> m_list_prev_xpr_render_ent_ids;
+
+        // The bounds of each RenderData entity, only kept
+        // with damage tracking
+        std::vector<BoundingBox> m_list_opq_render_bboxes;
+        std::vector<BoundingBox> m_list_xpr_render_bboxes;
+        std::vector<BoundingBox> m_list_prev_opq_render_bboxes;
+        std::vector<BoundingBox> m_list_prev_xpr_render_bboxes;
+
+        DrawSnapshot m_snapshot;
+
+        // The root widget of each compositor layer where indices
+        // correspond to DrawKey layer id. Index 0 is unused.
+        std::vector<Widget*> m_list_layer_roots;
+        uint m_layer_count{0};
+        bool m_layers_dirty{false};
+        std::vector<CompositorLayerUpdate> m_list_layer_updates;
+
+        // Cached layers
+        struct CachedLayer
+        {
+            bool cached{false};
+            bool owns_layer{false}; // created by SetLayerCached
+            bool dirty{false};
+            bool in_budget{false};
+            u64 version{0};
+            u64 signature{0};
+            BoundingBox bbox{0,0,0,0};
+
+            // The texture sets of the layer's DrawData as of
+            // the last Update
+            std::vector<Id> list_texture_set_ids;
+        };
+
+        // Indices correspond to DrawKey layer id
+        std::vector<CachedLayer> m_list_cached_layers;
+        uint m_cached_layer_count{0};
+        uint m_layer_cache_budget{16*1024*1024};
+
+        // Damage tracking
+        struct DrawnState
+        {
+            BoundingBox bbox{0,0,0,0}; // clipped
+            Id key{0};
+            Id texture_set{0};
+            bool drawn{false};
+        };
+
+        bool m_damage_tracking{false};
+
+        // The state each DrawData entity was last drawn
+        // with, where indices correspond to entity id
+        std::vector<DrawnState> m_list_drawn_states;
     };
 }
 
@@ -15,6 +15,8 @@
 */
 
 #include <raintk/RainTkDrawableWidget.hpp>
+#include <raintk/RainTkScene.hpp>
+#include <raintk/RainTkDrawSystem.hpp>
 
 namespace raintk
 {
@@ -27,7 +29,7 @@ namespace raintk
                                    shared_ptr<Widget> parent) :
         Widget(key,scene,parent)
     {
-
+        m_scene->GetDrawSystem()->AddDrawableWidget(this);
     }
 
     void DrawableWidget::Init(ks::Object::Key const &,
@@ -55,4 +57,9 @@ namespace raintk
     {
 
     }
+
+    void DrawableWidget::getDrawDataIds(std::vector<Id>& list_ent_ids) const
+    {
+        list_ent_ids.push_back(m_entity_id);
+    }
 }
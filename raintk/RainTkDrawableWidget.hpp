@@ -80,6 +80,11 @@ namespace raintk
         //
         virtual void updateDrawables() = 0;
 
+        // * Appends the ids of the entities whose DrawData
+        //   is changed by updateDrawables. By default that's
+        //   just this widget's entity.
+        virtual void getDrawDataIds(std::vector<Id>& list_ent_ids) const;
+
 
         Id m_cid_visible;
 
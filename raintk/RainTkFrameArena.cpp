@@ -0,0 +1,113 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+#include <raintk/RainTkFrameArena.hpp>
+
+namespace raintk
+{
+    FrameArena::FrameArena(std::size_t block_size_bytes)
+    {
+        addBlock(block_size_bytes);
+        m_block_allocation_count = 0;
+    }
+
+    FrameArena::~FrameArena()
+    {}
+
+    void* FrameArena::Allocate(std::size_t size_bytes, std::size_t align)
+    {
+        auto* block = &(m_list_blocks.back());
+
+        std::size_t offset = (m_offset+align-1) & ~(align-1);
+
+        if(offset+size_bytes > block->size_bytes)
+        {
+            // Blocks at least double in size so that a frame
+            // that keeps growing only adds a few blocks
+            addBlock(std::max(block->size_bytes*2,size_bytes+align));
+            block = &(m_list_blocks.back());
+
+            offset = 0;
+        }
+
+        m_used_bytes += (offset-m_offset)+size_bytes;
+        m_offset = offset+size_bytes;
+
+        return block->data.get()+offset;
+    }
+
+    void FrameArena::Deallocate(void* ptr, std::size_t size_bytes)
+    {
+        auto const &block = m_list_blocks.back();
+
+        if(static_cast<u8*>(ptr)+size_bytes == block.data.get()+m_offset)
+        {
+            m_offset -= size_bytes;
+            m_used_bytes -= size_bytes;
+        }
+    }
+
+    void FrameArena::Reset()
+    {
+        if(m_list_blocks.size() > 1)
+        {
+            std::size_t const size_bytes =
+                    m_prev_blocks_size_bytes+
+                    m_list_blocks.back().size_bytes;
+
+            m_list_blocks.clear();
+            m_prev_blocks_size_bytes = 0;
+            addBlock(size_bytes);
+        }
+
+        m_offset = 0;
+        m_used_bytes = 0;
+        m_block_allocation_count = 0;
+    }
+
+    std::size_t FrameArena::GetUsedBytes() const
+    {
+        return m_used_bytes;
+    }
+
+    std::size_t FrameArena::GetCapacityBytes() const
+    {
+        return m_prev_blocks_size_bytes+m_list_blocks.back().size_bytes;
+    }
+
+    uint FrameArena::GetBlockAllocationCount() const
+    {
+        return m_block_allocation_count;
+    }
+
+    void FrameArena::addBlock(std::size_t size_bytes)
+    {
+        if(!m_list_blocks.empty())
+        {
+            m_prev_blocks_size_bytes += m_list_blocks.back().size_bytes;
+        }
+
+        m_list_blocks.push_back(
+                    Block{
+                        unique_ptr<u8[]>(new u8[size_bytes]),
+                        size_bytes
+                    });
+
+        m_offset = 0;
+        m_block_allocation_count++;
+    }
+}
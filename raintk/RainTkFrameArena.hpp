@@ -0,0 +1,156 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef RAINTK_FRAME_ARENA_HPP
+#define RAINTK_FRAME_ARENA_HPP
+
+#include <vector>
+#include <cstddef>
+#include <raintk/RainTkGlobal.hpp>
+
+namespace raintk
+{
+    // =========================================================== //
+
+    // FrameArena
+    // * A linear (bump) allocator for data that only lives for
+    //   a single frame, like the lists the systems build in
+    //   their Update functions
+    // * Owned by the Scene and reset at the start of each
+    //   frame. Nothing allocated from it may be used after
+    //   the frame it was allocated in.
+    // * Memory is taken from blocks that are kept between
+    //   frames. If a frame needs more than one block, the
+    //   blocks are replaced with a single larger block when
+    //   the arena is reset, so a frame that uses about as
+    //   much memory as the previous one doesn't allocate.
+    // * Not thread safe; it should only be used from the
+    //   update thread
+    class FrameArena final
+    {
+    public:
+        FrameArena(std::size_t block_size_bytes=64*1024);
+        ~FrameArena();
+
+        FrameArena(FrameArena const &) = delete;
+        FrameArena& operator=(FrameArena const &) = delete;
+
+        // @align must be a power of two
+        void* Allocate(std::size_t size_bytes, std::size_t align);
+
+        // Memory is only reused if @ptr was the most recent
+        // allocation; otherwise it's reclaimed on Reset
+        void Deallocate(void* ptr, std::size_t size_bytes);
+
+        void Reset();
+
+        // Bytes allocated since the last Reset
+        std::size_t GetUsedBytes() const;
+
+        std::size_t GetCapacityBytes() const;
+
+        // Number of blocks the arena allocated since the last
+        // Reset. Heap allocations made outside of the arena during
+        // the frame aren't counted.
+        uint GetBlockAllocationCount() const;
+
+    private:
+        struct Block
+        {
+            unique_ptr<u8[]> data;
+            std::size_t size_bytes;
+        };
+
+        void addBlock(std::size_t size_bytes);
+
+        std::vector<Block> m_list_blocks;
+
+        // Offset into the last block
+        std::size_t m_offset{0};
+
+        // Sizes of the blocks before the last one
+        std::size_t m_prev_blocks_size_bytes{0};
+
+        std::size_t m_used_bytes{0};
+        uint m_block_allocation_count{0};
+    };
+
+    // =========================================================== //
+
+    // FrameAllocator
+    // * A standard allocator that uses a FrameArena so that
+    //   standard containers can be used for frame temporaries
+    // * There's no default constructor; the arena must be
+    //   passed to each container (including the elements of
+    //   nested containers):
+    //
+    //   FrameVector<Id> list_ids(frame_arena);
+    template<typename T>
+    class FrameAllocator
+    {
+    public:
+        using value_type = T;
+
+        FrameAllocator(FrameArena* arena) :
+            m_arena(arena)
+        {}
+
+        template<typename U>
+        FrameAllocator(FrameAllocator<U> const &other) :
+            m_arena(other.GetArena())
+        {}
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(
+                        m_arena->Allocate(n*sizeof(T),alignof(T)));
+        }
+
+        void deallocate(T* ptr, std::size_t n)
+        {
+            m_arena->Deallocate(ptr,n*sizeof(T));
+        }
+
+        FrameArena* GetArena() const
+        {
+            return m_arena;
+        }
+
+    private:
+        FrameArena* m_arena;
+    };
+
+    template<typename T, typename U>
+    bool operator == (FrameAllocator<T> const &a,
+                      FrameAllocator<U> const &b)
+    {
+        return (a.GetArena() == b.GetArena());
+    }
+
+    template<typename T, typename U>
+    bool operator != (FrameAllocator<T> const &a,
+                      FrameAllocator<U> const &b)
+    {
+        return !(a == b);
+    }
+
+    template<typename T>
+    using FrameVector = std::vector<T,FrameAllocator<T>>;
+
+    // =========================================================== //
+}
+
+#endif // RAINTK_FRAME_ARENA_HPP
@@ -0,0 +1,405 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <ks/gl/KsGLCommands.hpp>
+#include <raintk/RainTkFramePacer.hpp>
+#include <raintk/RainTkLog.hpp>
+
+namespace raintk
+{
+    namespace
+    {
+        // Weight of new samples in the moving averages
+        float const k_avg_weight = 0.1f;
+
+        // Frame times longer than this (ie. while the app
+        // is paused) aren't included in the average
+        float const k_max_frame_time_ms = 250.0f;
+
+        float CalcAverage(float avg, float sample, bool first)
+        {
+            return first ? sample : (avg + k_avg_weight*(sample-avg));
+        }
+
+        float CalcDurationMs(TimePoint const &a, TimePoint const &b)
+        {
+            return ks::CalcDuration<Microseconds>(a,b).count()/1000.0f;
+        }
+
+#ifdef RAINTK_GL_FENCE_SYNC
+        // Fence syncs are core in OpenGL 3.2 and OpenGL ES 3.0.
+        // The context may be older than the headers the build
+        // used, so this is checked before the first fence.
+        bool GetFenceSyncSupported()
+        {
+            char const * version =
+                    reinterpret_cast<char const *>(
+                        glGetString(GL_VERSION));
+
+            if(version == nullptr)
+            {
+                return false;
+            }
+
+            // ie. "OpenGL ES 3.0 ..." or "3.3.0 ..."
+            char const * es_prefix = "OpenGL ES ";
+            bool const es = (std::strncmp(version,es_prefix,10) == 0);
+            if(es)
+            {
+                version += 10;
+            }
+
+            int major=0;
+            int minor=0;
+            while(*version >= '0' && *version <= '9')
+            {
+                major = major*10 + (*version-'0');
+                version++;
+            }
+            if(*version == '.')
+            {
+                version++;
+                while(*version >= '0' && *version <= '9')
+                {
+                    minor = minor*10 + (*version-'0');
+                    version++;
+                }
+            }
+
+            return es ?
+                        (major >= 3) :
+                        (major > 3 || (major == 3 && minor >= 2));
+        }
+
+        void* CreateFence()
+        {
+            return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE,0);
+        }
+
+        // Returns true if @fence has been signaled. Failed waits
+        // also return true so that a bad fence can't stall
+        // rendering.
+        bool WaitForFence(void* fence, bool block)
+        {
+            GLbitfield const flags = block ? GL_SYNC_FLUSH_COMMANDS_BIT : 0;
+            GLuint64 const timeout_ns = block ? 1000000000 : 0;
+
+            GLenum const result =
+                    glClientWaitSync(
+                        static_cast<GLsync>(fence),
+                        flags,
+                        timeout_ns);
+
+            return (result != GL_TIMEOUT_EXPIRED);
+        }
+
+        void DestroyFence(void* fence)
+        {
+            glDeleteSync(static_cast<GLsync>(fence));
+        }
+#endif
+    }
+
+    // ============================================================= //
+
+    FramePacer::FramePacer() :
+        m_max_frames_in_flight(2),
+        m_late_update_enabled(true),
+        m_late_update_margin(Milliseconds(4)),
+        m_next_frame_id(0),
+        m_fence_sync_state(FenceSyncState::Unknown),
+        m_unfinished_frame_count(0),
+        m_has_completed_frame(false)
+    {}
+
+    FramePacer::~FramePacer()
+    {}
+
+    void FramePacer::SetMaxFramesInFlight(uint max_frames)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_max_frames_in_flight = std::max(max_frames,1u);
+    }
+
+    uint FramePacer::GetMaxFramesInFlight() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_max_frames_in_flight;
+    }
+
+    void FramePacer::SetLateUpdateEnabled(bool enabled)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_late_update_enabled = enabled;
+    }
+
+    void FramePacer::SetLateUpdateMargin(Microseconds margin)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_late_update_margin = margin;
+    }
+
+    FramePacer::Metrics FramePacer::GetMetrics() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_metrics;
+    }
+
+    TimePoint FramePacer::GetNextUpdateTime() const
+    {
+        TimePoint const now = std::chrono::high_resolution_clock::now();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Need at least one frame time sample
+        if(!m_late_update_enabled || m_metrics.frames_completed < 2)
+        {
+            return now;
+        }
+
+        // The next frame completes after the frames that are
+        // already in flight, one frame interval apart
+        float const interval_ms = m_metrics.avg_frame_time_ms;
+        float const lead_ms =
+                m_metrics.avg_cpu_cost_ms +
+                (m_late_update_margin.count()/1000.0f);
+
+        float const start_ms =
+                (interval_ms*(m_list_frames_in_flight.size()+1))-lead_ms;
+
+        if(start_ms <= 0.0f)
+        {
+            return now;
+        }
+
+        TimePoint const start_time =
+                m_last_complete_time +
+                std::chrono::duration_cast<TimePoint::duration>(
+                    Microseconds(static_cast<s64>(start_ms*1000.0f)));
+
+        // Never wait longer than a frame
+        TimePoint const max_start_time =
+                now +
+                std::chrono::duration_cast<TimePoint::duration>(
+                    Microseconds(static_cast<s64>(interval_ms*1000.0f)));
+
+        return std::min(start_time,max_start_time);
+    }
+
+    FramePacer::Frame FramePacer::BeginFrame(TimePoint update_time)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Frame frame;
+        frame.id = m_next_frame_id++;
+        frame.update_time = update_time;
+        frame.has_input = false;
+
+        return frame;
+    }
+
+    void FramePacer::WaitForFrameSlot()
+    {
+#ifdef RAINTK_GL_FENCE_SYNC
+        pollFrames(false);
+
+        while(true)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if(m_list_frames_in_flight.size() < m_max_frames_in_flight)
+                {
+                    return;
+                }
+            }
+
+            pollFrames(true);
+        }
+#endif
+    }
+
+    void FramePacer::SubmitFrame(Frame const &frame)
+    {
+        TimePoint const submit_time = std::chrono::high_resolution_clock::now();
+
+#ifdef RAINTK_GL_FENCE_SYNC
+        // m_fence_sync_state is only used on the render thread
+        if(m_fence_sync_state == FenceSyncState::Unknown)
+        {
+            m_fence_sync_state =
+                    GetFenceSyncSupported() ?
+                        FenceSyncState::Supported :
+                        FenceSyncState::Unsupported;
+
+            if(m_fence_sync_state == FenceSyncState::Unsupported)
+            {
+                rtklog.Warn() << "FramePacer: Fence syncs not supported "
+                                 "by the context, using glFinish";
+            }
+        }
+
+        void* fence =
+                (m_fence_sync_state == FenceSyncState::Supported) ?
+                    CreateFence() : nullptr;
+
+        if(fence != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_metrics.avg_cpu_cost_ms =
+                    CalcAverage(
+                        m_metrics.avg_cpu_cost_ms,
+                        CalcDurationMs(frame.update_time,submit_time),
+                        frame.id == 0);
+
+            m_list_frames_in_flight.push_back(
+                        InFlightFrame{frame,submit_time,fence});
+
+            m_metrics.frames_in_flight = m_list_frames_in_flight.size();
+            return;
+        }
+#endif
+        // Without fences, wait for the GPU to finish every
+        // max frames in flight frames. At most that many
+        // frames can be queued before one of the waits.
+        bool finish;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_unfinished_frame_count++;
+            finish = (m_unfinished_frame_count >= m_max_frames_in_flight);
+        }
+
+        if(finish)
+        {
+            ks::gl::Finish();
+        }
+
+        TimePoint const complete_time = std::chrono::high_resolution_clock::now();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_metrics.avg_cpu_cost_ms =
+                CalcAverage(
+                    m_metrics.avg_cpu_cost_ms,
+                    CalcDurationMs(frame.update_time,submit_time),
+                    frame.id == 0);
+
+        if(finish)
+        {
+            m_unfinished_frame_count = 0;
+        }
+
+        // Frame times are measured at the swap since there's
+        // no way to tell when the unfinished frames complete
+        completeFrame(InFlightFrame{frame,submit_time,nullptr},complete_time);
+        m_metrics.frames_in_flight = m_unfinished_frame_count;
+    }
+
+    void FramePacer::Reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // The fences aren't deleted since this is called
+        // after the context they belong to has been lost
+        m_list_frames_in_flight.clear();
+        m_has_completed_frame = false;
+        m_metrics.frames_in_flight = 0;
+        m_unfinished_frame_count = 0;
+
+        // The new context may be a different version
+        m_fence_sync_state = FenceSyncState::Unknown;
+    }
+
+    void FramePacer::pollFrames(bool wait_for_oldest)
+    {
+#ifdef RAINTK_GL_FENCE_SYNC
+        bool block = wait_for_oldest;
+
+        while(true)
+        {
+            InFlightFrame oldest;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if(m_list_frames_in_flight.empty())
+                {
+                    return;
+                }
+                oldest = m_list_frames_in_flight.front();
+            }
+
+            // The fence is waited on without holding the lock
+            // so the update thread isn't blocked
+            if(!WaitForFence(oldest.fence,block))
+            {
+                return;
+            }
+
+            DestroyFence(oldest.fence);
+            block = false;
+
+            TimePoint const complete_time =
+                    std::chrono::high_resolution_clock::now();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_list_frames_in_flight.pop_front();
+            completeFrame(oldest,complete_time);
+        }
+#else
+        (void)wait_for_oldest;
+#endif
+    }
+
+    void FramePacer::completeFrame(InFlightFrame const &in_flight,
+                                   TimePoint complete_time)
+    {
+        if(m_has_completed_frame)
+        {
+            float const frame_time_ms =
+                    CalcDurationMs(m_last_complete_time,complete_time);
+
+            m_metrics.frame_time_ms = frame_time_ms;
+
+            if(frame_time_ms < k_max_frame_time_ms)
+            {
+                m_metrics.avg_frame_time_ms =
+                        CalcAverage(
+                            m_metrics.avg_frame_time_ms,
+                            frame_time_ms,
+                            m_metrics.avg_frame_time_ms == 0.0f);
+            }
+        }
+
+        if(in_flight.frame.has_input)
+        {
+            float const latency_ms =
+                    CalcDurationMs(in_flight.frame.input_time,complete_time);
+
+            m_metrics.input_latency_ms = latency_ms;
+            m_metrics.avg_input_latency_ms =
+                    CalcAverage(
+                        m_metrics.avg_input_latency_ms,
+                        latency_ms,
+                        m_metrics.avg_input_latency_ms == 0.0f);
+        }
+
+        m_has_completed_frame = true;
+        m_last_complete_time = complete_time;
+        m_metrics.frames_completed++;
+        m_metrics.frames_in_flight = m_list_frames_in_flight.size();
+    }
+}
@@ -0,0 +1,151 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef RAINTK_FRAME_PACER_HPP
+#define RAINTK_FRAME_PACER_HPP
+
+#include <deque>
+#include <mutex>
+#include <raintk/RainTkGlobal.hpp>
+
+namespace raintk
+{
+    // FramePacer
+    // * Limits the number of frames that have been submitted
+    //   to the GPU but haven't completed yet. When the build
+    //   defines RAINTK_GL_FENCE_SYNC and the context supports
+    //   it (OpenGL 3.2 or OpenGL ES 3.0) a fence is inserted
+    //   after each swap. Otherwise glFinish is called after
+    //   every max frames in flight swaps.
+    // * Measures the achieved frame time and the cost of
+    //   each frame, and uses them to schedule updates to
+    //   start as late as possible before the next swap so
+    //   that input is sampled closer to when it's displayed
+    // * Frame functions marked (update) must be called from
+    //   the Scene thread and those marked (render) from the
+    //   thread the Window renders on. Everything else can be
+    //   called from either.
+    class FramePacer final
+    {
+    public:
+        struct Frame
+        {
+            u64 id;
+            TimePoint update_time;
+
+            // The timestamp of the most recent input point
+            // handled during this frame's update, if any
+            bool has_input;
+            TimePoint input_time;
+        };
+
+        struct Metrics
+        {
+            // The time between the two most recently completed
+            // frames and its moving average
+            float frame_time_ms{0.0f};
+            float avg_frame_time_ms{0.0f};
+
+            // The time from the start of an update until its
+            // frame was submitted by the render thread
+            float avg_cpu_cost_ms{0.0f};
+
+            // The time from the input a frame responds to until
+            // the frame completed (ie. touch-to-photon, without
+            // the display's own latency)
+            float input_latency_ms{0.0f};
+            float avg_input_latency_ms{0.0f};
+
+            uint frames_in_flight{0};
+            u64 frames_completed{0};
+        };
+
+        FramePacer();
+        ~FramePacer();
+
+        // The max number of frames that can be submitted and
+        // not yet completed. Must be at least 1. Default is 2.
+        void SetMaxFramesInFlight(uint max_frames);
+        uint GetMaxFramesInFlight() const;
+
+        // * If enabled, GetNextUpdateTime returns the latest time
+        //   an update can start and still be ready for its swap
+        // * @margin is extra time reserved for GPU work and
+        //   variance in the frame cost
+        void SetLateUpdateEnabled(bool enabled);
+        void SetLateUpdateMargin(Microseconds margin);
+
+        Metrics GetMetrics() const;
+
+        // (update) Returns the time the next update should
+        // start at. May be in the past.
+        TimePoint GetNextUpdateTime() const;
+
+        // (update) Called at the start of each update
+        Frame BeginFrame(TimePoint update_time);
+
+        // (render) Blocks until fewer than the max number of
+        // frames are in flight. Call before rendering.
+        void WaitForFrameSlot();
+
+        // (render) Call right after SwapBuffers
+        void SubmitFrame(Frame const &frame);
+
+        // (render) Drops all frames in flight, ie. when the
+        // graphics context has been lost
+        void Reset();
+
+    private:
+        struct InFlightFrame
+        {
+            Frame frame;
+            TimePoint submit_time;
+            void* fence;
+        };
+
+        void pollFrames(bool wait_for_oldest);
+        void completeFrame(InFlightFrame const &in_flight,
+                           TimePoint complete_time);
+
+        mutable std::mutex m_mutex;
+
+        uint m_max_frames_in_flight;
+        bool m_late_update_enabled;
+        Microseconds m_late_update_margin;
+
+        u64 m_next_frame_id;
+        std::deque<InFlightFrame> m_list_frames_in_flight;
+
+        enum class FenceSyncState
+        {
+            Unknown,
+            Supported,
+            Unsupported
+        };
+
+        FenceSyncState m_fence_sync_state;
+
+        // Frames submitted since the last glFinish when
+        // fences aren't used
+        uint m_unfinished_frame_count;
+
+        bool m_has_completed_frame;
+        TimePoint m_last_complete_time;
+        Metrics m_metrics;
+    };
+}
+
+#endif // RAINTK_FRAME_PACER_HPP
@@ -0,0 +1,283 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <ks/KsEventLoop.hpp>
+#include <ks/KsTask.hpp>
+#include <raintk/RainTkLog.hpp>
+#include <raintk/RainTkListModelMapped.hpp>
+#include <raintk/RainTkTextureShadow.hpp>
+#include <raintk/RainTkGlyphPageStore.hpp>
+
+namespace raintk
+{
+    namespace
+    {
+        u32 const k_magic = 0x474B5452; // 'RTKG'
+
+        // Bump this when the layout changes so that
+        // older files are ignored
+        u32 const k_version = 1;
+
+        struct Header
+        {
+            u32 magic;
+            u32 version;
+            u32 atlas_size_px;
+            u32 glyph_size_px;
+            u32 sdf_size_px;
+            u32 page_count;
+            u64 font_hash;
+        };
+
+        struct PageHeader
+        {
+            u32 atlas_index;
+            u32 padding;
+        };
+    }
+
+    // ============================================================= //
+
+    GlyphPageStore::GlyphPageStore(std::string path,
+                                   uint atlas_size_px,
+                                   uint glyph_size_px,
+                                   uint sdf_size_px,
+                                   u64 font_hash) :
+        m_path(std::move(path)),
+        m_atlas_size_px(atlas_size_px),
+        m_glyph_size_px(glyph_size_px),
+        m_sdf_size_px(sdf_size_px),
+        m_font_hash(font_hash),
+        m_saving(make_shared<std::atomic<bool>>(false))
+    {
+        m_worker_event_loop = make_shared<ks::EventLoop>();
+        m_worker_thread = ks::EventLoop::LaunchInThread(m_worker_event_loop);
+
+        load();
+    }
+
+    GlyphPageStore::~GlyphPageStore()
+    {
+        // Finishes the tasks already posted, so a running
+        // Save completes before the file is unmapped
+        ks::EventLoop::RemoveFromThread(
+                    m_worker_event_loop,
+                    m_worker_thread,
+                    true);
+    }
+
+    uint GlyphPageStore::GetPageCount() const
+    {
+        return m_lkup_pages.size();
+    }
+
+    u8 const * GlyphPageStore::GetPage(uint atlas_index) const
+    {
+        auto it = m_lkup_pages.find(atlas_index);
+        if(it == m_lkup_pages.end())
+        {
+            return nullptr;
+        }
+
+        return it->second;
+    }
+
+    bool GlyphPageStore::GetIsSaving() const
+    {
+        return m_saving->load();
+    }
+
+    bool GlyphPageStore::Save(std::map<uint,unique_ptr<TextureShadow>> const &lkup_shadows)
+    {
+        if(m_saving->load())
+        {
+            return false;
+        }
+
+        u64 const page_bytes = u64(m_atlas_size_px)*m_atlas_size_px;
+
+        // Pages loaded from the file whose atlases haven't
+        // been created yet are kept as they are
+        auto list_pages =
+                make_shared<std::vector<std::pair<uint,std::vector<u8>>>>();
+
+        for(auto const &shadow_it : lkup_shadows)
+        {
+            auto const &shadow = *(shadow_it.second);
+            if(shadow.GetWidthPx() != m_atlas_size_px ||
+               shadow.GetHeightPx() != m_atlas_size_px)
+            {
+                continue;
+            }
+
+            list_pages->emplace_back(
+                        shadow_it.first,
+                        std::vector<u8>(
+                            shadow.GetData(),
+                            shadow.GetData()+page_bytes));
+        }
+
+        for(auto const &page_it : m_lkup_pages)
+        {
+            if(lkup_shadows.count(page_it.first) == 0)
+            {
+                list_pages->emplace_back(
+                            page_it.first,
+                            std::vector<u8>(
+                                page_it.second,
+                                page_it.second+page_bytes));
+            }
+        }
+
+        Header const header{
+            k_magic,
+            k_version,
+            m_atlas_size_px,
+            m_glyph_size_px,
+            m_sdf_size_px,
+            static_cast<u32>(list_pages->size()),
+            m_font_hash
+        };
+
+        std::string const path = m_path;
+        auto saving = m_saving;
+        saving->store(true);
+
+        auto save_task =
+                make_shared<ks::Task>(
+                    [path,header,list_pages,saving]()
+                    {
+                        std::string const temp_path = path+".tmp";
+
+                        bool ok = false;
+                        {
+                            std::ofstream file(
+                                        temp_path,
+                                        std::ios_base::out |
+                                        std::ios_base::trunc |
+                                        std::ios_base::binary);
+
+                            file.write(
+                                        reinterpret_cast<char const *>(&header),
+                                        sizeof(Header));
+
+                            for(auto const &page : *list_pages)
+                            {
+                                PageHeader const page_header{page.first,0};
+
+                                file.write(
+                                            reinterpret_cast<char const *>(&page_header),
+                                            sizeof(PageHeader));
+
+                                file.write(
+                                            reinterpret_cast<char const *>(page.second.data()),
+                                            page.second.size());
+                            }
+
+                            ok = file.good();
+                        }
+
+                        // The old file may still be mapped; it stays
+                        // valid until it's unmapped after the rename
+                        if(!ok || std::rename(temp_path.c_str(),path.c_str()) != 0)
+                        {
+                            rtklog.Warn() << "GlyphPageStore: Failed to save "
+                                          << path;
+
+                            std::remove(temp_path.c_str());
+                        }
+
+                        saving->store(false);
+                    });
+
+        m_worker_event_loop->PostTask(save_task);
+
+        return true;
+    }
+
+    void GlyphPageStore::load()
+    {
+        try
+        {
+            m_file = make_unique<MappedFile>(m_path);
+        }
+        catch(ListModelMappedFileError const &)
+        {
+            // Nothing saved yet
+            rtklog.Trace() << "GlyphPageStore: No pages saved at " << m_path;
+            return;
+        }
+
+        u8 const * data = m_file->GetData();
+        u64 const size = m_file->GetSize();
+
+        Header header;
+        if(size < sizeof(Header))
+        {
+            rtklog.Warn() << "GlyphPageStore: Ignoring " << m_path
+                          << ": Too small";
+            m_file.reset();
+            return;
+        }
+
+        std::memcpy(&header,data,sizeof(Header));
+
+        if(header.magic != k_magic ||
+           header.version != k_version ||
+           header.atlas_size_px != m_atlas_size_px ||
+           header.glyph_size_px != m_glyph_size_px ||
+           header.sdf_size_px != m_sdf_size_px ||
+           header.font_hash != m_font_hash)
+        {
+            rtklog.Trace() << "GlyphPageStore: Ignoring " << m_path
+                           << ": Different version, params or fonts";
+            m_file.reset();
+            return;
+        }
+
+        u64 const page_bytes = u64(m_atlas_size_px)*m_atlas_size_px;
+        u64 const expected_size =
+                sizeof(Header)+
+                header.page_count*(sizeof(PageHeader)+page_bytes);
+
+        if(size != expected_size)
+        {
+            rtklog.Warn() << "GlyphPageStore: Ignoring " << m_path
+                          << ": Expected " << expected_size
+                          << " bytes, got " << size;
+            m_file.reset();
+            return;
+        }
+
+        u64 offset = sizeof(Header);
+        for(uint i=0; i < header.page_count; i++)
+        {
+            PageHeader page_header;
+            std::memcpy(&page_header,data+offset,sizeof(PageHeader));
+            offset += sizeof(PageHeader);
+
+            m_lkup_pages[page_header.atlas_index] = data+offset;
+            offset += page_bytes;
+        }
+
+        rtklog.Trace() << "GlyphPageStore: Loaded " << m_lkup_pages.size()
+                       << " pages from " << m_path;
+    }
+}
@@ -0,0 +1,102 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef RAINTK_GLYPH_PAGE_STORE_HPP
+#define RAINTK_GLYPH_PAGE_STORE_HPP
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <raintk/RainTkGlobal.hpp>
+
+namespace ks
+{
+    class EventLoop;
+}
+
+namespace raintk
+{
+    class MappedFile;
+    class TextureShadow;
+
+    // GlyphPageStore
+    // * Keeps the text atlas pages in a file so that glyphs
+    //   created in an earlier run are already on the GPU
+    //   when the atlases are created in the next one
+    // * The file is memory mapped when the store is created
+    //   and each page is only read in when its atlas is
+    //   created. A file with a different version, atlas, glyph
+    //   or SDF size, or font hash is ignored and replaced by
+    //   the next Save.
+    // * Layout (native byte order):
+    //   - Header: magic, version, atlas size, glyph size,
+    //     SDF size, page count (u32 each), font hash (u64)
+    //   - Pages: atlas index (u32), padding (u32), then
+    //     atlas size*atlas size bytes of LUMINANCE8 data
+    class GlyphPageStore final
+    {
+    public:
+        // @font_hash should identify the fonts the atlases
+        // are created from; the store can't tell when they
+        // change otherwise
+        GlyphPageStore(std::string path,
+                       uint atlas_size_px,
+                       uint glyph_size_px,
+                       uint sdf_size_px,
+                       u64 font_hash);
+
+        // Waits for a running Save to finish
+        ~GlyphPageStore();
+
+        GlyphPageStore(GlyphPageStore const &) = delete;
+        GlyphPageStore& operator=(GlyphPageStore const &) = delete;
+
+        uint GetPageCount() const;
+
+        // Returns the atlas size*atlas size bytes of the page
+        // saved for @atlas_index, or nullptr if there isn't one
+        u8 const * GetPage(uint atlas_index) const;
+
+        // Returns true while a Save is being written
+        bool GetIsSaving() const;
+
+        // * Copies @lkup_shadows and writes them to the file on
+        //   a worker thread. The file is written to a temporary
+        //   file first and renamed over the old one once done.
+        // * Does nothing and returns false if a Save is still
+        //   running; the caller should try again later.
+        bool Save(std::map<uint,unique_ptr<TextureShadow>> const &lkup_shadows);
+
+    private:
+        void load();
+
+        std::string const m_path;
+        uint const m_atlas_size_px;
+        uint const m_glyph_size_px;
+        uint const m_sdf_size_px;
+        u64 const m_font_hash;
+
+        unique_ptr<MappedFile> m_file;
+        std::map<uint,u8 const *> m_lkup_pages;
+
+        shared_ptr<std::atomic<bool>> m_saving;
+        shared_ptr<ks::EventLoop> m_worker_event_loop;
+        std::thread m_worker_thread;
+    };
+}
+
+#endif // RAINTK_GLYPH_PAGE_STORE_HPP
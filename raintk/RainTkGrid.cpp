@@ -30,7 +30,9 @@ namespace raintk
     Grid::Grid(ks::Object::Key const &key,
                Scene* scene,
                shared_ptr<Widget> parent) :
-        Widget(key,scene,parent)
+        Widget(key,scene,parent),
+        m_dirty_index(0),
+        m_prev_item_count(0)
     {
 
     }
@@ -71,36 +73,44 @@ namespace raintk
 
     Grid::~Grid()
     {
-
+        // The child connections capture this Grid so they
+        // must be removed in case the children outlive it
+        for(auto& item : m_list_items)
+        {
+            item.widget->width.signal_changed.Disconnect(item.cid_width);
+            item.widget->height.signal_changed.Disconnect(item.cid_height);
+        }
     }
 
     void Grid::AddChild(shared_ptr<Widget> const &child)
     {
         Widget::AddChild(child);
 
-        shared_ptr<Grid> this_grid =
-                std::static_pointer_cast<Grid>(
-                    shared_from_this());
+        Widget* child_ptr = child.get();
 
         Item new_item;
-
-        new_item.widget = child.get();
+        new_item.widget = child_ptr;
+        new_item.width = 0.0f;
+        new_item.height = 0.0f;
 
         new_item.cid_width =
                 child->width.signal_changed.Connect(
-                    this_grid,
-                    &Grid::onLayoutChanged,
-                    ks::ConnectionType::Direct);
+                    [this,child_ptr](){
+                        onChildDimsChanged(child_ptr);
+                    });
 
         new_item.cid_height =
                 child->height.signal_changed.Connect(
-                    this_grid,
-                    &Grid::onLayoutChanged,
-                    ks::ConnectionType::Direct);
+                    [this,child_ptr](){
+                        onChildDimsChanged(child_ptr);
+                    });
 
         // Save
-        auto it = m_list_items.insert(m_list_items.end(),new_item);
-        m_lkup_id_item_it.emplace(child->GetId(),it);
+        std::size_t const index = m_list_items.size();
+        m_list_items.push_back(new_item);
+        m_lkup_id_index.emplace(child->GetId(),index);
+
+        m_dirty_index = std::min(m_dirty_index,index);
 
         // Mark this widget as updated
         m_cmlist_update_data->GetComponent(m_entity_id).
@@ -109,19 +119,27 @@ namespace raintk
 
     void Grid::RemoveChild(shared_ptr<Widget> const &child)
     {
-        auto lkup_it = m_lkup_id_item_it.find(child->GetId());
-        if(lkup_it != m_lkup_id_item_it.end())
+        auto lkup_it = m_lkup_id_index.find(child->GetId());
+        if(lkup_it != m_lkup_id_index.end())
         {
-            auto it = lkup_it->second;
+            std::size_t const index = lkup_it->second;
+            auto& item = m_list_items[index];
+
+            item.widget->width.signal_changed.Disconnect(
+                        item.cid_width);
+
+            item.widget->height.signal_changed.Disconnect(
+                        item.cid_height);
 
-            it->widget->width.signal_changed.Disconnect(
-                        it->cid_width);
+            m_list_items.erase(m_list_items.begin()+index);
+            m_lkup_id_index.erase(lkup_it);
 
-            it->widget->height.signal_changed.Disconnect(
-                        it->cid_height);
+            for(std::size_t i=index; i < m_list_items.size(); i++)
+            {
+                m_lkup_id_index[m_list_items[i].widget->GetId()] = i;
+            }
 
-            m_list_items.erase(it);
-            m_lkup_id_item_it.erase(lkup_it);
+            m_dirty_index = std::min(m_dirty_index,index);
 
             m_cmlist_update_data->GetComponent(m_entity_id).
                     update |= UpdateData::UpdateWidget;
@@ -132,131 +150,289 @@ namespace raintk
 
     void Grid::onLayoutChanged()
     {
+        m_dirty_index = 0;
+
+        m_cmlist_update_data->GetComponent(m_entity_id).
+                update |= UpdateData::UpdateWidget;
+    }
+
+    void Grid::onChildDimsChanged(Widget* child)
+    {
+        auto lkup_it = m_lkup_id_index.find(child->GetId());
+        if(lkup_it != m_lkup_id_index.end() &&
+           lkup_it->second < m_dirty_index)
+        {
+            m_list_dirty_items.push_back(lkup_it->second);
+        }
+
         m_cmlist_update_data->GetComponent(m_entity_id).
                 update |= UpdateData::UpdateWidget;
     }
 
     void Grid::update()
     {
+        // Notify children once (see PropertyTransaction)
+        PropertyTransaction transaction;
+
         auto const layout_dirn_val = layout_direction.Get();
         auto const row_spacing_val = row_spacing.Get();
         auto const col_spacing_val = col_spacing.Get();
 
-        struct WidgetCell
-        {
-            uint c;
-            uint r;
-            Widget* widget;
-        };
-
-        std::vector<WidgetCell> list_widget_cells(m_list_items.size());
-        std::vector<float> list_col_w;
-        std::vector<float> list_row_h;
-
-        // Create widget cells
-        if(layout_dirn_val == LayoutDirection::LeftToRight ||
-           layout_dirn_val == LayoutDirection::RightToLeft)
+        bool const row_major =
+                (layout_dirn_val == LayoutDirection::LeftToRight ||
+                 layout_dirn_val == LayoutDirection::RightToLeft);
+
+        bool const mirror_x =
+                (layout_dirn_val == LayoutDirection::RightToLeft ||
+                 layout_dirn_val == LayoutDirection::TopToBottomRTL);
+
+        std::size_t const item_count = m_list_items.size();
+        std::size_t const dirty_index = m_dirty_index;
+
+        // The number of cells along the primary layout direction
+        uint track_size=0;
+        if(row_major)
         {
-            uint const col_count = cols.Get();
-            if(col_count == 0) {
+            track_size = cols.Get();
+            if(track_size == 0) {
                 throw GridDimensionInvalid(
                             "Grid: Column count must be greater than 0");
             }
+        }
+        else
+        {
+            track_size = rows.Get();
+            if(track_size == 0) {
+                throw GridDimensionInvalid(
+                            "Grid: Row count must be greater than 0");
+            }
+        }
 
-            uint const full_row_count = (m_list_items.size()/col_count);
+        // Items fill a primary track (a row if row_major) before
+        // starting the next one
+        std::size_t const major_count = (item_count+track_size-1)/track_size;
+        std::size_t const col_count = row_major ? track_size : major_count;
+        std::size_t const row_count = row_major ? major_count : track_size;
 
-            list_col_w.resize(col_count,0);
-            list_row_h.resize(full_row_count+1,0);
+        auto get_col =
+                [row_major,track_size](std::size_t i) -> std::size_t {
+                    return row_major ? (i%track_size) : (i/track_size);
+                };
 
-            uint item_count=0;
+        auto get_row =
+                [row_major,track_size](std::size_t i) -> std::size_t {
+                    return row_major ? (i/track_size) : (i%track_size);
+                };
 
-            for(auto& item : m_list_items)
-            {
-                auto& cell = list_widget_cells[item_count];
-                cell.c = item_count%col_count;
-                cell.r = item_count/col_count;
-                cell.widget = item.widget;
+        // The layout params changed, so every size is stale
+        if(dirty_index == 0)
+        {
+            m_list_col_size.clear();
+            m_list_row_size.clear();
+            m_list_col_x.clear();
+            m_list_row_y.clear();
+        }
 
-                item_count++;
+        std::size_t const prev_col_count =
+                m_list_col_x.empty() ? 0 : m_list_col_x.size()-1;
+
+        std::size_t const prev_row_count =
+                m_list_row_y.empty() ? 0 : m_list_row_y.size()-1;
+
+        m_list_col_size.resize(col_count,0);
+        m_list_row_size.resize(row_count,0);
+
+        // Find the columns and rows that have to be rescanned.
+        // Items from dirty_index on may be in a different cell,
+        // and the cells they left behind may now be empty.
+        std::vector<bool> list_col_dirty(col_count,false);
+        std::vector<bool> list_row_dirty(row_count,false);
+
+        auto mark_cell =
+                [&](std::size_t i)
+                {
+                    std::size_t const c = get_col(i);
+                    std::size_t const r = get_row(i);
+                    if(c < col_count) {
+                        list_col_dirty[c] = true;
+                    }
+                    if(r < row_count) {
+                        list_row_dirty[r] = true;
+                    }
+                };
+
+        std::size_t const cell_end = std::max(item_count,m_prev_item_count);
+        for(std::size_t i=dirty_index; i < cell_end; i++)
+        {
+            if(i < item_count)
+            {
+                auto& item = m_list_items[i];
+                item.width = item.widget->width.Get();
+                item.height = item.widget->height.Get();
             }
+            mark_cell(i);
         }
-        else
+
+        for(auto const i : m_list_dirty_items)
         {
-            uint const row_count = rows.Get();
-            if(row_count == 0) {
-                throw GridDimensionInvalid(
-                            "Grid: Row count must be greater than 0");
+            if(i < dirty_index)
+            {
+                auto& item = m_list_items[i];
+                item.width = item.widget->width.Get();
+                item.height = item.widget->height.Get();
+                mark_cell(i);
             }
+        }
 
-            uint const full_col_count = (m_list_items.size()/row_count);
-            list_col_w.resize(full_col_count+1,0);
-            list_row_h.resize(row_count,0);
-
-            uint item_count=0;
+        // Rescan the marked columns and rows. This only reads
+        // the cached dims of the items in each of them.
+        std::size_t first_col_changed = std::min(col_count,prev_col_count);
+        for(std::size_t c=0; c < col_count; c++)
+        {
+            if(!list_col_dirty[c])
+            {
+                continue;
+            }
 
-            for(auto& item : m_list_items)
+            float size = 0;
+            for(std::size_t i = row_major ? c : c*track_size;
+                i < item_count && get_col(i) == c;
+                i += (row_major ? track_size : 1))
             {
-                auto& cell = list_widget_cells[item_count];
-                cell.c = item_count/row_count;
-                cell.r = item_count%row_count;
-                cell.widget = item.widget;
+                size = std::max(size,m_list_items[i].width+row_spacing_val);
+            }
 
-                item_count++;
+            if(size != m_list_col_size[c])
+            {
+                m_list_col_size[c] = size;
+                first_col_changed = std::min(first_col_changed,c);
             }
         }
 
-        // Set cell dimensions based on max item dims
-        for(auto& cell : list_widget_cells)
+        std::size_t first_row_changed = std::min(row_count,prev_row_count);
+        for(std::size_t r=0; r < row_count; r++)
         {
-            list_col_w[cell.c] =
-                    std::max(
-                        list_col_w[cell.c],
-                        cell.widget->width.Get()+row_spacing_val);
-
-            list_row_h[cell.r] =
-                    std::max(
-                        list_row_h[cell.r],
-                        cell.widget->height.Get()+col_spacing_val);
+            if(!list_row_dirty[r])
+            {
+                continue;
+            }
+
+            float size = 0;
+            for(std::size_t i = row_major ? r*track_size : r;
+                i < item_count && get_row(i) == r;
+                i += (row_major ? 1 : track_size))
+            {
+                size = std::max(size,m_list_items[i].height+col_spacing_val);
+            }
+
+            if(size != m_list_row_size[r])
+            {
+                m_list_row_size[r] = size;
+                first_row_changed = std::min(first_row_changed,r);
+            }
         }
 
-        // Accumulate cell dimensions
-        float w_acc=0;
-        for(auto& w : list_col_w)
+        // Accumulate from the first column and row that changed
+        m_list_col_x.resize(col_count+1,0);
+        for(std::size_t c=first_col_changed; c < col_count; c++)
         {
-            w += w_acc;
-            w_acc = w;
+            m_list_col_x[c+1] = m_list_col_x[c]+m_list_col_size[c];
         }
-        children_width = w_acc-row_spacing_val;
 
-        float h_acc=0;
-        for(auto& h : list_row_h)
+        m_list_row_y.resize(row_count+1,0);
+        for(std::size_t r=first_row_changed; r < row_count; r++)
         {
-            h += h_acc;
-            h_acc = h;
+            m_list_row_y[r+1] = m_list_row_y[r]+m_list_row_size[r];
         }
-        children_height = h_acc-col_spacing_val;
 
-        // Position items
-        if(layout_dirn_val == LayoutDirection::LeftToRight ||
-           layout_dirn_val == LayoutDirection::TopToBottomLTR)
+        float const prev_grid_width = children_width.Get();
+        float const grid_width = m_list_col_x.back()-row_spacing_val;
+        children_width = grid_width;
+        children_height = m_list_row_y.back()-col_spacing_val;
+
+        auto position_item =
+                [&](std::size_t i)
+                {
+                    auto const &item = m_list_items[i];
+
+                    float x = m_list_col_x[get_col(i)];
+                    if(mirror_x)
+                    {
+                        // Mirror x for RTL layouts
+                        x = ((x+item.width)*-1.0f)+grid_width;
+                    }
+
+                    float const y = m_list_row_y[get_row(i)];
+
+                    if(item.widget->x.Get() != x)
+                    {
+                        item.widget->x = x;
+                    }
+
+                    if(item.widget->y.Get() != y)
+                    {
+                        item.widget->y = y;
+                    }
+                };
+
+        if(mirror_x && grid_width != prev_grid_width)
         {
-            for(auto& cell : list_widget_cells)
+            // Every mirrored x depends on the grid width
+            for(std::size_t i=0; i < item_count; i++)
             {
-                cell.widget->x = (cell.c > 0) ? list_col_w[cell.c-1] : 0;
-                cell.widget->y = (cell.r > 0) ? list_row_h[cell.r-1] : 0;
+                position_item(i);
             }
         }
         else
         {
-            float const grid_width = w_acc-row_spacing_val;
+            // The offsets of the columns and rows after the first
+            // one that changed size have moved. Primary tracks
+            // are contiguous runs of items, the others are strided.
+            std::size_t const major_moved =
+                    (row_major ? first_row_changed : first_col_changed)+1;
+
+            std::size_t const minor_moved =
+                    (row_major ? first_col_changed : first_row_changed)+1;
+
+            std::size_t const major_start =
+                    std::min(item_count,major_moved*track_size);
+
+            for(std::size_t i=major_start; i < item_count; i++)
+            {
+                position_item(i);
+            }
+
+            for(std::size_t m=0;
+                minor_moved < track_size && m*track_size < major_start;
+                m++)
+            {
+                for(std::size_t n=minor_moved; n < track_size; n++)
+                {
+                    std::size_t const i = m*track_size+n;
+                    if(i < major_start)
+                    {
+                        position_item(i);
+                    }
+                }
+            }
 
-            for(auto& cell : list_widget_cells)
+            // Items that changed cells or dims
+            for(std::size_t i=dirty_index; i < major_start; i++)
             {
-                // Mirror x for RTL layouts
-                float x = (cell.c > 0) ? list_col_w[cell.c-1] : 0;
-                cell.widget->x = ((x+cell.widget->width.Get())*-1.0)+grid_width;
-                cell.widget->y = (cell.r > 0) ? list_row_h[cell.r-1] : 0;
+                position_item(i);
+            }
+
+            for(auto const i : m_list_dirty_items)
+            {
+                if(i < major_start)
+                {
+                    position_item(i);
+                }
             }
         }
+
+        m_dirty_index = item_count;
+        m_list_dirty_items.clear();
+        m_prev_item_count = item_count;
     }
 }
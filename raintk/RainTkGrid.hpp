@@ -17,8 +17,8 @@
 #ifndef RAINTK_GRID_HPP
 #define RAINTK_GRID_HPP
 
-#include <map>
-#include <list>
+#include <vector>
+#include <unordered_map>
 #include <raintk/RainTkWidget.hpp>
 
 namespace raintk
@@ -90,6 +90,7 @@ namespace raintk
 
     protected:
         void onLayoutChanged();
+        void onChildDimsChanged(Widget* child);
 
         Id m_cid_layout_direction;
         Id m_cid_rows;
@@ -105,10 +106,31 @@ namespace raintk
             Widget* widget;
             Id cid_height;
             Id cid_width;
+
+            // Child dims as of the last update
+            float width;
+            float height;
         };
 
-        std::list<Item> m_list_items;
-        std::map<Id,std::list<Item>::iterator> m_lkup_id_item_it;
+        std::vector<Item> m_list_items;
+        std::unordered_map<Id,std::size_t> m_lkup_id_index;
+
+        // Column and row sizes (the max item dims plus
+        // spacing) and their prefix sums as of the last update
+        std::vector<float> m_list_col_size;
+        std::vector<float> m_list_row_size;
+        std::vector<float> m_list_col_x;
+        std::vector<float> m_list_row_y;
+
+        // Index of the first item whose cell or dims may have
+        // changed since the last update
+        std::size_t m_dirty_index;
+
+        // Items before m_dirty_index whose dims changed. Only
+        // their columns and rows are rescanned.
+        std::vector<std::size_t> m_list_dirty_items;
+
+        std::size_t m_prev_item_count;
     };
 
     // =========================================================== //
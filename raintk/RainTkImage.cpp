@@ -184,6 +184,12 @@ namespace raintk
         draw_data.key.SetClip(m_clip_id);
     }
 
+    void Image::onLayerIdUpdated()
+    {
+        auto& draw_data = m_cmlist_draw_data->GetComponent(m_entity_id);
+        draw_data.key.SetLayer(m_layer_id);
+    }
+
     void Image::onTransformUpdated()
     {
         m_upd_xf = true;
@@ -203,7 +209,7 @@ namespace raintk
     void Image::createDrawables()
     {
         // Destroy drawable resources fi they already exist
-        if(m_scene->GetEntityHasComponents<DrawData>(m_entity_id))
+        if(m_cmlist_draw_data->GetHasComponent(m_entity_id))
         {
             destroyDrawables();
         }
@@ -254,6 +260,7 @@ namespace raintk
         auto draw_key = g_draw_key;
         draw_key.SetUniformSet(m_uniform_set_id);
         draw_key.SetTextureSet(m_texture_set_id);
+        draw_key.SetLayer(m_layer_id);
 
         // DrawData
         m_cmlist_draw_data->Create(
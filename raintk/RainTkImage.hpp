@@ -91,6 +91,7 @@ namespace raintk
         void onWidthChanged() override;
         void onHeightChanged() override;
         void onClipIdUpdated() override;
+        void onLayerIdUpdated() override;
         void onTransformUpdated() override;
         void onAccOpacityUpdated() override;
 
@@ -26,8 +26,8 @@ namespace raintk
                          shared_ptr<Widget> parent) :
         Widget(key,scene,parent),
         m_cmlist_input_data(
-            static_cast<InputDataComponentList*>(
-                m_scene->template GetComponentList<InputData>()))
+            m_scene->GetInputSystem()->
+            GetInputDataComponentList())
     {
 
     }
@@ -106,13 +106,12 @@ namespace raintk
     InputListener::~InputListener()
     {}
 
-    std::vector<InputArea::Point>
-    InputListener::GetInputs(TimePoint const &prev_upd_time,
-                             TimePoint const &curr_upd_time)
+    void InputListener::GetInputs(TimePoint const &prev_upd_time,
+                                  TimePoint const &curr_upd_time,
+                                  FrameVector<InputArea::Point>& list_all_points)
     {
-        // All input points for the delayed frame
-        std::vector<InputArea::Point> list_all_points;
-
+        // All input points for the delayed frame are
+        // appended to list_all_points
         uint const type_count = static_cast<uint>(InputType::TypeCount);
         for(uint type_idx=0; type_idx < type_count; type_idx++)
         {
@@ -141,41 +140,66 @@ namespace raintk
 
             auto target_time = target_frame.t1 - Milliseconds(1);
 
-            auto list_points =
-                    collectPointsInFrame(
+            std::size_t const first_point_idx = list_all_points.size();
+
+            collectPointsInFrame(
                         input_history,
-                        target_frame);
+                        target_frame,
+                        list_all_points);
 
 
             InputArea::Point ip_point;
             if(sampleInputHistory(input_history,target_time,ip_point))
             {
-                if(list_points.empty())
+                if(list_all_points.size() == first_point_idx)
                 {
                     // Add an estimated input point if this frame has
                     // no inputs to make input position updating smoother
-                    list_points.push_back(ip_point);
+                    list_all_points.push_back(ip_point);
                 }
                 else
                 {
-                    for(auto& pt : list_points)
+                    for(std::size_t i=first_point_idx; i < list_all_points.size(); i++)
                     {
-                        pt.x = ip_point.x;
-                        pt.y = ip_point.y;
+                        list_all_points[i].x = ip_point.x;
+                        list_all_points[i].y = ip_point.y;
                     }
                 }
             }
-
-            // Save the points
-            list_all_points.insert(
-                        list_all_points.end(),
-                        list_points.begin(),
-                        list_points.end());
         }
 
         m_frame++;
+    }
+
+    void InputListener::GetInputHistory(
+            InputArea::Point::Type type,
+            TimePoint const &t0,
+            TimePoint const &t1,
+            std::vector<InputArea::Point>& list_points) const
+    {
+        auto const &input_history =
+                m_lkup_input_history[static_cast<uint>(type)];
 
-        return list_all_points;
+        for(auto const &p : input_history)
+        {
+            if(p.point.timestamp >= t0 && p.point.timestamp <= t1)
+            {
+                list_points.push_back(p.point);
+            }
+        }
+    }
+
+    bool InputListener::GetHasBufferedInputs() const
+    {
+        for(auto const &input_history : m_lkup_input_history)
+        {
+            if(!input_history.empty())
+            {
+                return true;
+            }
+        }
+
+        return false;
     }
 
     shared_ptr<Widget> InputListener::GetWidgetWithInputFocus() const
@@ -277,12 +301,11 @@ namespace raintk
                     input_history.end());
     }
 
-    std::vector<InputArea::Point>
-    InputListener::collectPointsInFrame(
+    void InputListener::collectPointsInFrame(
             std::vector<HistoryPoint>& input_history,
-            Frame const &frame)
+            Frame const &frame,
+            FrameVector<InputArea::Point>& list_points)
     {
-        std::vector<InputArea::Point> list_points;
         for(auto& p : input_history)
         {
             if(p.frame_num == frame.num)
@@ -290,8 +313,6 @@ namespace raintk
                 list_points.push_back(p.point);
             }
         }
-
-        return list_points;
     }
 
     bool InputListener::sampleInputHistory(
@@ -16,6 +16,7 @@
 
 #include <raintk/RainTkGlobal.hpp>
 #include <raintk/RainTkInputArea.hpp>
+#include <raintk/RainTkFrameArena.hpp>
 #include <ks/gui/KsGuiInput.hpp>
 
 namespace ks
@@ -56,11 +57,28 @@ namespace raintk
 
         ~InputListener();
 
-        // Should be called every frame
-        std::vector<InputArea::Point>
-        GetInputs(TimePoint const &prev_upd_time,
-                  TimePoint const &curr_upd_time);
-
+        // * Should be called every frame
+        // * Appends the input points for the frame to @list_points
+        void GetInputs(TimePoint const &prev_upd_time,
+                       TimePoint const &curr_upd_time,
+                       FrameVector<InputArea::Point>& list_points);
+
+        // * Appends the raw input points of @type with timestamps
+        //   in [@t0,@t1] to @list_points, oldest first
+        // * Unlike GetInputs, positions aren't interpolated and
+        //   every sample is kept, but only for the last few
+        //   frames (the input buffer size)
+        void GetInputHistory(
+                InputArea::Point::Type type,
+                TimePoint const &t0,
+                TimePoint const &t1,
+                std::vector<InputArea::Point>& list_points) const;
+
+
+        // Returns true if there are buffered mouse or touch
+        // points, ie. GetInputs may still return points for
+        // the next few frames
+        bool GetHasBufferedInputs() const;
 
         shared_ptr<Widget> GetWidgetWithInputFocus() const;
 
@@ -81,9 +99,10 @@ namespace raintk
                 std::vector<HistoryPoint>& input_history,
                 Frame const &frame);
 
-        static std::vector<InputArea::Point> collectPointsInFrame(
+        static void collectPointsInFrame(
                 std::vector<HistoryPoint>& input_history,
-                Frame const &frame);
+                Frame const &frame,
+                FrameVector<InputArea::Point>& list_points);
 
         static bool sampleInputHistory(
                 std::vector<HistoryPoint>& input_history,
@@ -30,6 +30,57 @@ namespace raintk
 
     using InputType = InputArea::Point::Type;
 
+    namespace
+    {
+        // * Keeps only the last of each run of consecutive moves
+        //   for a pointer (mouse or touch index)
+        // * Presses and releases are never dropped and end a run,
+        //   so a move before a press is still dispatched before it
+        void CoalescePoints(FrameArena* frame_arena,
+                            FrameVector<InputArea::Point>& list_points)
+        {
+            uint const type_count = static_cast<uint>(InputType::TypeCount);
+            std::array<uint,type_count> lkup_move_idx;
+            lkup_move_idx.fill(std::numeric_limits<uint>::max());
+
+            FrameVector<bool> list_keep(list_points.size(),true,frame_arena);
+
+            for(uint i=0; i < list_points.size(); i++)
+            {
+                auto const &point = list_points[i];
+                uint const type_idx = static_cast<uint>(point.type);
+
+                if(point.action == InputArea::Point::Action::None)
+                {
+                    if(lkup_move_idx[type_idx] != std::numeric_limits<uint>::max())
+                    {
+                        list_keep[lkup_move_idx[type_idx]] = false;
+                    }
+                    lkup_move_idx[type_idx] = i;
+                }
+                else
+                {
+                    lkup_move_idx[type_idx] = std::numeric_limits<uint>::max();
+                }
+            }
+
+            uint keep_count=0;
+            for(uint i=0; i < list_points.size(); i++)
+            {
+                if(list_keep[i])
+                {
+                    if(keep_count != i)
+                    {
+                        list_points[keep_count] = list_points[i];
+                    }
+                    keep_count++;
+                }
+            }
+
+            list_points.resize(keep_count);
+        }
+    }
+
     class InputReplay : public raintk::Animation
     {
     public:
@@ -149,7 +200,7 @@ namespace raintk
         void complete() override
         {}
 
-        std::vector<InputArea::Point> GetPoints()
+        std::vector<InputArea::Point> const &GetPoints() const
         {
             return m_list_points;
         }
@@ -188,17 +239,9 @@ namespace raintk
         m_scene(scene),
         m_app(app)
     {
-        // Get the InputData mask
-        m_inputable_mask =
-                m_scene->template GetComponentMask<InputData,TransformData>();
-
         // Create the InputData component list
-        m_scene->template RegisterComponentList<InputData>(
-                    make_unique<InputDataComponentList>(*m_scene));
-
-        m_cmlist_input_data =
-                static_cast<InputDataComponentList*>(
-                    m_scene->template GetComponentList<InputData>());
+        m_cmlist_input_data = make_unique<InputDataComponentList>();
+        m_scene->RegisterDenseComponentList(m_cmlist_input_data.get());
 
         // Create the InputListener
         m_input_listener = ks::MakeObject<InputListener>(app);
@@ -217,8 +260,8 @@ namespace raintk
     void InputSystem::Update(TimePoint const &prev_upd_time,
                              TimePoint const &curr_upd_time)
     {
-        auto& list_entities = m_scene->GetEntityList();
-        auto& list_input_data = m_cmlist_input_data->GetSparseList();
+        auto const &list_input_data = m_cmlist_input_data->GetDenseList();
+        auto const &list_input_ent_ids = m_cmlist_input_data->GetDenseIds();
 
         auto const & list_xf_data =
                 static_cast<TransformDataComponentList*>(
@@ -227,22 +270,21 @@ namespace raintk
 
         m_list_input_areas_by_depth.clear();
 
-        for(uint ent_id=0; ent_id < list_entities.size(); ent_id++)
+        // Only entities with InputData are visited. They're all
+        // InputAreas so they always have TransformData as well
+        for(uint i=0; i < list_input_data.size(); i++)
         {
-            if((list_entities[ent_id].mask & m_inputable_mask)==m_inputable_mask)
-            {
-                auto& input_data = list_input_data[ent_id];
-                auto const &xf_data = list_xf_data[ent_id];
+            auto const &input_data = list_input_data[i];
+            auto const &xf_data = list_xf_data[list_input_ent_ids[i]];
 
-                // NOTE: We need to check if the transform data is valid.
-                // TransformData is invalid until the TransformSystem has
-                // updated it for the first time.
-                if(input_data.enabled && xf_data.valid)
-                {
-                    m_list_input_areas_by_depth.emplace_back(
-                                xf_data.world_xf[3].z,
-                                input_data.input_area);
-                }
+            // NOTE: We need to check if the transform data is valid.
+            // TransformData is invalid until the TransformSystem has
+            // updated it for the first time.
+            if(input_data.enabled && xf_data.valid)
+            {
+                m_list_input_areas_by_depth.emplace_back(
+                            xf_data.world_xf[3].z,
+                            input_data.input_area);
             }
         }
 
@@ -261,24 +303,48 @@ namespace raintk
         }
 
         // Get Input points
-        auto list_points =
-                m_input_listener->GetInputs(
-                    prev_upd_time,curr_upd_time);
+        auto frame_arena = m_scene->GetFrameArena();
+        FrameVector<InputArea::Point> list_points(frame_arena);
+
+        m_input_listener->GetInputs(
+                    prev_upd_time,curr_upd_time,list_points);
 
         if(m_input_replay)
         {
             // Overwrite points with replay data
-            list_points = m_input_replay->GetPoints();
+            auto const &list_replay_points = m_input_replay->GetPoints();
+            list_points.assign(
+                        list_replay_points.begin(),
+                        list_replay_points.end());
         }
 
-        while(list_points.empty()==false)
+        m_has_input = false;
+        for(auto const &point : list_points)
         {
-            for(uint i=0; i < m_list_input_areas_by_depth.size();)
+            if(!m_has_input || point.timestamp > m_last_input_time)
             {
-                auto input_area = m_list_input_areas_by_depth[i].second;
-                auto const &world_pt = list_points[0];
+                m_last_input_time = point.timestamp;
+                m_has_input = true;
+            }
+        }
+
+        // High rate mice and touchscreens can deliver many moves
+        // per frame. Only the latest position of each pointer
+        // matters for dispatching (the full history is still
+        // available through GetInputHistory)
+        CoalescePoints(frame_arena,list_points);
+
+        for(auto const &world_pt : list_points)
+        {
+            glm::vec2 world_xy(world_pt.x,world_pt.y);
+
+            // Try each point with InputAreas from front to back
+            // until one accepts it. Points that are rejected by
+            // all InputAreas are discarded.
+            for(auto const &depth_input_area : m_list_input_areas_by_depth)
+            {
+                auto input_area = depth_input_area.second;
 
-                glm::vec2 world_xy(world_pt.x,world_pt.y);
                 glm::vec2 local_xy = Widget::CalcLocalCoords(input_area,world_xy);
                 bool inside = Widget::CalcPointInside(input_area,world_xy,local_xy);
 
@@ -290,42 +356,16 @@ namespace raintk
 
                 if(response == InputArea::Response::Accept)
                 {
-                    list_points.erase(list_points.begin());
-
-                    if(list_points.empty())
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        // Start back at the beginning
-                        i=0;
-                    }
-                }
-                else
-                {
-                    // Try the current point with
-                    // the next InputArea
-                    i++;
+                    break;
                 }
             }
-
-            if(list_points.empty())
-            {
-                break;
-            }
-
-            // When we get here the first entry in list_points
-            // has been rejected by all InputAreas. Discard it
-            // and try from the beginning with the next point.
-            list_points.erase(list_points.begin());
         }
     }
 
     InputDataComponentList*
     InputSystem::GetInputDataComponentList() const
     {
-        return m_cmlist_input_data;
+        return m_cmlist_input_data.get();
     }
 
     std::vector<std::pair<float,InputArea*>> const &
@@ -334,6 +374,31 @@ namespace raintk
         return m_list_input_areas_by_depth;
     }
 
+    bool InputSystem::GetLastInputTime(TimePoint& input_time) const
+    {
+        if(m_has_input)
+        {
+            input_time = m_last_input_time;
+        }
+
+        return m_has_input;
+    }
+
+    bool InputSystem::GetHasPendingInputs() const
+    {
+        return (m_input_replay != nullptr ||
+                m_input_listener->GetHasBufferedInputs());
+    }
+
+    void InputSystem::GetInputHistory(
+            InputArea::Point::Type type,
+            TimePoint const &t0,
+            TimePoint const &t1,
+            std::vector<InputArea::Point>& list_points) const
+    {
+        m_input_listener->GetInputHistory(type,t0,t1,list_points);
+    }
+
     shared_ptr<Widget> InputSystem::GetWidgetWithInputFocus() const
     {
         return m_input_listener->GetWidgetWithInputFocus();
@@ -342,11 +407,13 @@ namespace raintk
     void InputSystem::SetInputFocus(shared_ptr<Widget> const &focus_widget)
     {
         m_input_listener->SetInputFocus(focus_widget);
+        m_scene->RequestUpdate();
     }
 
     void InputSystem::ClearInputFocus()
     {
         m_input_listener->ClearInputFocus();
+        m_scene->RequestUpdate();
     }
 
     void InputSystem::StartInputRecording(std::string const &file_name)
@@ -19,6 +19,7 @@
 
 #include <ks/draw/KsDrawSystem.hpp>
 #include <raintk/RainTkComponents.hpp>
+#include <raintk/RainTkInputArea.hpp>
 
 namespace ks
 {
@@ -57,6 +58,28 @@ namespace raintk
         std::vector<std::pair<float,InputArea*>> const &
         GetInputAreasByDepth() const;
 
+        // * Sets @input_time to the timestamp of the most recent
+        //   input point handled during the last Update
+        // * Returns false if no input points were handled
+        bool GetLastInputTime(TimePoint& input_time) const;
+
+        // Returns true if there are inputs that haven't been
+        // handled yet (or input playback is running), so that
+        // the next frame needs an Update
+        bool GetHasPendingInputs() const;
+
+        // * Appends the raw mouse or touch points of @type with
+        //   timestamps in [@t0,@t1] to @list_points, oldest first
+        // * Update only dispatches one move per pointer each frame,
+        //   this keeps every sample for the last few frames for
+        //   things like estimating velocity
+        // * Doesn't include points from input playback
+        void GetInputHistory(
+                InputArea::Point::Type type,
+                TimePoint const &t0,
+                TimePoint const &t1,
+                std::vector<InputArea::Point>& list_points) const;
+
         shared_ptr<Widget> GetWidgetWithInputFocus() const;
 
         // * Set which Widget has Input focus or clear it
@@ -76,14 +99,16 @@ namespace raintk
 
         Scene* const m_scene;
         ks::gui::Application* const m_app;
-        uint m_inputable_mask;
-        InputDataComponentList* m_cmlist_input_data;
+        unique_ptr<InputDataComponentList> m_cmlist_input_data;
 
         shared_ptr<InputRecorder> m_input_recorder;
         shared_ptr<InputListener> m_input_listener;
         shared_ptr<InputReplay> m_input_replay;
 
         std::vector<std::pair<float,InputArea*>> m_list_input_areas_by_depth;
+
+        bool m_has_input{false};
+        TimePoint m_last_input_time;
     };
 }
 
@@ -25,4 +25,221 @@ namespace raintk
     ListModelSizeIsFixed::ListModelSizeIsFixed() :
         ks::Exception(ks::Exception::ErrorLevel::ERROR,"",false)
     {}
+
+    ListModelInvalidChanges::ListModelInvalidChanges(std::string msg) :
+        ks::Exception(ks::Exception::ErrorLevel::ERROR,msg)
+    {}
+
+    // =========================================================== //
+
+    void ListModelChangeSet::AddInsert(uint idx_before, uint count)
+    {
+        if(count == 0)
+        {
+            return;
+        }
+
+        if(!m_list_changes.empty())
+        {
+            auto& last = m_list_changes.back();
+
+            // Merge with an insert that this one is
+            // within or directly next to
+            if(last.type == ListModelChange::Type::Insert &&
+               idx_before >= last.index &&
+               idx_before <= last.index+last.count)
+            {
+                last.count += count;
+                return;
+            }
+        }
+
+        m_list_changes.push_back(
+                    ListModelChange{
+                        ListModelChange::Type::Insert,
+                        idx_before,
+                        count,
+                        0});
+    }
+
+    void ListModelChangeSet::AddRemove(uint idx_first, uint idx_after_last)
+    {
+        if(idx_after_last <= idx_first)
+        {
+            return;
+        }
+
+        uint const count = idx_after_last-idx_first;
+
+        if(!m_list_changes.empty())
+        {
+            auto& last = m_list_changes.back();
+
+            if(last.type == ListModelChange::Type::Remove)
+            {
+                // Removing the items that followed the last
+                // removed range
+                if(idx_first == last.index)
+                {
+                    last.count += count;
+                    return;
+                }
+
+                // Removing the items that preceded it
+                if(idx_after_last == last.index)
+                {
+                    last.index = idx_first;
+                    last.count += count;
+                    return;
+                }
+            }
+        }
+
+        m_list_changes.push_back(
+                    ListModelChange{
+                        ListModelChange::Type::Remove,
+                        idx_first,
+                        count,
+                        0});
+    }
+
+    void ListModelChangeSet::AddMove(uint idx_first,
+                                     uint idx_after_last,
+                                     uint idx_to)
+    {
+        if(idx_after_last <= idx_first || idx_to == idx_first)
+        {
+            return;
+        }
+
+        m_list_changes.push_back(
+                    ListModelChange{
+                        ListModelChange::Type::Move,
+                        idx_first,
+                        idx_after_last-idx_first,
+                        idx_to});
+    }
+
+    void ListModelChangeSet::AddUpdate(uint index)
+    {
+        if(!m_list_changes.empty())
+        {
+            auto& last = m_list_changes.back();
+
+            if(last.type == ListModelChange::Type::Update)
+            {
+                if(index >= last.index &&
+                   index < last.index+last.count)
+                {
+                    return;
+                }
+
+                if(index == last.index+last.count)
+                {
+                    last.count++;
+                    return;
+                }
+
+                if(index+1 == last.index)
+                {
+                    last.index = index;
+                    last.count++;
+                    return;
+                }
+            }
+        }
+
+        m_list_changes.push_back(
+                    ListModelChange{
+                        ListModelChange::Type::Update,
+                        index,
+                        1,
+                        0});
+    }
+
+    std::vector<ListModelChange> const & ListModelChangeSet::GetChanges() const
+    {
+        return m_list_changes;
+    }
+
+    bool ListModelChangeSet::GetEmpty() const
+    {
+        return m_list_changes.empty();
+    }
+
+    void ListModelChangeSet::Clear()
+    {
+        m_list_changes.clear();
+    }
+
+    bool ListModelChangeSet::MapIndex(uint& index, bool& updated) const
+    {
+        bool moved = false;
+        return MapIndex(index,updated,moved);
+    }
+
+    bool ListModelChangeSet::MapIndex(uint& index, bool& updated, bool& moved) const
+    {
+        for(auto const &change : m_list_changes)
+        {
+            uint const idx_end = change.index+change.count;
+
+            switch(change.type)
+            {
+                case ListModelChange::Type::Insert:
+                {
+                    if(index >= change.index)
+                    {
+                        index += change.count;
+                    }
+                    break;
+                }
+                case ListModelChange::Type::Remove:
+                {
+                    if(index >= idx_end)
+                    {
+                        index -= change.count;
+                    }
+                    else if(index >= change.index)
+                    {
+                        return false;
+                    }
+                    break;
+                }
+                case ListModelChange::Type::Move:
+                {
+                    if(index >= change.index && index < idx_end)
+                    {
+                        index = change.index_to+(index-change.index);
+                        moved = true;
+                    }
+                    else
+                    {
+                        // Take the moved items out, then put
+                        // them back in at index_to
+                        if(index >= idx_end)
+                        {
+                            index -= change.count;
+                        }
+
+                        if(index >= change.index_to)
+                        {
+                            index += change.count;
+                        }
+                    }
+                    break;
+                }
+                case ListModelChange::Type::Update:
+                {
+                    if(index >= change.index && index < idx_end)
+                    {
+                        updated = true;
+                    }
+                    break;
+                }
+            }
+        }
+
+        return true;
+    }
 }
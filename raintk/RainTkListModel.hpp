@@ -37,6 +37,64 @@ namespace raintk
         ~ListModelSizeIsFixed() = default;
     };
 
+    class ListModelInvalidChanges : public ks::Exception
+    {
+    public:
+        ListModelInvalidChanges(std::string msg);
+        ~ListModelInvalidChanges() = default;
+    };
+
+    // =========================================================== //
+
+    struct ListModelChange
+    {
+        enum class Type : u8
+        {
+            Insert,
+            Remove,
+            Move,
+            Update
+        };
+
+        Type type;
+        uint index; // first item
+        uint count;
+        uint index_to; // Move: new index of the first item
+    };
+
+    // ListModelChangeSet
+    // * A list of changes made to a ListModel, in the order
+    //   they were made. The indices of each change are for
+    //   the model as it was right before that change.
+    // * Adjacent changes of the same type are merged, so ie.
+    //   appending items one at a time results in a single
+    //   Insert change
+    class ListModelChangeSet
+    {
+    public:
+        void AddInsert(uint idx_before, uint count);
+        void AddRemove(uint idx_first, uint idx_after_last);
+        void AddMove(uint idx_first, uint idx_after_last, uint idx_to);
+        void AddUpdate(uint index);
+
+        std::vector<ListModelChange> const & GetChanges() const;
+        bool GetEmpty() const;
+        void Clear();
+
+        // * Maps @index from the model before these changes to
+        //   the model after them
+        // * Returns false if the item was removed
+        // * @updated is set if the item's data was changed
+        // * @moved is set if the item was part of a Move
+        bool MapIndex(uint& index, bool& updated) const;
+        bool MapIndex(uint& index, bool& updated, bool& moved) const;
+
+    private:
+        std::vector<ListModelChange> m_list_changes;
+    };
+
+    // =========================================================== //
+
 
     template<typename T>
     class ListModel
@@ -65,8 +123,14 @@ namespace raintk
         // (like after a sort)
         ks::Signal<> signal_layout_changed;
 
+        // Emitted once for all of the changes made between
+        // BeginChanges and EndChanges, and for every Move
+        ks::Signal<shared_ptr<ListModelChangeSet const>> signal_changes;
+
 
-        ListModel() {}
+        ListModel() :
+            m_change_set(make_shared<ListModelChangeSet>())
+        {}
 
         ~ListModel() {}
 
@@ -118,6 +182,136 @@ namespace raintk
             throw ListModelSizeIsFixed();
         }
 
+        // Called by views with the range of items they currently
+        // have delegates for, so that models which load their
+        // items on demand can prioritize them
+        virtual void SetViewRange(uint idx_first, uint idx_end)
+        {
+            (void)idx_first;
+            (void)idx_end;
+        }
+
+        // Moves the items in [@idx_first,@idx_after_last) so
+        // that the first item is at @idx_to afterwards
+        virtual void Move(uint idx_first, uint idx_after_last, uint idx_to)
+        {
+            (void)idx_first;
+            (void)idx_after_last;
+            (void)idx_to;
+            throw ListModelItemsAreReadOnly();
+        }
+
+        // * Changes made between BeginChanges and EndChanges are
+        //   collected into a single ListModelChangeSet that is
+        //   emitted with signal_changes by EndChanges. None of the
+        //   per item signals are emitted in the meantime.
+        // * Calls can be nested; the changes are emitted by the
+        //   outermost EndChanges
+        void BeginChanges()
+        {
+            m_change_depth++;
+        }
+
+        void EndChanges()
+        {
+            if(m_change_depth == 0)
+            {
+                throw ListModelInvalidChanges(
+                            "ListModel: EndChanges called without "
+                            "BeginChanges");
+            }
+
+            m_change_depth--;
+
+            if(m_change_depth == 0)
+            {
+                emitChanges();
+            }
+        }
+
+    protected:
+        // Models should report their changes with these instead
+        // of emitting the signals directly so that they can be
+        // collected between BeginChanges and EndChanges
+        void notifyBeforeAddingItems(uint idx_before, uint count)
+        {
+            if(m_change_depth == 0)
+            {
+                signal_before_adding_items.Emit(idx_before,count);
+            }
+        }
+
+        void notifyAddedItems(uint idx_first_added, uint idx_end_added)
+        {
+            if(m_change_depth == 0)
+            {
+                signal_added_items.Emit(idx_first_added,idx_end_added);
+                return;
+            }
+
+            m_change_set->AddInsert(
+                        idx_first_added,
+                        idx_end_added-idx_first_added);
+        }
+
+        void notifyBeforeRemovingItems(uint idx_first_remove, uint idx_end_remove)
+        {
+            if(m_change_depth == 0)
+            {
+                signal_before_removing_items.Emit(idx_first_remove,idx_end_remove);
+                return;
+            }
+
+            m_change_set->AddRemove(idx_first_remove,idx_end_remove);
+        }
+
+        void notifyRemovedItems(uint idx_after_removed, uint count)
+        {
+            if(m_change_depth == 0)
+            {
+                signal_removed_items.Emit(idx_after_removed,count);
+            }
+        }
+
+        void notifyDataChanged(uint index)
+        {
+            if(m_change_depth == 0)
+            {
+                signal_data_changed.Emit(index);
+                return;
+            }
+
+            m_change_set->AddUpdate(index);
+        }
+
+        void notifyMovedItems(uint idx_first, uint idx_after_last, uint idx_to)
+        {
+            m_change_set->AddMove(idx_first,idx_after_last,idx_to);
+
+            if(m_change_depth == 0)
+            {
+                emitChanges();
+            }
+        }
+
+    private:
+        void emitChanges()
+        {
+            if(m_change_set->GetEmpty())
+            {
+                return;
+            }
+
+            shared_ptr<ListModelChangeSet const> change_set =
+                    std::move(m_change_set);
+
+            m_change_set = make_shared<ListModelChangeSet>();
+
+            signal_changes.Emit(change_set);
+        }
+
+        uint m_change_depth{0};
+        shared_ptr<ListModelChangeSet> m_change_set;
     };
 
 
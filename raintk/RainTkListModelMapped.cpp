@@ -0,0 +1,187 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+#include <raintk/RainTkListModelMapped.hpp>
+
+#ifdef _WIN32
+// wingdi.h defines ERROR, which clashes with ks::Exception
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace raintk
+{
+    ListModelMappedFileError::ListModelMappedFileError(std::string msg) :
+        ks::Exception(ks::Exception::ErrorLevel::ERROR,msg)
+    {}
+
+    // =========================================================== //
+
+#ifdef _WIN32
+    MappedFile::MappedFile(std::string const &path)
+    {
+        HANDLE file_handle =
+                CreateFileA(path.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            NULL,
+                            OPEN_EXISTING,
+                            FILE_FLAG_RANDOM_ACCESS,
+                            NULL);
+
+        if(file_handle == INVALID_HANDLE_VALUE)
+        {
+            throw ListModelMappedFileError(
+                        "MappedFile: Failed to open "+path);
+        }
+
+        LARGE_INTEGER file_size;
+        if(!GetFileSizeEx(file_handle,&file_size))
+        {
+            CloseHandle(file_handle);
+            throw ListModelMappedFileError(
+                        "MappedFile: Failed to get the size of "+path);
+        }
+
+        m_file_handle = file_handle;
+        m_size = file_size.QuadPart;
+
+        // Empty files can't be mapped
+        if(m_size == 0)
+        {
+            return;
+        }
+
+        HANDLE mapping_handle =
+                CreateFileMappingA(file_handle,
+                                   NULL,
+                                   PAGE_READONLY,
+                                   0,0,
+                                   NULL);
+
+        if(mapping_handle == NULL)
+        {
+            CloseHandle(file_handle);
+            throw ListModelMappedFileError(
+                        "MappedFile: Failed to map "+path);
+        }
+
+        m_mapping_handle = mapping_handle;
+
+        void* data = MapViewOfFile(mapping_handle,FILE_MAP_READ,0,0,0);
+        if(data == NULL)
+        {
+            CloseHandle(mapping_handle);
+            CloseHandle(file_handle);
+            throw ListModelMappedFileError(
+                        "MappedFile: Failed to map "+path);
+        }
+
+        m_data = static_cast<u8 const *>(data);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if(m_data)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if(m_mapping_handle)
+        {
+            CloseHandle(m_mapping_handle);
+        }
+        CloseHandle(m_file_handle);
+    }
+
+    void MappedFile::Prefetch(u64, u64) const
+    {
+        // FILE_FLAG_RANDOM_ACCESS already keeps the cache
+        // manager from reading far ahead of what's accessed
+    }
+#else
+    MappedFile::MappedFile(std::string const &path)
+    {
+        m_fd = open(path.c_str(),O_RDONLY);
+        if(m_fd < 0)
+        {
+            throw ListModelMappedFileError(
+                        "MappedFile: Failed to open "+path);
+        }
+
+        struct stat file_stat;
+        if(fstat(m_fd,&file_stat) != 0)
+        {
+            close(m_fd);
+            throw ListModelMappedFileError(
+                        "MappedFile: Failed to get the size of "+path);
+        }
+
+        m_size = file_stat.st_size;
+
+        // Empty files can't be mapped
+        if(m_size == 0)
+        {
+            return;
+        }
+
+        void* data = mmap(nullptr,m_size,PROT_READ,MAP_PRIVATE,m_fd,0);
+        if(data == MAP_FAILED)
+        {
+            close(m_fd);
+            throw ListModelMappedFileError(
+                        "MappedFile: Failed to map "+path);
+        }
+
+        // Views only touch a small part of the file at a
+        // time, so don't read far ahead of what's accessed
+        madvise(data,m_size,MADV_RANDOM);
+
+        m_data = static_cast<u8 const *>(data);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if(m_data)
+        {
+            munmap(const_cast<u8*>(m_data),m_size);
+        }
+        close(m_fd);
+    }
+
+    void MappedFile::Prefetch(u64 offset, u64 size) const
+    {
+        if(m_data == nullptr || offset >= m_size)
+        {
+            return;
+        }
+
+        // madvise needs a page aligned address
+        u64 const page_size = sysconf(_SC_PAGESIZE);
+        u64 const first = offset-(offset%page_size);
+        u64 const end = std::min(offset+size,m_size);
+
+        madvise(const_cast<u8*>(m_data)+first,end-first,MADV_WILLNEED);
+    }
+#endif
+}
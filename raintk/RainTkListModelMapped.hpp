@@ -0,0 +1,193 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef RAINTK_LIST_MODEL_MAPPED_HPP
+#define RAINTK_LIST_MODEL_MAPPED_HPP
+
+#include <type_traits>
+#include <raintk/RainTkListModel.hpp>
+
+namespace raintk
+{
+    class ListModelMappedFileError : public ks::Exception
+    {
+    public:
+        ListModelMappedFileError(std::string msg);
+        ~ListModelMappedFileError() = default;
+    };
+
+    // =========================================================== //
+
+    // MappedFile
+    // * A read only memory mapping of an entire file. Nothing
+    //   is read until the mapped memory is accessed, and then
+    //   only the pages that are touched.
+    class MappedFile final
+    {
+    public:
+        // Throws ListModelMappedFileError if the file
+        // can't be opened or mapped
+        MappedFile(std::string const &path);
+        ~MappedFile();
+
+        MappedFile(MappedFile const &) = delete;
+        MappedFile& operator=(MappedFile const &) = delete;
+
+        u8 const * GetData() const
+        {
+            return m_data;
+        }
+
+        u64 GetSize() const
+        {
+            return m_size;
+        }
+
+        // Hints that [@offset,@offset+@size) will be accessed
+        // soon so the OS can start reading it in
+        void Prefetch(u64 offset, u64 size) const;
+
+    private:
+        u8 const * m_data{nullptr};
+        u64 m_size{0};
+
+#ifdef _WIN32
+        void* m_file_handle{nullptr};
+        void* m_mapping_handle{nullptr};
+#else
+        int m_fd{-1};
+#endif
+    };
+
+    // =========================================================== //
+
+    // ListModelMappedString
+    // * A variable length string stored in a mapped file
+    //   outside of the fixed size records. Records reference
+    //   their strings with this, and the string is only
+    //   read when it's decoded with GetString.
+    struct ListModelMappedString
+    {
+        u64 offset; // from the start of the file
+        u64 size; // in bytes
+    };
+
+    // =========================================================== //
+
+    // ListModelMapped
+    // * A read only model over a memory mapped file of fixed
+    //   size records, so that large tables don't have to be
+    //   copied into memory
+    // * GetData returns references directly into the mapping
+    // * @RecordType must be a POD type that matches the layout
+    //   of the records in the file, including its byte order
+    template<typename RecordType>
+    class ListModelMapped final : public ListModel<RecordType>
+    {
+        static_assert(std::is_pod<RecordType>::value,
+                      "ListModelMapped: RecordType must be a POD type");
+
+    public:
+        // * The records start @records_offset bytes into the
+        //   file, which must be a multiple of the alignment
+        //   of RecordType
+        // * If @record_count is 0, the records run to the
+        //   end of the file
+        ListModelMapped(std::string const &path,
+                        u64 records_offset=0,
+                        uint record_count=0) :
+            m_file(path)
+        {
+            if(records_offset % alignof(RecordType) != 0)
+            {
+                throw ListModelMappedFileError(
+                            "ListModelMapped: Misaligned records in "+path);
+            }
+
+            if(records_offset > m_file.GetSize())
+            {
+                throw ListModelMappedFileError(
+                            "ListModelMapped: Records start past the end of "+path);
+            }
+
+            u64 const available_count =
+                    (m_file.GetSize()-records_offset)/sizeof(RecordType);
+
+            if(record_count == 0)
+            {
+                record_count = available_count;
+            }
+            else if(record_count > available_count)
+            {
+                throw ListModelMappedFileError(
+                            "ListModelMapped: Not enough records in "+path);
+            }
+
+            m_records = m_file.GetData()+records_offset;
+            m_size = record_count;
+        }
+
+        ~ListModelMapped() = default;
+
+        uint GetSize() const override
+        {
+            return m_size;
+        }
+
+        RecordType const & GetData(uint index) const override
+        {
+            return *reinterpret_cast<RecordType const *>(
+                        m_records+u64(index)*sizeof(RecordType));
+        }
+
+        void SetViewRange(uint idx_first, uint idx_end) override
+        {
+            if(idx_end <= idx_first || idx_end > m_size)
+            {
+                return;
+            }
+
+            m_file.Prefetch(
+                        (m_records-m_file.GetData())+u64(idx_first)*sizeof(RecordType),
+                        u64(idx_end-idx_first)*sizeof(RecordType));
+        }
+
+        // * Decodes a string referenced by a record
+        // * Throws ListModelMappedFileError if the string
+        //   isn't within the file
+        std::string GetString(ListModelMappedString const &string) const
+        {
+            if(string.offset > m_file.GetSize() ||
+               string.size > m_file.GetSize()-string.offset)
+            {
+                throw ListModelMappedFileError(
+                            "ListModelMapped: String out of bounds");
+            }
+
+            return std::string(
+                        reinterpret_cast<char const *>(
+                            m_file.GetData()+string.offset),
+                        string.size);
+        }
+
+    private:
+        MappedFile m_file;
+        u8 const * m_records{nullptr};
+        uint m_size{0};
+    };
+}
+
+#endif // RAINTK_LIST_MODEL_MAPPED_HPP
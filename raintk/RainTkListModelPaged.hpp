@@ -0,0 +1,402 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef RAINTK_LIST_MODEL_PAGED_HPP
+#define RAINTK_LIST_MODEL_PAGED_HPP
+
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <ks/KsEventLoop.hpp>
+#include <ks/KsTask.hpp>
+#include <raintk/RainTkListModel.hpp>
+#include <raintk/RainTkLog.hpp>
+
+namespace raintk
+{
+    // ListModelPageSource
+    // * Supplies the items of a ListModelPaged
+    template<typename DataType>
+    class ListModelPageSource
+    {
+    public:
+        virtual ~ListModelPageSource() {}
+
+        // Returns the total number of items. Called on the
+        // thread the model is used on.
+        virtual uint GetSize() = 0;
+
+        // * Appends the items [@idx_first,@idx_end) to @list_items
+        // * Called on the model's worker thread, one page at a
+        //   time. A page that throws is left unloaded and is
+        //   requested again the next time it's needed.
+        virtual void Fetch(uint idx_first,
+                           uint idx_end,
+                           std::vector<DataType>& list_items) = 0;
+    };
+
+    // =========================================================== //
+
+    // ListModelPaged
+    // * A read only model that loads its items in pages from a
+    //   ListModelPageSource on a worker thread, so only the
+    //   pages around the view have to be in memory
+    // * Items that aren't loaded yet return a placeholder.
+    //   signal_data_changed is emitted for each item of a
+    //   page once it has been loaded.
+    // * Pages are requested for the range a view reports with
+    //   SetViewRange and for any item GetData is called on.
+    //   Queued requests that have left the view range are
+    //   dropped before they're fetched.
+    // * The least recently used pages outside of the view range
+    //   are evicted once there are more than the page budget
+    // * Completed pages are handed back with tasks posted to
+    //   @event_loop, which must run on the thread the model
+    //   is used on
+    template<typename DataType>
+    class ListModelPaged final : public ListModel<DataType>
+    {
+    public:
+        ListModelPaged(shared_ptr<ks::EventLoop> event_loop,
+                       shared_ptr<ListModelPageSource<DataType>> source,
+                       DataType placeholder,
+                       uint page_size=64,
+                       uint page_budget=32) :
+            m_event_loop(std::move(event_loop)),
+            m_source(std::move(source)),
+            m_placeholder(std::move(placeholder)),
+            m_page_size(std::max<uint>(page_size,1)),
+            m_page_budget(std::max<uint>(page_budget,1)),
+            m_size(m_source->GetSize()),
+            m_alive(make_shared<bool>(true))
+        {
+            m_worker_event_loop = make_shared<ks::EventLoop>();
+            m_worker_thread = ks::EventLoop::LaunchInThread(m_worker_event_loop);
+        }
+
+        ~ListModelPaged()
+        {
+            for(auto& request : m_lkup_requests)
+            {
+                request.second->store(true);
+            }
+
+            ks::EventLoop::RemoveFromThread(
+                        m_worker_event_loop,
+                        m_worker_thread,
+                        true);
+        }
+
+
+        uint GetSize() const override
+        {
+            return m_size;
+        }
+
+        DataType const & GetData(uint index) const override
+        {
+            uint const page_index = index/m_page_size;
+
+            auto it = m_lkup_pages.find(page_index);
+            if(it == m_lkup_pages.end())
+            {
+                // Loading pages doesn't change what the
+                // model holds as far as its users can tell
+                const_cast<ListModelPaged*>(this)->requestPage(page_index);
+                return m_placeholder;
+            }
+
+            auto& page = it->second;
+            page.last_used = ++m_use_counter;
+
+            return page.list_items[index-page_index*m_page_size];
+        }
+
+        void SetViewRange(uint idx_first, uint idx_end) override
+        {
+            if(idx_end <= idx_first || m_size == 0)
+            {
+                m_view_page_first = 0;
+                m_view_page_end = 0;
+                return;
+            }
+
+            idx_end = std::min(idx_end,m_size);
+
+            // Keep a page on either side of the view loaded
+            uint const page_count = (m_size+m_page_size-1)/m_page_size;
+            uint const first = idx_first/m_page_size;
+            uint const end = (idx_end-1)/m_page_size+1;
+
+            m_view_page_first = (first > 0) ? first-1 : 0;
+            m_view_page_end = std::min(end+1,page_count);
+
+            // Drop queued requests that are no longer needed
+            for(auto it = m_lkup_requests.begin();
+                it != m_lkup_requests.end();)
+            {
+                if(!getPageInView(it->first))
+                {
+                    it->second->store(true);
+                    it = m_lkup_requests.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+
+            // Request the visible pages before the ones
+            // on either side of them
+            for(uint i=first; i < end; i++)
+            {
+                requestPage(i);
+            }
+
+            for(uint i=m_view_page_first; i < m_view_page_end; i++)
+            {
+                requestPage(i);
+            }
+        }
+
+
+        // * Sets the max number of pages that are kept loaded.
+        //   Pages in the view range are never evicted, so this
+        //   can be exceeded when the view is large.
+        void SetPageBudget(uint page_budget)
+        {
+            m_page_budget = std::max<uint>(page_budget,1);
+            evictPages();
+        }
+
+        uint GetPageSize() const
+        {
+            return m_page_size;
+        }
+
+        uint GetLoadedPageCount() const
+        {
+            return m_lkup_pages.size();
+        }
+
+        bool GetLoaded(uint index) const
+        {
+            return (m_lkup_pages.count(index/m_page_size) > 0);
+        }
+
+        // Drops all pages and reads the size from the source
+        // again; emits signal_layout_changed
+        void Reload()
+        {
+            for(auto& request : m_lkup_requests)
+            {
+                request.second->store(true);
+            }
+
+            m_lkup_requests.clear();
+            m_lkup_pages.clear();
+            m_size = m_source->GetSize();
+
+            this->signal_layout_changed.Emit();
+        }
+
+    private:
+        struct Page
+        {
+            std::vector<DataType> list_items;
+            u64 last_used;
+        };
+
+        // Set once a request is no longer needed
+        using RequestCancelled = std::atomic<bool>;
+
+        bool getPageInView(uint page_index) const
+        {
+            return (page_index >= m_view_page_first &&
+                    page_index < m_view_page_end);
+        }
+
+        void requestPage(uint page_index)
+        {
+            if(m_lkup_pages.count(page_index) ||
+               m_lkup_requests.count(page_index))
+            {
+                return;
+            }
+
+            auto cancelled = make_shared<RequestCancelled>(false);
+            m_lkup_requests.emplace(page_index,cancelled);
+
+            uint const idx_first = page_index*m_page_size;
+            uint const idx_end = std::min(idx_first+m_page_size,m_size);
+
+            auto source = m_source;
+            auto event_loop = m_event_loop;
+            weak_ptr<bool> weak_alive = m_alive;
+            auto this_model = this;
+
+            auto fetch_task =
+                    make_shared<ks::Task>(
+                        [=]()
+                        {
+                            if(cancelled->load())
+                            {
+                                return;
+                            }
+
+                            auto list_items = make_shared<std::vector<DataType>>();
+                            list_items->reserve(idx_end-idx_first);
+
+                            bool ok = true;
+                            try
+                            {
+                                source->Fetch(idx_first,idx_end,*list_items);
+                            }
+                            catch(std::exception const &e)
+                            {
+                                rtklog.Warn() << "ListModelPaged: Failed to fetch "
+                                              << "page " << page_index
+                                              << ": " << e.what();
+                                ok = false;
+                            }
+
+                            if(ok && list_items->size() != (idx_end-idx_first))
+                            {
+                                rtklog.Warn() << "ListModelPaged: Page "
+                                              << page_index << " has "
+                                              << list_items->size() << " items, "
+                                              << "expected " << (idx_end-idx_first);
+                                ok = false;
+                            }
+
+                            // Hand the page back on the model's thread
+                            auto loaded_task =
+                                    make_shared<ks::Task>(
+                                        [=]()
+                                        {
+                                            if(weak_alive.lock())
+                                            {
+                                                this_model->onPageLoaded(
+                                                            page_index,
+                                                            cancelled,
+                                                            ok ? list_items : nullptr);
+                                            }
+                                        });
+
+                            event_loop->PostTask(loaded_task);
+                        });
+
+            m_worker_event_loop->PostTask(fetch_task);
+        }
+
+        void onPageLoaded(uint page_index,
+                          shared_ptr<RequestCancelled> const &cancelled,
+                          shared_ptr<std::vector<DataType>> list_items)
+        {
+            auto it = m_lkup_requests.find(page_index);
+            if(it == m_lkup_requests.end() || it->second != cancelled)
+            {
+                // Stale request
+                return;
+            }
+
+            m_lkup_requests.erase(it);
+
+            if(!list_items)
+            {
+                return;
+            }
+
+            auto& page = m_lkup_pages[page_index];
+            page.list_items = std::move(*list_items);
+            page.last_used = ++m_use_counter;
+
+            evictPages();
+
+            uint const idx_first = page_index*m_page_size;
+            uint const idx_end = idx_first+page.list_items.size();
+
+            // Emitted as a single Update change
+            this->BeginChanges();
+            for(uint i=idx_first; i < idx_end; i++)
+            {
+                this->notifyDataChanged(i);
+            }
+            this->EndChanges();
+        }
+
+        void evictPages()
+        {
+            while(m_lkup_pages.size() > m_page_budget)
+            {
+                auto it_lru = m_lkup_pages.end();
+
+                for(auto it = m_lkup_pages.begin();
+                    it != m_lkup_pages.end(); ++it)
+                {
+                    if(getPageInView(it->first))
+                    {
+                        continue;
+                    }
+
+                    if(it_lru == m_lkup_pages.end() ||
+                       it->second.last_used < it_lru->second.last_used)
+                    {
+                        it_lru = it;
+                    }
+                }
+
+                if(it_lru == m_lkup_pages.end())
+                {
+                    // Everything left is in view
+                    break;
+                }
+
+                m_lkup_pages.erase(it_lru);
+            }
+        }
+
+
+        shared_ptr<ks::EventLoop> m_event_loop;
+        shared_ptr<ks::EventLoop> m_worker_event_loop;
+        std::thread m_worker_thread;
+
+        shared_ptr<ListModelPageSource<DataType>> m_source;
+        DataType const m_placeholder;
+        uint const m_page_size;
+        uint m_page_budget;
+        uint m_size;
+
+        // Tasks posted back to m_event_loop only run
+        // while this is alive
+        shared_ptr<bool> m_alive;
+
+        // The range of pages around the view [first,end)
+        uint m_view_page_first{0};
+        uint m_view_page_end{0};
+
+        // GetData is const but keeps track of page use
+        mutable u64 m_use_counter{0};
+        mutable std::unordered_map<uint,Page> m_lkup_pages;
+
+        std::unordered_map<
+            uint,
+            shared_ptr<RequestCancelled>
+        > m_lkup_requests;
+    };
+}
+
+#endif // RAINTK_LIST_MODEL_PAGED_HPP
@@ -17,6 +17,7 @@
 #ifndef RAINTK_LIST_MODEL_STL_VECTOR_HPP
 #define RAINTK_LIST_MODEL_STL_VECTOR_HPP
 
+#include <algorithm>
 #include <raintk/RainTkListModel.hpp>
 
 namespace raintk
@@ -48,55 +49,75 @@ namespace raintk
         void SetData(uint index, DataType const &data) override
         {
             m_list[index] = data;
-            this->signal_data_changed.Emit(index);
+            this->notifyDataChanged(index);
         }
 
 
         // This model can be resized
         void Insert(uint idx_before, DataType const &data) override
         {
-            this->signal_before_adding_items.Emit(idx_before,1);
+            this->notifyBeforeAddingItems(idx_before,1);
             m_list.insert(std::next(m_list.begin(),idx_before),data);
-            this->signal_added_items.Emit(idx_before,idx_before+1);
+            this->notifyAddedItems(idx_before,idx_before+1);
         }
 
         void Insert(uint idx_before, uint count, DataType const &data) override
         {
-            this->signal_before_adding_items.Emit(idx_before,count);
+            this->notifyBeforeAddingItems(idx_before,count);
             m_list.insert(std::next(m_list.begin(),idx_before),count,data);
-            this->signal_added_items.Emit(idx_before,idx_before+count);
+            this->notifyAddedItems(idx_before,idx_before+count);
         }
 
         void Insert(uint idx_before, std::vector<DataType> const &list_data) override
         {
-            this->signal_before_adding_items.Emit(idx_before,list_data.size());
+            this->notifyBeforeAddingItems(idx_before,list_data.size());
             m_list.insert(std::next(m_list.begin(),idx_before),
                           list_data.begin(),
                           list_data.end());
 
-            this->signal_added_items.Emit(
+            this->notifyAddedItems(
                         idx_before,
                         idx_before+list_data.size());
         }
 
         void Erase(uint idx) override
         {
-            this->signal_before_removing_items.Emit(idx,idx+1);
+            this->notifyBeforeRemovingItems(idx,idx+1);
             m_list.erase(std::next(m_list.begin(),idx));
-            this->signal_removed_items.Emit(idx,1);
+            this->notifyRemovedItems(idx,1);
         }
 
         void Erase(uint idx_first, uint idx_after_last) override
         {
-            this->signal_before_removing_items.Emit(idx_first,idx_after_last);
+            this->notifyBeforeRemovingItems(idx_first,idx_after_last);
             m_list.erase(std::next(m_list.begin(),idx_first),
                          std::next(m_list.begin(),idx_after_last));
 
-            this->signal_removed_items.Emit(
+            this->notifyRemovedItems(
                         idx_first,
                         idx_after_last-idx_first);
         }
 
+        void Move(uint idx_first, uint idx_after_last, uint idx_to) override
+        {
+            uint const count = idx_after_last-idx_first;
+
+            if(idx_to < idx_first)
+            {
+                std::rotate(std::next(m_list.begin(),idx_to),
+                            std::next(m_list.begin(),idx_first),
+                            std::next(m_list.begin(),idx_after_last));
+            }
+            else if(idx_to > idx_first)
+            {
+                std::rotate(std::next(m_list.begin(),idx_first),
+                            std::next(m_list.begin(),idx_after_last),
+                            std::next(m_list.begin(),idx_to+count));
+            }
+
+            this->notifyMovedItems(idx_first,idx_after_last,idx_to);
+        }
+
 
         // Supported vector methods
         void Reserve(uint capacity)
@@ -0,0 +1,973 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef RAINTK_LIST_MODEL_SORT_FILTER_PROXY_HPP
+#define RAINTK_LIST_MODEL_SORT_FILTER_PROXY_HPP
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <raintk/RainTkListModel.hpp>
+
+namespace raintk
+{
+    // ListModelSortFilterProxy
+    // * Presents the items of a source model sorted by a
+    //   comparator and/or filtered by a predicate
+    // * The proxy keeps maps between source and proxy indices
+    //   that are updated incrementally as the source changes,
+    //   and only the resulting adds, removes and moves are
+    //   emitted. Changes that affect more than one proxy item
+    //   are emitted as a single change set.
+    // * Items that compare equal keep their source order
+    // * Items can be changed with SetData but the proxy can't
+    //   be resized directly
+    // * Change sets emitted by the source are mapped to the
+    //   proxy and emitted as a single change set. Only the
+    //   items that were added, changed or moved are tested
+    //   and sorted again.
+    // * Layout changes of the source are handled by rebuilding
+    //   the proxy, which emits signal_layout_changed
+    template<typename DataType>
+    class ListModelSortFilterProxy final : public ListModel<DataType>
+    {
+    public:
+        using Comparator = std::function<bool(DataType const &,DataType const &)>;
+        using Predicate = std::function<bool(DataType const &)>;
+
+        ListModelSortFilterProxy(shared_ptr<ListModel<DataType>> source) :
+            m_source(std::move(source))
+        {
+            m_cid_added_items =
+                    m_source->signal_added_items.Connect(
+                        this,
+                        &ListModelSortFilterProxy::onSourceAddedItems,
+                        nullptr,
+                        ks::ConnectionType::Direct);
+
+            m_cid_before_removing_items =
+                    m_source->signal_before_removing_items.Connect(
+                        this,
+                        &ListModelSortFilterProxy::onSourceBeforeRemovingItems,
+                        nullptr,
+                        ks::ConnectionType::Direct);
+
+            m_cid_removed_items =
+                    m_source->signal_removed_items.Connect(
+                        this,
+                        &ListModelSortFilterProxy::onSourceRemovedItems,
+                        nullptr,
+                        ks::ConnectionType::Direct);
+
+            m_cid_data_changed =
+                    m_source->signal_data_changed.Connect(
+                        this,
+                        &ListModelSortFilterProxy::onSourceDataChanged,
+                        nullptr,
+                        ks::ConnectionType::Direct);
+
+            m_cid_layout_changed =
+                    m_source->signal_layout_changed.Connect(
+                        this,
+                        &ListModelSortFilterProxy::onSourceLayoutChanged,
+                        nullptr,
+                        ks::ConnectionType::Direct);
+
+            m_cid_changes =
+                    m_source->signal_changes.Connect(
+                        this,
+                        &ListModelSortFilterProxy::onSourceChanges,
+                        nullptr,
+                        ks::ConnectionType::Direct);
+
+            rebuild();
+        }
+
+        ~ListModelSortFilterProxy()
+        {
+            m_source->signal_added_items.Disconnect(m_cid_added_items);
+            m_source->signal_before_removing_items.Disconnect(m_cid_before_removing_items);
+            m_source->signal_removed_items.Disconnect(m_cid_removed_items);
+            m_source->signal_data_changed.Disconnect(m_cid_data_changed);
+            m_source->signal_layout_changed.Disconnect(m_cid_layout_changed);
+            m_source->signal_changes.Disconnect(m_cid_changes);
+        }
+
+
+        uint GetSize() const override
+        {
+            return m_list_proxy.size();
+        }
+
+        DataType const & GetData(uint index) const override
+        {
+            return m_source->GetData(m_list_proxy[index]);
+        }
+
+        // Writes through to the source model
+        void SetData(uint index, DataType const &data) override
+        {
+            m_source->SetData(m_list_proxy[index],data);
+        }
+
+
+        shared_ptr<ListModel<DataType>> const & GetSourceModel() const
+        {
+            return m_source;
+        }
+
+        uint GetSourceIndex(uint proxy_index) const
+        {
+            return m_list_proxy[proxy_index];
+        }
+
+        // Returns -1 if the source item is filtered out
+        sint GetProxyIndex(uint source_index) const
+        {
+            return m_list_source_to_proxy[source_index];
+        }
+
+        // * Sorts the proxy with @less. An empty comparator
+        //   keeps the source order.
+        // * The items that changed places are emitted as
+        //   Moves in a single change set
+        void SetComparator(Comparator less)
+        {
+            m_less = std::move(less);
+
+            if(m_less)
+            {
+                std::sort(m_list_order.begin(),
+                          m_list_order.end(),
+                          [this](uint a, uint b) {
+                              return orderLess(a,b);
+                          });
+            }
+            else
+            {
+                for(uint i=0; i < m_list_order.size(); i++)
+                {
+                    m_list_order[i] = i;
+                }
+            }
+
+            updateOrderMap(0,m_list_order.size());
+
+            std::vector<uint> list_proxy;
+            list_proxy.reserve(m_list_proxy.size());
+            for(auto source_index : m_list_order)
+            {
+                if(m_list_accepted[source_index])
+                {
+                    list_proxy.push_back(source_index);
+                }
+            }
+
+            this->BeginChanges();
+
+            // Build the new order front to back. Before placing
+            // item p, the model holds the p items placed so far
+            // followed by the rest in their old order, so the item
+            // is at p plus the number of unplaced items before it.
+            // Those are counted with a Fenwick tree over the old
+            // proxy indices. Runs of items that were adjacent are
+            // moved together.
+            uint const proxy_size = list_proxy.size();
+            std::vector<uint> list_unplaced(proxy_size+1,0);
+            for(uint i=1; i <= proxy_size; i++)
+            {
+                list_unplaced[i]++;
+                uint const parent = i+(i & (~i+1));
+                if(parent <= proxy_size)
+                {
+                    list_unplaced[parent] += list_unplaced[i];
+                }
+            }
+
+            auto count_unplaced_before =
+                    [&list_unplaced](uint prev_index)
+                    {
+                        uint count=0;
+                        for(uint i=prev_index; i > 0; i -= (i & (~i+1)))
+                        {
+                            count += list_unplaced[i];
+                        }
+                        return count;
+                    };
+
+            auto set_placed =
+                    [&list_unplaced,proxy_size](uint prev_index)
+                    {
+                        for(uint i=prev_index+1; i <= proxy_size; i += (i & (~i+1)))
+                        {
+                            list_unplaced[i]--;
+                        }
+                    };
+
+            uint move_first=0;
+            uint move_count=0;
+            uint move_to=0;
+            uint move_prev_last=0;
+
+            for(uint p=0; p < proxy_size; p++)
+            {
+                uint const prev_index = m_list_source_to_proxy[list_proxy[p]];
+
+                if(move_count > 0 && prev_index == move_prev_last+1)
+                {
+                    move_count++;
+                    move_prev_last = prev_index;
+                    set_placed(prev_index);
+                    continue;
+                }
+
+                if(move_count > 0)
+                {
+                    this->notifyMovedItems(move_first,move_first+move_count,move_to);
+                    move_count = 0;
+                }
+
+                uint const index = p+count_unplaced_before(prev_index);
+                if(index != p)
+                {
+                    move_first = index;
+                    move_count = 1;
+                    move_to = p;
+                    move_prev_last = prev_index;
+                }
+
+                set_placed(prev_index);
+            }
+
+            if(move_count > 0)
+            {
+                this->notifyMovedItems(move_first,move_first+move_count,move_to);
+            }
+
+            m_list_proxy = std::move(list_proxy);
+            updateProxyMap(0,m_list_proxy.size());
+
+            this->EndChanges();
+        }
+
+        // * Only items that @accept returns true for are in the
+        //   proxy. An empty predicate accepts every item.
+        // * Items that are filtered in or out are emitted as a
+        //   single change set
+        void SetFilter(Predicate accept)
+        {
+            m_accept = std::move(accept);
+
+            for(uint i=0; i < m_list_accepted.size(); i++)
+            {
+                m_list_accepted[i] = calcAccepted(i);
+            }
+
+            applyFilter();
+        }
+
+        // * Same as SetFilter for a predicate that only accepts
+        //   items that the current one accepts, ie. when more
+        //   characters are typed into a search field
+        // * Only the items currently in the proxy are tested
+        void NarrowFilter(Predicate accept)
+        {
+            m_accept = std::move(accept);
+
+            for(auto source_index : m_list_proxy)
+            {
+                m_list_accepted[source_index] = calcAccepted(source_index);
+            }
+
+            applyFilter();
+        }
+
+    private:
+        bool calcAccepted(uint source_index) const
+        {
+            return (!m_accept || m_accept(m_source->GetData(source_index)));
+        }
+
+        // Strict order of source items in the proxy, falls
+        // back to the source order for equal items
+        bool orderLess(uint source_a, uint source_b) const
+        {
+            if(m_less)
+            {
+                auto const &a = m_source->GetData(source_a);
+                auto const &b = m_source->GetData(source_b);
+
+                if(m_less(a,b))
+                {
+                    return true;
+                }
+
+                if(m_less(b,a))
+                {
+                    return false;
+                }
+            }
+
+            return (source_a < source_b);
+        }
+
+        uint findPosition(std::vector<uint> const &list, uint source_index) const
+        {
+            auto it = std::lower_bound(
+                        list.begin(),
+                        list.end(),
+                        source_index,
+                        [this](uint a, uint b) {
+                            return orderLess(a,b);
+                        });
+
+            return std::distance(list.begin(),it);
+        }
+
+        void updateOrderMap(uint first, uint end)
+        {
+            for(uint i=first; i < end; i++)
+            {
+                m_list_source_to_order[m_list_order[i]] = i;
+            }
+        }
+
+        void updateProxyMap(uint first, uint end)
+        {
+            for(uint i=first; i < end; i++)
+            {
+                m_list_source_to_proxy[m_list_proxy[i]] = i;
+            }
+        }
+
+        void rebuildMaps()
+        {
+            uint const source_size = m_list_accepted.size();
+
+            m_list_source_to_order.resize(source_size);
+            updateOrderMap(0,source_size);
+
+            m_list_source_to_proxy.assign(source_size,-1);
+            updateProxyMap(0,m_list_proxy.size());
+        }
+
+        void rebuild()
+        {
+            uint const source_size = m_source->GetSize();
+
+            m_list_order.resize(source_size);
+            m_list_accepted.resize(source_size);
+
+            for(uint i=0; i < source_size; i++)
+            {
+                m_list_order[i] = i;
+                m_list_accepted[i] = calcAccepted(i);
+            }
+
+            if(m_less)
+            {
+                std::sort(m_list_order.begin(),
+                          m_list_order.end(),
+                          [this](uint a, uint b) {
+                              return orderLess(a,b);
+                          });
+            }
+
+            m_list_proxy.clear();
+            for(auto source_index : m_list_order)
+            {
+                if(m_list_accepted[source_index])
+                {
+                    m_list_proxy.push_back(source_index);
+                }
+            }
+
+            rebuildMaps();
+        }
+
+        // Updates the proxy to match m_list_accepted and emits
+        // the difference as a single change set
+        void applyFilter()
+        {
+            std::vector<uint> list_proxy;
+            list_proxy.reserve(m_list_order.size());
+
+            this->BeginChanges();
+
+            // Walk the sort order, which both the old and the
+            // new proxy are subsequences of. @proxy_index is the
+            // index into the model as it is after the preceding
+            // changes.
+            uint proxy_index=0;
+            uint remove_first=0;
+            uint remove_count=0;
+            uint insert_first=0;
+            uint insert_count=0;
+
+            auto flush =
+                    [&]()
+                    {
+                        if(remove_count > 0)
+                        {
+                            this->notifyBeforeRemovingItems(
+                                        remove_first,
+                                        remove_first+remove_count);
+
+                            remove_count = 0;
+                        }
+
+                        if(insert_count > 0)
+                        {
+                            this->notifyAddedItems(
+                                        insert_first,
+                                        insert_first+insert_count);
+
+                            insert_count = 0;
+                        }
+                    };
+
+            for(auto source_index : m_list_order)
+            {
+                bool const was_accepted =
+                        (m_list_source_to_proxy[source_index] >= 0);
+
+                bool const accepted = m_list_accepted[source_index];
+
+                if(was_accepted && !accepted)
+                {
+                    if(insert_count > 0)
+                    {
+                        flush();
+                    }
+
+                    if(remove_count == 0)
+                    {
+                        remove_first = proxy_index;
+                    }
+
+                    remove_count++;
+                }
+                else if(!was_accepted && accepted)
+                {
+                    if(remove_count > 0)
+                    {
+                        flush();
+                    }
+
+                    if(insert_count == 0)
+                    {
+                        insert_first = proxy_index;
+                    }
+
+                    insert_count++;
+                    proxy_index++;
+                }
+                else if(accepted)
+                {
+                    flush();
+                    proxy_index++;
+                }
+
+                if(accepted)
+                {
+                    list_proxy.push_back(source_index);
+                }
+            }
+
+            flush();
+
+            m_list_proxy = std::move(list_proxy);
+
+            m_list_source_to_proxy.assign(m_list_order.size(),-1);
+            updateProxyMap(0,m_list_proxy.size());
+
+            this->EndChanges();
+        }
+
+        // These don't update the proxy map
+        uint insertIntoProxy(uint source_index)
+        {
+            uint const proxy_index = findPosition(m_list_proxy,source_index);
+
+            this->notifyBeforeAddingItems(proxy_index,1);
+
+            m_list_proxy.insert(
+                        std::next(m_list_proxy.begin(),proxy_index),
+                        source_index);
+
+            this->notifyAddedItems(proxy_index,proxy_index+1);
+
+            return proxy_index;
+        }
+
+        void removeFromProxy(uint proxy_index)
+        {
+            this->notifyBeforeRemovingItems(proxy_index,proxy_index+1);
+
+            m_list_proxy.erase(
+                        std::next(m_list_proxy.begin(),proxy_index));
+
+            this->notifyRemovedItems(proxy_index,1);
+        }
+
+        void onSourceAddedItems(uint idx_first_added, uint idx_end_added)
+        {
+            uint const count = idx_end_added-idx_first_added;
+            uint const prev_source_size = m_list_accepted.size();
+
+            // Shift the source indices after the added items. The
+            // maps find them without scanning the whole order.
+            for(uint i=idx_first_added; i < prev_source_size; i++)
+            {
+                m_list_order[m_list_source_to_order[i]] += count;
+
+                sint const proxy_index = m_list_source_to_proxy[i];
+                if(proxy_index >= 0)
+                {
+                    m_list_proxy[proxy_index] += count;
+                }
+            }
+
+            m_list_accepted.insert(
+                        std::next(m_list_accepted.begin(),idx_first_added),
+                        count,
+                        0);
+
+            m_list_source_to_order.insert(
+                        std::next(m_list_source_to_order.begin(),idx_first_added),
+                        count,
+                        0);
+
+            m_list_source_to_proxy.insert(
+                        std::next(m_list_source_to_proxy.begin(),idx_first_added),
+                        count,
+                        -1);
+
+            if(count > 1)
+            {
+                this->BeginChanges();
+            }
+
+            // Only the positions from the first insert onward
+            // have to be written to the maps
+            uint first_order_index = m_list_order.size();
+            uint first_proxy_index = m_list_proxy.size();
+
+            for(uint i=idx_first_added; i < idx_end_added; i++)
+            {
+                uint const order_index = findPosition(m_list_order,i);
+
+                m_list_order.insert(
+                            std::next(m_list_order.begin(),order_index),
+                            i);
+
+                first_order_index = std::min(first_order_index,order_index);
+
+                m_list_accepted[i] = calcAccepted(i);
+
+                if(m_list_accepted[i])
+                {
+                    first_proxy_index =
+                            std::min(first_proxy_index,insertIntoProxy(i));
+                }
+            }
+
+            updateOrderMap(first_order_index,m_list_order.size());
+            updateProxyMap(first_proxy_index,m_list_proxy.size());
+
+            if(count > 1)
+            {
+                this->EndChanges();
+            }
+        }
+
+        void onSourceBeforeRemovingItems(uint idx_first_remove,
+                                         uint idx_end_remove)
+        {
+            // Remove the proxy items, last first so that the
+            // proxy indices that are left stay valid
+            std::vector<uint> list_proxy_indices;
+            uint first_order_index = m_list_order.size();
+
+            for(uint i=idx_first_remove; i < idx_end_remove; i++)
+            {
+                if(m_list_source_to_proxy[i] >= 0)
+                {
+                    list_proxy_indices.push_back(m_list_source_to_proxy[i]);
+                }
+
+                first_order_index =
+                        std::min(first_order_index,m_list_source_to_order[i]);
+            }
+
+            std::sort(list_proxy_indices.begin(),
+                      list_proxy_indices.end(),
+                      std::greater<uint>());
+
+            if(list_proxy_indices.size() > 1)
+            {
+                this->BeginChanges();
+            }
+
+            for(auto proxy_index : list_proxy_indices)
+            {
+                removeFromProxy(proxy_index);
+            }
+
+            if(list_proxy_indices.size() > 1)
+            {
+                this->EndChanges();
+            }
+
+            // Nothing before the first removed item moves
+            m_list_order.erase(
+                        std::remove_if(
+                            std::next(m_list_order.begin(),first_order_index),
+                            m_list_order.end(),
+                            [&](uint source_index) {
+                                return (source_index >= idx_first_remove &&
+                                        source_index < idx_end_remove);
+                            }),
+                        m_list_order.end());
+
+            // The maps still use the source indices from before
+            // the removal until onSourceRemovedItems
+            updateOrderMap(first_order_index,m_list_order.size());
+
+            if(!list_proxy_indices.empty())
+            {
+                updateProxyMap(list_proxy_indices.back(),m_list_proxy.size());
+            }
+        }
+
+        void onSourceRemovedItems(uint idx_after_removed, uint count)
+        {
+            // The source indices after the removed items still
+            // have to be shifted. The maps find them without
+            // scanning the whole order.
+            uint const prev_source_size = m_list_accepted.size();
+
+            for(uint i=idx_after_removed+count; i < prev_source_size; i++)
+            {
+                m_list_order[m_list_source_to_order[i]] -= count;
+
+                sint const proxy_index = m_list_source_to_proxy[i];
+                if(proxy_index >= 0)
+                {
+                    m_list_proxy[proxy_index] -= count;
+                }
+            }
+
+            m_list_accepted.erase(
+                        std::next(m_list_accepted.begin(),idx_after_removed),
+                        std::next(m_list_accepted.begin(),idx_after_removed+count));
+
+            m_list_source_to_order.erase(
+                        std::next(m_list_source_to_order.begin(),idx_after_removed),
+                        std::next(m_list_source_to_order.begin(),idx_after_removed+count));
+
+            m_list_source_to_proxy.erase(
+                        std::next(m_list_source_to_proxy.begin(),idx_after_removed),
+                        std::next(m_list_source_to_proxy.begin(),idx_after_removed+count));
+        }
+
+        void onSourceDataChanged(uint source_index)
+        {
+            bool const was_accepted = m_list_accepted[source_index];
+            bool const accepted = calcAccepted(source_index);
+            m_list_accepted[source_index] = accepted;
+
+            // Update the item's place in the sort order
+            uint const prev_order_index = m_list_source_to_order[source_index];
+            uint order_index = prev_order_index;
+
+            if(m_less)
+            {
+                m_list_order.erase(
+                            std::next(m_list_order.begin(),prev_order_index));
+
+                order_index = findPosition(m_list_order,source_index);
+
+                m_list_order.insert(
+                            std::next(m_list_order.begin(),order_index),
+                            source_index);
+
+                updateOrderMap(std::min(prev_order_index,order_index),
+                               std::max(prev_order_index,order_index)+1);
+            }
+
+            if(was_accepted && accepted)
+            {
+                uint const prev_proxy_index = m_list_source_to_proxy[source_index];
+                uint proxy_index = prev_proxy_index;
+
+                if(order_index != prev_order_index)
+                {
+                    m_list_proxy.erase(
+                                std::next(m_list_proxy.begin(),prev_proxy_index));
+
+                    proxy_index = findPosition(m_list_proxy,source_index);
+
+                    m_list_proxy.insert(
+                                std::next(m_list_proxy.begin(),proxy_index),
+                                source_index);
+
+                    updateProxyMap(std::min(prev_proxy_index,proxy_index),
+                                   std::max(prev_proxy_index,proxy_index)+1);
+                }
+
+                if(proxy_index != prev_proxy_index)
+                {
+                    this->BeginChanges();
+                    this->notifyMovedItems(prev_proxy_index,prev_proxy_index+1,proxy_index);
+                    this->notifyDataChanged(proxy_index);
+                    this->EndChanges();
+                }
+                else
+                {
+                    this->notifyDataChanged(proxy_index);
+                }
+            }
+            else if(was_accepted)
+            {
+                uint const proxy_index = m_list_source_to_proxy[source_index];
+                removeFromProxy(proxy_index);
+
+                m_list_source_to_proxy[source_index] = -1;
+                updateProxyMap(proxy_index,m_list_proxy.size());
+            }
+            else if(accepted)
+            {
+                uint const proxy_index = insertIntoProxy(source_index);
+                updateProxyMap(proxy_index,m_list_proxy.size());
+            }
+        }
+
+        void onSourceLayoutChanged()
+        {
+            rebuild();
+            this->signal_layout_changed.Emit();
+        }
+
+        void onSourceChanges(shared_ptr<ListModelChangeSet const> change_set)
+        {
+            // The source has already made all of the changes, so
+            // its data can only be read with the final indices
+            uint const prev_source_size = m_list_accepted.size();
+            uint const source_size = m_source->GetSize();
+
+            // Map each item to its source index after the changes.
+            // Items that were updated or moved have to be placed
+            // again, along with the inserted ones.
+            std::vector<sint> list_prev_to_source(prev_source_size,-1);
+            std::vector<u8> list_placed(source_size,0);
+            std::vector<u8> list_updated(source_size,0);
+            std::vector<u8> list_accepted(source_size,0);
+
+            for(uint i=0; i < prev_source_size; i++)
+            {
+                uint index = i;
+                bool updated = false;
+                bool moved = false;
+
+                if(change_set->MapIndex(index,updated,moved))
+                {
+                    list_prev_to_source[i] = index;
+                    list_updated[index] = updated;
+
+                    if(!updated && !moved)
+                    {
+                        list_placed[index] = 1;
+                        list_accepted[index] = m_list_accepted[i];
+                    }
+                }
+            }
+
+            // Items that are still placed keep their relative order
+            // since neither their data nor their source order changed
+            std::vector<uint> list_order;
+            list_order.reserve(source_size);
+            for(auto source_index : m_list_order)
+            {
+                sint const index = list_prev_to_source[source_index];
+                if(index >= 0 && list_placed[index])
+                {
+                    list_order.push_back(index);
+                }
+            }
+
+            std::vector<uint> list_unplaced;
+            for(uint i=0; i < source_size; i++)
+            {
+                if(!list_placed[i])
+                {
+                    list_accepted[i] = calcAccepted(i);
+                    list_unplaced.push_back(i);
+                }
+            }
+
+            auto order_less =
+                    [this](uint a, uint b) {
+                        return orderLess(a,b);
+                    };
+
+            std::sort(list_unplaced.begin(),list_unplaced.end(),order_less);
+
+            m_list_order.clear();
+            m_list_order.reserve(source_size);
+            std::merge(list_order.begin(),
+                       list_order.end(),
+                       list_unplaced.begin(),
+                       list_unplaced.end(),
+                       std::back_inserter(m_list_order),
+                       order_less);
+
+            m_list_accepted = std::move(list_accepted);
+
+            // The proxy items from before the changes, with
+            // -1 for the ones that were removed from the source
+            std::vector<sint> list_prev_proxy;
+            list_prev_proxy.reserve(m_list_proxy.size());
+            for(auto source_index : m_list_proxy)
+            {
+                list_prev_proxy.push_back(list_prev_to_source[source_index]);
+            }
+
+            m_list_proxy.clear();
+            for(auto source_index : m_list_order)
+            {
+                if(m_list_accepted[source_index])
+                {
+                    m_list_proxy.push_back(source_index);
+                }
+            }
+
+            rebuildMaps();
+
+            // Find the previous proxy items that can stay where
+            // they are. Items that were placed are still accepted
+            // and in order, so they always stay. Other items stay
+            // if they're still accepted and remain between the
+            // same placed items and after any other item that
+            // stays.
+            std::vector<u8> list_stays(list_prev_proxy.size(),0);
+            sint next_placed_proxy_index = m_list_proxy.size();
+
+            for(uint i=list_prev_proxy.size(); i-- > 0;)
+            {
+                sint const index = list_prev_proxy[i];
+                if(index >= 0 && list_placed[index])
+                {
+                    list_stays[i] = 1;
+                    next_placed_proxy_index = m_list_source_to_proxy[index];
+                }
+                else if(index >= 0)
+                {
+                    // Mark items that stay between the same placed
+                    // items for now, and check their order below
+                    list_stays[i] =
+                            (m_list_source_to_proxy[index] >= 0 &&
+                             m_list_source_to_proxy[index] < next_placed_proxy_index);
+                }
+            }
+
+            sint prev_proxy_index = -1;
+            for(uint i=0; i < list_prev_proxy.size(); i++)
+            {
+                if(list_stays[i])
+                {
+                    sint const proxy_index =
+                            m_list_source_to_proxy[list_prev_proxy[i]];
+
+                    if(proxy_index > prev_proxy_index)
+                    {
+                        prev_proxy_index = proxy_index;
+                    }
+                    else
+                    {
+                        list_stays[i] = 0;
+                    }
+                }
+            }
+
+            // Emit the difference: remove the items that don't stay,
+            // last first, then insert the items that are missing in
+            // their final order
+            this->BeginChanges();
+
+            std::vector<u8> list_present(m_list_proxy.size(),0);
+
+            for(uint i=list_prev_proxy.size(); i-- > 0;)
+            {
+                if(list_stays[i])
+                {
+                    list_present[m_list_source_to_proxy[list_prev_proxy[i]]] = 1;
+                }
+                else
+                {
+                    this->notifyBeforeRemovingItems(i,i+1);
+                    this->notifyRemovedItems(i,1);
+                }
+            }
+
+            for(uint i=0; i < m_list_proxy.size(); i++)
+            {
+                if(!list_present[i])
+                {
+                    this->notifyBeforeAddingItems(i,1);
+                    this->notifyAddedItems(i,i+1);
+                }
+            }
+
+            for(uint i=0; i < m_list_proxy.size(); i++)
+            {
+                if(list_present[i] && list_updated[m_list_proxy[i]])
+                {
+                    this->notifyDataChanged(i);
+                }
+            }
+
+            this->EndChanges();
+        }
+
+
+        shared_ptr<ListModel<DataType>> m_source;
+
+        Comparator m_less;
+        Predicate m_accept;
+
+        // Source indices of all items in sorted order
+        std::vector<uint> m_list_order;
+
+        // Source indices of the accepted items in sorted
+        // order; indices correspond to proxy index
+        std::vector<uint> m_list_proxy;
+
+        // Indices correspond to source index
+        std::vector<u8> m_list_accepted;
+        std::vector<uint> m_list_source_to_order;
+        std::vector<sint> m_list_source_to_proxy; // -1 if filtered out
+
+        Id m_cid_added_items;
+        Id m_cid_before_removing_items;
+        Id m_cid_removed_items;
+        Id m_cid_data_changed;
+        Id m_cid_layout_changed;
+        Id m_cid_changes;
+    };
+}
+
+#endif // RAINTK_LIST_MODEL_SORT_FILTER_PROXY_HPP
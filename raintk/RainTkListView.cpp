@@ -21,4 +21,33 @@ namespace raintk
     ListViewDelegateHeightInvalid::ListViewDelegateHeightInvalid(std::string msg) :
         ks::Exception(ks::Exception::ErrorLevel::ERROR,msg)
     {}
+
+    // =========================================================== //
+
+    ListViewPrefetchAnimation::ListViewPrefetchAnimation(
+            ks::Object::Key const &key,
+            Scene* scene,
+            std::function<bool()> prefetch) :
+        Animation(key,scene),
+        m_prefetch(std::move(prefetch))
+    {}
+
+    void ListViewPrefetchAnimation::Init(
+            ks::Object::Key const &,
+            shared_ptr<ListViewPrefetchAnimation> const &)
+    {}
+
+    ListViewPrefetchAnimation::~ListViewPrefetchAnimation()
+    {}
+
+    void ListViewPrefetchAnimation::start()
+    {}
+
+    bool ListViewPrefetchAnimation::update(float)
+    {
+        return m_prefetch();
+    }
+
+    void ListViewPrefetchAnimation::complete()
+    {}
 }
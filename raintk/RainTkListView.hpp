@@ -17,6 +17,7 @@
 #include <raintk/RainTkListModelSTLVector.hpp>
 #include <raintk/RainTkListDelegate.hpp>
 #include <raintk/RainTkScrollArea.hpp>
+#include <raintk/RainTkAnimation.hpp>
 #include <raintk/RainTkScene.hpp>
 
 #ifdef RAINTK_DEBUG_LIST_VIEW_GUIDELINES
@@ -31,8 +32,12 @@ namespace raintk
     {
         enum class Layout
         {
-            // Row, // TODO
-            Column
+            Row,
+            Column,
+
+            // Lines of grid_columns cells stacked vertically;
+            // scrolls like Column
+            Grid
         };
 
         // TODO
@@ -55,6 +60,34 @@ namespace raintk
 
     // =========================================================== //
 
+    // ListViewPrefetchAnimation
+    // * Runs every frame while a ListView has delegates left
+    //   to prefetch. @prefetch should flag the ListView for an
+    //   update and return true once there's nothing left to do.
+    class ListViewPrefetchAnimation : public Animation
+    {
+    public:
+        using base_type = raintk::Animation;
+
+        ListViewPrefetchAnimation(ks::Object::Key const &key,
+                                  Scene* scene,
+                                  std::function<bool()> prefetch);
+
+        void Init(ks::Object::Key const &,
+                  shared_ptr<ListViewPrefetchAnimation> const &);
+
+        ~ListViewPrefetchAnimation();
+
+    private:
+        void start() override;
+        bool update(float delta_ms) override;
+        void complete() override;
+
+        std::function<bool()> m_prefetch;
+    };
+
+    // =========================================================== //
+
     template<typename ItemType, typename DelegateType>
     class ListView : public raintk::ScrollArea
     {
@@ -98,6 +131,7 @@ namespace raintk
         Id m_cid_removed_items;
         Id m_cid_data_changed;
         Id m_cid_layout_changed;
+        Id m_cid_changes;
 
         // * Delegate bounds
         Property<float> m_delegate_bounds_top{
@@ -121,6 +155,16 @@ namespace raintk
         Property<float>* m_delegate_bounds_start;
         Property<float>* m_delegate_bounds_end;
 
+        // * How far the delegate bounds are stretched ahead
+        //   of the view in the direction of a flick
+        Property<float> m_prefetch_lead_start{
+            0.0f
+        };
+
+        Property<float> m_prefetch_lead_end{
+            0.0f
+        };
+
         Property<float>* m_view_size;
         Property<float>* m_content_size;
         unique_ptr<ContentPosition> m_content_position;
@@ -136,11 +180,23 @@ namespace raintk
         std::function<float(shared_ptr<DelegateType> const &)> m_get_delegate_size;
         std::function<float(shared_ptr<DelegateType> const &)> m_get_delegate_position;
         std::function<void(shared_ptr<DelegateType> const &,float)> m_set_delegate_position;
+        std::function<void(shared_ptr<DelegateType> const &,float)> m_set_delegate_cross_position;
 
         ListDelegates m_list_delegates;
 
         bool m_upd_reposition;
 
+        // * Prefetching
+        Milliseconds m_prefetch_time{250};
+        Microseconds m_prefetch_budget{2000};
+        bool m_prefetch_pending{false};
+        shared_ptr<ListViewPrefetchAnimation> m_prefetch_anim;
+
+        // * The range of model indices [first,end) that was
+        //   last reported to the model with SetViewRange
+        uint m_view_range_first{0};
+        uint m_view_range_end{0};
+
 #ifdef RAINTK_DEBUG_LIST_VIEW_GUIDELINES
         // * Guidelines to help debug, should be disabled
         //   in release builds
@@ -164,6 +220,13 @@ namespace raintk
             ListViewProperties::Layout::Column
         };
 
+        // * The number of cells in each line of a Grid layout.
+        //   Cells are placed at equal intervals across the width
+        //   of the view, and spacing is left between them.
+        Property<uint> grid_columns{
+            4
+        };
+
         // === //
 
         using base_type = raintk::ScrollArea;
@@ -206,6 +269,11 @@ namespace raintk
                         this_view,
                         &ListViewType::onLayoutDirectionChanged,
                         ks::ConnectionType::Direct);
+
+            grid_columns.signal_changed.Connect(
+                        this_view,
+                        &ListViewType::onGridColumnsChanged,
+                        ks::ConnectionType::Direct);
         }
 
         void SetListModel(shared_ptr<ListModel<ItemType>> list_model)
@@ -217,6 +285,8 @@ namespace raintk
             }
 
             m_list_delegates.clear();
+            m_view_range_first = 0;
+            m_view_range_end = 0;
 
             // Disconnect previous connections
             if(m_list_model)
@@ -238,6 +308,9 @@ namespace raintk
 
                 m_list_model->signal_layout_changed.Disconnect(
                             m_cid_layout_changed);
+
+                m_list_model->signal_changes.Disconnect(
+                            m_cid_changes);
             }
 
             // Setup new connections
@@ -282,6 +355,12 @@ namespace raintk
                         &ListViewType::onLayoutChanged,
                         ks::ConnectionType::Direct);
 
+            m_cid_changes =
+                    m_list_model->signal_changes.Connect(
+                        this_view,
+                        &ListViewType::onChanges,
+                        ks::ConnectionType::Direct);
+
 
             m_content_parent->x = 0;
             m_content_parent->y = 0;
@@ -292,6 +371,47 @@ namespace raintk
                     update |= UpdateData::UpdateWidget;
         }
 
+        // * Sets how far ahead of the view delegates are created
+        //   during a flick, as the time it takes the flick to
+        //   cover that distance. The lead is limited to the
+        //   size of the view.
+        void SetPrefetchTime(Milliseconds prefetch_time)
+        {
+            m_prefetch_time = prefetch_time;
+        }
+
+        // * Sets the time that can be spent creating delegates
+        //   outside of the view each frame. Delegates within the
+        //   view are always created right away. At least one
+        //   delegate is prefetched every frame so the rest are
+        //   created over the following frames.
+        void SetPrefetchBudget(Microseconds prefetch_budget)
+        {
+            m_prefetch_budget = prefetch_budget;
+        }
+
+        Milliseconds GetPrefetchTime() const
+        {
+            return m_prefetch_time;
+        }
+
+        Microseconds GetPrefetchBudget() const
+        {
+            return m_prefetch_budget;
+        }
+
+        // Returns true if there are delegates within the delegate
+        // bounds that haven't been created yet
+        bool GetPrefetchPending() const
+        {
+            return m_prefetch_pending;
+        }
+
+        uint GetDelegateCount() const
+        {
+            return m_list_delegates.size();
+        }
+
 #ifdef RAINTK_DEBUG_LIST_VIEW_GUIDELINES
         void ShowDebugGuidelines(bool show)
         {
@@ -326,6 +446,13 @@ namespace raintk
             m_cmlist_update_data->GetComponent(m_entity_id).
                     update |= UpdateData::UpdateWidget;
 
+            if(getLineLength() > 1)
+            {
+                // The cells after the change move between lines
+                removeDelegates();
+                return;
+            }
+
 
             // If the current delegate list is empty or the
             // newly added range is after the current delegates
@@ -429,6 +556,12 @@ namespace raintk
             m_cmlist_update_data->GetComponent(m_entity_id).
                     update |= UpdateData::UpdateWidget;
 
+            if(getLineLength() > 1)
+            {
+                removeDelegates();
+                return;
+            }
+
             // If the current delegate list is empty or the
             // range to be removed is after the current delegates
             if(m_list_delegates.empty() ||
@@ -537,6 +670,8 @@ namespace raintk
         void onLayoutChanged()
         {
             m_list_delegates.clear();
+            m_view_range_first = 0;
+            m_view_range_end = 0;
             m_content_parent->x = 0;
             m_content_parent->y = 0;
             m_content_parent->width = width.Get();
@@ -546,6 +681,212 @@ namespace raintk
                     update |= UpdateData::UpdateWidget;
         }
 
+        // Reconciles the delegates with all of the changes in
+        // @change_set at once. Delegates for items that still
+        // exist are kept and moved to their new positions around
+        // the first one in the view, so the view doesn't jump.
+        void onChanges(shared_ptr<ListModelChangeSet const> change_set)
+        {
+            m_cmlist_update_data->GetComponent(m_entity_id).
+                    update |= UpdateData::UpdateWidget;
+
+            if(m_list_delegates.empty())
+            {
+                return;
+            }
+
+            if(getLineLength() > 1)
+            {
+                removeDelegates();
+                return;
+            }
+
+            struct MappedDelegate
+            {
+                shared_ptr<DelegateType> delegate;
+                uint index;
+                bool updated;
+            };
+
+            float const view_start = -1.0f*m_content_position->Get();
+            float const view_end = view_start+m_view_size->Get();
+
+            // Map the delegates to their new model indices
+            std::vector<MappedDelegate> list_mapped;
+            list_mapped.reserve(m_list_delegates.size());
+
+            shared_ptr<DelegateType> anchor;
+            bool anchor_in_view = false;
+            uint anchor_prev_index = 0;
+            uint anchor_index = 0;
+
+            for(auto& delegate : m_list_delegates)
+            {
+                uint index = delegate->GetIndex();
+                bool updated = false;
+
+                if(!change_set->MapIndex(index,updated))
+                {
+                    m_content_parent->RemoveChild(delegate);
+                    continue;
+                }
+
+                float const position = m_get_delegate_position(delegate);
+
+                bool const in_view =
+                        (position+m_get_delegate_size(delegate) > view_start) &&
+                        (position < view_end);
+
+                if(!anchor || (!anchor_in_view && in_view))
+                {
+                    anchor = delegate;
+                    anchor_in_view = in_view;
+                    anchor_prev_index = delegate->GetIndex();
+                    anchor_index = index;
+                }
+
+                list_mapped.push_back(
+                            MappedDelegate{delegate,index,updated});
+            }
+
+            m_list_delegates.clear();
+
+            if(!anchor)
+            {
+                // Nothing survived; update() starts over
+                // from the content position
+                return;
+            }
+
+            std::sort(list_mapped.begin(),
+                      list_mapped.end(),
+                      [](MappedDelegate const &a, MappedDelegate const &b) {
+                          return a.index < b.index;
+                      });
+
+            auto take_delegate =
+                    [&](uint index) -> shared_ptr<DelegateType>
+                    {
+                        auto it = std::lower_bound(
+                                    list_mapped.begin(),
+                                    list_mapped.end(),
+                                    index,
+                                    [](MappedDelegate const &a, uint b) {
+                                        return a.index < b;
+                                    });
+
+                        if(it == list_mapped.end() ||
+                           it->index != index ||
+                           !it->delegate)
+                        {
+                            return nullptr;
+                        }
+
+                        auto delegate = std::move(it->delegate);
+
+                        if(delegate->GetIndex() != index)
+                        {
+                            delegate->SetIndex(index);
+                        }
+
+                        if(it->updated)
+                        {
+                            delegate->SetData(m_list_model->GetData(index));
+                        }
+
+                        return delegate;
+                    };
+
+            float const spacing_val = spacing.Get();
+            uint const model_size = m_list_model->GetSize();
+            float const anchor_position = m_get_delegate_position(anchor);
+
+            // Walk out from the anchor in both directions, reusing
+            // delegates while they're contiguous. New delegates are
+            // only created here within the view; the rest of the
+            // delegate bounds are left to update()
+            m_list_delegates.push_back(take_delegate(anchor_index));
+
+            float position =
+                    anchor_position+
+                    m_get_delegate_size(m_list_delegates.back())+
+                    spacing_val;
+
+            for(uint index=anchor_index+1; index < model_size; index++)
+            {
+                auto delegate = take_delegate(index);
+                if(!delegate)
+                {
+                    if(position >= view_end)
+                    {
+                        break;
+                    }
+
+                    delegate = createDelegate(index);
+                }
+
+                m_set_delegate_position(delegate,position);
+                position += (m_get_delegate_size(delegate)+spacing_val);
+                m_list_delegates.push_back(delegate);
+            }
+
+            ListDelegates list_before;
+            position = anchor_position;
+
+            for(sint index=sint(anchor_index)-1; index >= 0; index--)
+            {
+                auto delegate = take_delegate(index);
+                if(!delegate)
+                {
+                    if(position <= view_start)
+                    {
+                        break;
+                    }
+
+                    delegate = createDelegate(index);
+                }
+
+                position -= (m_get_delegate_size(delegate)+spacing_val);
+                m_set_delegate_position(delegate,position);
+                list_before.push_back(delegate);
+            }
+
+            m_list_delegates.insert(
+                        m_list_delegates.begin(),
+                        list_before.rbegin(),
+                        list_before.rend());
+
+            // Remove the delegates that were left out
+            for(auto& mapped : list_mapped)
+            {
+                if(mapped.delegate)
+                {
+                    m_content_parent->RemoveChild(mapped.delegate);
+                }
+            }
+
+            // Keep the estimated content position in line with
+            // the anchor's new index, as in onAddedItems
+            if(anchor_index != anchor_prev_index)
+            {
+                float const shift =
+                        (float(anchor_index)-float(anchor_prev_index))*
+                        (m_average_delegate_size+spacing_val);
+
+                for(auto& delegate : m_list_delegates)
+                {
+                    m_set_delegate_position(
+                                delegate,
+                                m_get_delegate_position(delegate)+shift);
+                }
+
+                updateContentParentSize();
+
+                m_content_position->Assign(
+                            m_content_position->Get()-shift);
+            }
+        }
+
         typename std::vector<shared_ptr<DelegateType>>::iterator
         getDelegateItForModelIndex(uint model_index)
         {
@@ -574,10 +915,45 @@ namespace raintk
                         model_index-m_list_delegates.front()->GetIndex());
         }
 
+        // Column and Grid layouts scroll vertically
+        bool getLayoutVertical() const
+        {
+            return (layout.Get() != ListViewProperties::Layout::Row);
+        }
+
+        // The number of delegates in each line along the
+        // layout direction; one unless the layout is a Grid
+        uint getLineLength() const
+        {
+            if(layout.Get() == ListViewProperties::Layout::Grid)
+            {
+                return std::max<uint>(grid_columns.Get(),1);
+            }
+
+            return 1;
+        }
+
+        // Removes all delegates so that update() starts over
+        // from the current content position
+        void removeDelegates()
+        {
+            for(auto& delegate : m_list_delegates)
+            {
+                m_content_parent->RemoveChild(delegate);
+            }
+
+            m_list_delegates.clear();
+
+            m_cmlist_update_data->GetComponent(m_entity_id).
+                    update |= UpdateData::UpdateWidget;
+        }
+
         void setupLayoutDirection()
         {
-            if(layout.Get()==ListViewProperties::Layout::Column)
+            if(getLayoutVertical())
             {
+                direction = Direction::Vertical;
+
                 m_view_size = &(height);
                 m_content_size = &(m_content_parent->height);
 
@@ -603,9 +979,16 @@ namespace raintk
                         [](shared_ptr<DelegateType> const &d, float new_position) {
                             return d->y = new_position;
                         };
+
+                m_set_delegate_cross_position =
+                        [](shared_ptr<DelegateType> const &d, float new_position) {
+                            return d->x = new_position;
+                        };
             }
             else
             {
+                direction = Direction::Horizontal;
+
                 m_view_size = &(width);
                 m_content_size = &(m_content_parent->width);
 
@@ -631,6 +1014,11 @@ namespace raintk
                         [](shared_ptr<DelegateType> const &d, float new_position) {
                             return d->x = new_position;
                         };
+
+                m_set_delegate_cross_position =
+                        [](shared_ptr<DelegateType> const &d, float new_position) {
+                            return d->y = new_position;
+                        };
             }
 
             calcDelegateBounds();
@@ -638,7 +1026,23 @@ namespace raintk
 
         void onLayoutDirectionChanged()
         {
+            // The delegates were connected to and placed
+            // along the previous direction
+            removeDelegates();
             setupLayoutDirection();
+
+            m_content_parent->x = 0;
+            m_content_parent->y = 0;
+            m_content_parent->width = width.Get();
+            m_content_parent->height = height.Get();
+        }
+
+        void onGridColumnsChanged()
+        {
+            if(layout.Get() == ListViewProperties::Layout::Grid)
+            {
+                removeDelegates();
+            }
         }
 
         void onScrollPositionChanged()
@@ -648,24 +1052,31 @@ namespace raintk
         }
 
         // Fix the delegate positions after their dimensions have changed
-        // The delegates are shifted relative to the first delegate
+        // The lines are shifted relative to the first line
         void repositionDelegates()
         {
             float spacing_val = spacing.Get();
+            uint const line_length = getLineLength();
 
             float position =
-                    m_get_delegate_position(m_list_delegates.front())+
-                    m_get_delegate_size(m_list_delegates.front())+
-                    spacing_val;
+                    m_get_delegate_position(m_list_delegates.front());
 
-            auto it_delegate = std::next(m_list_delegates.begin());
+            auto it_delegate = m_list_delegates.begin();
             while(it_delegate != m_list_delegates.end())
             {
-                auto& delegate = *it_delegate;
-                m_set_delegate_position(delegate,position);
+                uint const line = (*it_delegate)->GetIndex()/line_length;
+                float line_size = 0.0f;
 
-                position += (m_get_delegate_size(delegate)+spacing_val);
-                ++it_delegate;
+                while(it_delegate != m_list_delegates.end() &&
+                      (*it_delegate)->GetIndex()/line_length == line)
+                {
+                    auto& delegate = *it_delegate;
+                    m_set_delegate_position(delegate,position);
+                    line_size = std::max(line_size,m_get_delegate_size(delegate));
+                    ++it_delegate;
+                }
+
+                position += (line_size+spacing_val);
             }
         }
 
@@ -673,15 +1084,21 @@ namespace raintk
         {
             if(m_list_model==nullptr || m_list_model->GetSize()==0)
             {
+                m_prefetch_pending = false;
                 return;
             }
 
             if(m_upd_reposition)
             {
-                repositionDelegates();
+                if(!m_list_delegates.empty())
+                {
+                    repositionDelegates();
+                }
                 m_upd_reposition = false;
             }
 
+            updatePrefetchLead();
+
             // Erase all delegates outside of the delegate extents
             eraseDelegatesOutsideExtents(
                         m_delegate_bounds_top.Get(),
@@ -691,32 +1108,113 @@ namespace raintk
 
             if(m_list_delegates.empty())
             {
-                // Create the first delegate using an estimated
-                // index based on the current position of the list
+                // Create the first line of delegates using an
+                // estimated index based on the current position
+                // of the list
 
                 calcAverageDelegateSize();
                 updateContentParentSize();
 
-                // Get model index based on content position
-                float estimated_model_index =
-                        (m_content_position->Get()*-1.0f)/
-                        (m_average_delegate_size+spacing.Get());
+                // Get the line based on content position
+                float const estimated_step =
+                        m_average_delegate_size+spacing.Get();
 
-                // Create delegate for model index
-                m_list_delegates.push_back(
-                            createDelegate(estimated_model_index));
+                uint estimated_line =
+                        std::max(0.0f,m_content_position->Get()*-1.0f)/
+                        estimated_step;
 
-                m_set_delegate_position(
-                            m_list_delegates.back(),
-                            m_content_position->Get());
+                estimated_line =
+                        std::min<uint>(estimated_line,
+                                       getLineCount()-1);
+
+                // Create delegates for the line. They're placed at
+                // the estimated position so that they land within
+                // the view after a large jump (ie from a fast flick)
+                createLine(estimated_line*getLineLength(),
+                           m_list_delegates);
+
+                for(auto& delegate : m_list_delegates)
+                {
+                    m_set_delegate_position(
+                                delegate,
+                                estimated_line*estimated_step);
+                }
             }
 
             // There must be at least one delegate at this point
-            fillSpaceBefore();
-            fillSpaceAfter();
+            fillSpace();
             correctDelegatePositions();
             calcAverageDelegateSize();
             updateContentParentSize();
+
+            uint const view_range_first = m_list_delegates.front()->GetIndex();
+            uint const view_range_end = m_list_delegates.back()->GetIndex()+1;
+
+            if(view_range_first != m_view_range_first ||
+               view_range_end != m_view_range_end)
+            {
+                m_view_range_first = view_range_first;
+                m_view_range_end = view_range_end;
+                m_list_model->SetViewRange(
+                            m_view_range_first,
+                            m_view_range_end);
+            }
+        }
+
+        uint getLineCount() const
+        {
+            uint const line_length = getLineLength();
+            return (m_list_model->GetSize()+line_length-1)/line_length;
+        }
+
+        // Creates the delegates for the line that starts at
+        // @model_index, appends them to @list_line and returns
+        // the size of the line (its largest delegate)
+        float createLine(uint model_index, ListDelegates& list_line)
+        {
+            uint const line_length = getLineLength();
+            uint const idx_end =
+                    std::min<uint>(model_index+line_length,
+                                   m_list_model->GetSize());
+
+            float const cell_step = (width.Get()+spacing.Get())/line_length;
+            float line_size = 0.0f;
+
+            for(uint i=model_index; i < idx_end; i++)
+            {
+                auto delegate = createDelegate(i);
+
+                if(line_length > 1)
+                {
+                    m_set_delegate_cross_position(
+                                delegate,(i-model_index)*cell_step);
+                }
+
+                line_size = std::max(line_size,m_get_delegate_size(delegate));
+                list_line.push_back(delegate);
+            }
+
+            return line_size;
+        }
+
+        // Returns the end position of the last line of delegates
+        float getLastLineEnd() const
+        {
+            uint const line_length = getLineLength();
+            uint const line = m_list_delegates.back()->GetIndex()/line_length;
+
+            float line_end = 0.0f;
+            for(auto it = m_list_delegates.rbegin();
+                it != m_list_delegates.rend() &&
+                (*it)->GetIndex()/line_length == line; ++it)
+            {
+                line_end = std::max(
+                            line_end,
+                            m_get_delegate_position(*it)+
+                            m_get_delegate_size(*it));
+            }
+
+            return line_end;
         }
 
         shared_ptr<DelegateType> createDelegate(uint model_index)
@@ -730,7 +1228,7 @@ namespace raintk
             // Avoiding using the shared_ptr for this object for
             // lifetime tracking to avoid creating one everytime;
             // should be okay
-            if(layout.Get() == ListViewProperties::Layout::Column)
+            if(getLayoutVertical())
             {
                 delegate->m_cid_delegate_height =
                         delegate->height.signal_changed.Connect(
@@ -752,12 +1250,114 @@ namespace raintk
             return delegate;
         }
 
-        // Fill available space before the first delegate
-        // in list_delegates
-        void fillSpaceBefore()
+        void updatePrefetchLead()
+        {
+            glm::vec2 const velocity = GetFlickVelocity();
+
+            float const axis_velocity =
+                    getLayoutVertical() ? velocity.y : velocity.x;
+
+            // The content moves opposite to the direction
+            // that is being scrolled towards
+            float const speed = fabs(axis_velocity);
+            float const max_lead = m_view_size->Get();
+            float const lead =
+                    std::min(speed*m_prefetch_time.count()/1000.0f,
+                             max_lead);
+
+            float const lead_start = (axis_velocity > 0.0f) ? lead : 0.0f;
+            float const lead_end = (axis_velocity < 0.0f) ? lead : 0.0f;
+
+            if(m_prefetch_lead_start.Get() != lead_start)
+            {
+                m_prefetch_lead_start = lead_start;
+            }
+
+            if(m_prefetch_lead_end.Get() != lead_end)
+            {
+                m_prefetch_lead_end = lead_end;
+            }
+        }
+
+        void fillSpace()
+        {
+            // Delegates within the view are always created
+            float const view_start = -1.0f*m_content_position->Get();
+            float const view_end = view_start+m_view_size->Get();
+
+            fillSpaceBefore(view_start,nullptr);
+            fillSpaceAfter(view_end,nullptr);
+
+            // The rest of the delegate bounds are filled while
+            // there's time left in the budget, starting with the
+            // side that is being scrolled towards
+            TimePoint const deadline =
+                    std::chrono::high_resolution_clock::now()+
+                    m_prefetch_budget;
+
+            float const bounds_start = m_delegate_bounds_start->Get();
+            float const bounds_end = m_delegate_bounds_end->Get();
+
+            bool filled = false;
+            if(m_prefetch_lead_start.Get() > 0.0f)
+            {
+                filled =
+                        fillSpaceBefore(bounds_start,&deadline) &&
+                        fillSpaceAfter(bounds_end,&deadline);
+            }
+            else
+            {
+                filled =
+                        fillSpaceAfter(bounds_end,&deadline) &&
+                        fillSpaceBefore(bounds_start,&deadline);
+            }
+
+            m_prefetch_pending = !filled;
+
+            if(m_prefetch_pending)
+            {
+                // Continue in the next frame
+                if(!m_prefetch_anim)
+                {
+                    m_prefetch_anim =
+                            ks::MakeObject<ListViewPrefetchAnimation>(
+                                m_scene,
+                                [this](){ return this->onPrefetch(); });
+
+                    m_prefetch_anim->SetKeepOnComplete(true);
+                }
+
+                if(m_prefetch_anim->GetState() != Animation::State::Running)
+                {
+                    m_prefetch_anim->Start();
+                }
+            }
+        }
+
+        bool onPrefetch()
+        {
+            if(!m_prefetch_pending)
+            {
+                return true;
+            }
+
+            m_cmlist_update_data->GetComponent(m_entity_id).
+                    update |= UpdateData::UpdateWidget;
+
+            return false;
+        }
+
+        // Fill available space before the first line of
+        // delegates in list_delegates up to @bounds_start
+        // * If @deadline isn't null, returns false if it was
+        //   reached before the space could be filled
+        bool fillSpaceBefore(float bounds_start,
+                             TimePoint const * deadline)
         {
+            // The first delegate always starts a line
+            uint const line_length = getLineLength();
             sint model_index = m_list_delegates.front()->GetIndex();
-            model_index--;
+            model_index -= sint(line_length);
 
             // ie. The edge closest towards the start
             // of the delegate bounds
@@ -766,11 +1366,14 @@ namespace raintk
                         m_list_delegates.front());
 
             float space_before =
-                    first_start_position-m_delegate_bounds_start->Get();
+                    first_start_position-bounds_start;
+
+            bool created = false;
+            ListDelegates list_line;
 
             while((space_before > 0) &&
                   (model_index >= 0) &&
-                  (m_list_delegates.size() <= m_max_delegate_count))
+                  (m_list_delegates.size() <= m_max_delegate_count*line_length))
             {
                 // Ensure that adding another delegate would place
                 // it at least partially within the delegate bounds
@@ -779,41 +1382,60 @@ namespace raintk
                     break;
                 }
 
-                auto delegate = createDelegate(model_index);
+                if(deadline && created &&
+                   std::chrono::high_resolution_clock::now() >= *deadline)
+                {
+                    return false;
+                }
+
+                created = true;
+
+                list_line.clear();
+                float const line_size = createLine(model_index,list_line);
+
+                first_start_position -= (spacing.Get()+line_size);
+                for(auto& delegate : list_line)
+                {
+                    m_set_delegate_position(delegate,first_start_position);
+                }
 
                 m_list_delegates.insert(
                             m_list_delegates.begin(),
-                            delegate);
+                            list_line.begin(),
+                            list_line.end());
 
-                first_start_position -= (spacing.Get()+m_get_delegate_size(delegate));
-                m_set_delegate_position(delegate,first_start_position);
-                space_before = first_start_position-m_delegate_bounds_start->Get();
+                space_before = first_start_position-bounds_start;
 
-                model_index--;
+                model_index -= sint(line_length);
             }
+
+            return true;
         }
 
-        // Fill available space after the last delegate
-        // in list_delegates
-        void fillSpaceAfter()
+        // Fill available space after the last line of
+        // delegates in list_delegates up to @bounds_end
+        // * If @deadline isn't null, returns false if it was
+        //   reached before the space could be filled
+        bool fillSpaceAfter(float bounds_end,
+                            TimePoint const * deadline)
         {
+            // The last delegate always ends a line
+            uint const line_length = getLineLength();
             uint model_index = m_list_delegates.back()->GetIndex();
             model_index++;
 
             // ie. The edge closest towards the end of
             // the delegate bounds
-            float last_end_position =
-                    m_get_delegate_position(
-                        m_list_delegates.back())+
-                    m_get_delegate_size(
-                        m_list_delegates.back());
+            float last_end_position = getLastLineEnd();
 
             float space_after =
-                    m_delegate_bounds_end->Get()-last_end_position;
+                    bounds_end-last_end_position;
+
+            bool created = false;
 
             while((space_after > 0) &&
                   (model_index < m_list_model->GetSize()) &&
-                  (m_list_delegates.size() <= m_max_delegate_count))
+                  (m_list_delegates.size() <= m_max_delegate_count*line_length))
             {
                 // Ensure that adding another delegate would place
                 // it at least partially within the delegate bounds
@@ -822,17 +1444,30 @@ namespace raintk
                     break;
                 }
 
-                auto delegate = createDelegate(model_index);
+                if(deadline && created &&
+                   std::chrono::high_resolution_clock::now() >= *deadline)
+                {
+                    return false;
+                }
+
+                created = true;
 
-                m_list_delegates.push_back(delegate);
+                uint const line_first = m_list_delegates.size();
+                float const line_size = createLine(model_index,m_list_delegates);
 
                 last_end_position += spacing.Get();
-                m_set_delegate_position(delegate,last_end_position);
-                last_end_position += m_get_delegate_size(delegate);
-                space_after = m_delegate_bounds_end->Get()-last_end_position;
+                for(uint i=line_first; i < m_list_delegates.size(); i++)
+                {
+                    m_set_delegate_position(m_list_delegates[i],last_end_position);
+                }
 
-                model_index++;
+                last_end_position += line_size;
+                space_after = bounds_end-last_end_position;
+
+                model_index += line_length;
             }
+
+            return true;
         }
 
         void correctDelegatePositions()
@@ -880,7 +1515,7 @@ namespace raintk
         {
             float estimated_size =
                     (m_average_delegate_size+spacing.Get())*
-                     m_list_model->GetSize();
+                     getLineCount();
 
             estimated_size -= spacing.Get();
 
@@ -892,9 +1527,7 @@ namespace raintk
 
             auto& last_delegate = m_list_delegates.back();
 
-            float last_delegate_end =
-                    m_get_delegate_position(last_delegate)+
-                    m_get_delegate_size(last_delegate);
+            float last_delegate_end = getLastLineEnd();
 
             if(last_delegate->GetIndex() ==
                     m_list_model->GetSize()-1)
@@ -919,19 +1552,21 @@ namespace raintk
 
         void calcDelegateBounds()
         {
-            if(layout.Get() == ListViewProperties::Layout::Column)
+            if(getLayoutVertical())
             {
                 m_delegate_bounds_top =
                         [this](){
                             return -1.0f*m_content_parent->y.Get()-
-                                delegate_extents.Get();
+                                delegate_extents.Get()-
+                                m_prefetch_lead_start.Get();
                         };
 
                 m_delegate_bounds_bottom =
                         [this](){
-                            return m_delegate_bounds_top.Get()+
+                            return -1.0f*m_content_parent->y.Get()+
                                     height.Get()+
-                                    2*delegate_extents.Get();
+                                    delegate_extents.Get()+
+                                    m_prefetch_lead_end.Get();
                         };
 
                 m_delegate_bounds_left =
@@ -945,6 +1580,34 @@ namespace raintk
                                     width.Get();
                         };
             }
+            else
+            {
+                m_delegate_bounds_left =
+                        [this](){
+                            return -1.0f*m_content_parent->x.Get()-
+                                delegate_extents.Get()-
+                                m_prefetch_lead_start.Get();
+                        };
+
+                m_delegate_bounds_right =
+                        [this](){
+                            return -1.0f*m_content_parent->x.Get()+
+                                    width.Get()+
+                                    delegate_extents.Get()+
+                                    m_prefetch_lead_end.Get();
+                        };
+
+                m_delegate_bounds_top =
+                        [this](){
+                            return m_content_parent->y.Get();
+                        };
+
+                m_delegate_bounds_bottom =
+                        [this](){
+                            return m_delegate_bounds_top.Get()+
+                                    height.Get();
+                        };
+            }
         }
 
         void calcAverageDelegateSize()
@@ -990,38 +1653,58 @@ namespace raintk
             }
         }
 
+        // Lines are only erased once all of their
+        // delegates are outside of the extents
         void eraseDelegatesOutsideExtents(float vext_t,
                                           float vext_b,
                                           float vext_l,
                                           float vext_r)
         {
-            uint remove_count=0;
-            for(auto it = m_list_delegates.end();
-                it != m_list_delegates.begin();)
+            uint const line_length = getLineLength();
+
+            ListDelegates list_keep;
+            list_keep.reserve(m_list_delegates.size());
+
+            auto it_line = m_list_delegates.begin();
+            while(it_line != m_list_delegates.end())
             {
-                --it;
+                uint const line = (*it_line)->GetIndex()/line_length;
+                bool outside_vext = true;
 
-                auto& delegate = *it;
+                auto it_line_end = it_line;
+                while(it_line_end != m_list_delegates.end() &&
+                      (*it_line_end)->GetIndex()/line_length == line)
+                {
+                    auto& delegate = *it_line_end;
+
+                    float delegate_t = delegate->y.Get();
+                    float delegate_b = delegate_t + delegate->height.Get();
+                    float delegate_l = delegate->x.Get();
+                    float delegate_r = delegate_l + delegate->width.Get();
 
-                // TODO fix
-                float delegate_t = delegate->y.Get();
-                float delegate_b = delegate_t + delegate->height.Get();
-                float delegate_l = delegate->x.Get();
-                float delegate_r = delegate_l + delegate->width.Get();
+                    outside_vext = outside_vext &&
+                            ((delegate_b < vext_t) ||
+                             (delegate_t > vext_b) ||
+                             (delegate_r < vext_l) ||
+                             (delegate_l > vext_r));
 
-                bool outside_vext =
-                        (delegate_b < vext_t) ||
-                        (delegate_t > vext_b) ||
-                        (delegate_r < vext_l) ||
-                        (delegate_l > vext_r);
+                    ++it_line_end;
+                }
 
-                if(outside_vext)
+                for(; it_line != it_line_end; ++it_line)
                 {
-                    remove_count++;
-                    m_content_parent->RemoveChild(delegate);
-                    it = m_list_delegates.erase(it);
+                    if(outside_vext)
+                    {
+                        m_content_parent->RemoveChild(*it_line);
+                    }
+                    else
+                    {
+                        list_keep.push_back(std::move(*it_line));
+                    }
                 }
             }
+
+            m_list_delegates.swap(list_keep);
         }
 
 #ifdef RAINTK_DEBUG_LIST_VIEW_GUIDELINES
@@ -17,6 +17,9 @@
 #include <algorithm>
 
 #include <glm/gtx/string_cast.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
 
 #include <ks/gl/KsGLCommands.hpp>
 #include <raintk/RainTkLog.hpp>
@@ -32,16 +35,84 @@ namespace raintk
         m_camera = camera;
     }
 
-    void MainDrawStage::SyncClipRegions(std::vector<BoundingBox> const &list_clip_regions)
+    void MainDrawStage::SyncSnapshot(DrawSnapshot &snapshot)
     {
-        m_list_clip_regions = list_clip_regions;
+        if(snapshot.clip_regions_updated)
+        {
+            m_list_clip_regions.swap(snapshot.list_clip_regions);
+            snapshot.clip_regions_updated = false;
+        }
+
+        if(snapshot.draw_order_updated)
+        {
+            m_list_opq_draw_order.swap(snapshot.list_opq_draw_order);
+            m_list_xpr_draw_order.swap(snapshot.list_xpr_draw_order);
+            m_list_opq_draw_bboxes.swap(snapshot.list_opq_draw_bboxes);
+            m_list_xpr_draw_bboxes.swap(snapshot.list_xpr_draw_bboxes);
+            snapshot.draw_order_updated = false;
+        }
+
+        // Damage is accumulated until it's rendered
+        m_damage_tracking = snapshot.damage_tracking;
+
+        if(snapshot.damage_updated)
+        {
+            m_damage_all = m_damage_all || snapshot.damage_all;
+            m_list_damage_regions.insert(
+                        m_list_damage_regions.end(),
+                        snapshot.list_damage_regions.begin(),
+                        snapshot.list_damage_regions.end());
+
+            snapshot.list_damage_regions.clear();
+            snapshot.damage_all = false;
+            snapshot.damage_updated = false;
+        }
+
+        if(snapshot.cached_layers_updated)
+        {
+            m_list_cached_layers.swap(snapshot.list_cached_layers);
+            snapshot.cached_layers_updated = false;
+        }
+
+        snapshot.cached_layer_stats = m_cached_layer_stats;
     }
 
-    void MainDrawStage::SyncDrawOrder(std::vector<Id> const &list_opq_draw_order,
-                                      std::vector<Id> const &list_xpr_draw_order)
+    void MainDrawStage::SyncLayers(std::vector<CompositorLayerUpdate> const &list_layer_updates)
     {
-        m_list_opq_draw_order = list_opq_draw_order;
-        m_list_xpr_draw_order = list_xpr_draw_order;
+        // Damage is in untransformed layer space
+        if(!list_layer_updates.empty())
+        {
+            m_damage_all = true;
+        }
+
+        for(auto const &update : list_layer_updates)
+        {
+            if(update.layer_id >= m_list_layers.size())
+            {
+                m_list_layers.resize(update.layer_id+1);
+            }
+
+            auto& layer = m_list_layers[update.layer_id];
+
+            if(update.type == CompositorLayerUpdate::Type::Start)
+            {
+                // The animation's start time is set when
+                // it is first rendered
+                layer.animation = update.animation;
+                layer.running = true;
+                layer.started = false;
+                m_layers_running = true;
+            }
+            else
+            {
+                layer = Layer();
+            }
+        }
+    }
+
+    bool MainDrawStage::GetHasRunningLayers() const
+    {
+        return m_layers_running;
     }
 
     void MainDrawStage::Render(ks::draw::DrawParams<DrawKey> &p)
@@ -52,34 +123,94 @@ namespace raintk
         // reset stats
         this->m_stats.reset();
 
-        // get params
-        auto& list_draw_calls = p.list_draw_calls;
+        // Evaluate compositor animations
+        bool const layers_animated = updateLayers();
 
-        // Setup viewport (all values in pixels)
-        // z == width, w == height
-        ks::gl::Viewport(viewport.x,viewport.y,viewport.z,viewport.w);
+        // Redraw the textures of cached layers that changed.
+        // This binds their framebuffers and sets their own
+        // viewports, so it's done before anything else.
+        updateLayerCaches(p);
 
         // Enable scissor test to allow for clipping
         p.state_set->SetScissorTest(GL_TRUE);
 
+        if(m_damage_tracking &&
+           createBackBuffer(viewport.z,viewport.w))
+        {
+            renderDamage(viewport,camera,p,layers_animated);
+        }
+        else
+        {
+            if(m_back_buffer.fbo != 0)
+            {
+                destroyBackBuffer();
+            }
+
+            // Setup viewport (all values in pixels)
+            // z == width, w == height
+            ks::gl::Viewport(viewport.x,viewport.y,viewport.z,viewport.w);
+
+            clear(viewport,p);
+            drawScene(viewport,camera,p,nullptr);
+        }
+
+        m_list_damage_regions.clear();
+        m_damage_all = false;
+
+        // Disable scissor test to reset to
+        // defaults for other draw stages
+        p.state_set->SetScissorTest(GL_FALSE);
+    }
+
+    void MainDrawStage::clear(glm::vec4 const &viewport,
+                              ks::draw::DrawParams<DrawKey>& p)
+    {
         // Enable depth writes to clear the buffer
         p.state_set->SetDepthMask(GL_TRUE);
         p.state_set->SetClearColor(0.11,0.11,0.11,1.0);
 
         // Set the scissor extents to the viewport so that
-        // everything cleared
-        ks::gl::Scissor(viewport.x,viewport.y,viewport.z,viewport.w);
+        // everything is cleared
+        setScissor(0,0,viewport.z,viewport.w);
 
         ks::gl::Clear(ks::gl::ColorBufferBit |
                       ks::gl::DepthBufferBit |
                       ks::gl::StencilBufferBit);
+    }
+
+    void MainDrawStage::drawScene(glm::vec4 const &viewport,
+                                  ks::gl::Camera<float> const &camera,
+                                  ks::draw::DrawParams<DrawKey>& p,
+                                  BoundingBox const * region)
+    {
+        auto& list_draw_calls = p.list_draw_calls;
+
+        // Draw calls that don't overlap @region are skipped
+        auto const skip =
+                [region](std::vector<BoundingBox> const &list_bboxes,
+                         uint index)
+                {
+                    return (region &&
+                            index < list_bboxes.size() &&
+                            !BoundingBoxesOverlap(list_bboxes[index],*region));
+                };
+
+        for(auto& cache : m_list_layer_caches)
+        {
+            cache.drawn = false;
+        }
 
         DrawKey prev_key; // key value should be 0
 
         // Opaque draw calls
-        for(auto const dc_id : m_list_opq_draw_order)
+        for(uint i=0; i < m_list_opq_draw_order.size(); i++)
         {
-            auto& draw_call = list_draw_calls[dc_id];
+            if(skip(m_list_opq_draw_bboxes,i))
+            {
+                continue;
+            }
+
+            auto& draw_call = list_draw_calls[m_list_opq_draw_order[i]];
             setupState(viewport,camera,p,prev_key,draw_call.key);
 
             ks::gl::ShaderProgram* shader =
@@ -99,9 +230,39 @@ namespace raintk
         }
 
         // Transparent draw calls
-        for(auto const dc_id : m_list_xpr_draw_order)
+        for(uint i=0; i < m_list_xpr_draw_order.size(); i++)
         {
-            auto& draw_call = list_draw_calls[dc_id];
+            auto& draw_call = list_draw_calls[m_list_xpr_draw_order[i]];
+
+            // Cached layers are drawn from their texture in
+            // place of their first draw call
+            Id const layer_id = draw_call.key.GetLayer();
+            if(layer_id != 0 &&
+               layer_id < m_list_layer_caches.size() &&
+               m_list_layer_caches[layer_id].ready)
+            {
+                auto& cache = m_list_layer_caches[layer_id];
+                if(!cache.drawn &&
+                   (!region ||
+                    BoundingBoxesOverlap(
+                        m_list_cached_layers[layer_id].bbox,*region)))
+                {
+                    drawLayerCache(viewport,camera,p,layer_id);
+                    m_cached_layer_stats.hits++;
+
+                    // The texture isn't drawn with a DrawKey,
+                    // so all state must be set again
+                    prev_key = DrawKey();
+                }
+                cache.drawn = true;
+                continue;
+            }
+
+            if(skip(m_list_xpr_draw_bboxes,i))
+            {
+                continue;
+            }
+
             setupState(viewport,camera,p,prev_key,draw_call.key);
 
             ks::gl::ShaderProgram* shader =
@@ -119,10 +280,190 @@ namespace raintk
             // Draw!
             issueDrawCall(shader,draw_call);
         }
+    }
 
-        // Disable scissor test to reset to
-        // defaults for other draw stages
-        p.state_set->SetScissorTest(GL_FALSE);
+    void MainDrawStage::renderDamage(glm::vec4 const &viewport,
+                                     ks::gl::Camera<float> const &camera,
+                                     ks::draw::DrawParams<DrawKey>& p,
+                                     bool damage_all)
+    {
+        damage_all = damage_all || m_damage_all;
+
+        // Damage is in untransformed layer space, so all of
+        // the scene is redrawn if any layer is transformed
+        if(!damage_all && !m_list_damage_regions.empty())
+        {
+            for(auto const &layer : m_list_layers)
+            {
+                if(layer.xf != glm::mat4(1.0f))
+                {
+                    damage_all = true;
+                    break;
+                }
+            }
+        }
+
+        glm::vec4 const buffer_viewport{0.0f,0.0f,viewport.z,viewport.w};
+
+        GLint prev_fbo = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING,&prev_fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER,m_back_buffer.fbo);
+        ks::gl::Viewport(0,0,viewport.z,viewport.w);
+
+        if(damage_all)
+        {
+            clear(buffer_viewport,p);
+            drawScene(buffer_viewport,camera,p,nullptr);
+        }
+        else
+        {
+            glm::mat4 const m4_pv =
+                    camera.GetProjMatrix()*
+                    camera.GetViewMatrix();
+
+            for(auto const &region : m_list_damage_regions)
+            {
+                glm::ivec4 const rect =
+                        CalcWindowRect(m4_pv,buffer_viewport,region);
+
+                if(rect.z <= rect.x || rect.w <= rect.y)
+                {
+                    continue;
+                }
+
+                // Everything drawn is limited to the region
+                m_scissor_limit = rect;
+                m_limit_scissor = true;
+
+                clear(buffer_viewport,p);
+                drawScene(buffer_viewport,camera,p,&region);
+            }
+
+            m_limit_scissor = false;
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER,prev_fbo);
+
+        // Copy the back buffer to the window
+        ks::gl::Viewport(viewport.x,viewport.y,viewport.z,viewport.w);
+        setScissor(0,0,viewport.z,viewport.w);
+
+        drawTexturedQuad(p,
+                         m_back_buffer.texture,
+                         glm::mat4(1.0f),
+                         BoundingBox{-1.0f,1.0f,1.0f,-1.0f},
+                         1.0f,
+                         false);
+    }
+
+    bool MainDrawStage::createBackBuffer(uint width, uint height)
+    {
+        if(m_back_buffer.fbo != 0 &&
+           m_back_buffer.width == width &&
+           m_back_buffer.height == height)
+        {
+            return true;
+        }
+
+        if(!createTexturedQuad() || width == 0 || height == 0)
+        {
+            return false;
+        }
+
+        destroyBackBuffer();
+
+        GLint prev_fbo = 0;
+        GLint prev_texture = 0;
+        GLint prev_renderbuffer = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING,&prev_fbo);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D,&prev_texture);
+        glGetIntegerv(GL_RENDERBUFFER_BINDING,&prev_renderbuffer);
+
+        auto& buffer = m_back_buffer;
+
+        glGenTextures(1,&buffer.texture);
+        glBindTexture(GL_TEXTURE_2D,buffer.texture);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D,0,GL_RGBA,width,height,0,
+                     GL_RGBA,GL_UNSIGNED_BYTE,nullptr);
+        glBindTexture(GL_TEXTURE_2D,prev_texture);
+
+        // GLES 2 has no stencil formats without extensions, so
+        // stencil configs don't work with damage tracking
+        glGenRenderbuffers(1,&buffer.depth);
+        glBindRenderbuffer(GL_RENDERBUFFER,buffer.depth);
+        glRenderbufferStorage(GL_RENDERBUFFER,GL_DEPTH_COMPONENT16,width,height);
+        glBindRenderbuffer(GL_RENDERBUFFER,prev_renderbuffer);
+
+        glGenFramebuffers(1,&buffer.fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER,buffer.fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER,GL_COLOR_ATTACHMENT0,
+                               GL_TEXTURE_2D,buffer.texture,0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER,GL_DEPTH_ATTACHMENT,
+                                  GL_RENDERBUFFER,buffer.depth);
+
+        bool const complete =
+                (glCheckFramebufferStatus(GL_FRAMEBUFFER) ==
+                 GL_FRAMEBUFFER_COMPLETE);
+
+        glBindFramebuffer(GL_FRAMEBUFFER,prev_fbo);
+
+        buffer.width = width;
+        buffer.height = height;
+
+        if(!complete)
+        {
+            rtklog.Warn() << "MainDrawStage: Incomplete back buffer ("
+                          << width << "x" << height << "), "
+                             "damage tracking is disabled";
+
+            destroyBackBuffer();
+            m_damage_tracking = false;
+            return false;
+        }
+
+        // The new buffer has nothing in it
+        m_damage_all = true;
+
+        return true;
+    }
+
+    void MainDrawStage::destroyBackBuffer()
+    {
+        auto& buffer = m_back_buffer;
+
+        if(buffer.fbo != 0)
+        {
+            glDeleteFramebuffers(1,&buffer.fbo);
+        }
+
+        if(buffer.texture != 0)
+        {
+            glDeleteTextures(1,&buffer.texture);
+        }
+
+        if(buffer.depth != 0)
+        {
+            glDeleteRenderbuffers(1,&buffer.depth);
+        }
+
+        buffer = BackBuffer();
+    }
+
+    void MainDrawStage::setScissor(sint x0, sint y0, sint x1, sint y1)
+    {
+        if(m_limit_scissor)
+        {
+            x0 = std::max(x0,m_scissor_limit.x);
+            y0 = std::max(y0,m_scissor_limit.y);
+            x1 = std::min(x1,m_scissor_limit.z);
+            y1 = std::min(y1,m_scissor_limit.w);
+        }
+
+        ks::gl::Scissor(x0,y0,std::max(x1-x0,0),std::max(y1-y0,0));
     }
 
     void MainDrawStage::Reset()
@@ -136,6 +477,494 @@ namespace raintk
         {
             return (f - sint(f));
         }
+
+        // Avoids dividing by zero for animations with no
+        // duration; they jump to their final values
+        float const k_min_duration_ms = 0.001f;
+
+        #include <raintk/shaders/RainTkTexturedQuad.glsl.hpp>
+
+        bool BoundingBoxesOverlap(BoundingBox const &a,
+                                  BoundingBox const &b)
+        {
+            return (a.x0 <= b.x1 && b.x0 <= a.x1 &&
+                    a.y0 <= b.y1 && b.y0 <= a.y1);
+        }
+
+        // Converts @bbox from world space to window coordinates
+        // with (0,0) at the bottom left, rounded outwards.
+        // Returns [x0,y0,x1,y1].
+        glm::ivec4 CalcWindowRect(glm::mat4 const &m4_pv,
+                                  glm::vec4 const &viewport,
+                                  BoundingBox const &bbox)
+        {
+            auto const ndc_bl = m4_pv*glm::vec4(bbox.x0,bbox.y1,0,1);
+            auto const ndc_tr = m4_pv*glm::vec4(bbox.x1,bbox.y0,0,1);
+
+            float const x0 = 0.5f*(ndc_bl.x+1.0f)*viewport.z;
+            float const y0 = 0.5f*(ndc_bl.y+1.0f)*viewport.w;
+            float const x1 = 0.5f*(ndc_tr.x+1.0f)*viewport.z;
+            float const y1 = 0.5f*(ndc_tr.y+1.0f)*viewport.w;
+
+            return glm::ivec4(
+                        std::max(sint(std::floor(x0)),sint(0)),
+                        std::max(sint(std::floor(y0)),sint(0)),
+                        std::min(sint(std::ceil(x1)),sint(viewport.z)),
+                        std::min(sint(std::ceil(y1)),sint(viewport.w)));
+        }
+
+        GLuint CompileShader(GLenum type, std::string const &source)
+        {
+            GLuint shader = glCreateShader(type);
+            char const * source_ptr = source.c_str();
+            glShaderSource(shader,1,&source_ptr,nullptr);
+            glCompileShader(shader);
+
+            GLint status = GL_FALSE;
+            glGetShaderiv(shader,GL_COMPILE_STATUS,&status);
+            if(status != GL_TRUE)
+            {
+                rtklog.Warn() << "MainDrawStage: Failed to compile "
+                                 "the textured quad shader";
+
+                glDeleteShader(shader);
+                return 0;
+            }
+
+            return shader;
+        }
+    }
+
+    bool MainDrawStage::updateLayers()
+    {
+        TimePoint const now = std::chrono::high_resolution_clock::now();
+        bool animated = false;
+        bool running = false;
+
+        for(auto& layer : m_list_layers)
+        {
+            if(!layer.running)
+            {
+                continue;
+            }
+
+            animated = true;
+
+            if(!layer.started)
+            {
+                layer.start_time = now;
+                layer.started = true;
+            }
+
+            auto const &anim = layer.animation;
+
+            float const elapsed_ms =
+                    std::chrono::duration_cast<Microseconds>(
+                        now-layer.start_time).count()/1000.0f;
+
+            float t =
+                    (elapsed_ms-anim.delay_ms)/
+                    std::max(anim.duration_ms,k_min_duration_ms);
+
+            t = std::min(std::max(t,0.0f),1.0f);
+
+            float k;
+            Tween::EvalBatch(anim.curve,anim.easing,&t,&k,1);
+
+            glm::vec2 const translation =
+                    anim.translation_from+
+                    (k*(anim.translation_to-anim.translation_from));
+
+            glm::vec2 const scale =
+                    anim.scale_from+
+                    (k*(anim.scale_to-anim.scale_from));
+
+            float const rotation =
+                    anim.rotation_from+
+                    (k*(anim.rotation_to-anim.rotation_from));
+
+            glm::vec3 const origin{anim.origin,0.0f};
+
+            layer.xf =
+                    glm::translate(glm::vec3(translation,0.0f)) *
+                    glm::translate(origin) *
+                    glm::rotate(rotation,glm::vec3(0.0f,0.0f,1.0f)) *
+                    glm::scale(glm::vec3(scale,1.0f)) *
+                    glm::translate(origin*-1.0f);
+
+            layer.opacity =
+                    anim.opacity_from+
+                    (k*(anim.opacity_to-anim.opacity_from));
+
+            // Hold the final values once complete
+            if(t >= 1.0f)
+            {
+                layer.running = false;
+            }
+
+            running = (running || layer.running);
+        }
+
+        m_layers_running = running;
+
+        return animated;
+    }
+
+    void MainDrawStage::setLayerUniforms(ks::gl::Camera<float> const &camera,
+                                         ks::gl::ShaderProgram* shader,
+                                         Id layer_id)
+    {
+        glm::mat4 u_m4_pv =
+                camera.GetProjMatrix()*
+                camera.GetViewMatrix();
+
+        float u_f_layer_opacity = 1.0f;
+
+        if(layer_id != 0 && layer_id < m_list_layers.size() &&
+           !m_rendering_layer_cache)
+        {
+            auto const &layer = m_list_layers[layer_id];
+            u_m4_pv = u_m4_pv*layer.xf;
+            u_f_layer_opacity = layer.opacity;
+        }
+
+        shader->GLSetUniform("u_m4_pv",u_m4_pv);
+        shader->GLSetUniform("u_f_layer_opacity",u_f_layer_opacity);
+    }
+
+    void MainDrawStage::updateLayerCaches(ks::draw::DrawParams<DrawKey>& p)
+    {
+        if(m_list_layer_caches.size() < m_list_cached_layers.size())
+        {
+            m_list_layer_caches.resize(m_list_cached_layers.size());
+        }
+
+        // Layers are drawn uncached if their textures
+        // can't be drawn at all
+        bool const can_cache =
+                m_list_cached_layers.empty() ?
+                    false : createTexturedQuad();
+
+        m_cached_layer_stats.bytes = 0;
+
+        for(uint layer_id=0; layer_id < m_list_layer_caches.size(); layer_id++)
+        {
+            auto& cache = m_list_layer_caches[layer_id];
+
+            bool const cached =
+                    can_cache &&
+                    layer_id < m_list_cached_layers.size() &&
+                    m_list_cached_layers[layer_id].cached;
+
+            if(!cached)
+            {
+                if(cache.texture != 0)
+                {
+                    destroyLayerCache(cache);
+                }
+                continue;
+            }
+
+            auto const version = m_list_cached_layers[layer_id].version;
+            if(cache.version != version)
+            {
+                // If this fails the layer is drawn uncached
+                // until its version changes again
+                cache.ready = renderLayerCache(p,layer_id);
+                cache.version = version;
+
+                if(cache.ready)
+                {
+                    m_cached_layer_stats.renders++;
+                }
+            }
+
+            m_cached_layer_stats.bytes += u64(cache.width)*cache.height*4;
+        }
+    }
+
+    bool MainDrawStage::renderLayerCache(ks::draw::DrawParams<DrawKey>& p,
+                                         Id layer_id)
+    {
+        auto const &desc = m_list_cached_layers[layer_id];
+        auto& cache = m_list_layer_caches[layer_id];
+
+        // The bounds are already in whole pixels
+        uint const width = desc.bbox.x1-desc.bbox.x0;
+        uint const height = desc.bbox.y1-desc.bbox.y0;
+
+        GLint prev_fbo = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING,&prev_fbo);
+
+        // (Re)create the texture and framebuffer if the size
+        // of the layer changed. Only GLES 2 functionality is
+        // used so this works with software implementations.
+        if(cache.texture == 0 ||
+           cache.width != width ||
+           cache.height != height)
+        {
+            destroyLayerCache(cache);
+
+            GLint prev_texture = 0;
+            glGetIntegerv(GL_TEXTURE_BINDING_2D,&prev_texture);
+
+            glGenTextures(1,&cache.texture);
+            glBindTexture(GL_TEXTURE_2D,cache.texture);
+            glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+            glTexImage2D(GL_TEXTURE_2D,0,GL_RGBA,width,height,0,
+                         GL_RGBA,GL_UNSIGNED_BYTE,nullptr);
+            glBindTexture(GL_TEXTURE_2D,prev_texture);
+
+            glGenFramebuffers(1,&cache.fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER,cache.fbo);
+            glFramebufferTexture2D(GL_FRAMEBUFFER,GL_COLOR_ATTACHMENT0,
+                                   GL_TEXTURE_2D,cache.texture,0);
+
+            cache.width = width;
+            cache.height = height;
+
+            if(glCheckFramebufferStatus(GL_FRAMEBUFFER) !=
+               GL_FRAMEBUFFER_COMPLETE)
+            {
+                rtklog.Warn() << "MainDrawStage: Incomplete framebuffer "
+                                 "for cached layer " << layer_id
+                              << " (" << width << "x" << height << ")";
+
+                glBindFramebuffer(GL_FRAMEBUFFER,prev_fbo);
+                destroyLayerCache(cache);
+                return false;
+            }
+        }
+        else
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER,cache.fbo);
+        }
+
+        // Map the layer's bounds to the whole texture
+        glm::vec4 const layer_viewport{0.0f,0.0f,float(width),float(height)};
+
+        ks::gl::Camera<float> layer_camera = m_camera;
+        layer_camera.SetProjMatrixAsOrtho(
+                    desc.bbox.x0,   // left
+                    desc.bbox.x1,   // right
+                    desc.bbox.y1,   // bottom
+                    desc.bbox.y0,   // top
+                    -100.1,         // near (relative to camera eye)
+                    0.1             // far (relative to camera eye)
+                    );
+
+        ks::gl::Viewport(0,0,width,height);
+        p.state_set->SetScissorTest(GL_TRUE);
+        ks::gl::Scissor(0,0,width,height);
+        p.state_set->SetClearColor(0,0,0,0);
+        ks::gl::Clear(ks::gl::ColorBufferBit);
+
+        m_rendering_layer_cache = true;
+
+        DrawKey prev_key;
+
+        for(auto const dc_id : m_list_xpr_draw_order)
+        {
+            auto& draw_call = p.list_draw_calls[dc_id];
+            if(draw_call.key.GetLayer() != layer_id)
+            {
+                continue;
+            }
+
+            setupState(layer_viewport,layer_camera,p,prev_key,draw_call.key);
+
+            ks::gl::ShaderProgram* shader =
+                    p.list_shaders[draw_call.key.GetShader()].get();
+
+            if(draw_call.list_uniforms)
+            {
+                auto &list_uniforms = *(draw_call.list_uniforms);
+                for(auto &uniform : list_uniforms) {
+                    uniform->GLSetUniform(shader);
+                }
+            }
+
+            issueDrawCall(shader,draw_call);
+        }
+
+        m_rendering_layer_cache = false;
+
+        glBindFramebuffer(GL_FRAMEBUFFER,prev_fbo);
+
+        return true;
+    }
+
+    void MainDrawStage::drawLayerCache(glm::vec4 const &viewport,
+                                       ks::gl::Camera<float> const &camera,
+                                       ks::draw::DrawParams<DrawKey>& p,
+                                       Id layer_id)
+    {
+        glm::mat4 u_m4_pv =
+                camera.GetProjMatrix()*
+                camera.GetViewMatrix();
+
+        float u_f_layer_opacity = 1.0f;
+
+        if(layer_id < m_list_layers.size())
+        {
+            auto const &layer = m_list_layers[layer_id];
+            u_m4_pv = u_m4_pv*layer.xf;
+            u_f_layer_opacity = layer.opacity;
+        }
+
+        // The layer was clipped when it was drawn
+        setScissor(0,0,viewport.z,viewport.w);
+
+        drawTexturedQuad(
+                    p,
+                    m_list_layer_caches[layer_id].texture,
+                    u_m4_pv,
+                    m_list_cached_layers[layer_id].bbox,
+                    u_f_layer_opacity,
+                    true);
+    }
+
+    void MainDrawStage::drawTexturedQuad(ks::draw::DrawParams<DrawKey>& p,
+                                         GLuint texture,
+                                         glm::mat4 const &u_m4_pv,
+                                         BoundingBox const &bbox,
+                                         float opacity,
+                                         bool blend)
+    {
+        // Triangle strip (x,y,s,t). The texture's first row
+        // is the bottom of @bbox.
+        float const vertices[16] = {
+            bbox.x0, bbox.y0, 0.0f, 1.0f,
+            bbox.x0, bbox.y1, 0.0f, 0.0f,
+            bbox.x1, bbox.y0, 1.0f, 1.0f,
+            bbox.x1, bbox.y1, 1.0f, 0.0f
+        };
+
+        // Save the state that isn't tracked by the StateSet
+        GLint prev_program = 0;
+        GLint prev_array_buffer = 0;
+        GLint prev_active_texture = 0;
+        GLint prev_texture = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM,&prev_program);
+        glGetIntegerv(GL_ARRAY_BUFFER_BINDING,&prev_array_buffer);
+        glGetIntegerv(GL_ACTIVE_TEXTURE,&prev_active_texture);
+        glActiveTexture(GL_TEXTURE0);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D,&prev_texture);
+
+        p.state_set->SetBlend(blend ? GL_TRUE : GL_FALSE);
+        if(blend)
+        {
+            p.state_set->SetBlendFunction(
+                        GL_ONE,
+                        GL_ONE_MINUS_SRC_ALPHA,
+                        GL_ONE,
+                        GL_ONE_MINUS_SRC_ALPHA);
+        }
+        p.state_set->SetDepthTest(GL_FALSE);
+        p.state_set->SetDepthMask(GL_FALSE);
+
+        glUseProgram(m_quad_prog);
+        glUniformMatrix4fv(m_quad_u_pv,1,GL_FALSE,glm::value_ptr(u_m4_pv));
+        glUniform1f(m_quad_u_opacity,opacity);
+        glUniform1i(m_quad_u_tex0,0);
+
+        glBindTexture(GL_TEXTURE_2D,texture);
+
+        glBindBuffer(GL_ARRAY_BUFFER,m_quad_vbo);
+        glBufferData(GL_ARRAY_BUFFER,sizeof(vertices),vertices,GL_STREAM_DRAW);
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(0,2,GL_FLOAT,GL_FALSE,4*sizeof(float),
+                              reinterpret_cast<void const*>(0));
+        glVertexAttribPointer(1,2,GL_FLOAT,GL_FALSE,4*sizeof(float),
+                              reinterpret_cast<void const*>(2*sizeof(float)));
+
+        glDrawArrays(GL_TRIANGLE_STRIP,0,4);
+
+        glDisableVertexAttribArray(0);
+        glDisableVertexAttribArray(1);
+
+        // Restore
+        glBindBuffer(GL_ARRAY_BUFFER,prev_array_buffer);
+        glBindTexture(GL_TEXTURE_2D,prev_texture);
+        glActiveTexture(prev_active_texture);
+        glUseProgram(prev_program);
+
+        this->m_stats.draw_calls++;
+    }
+
+    void MainDrawStage::destroyLayerCache(LayerCache& cache)
+    {
+        if(cache.fbo != 0)
+        {
+            glDeleteFramebuffers(1,&cache.fbo);
+        }
+
+        if(cache.texture != 0)
+        {
+            glDeleteTextures(1,&cache.texture);
+        }
+
+        cache = LayerCache();
+    }
+
+    bool MainDrawStage::createTexturedQuad()
+    {
+        if(m_quad_prog != 0)
+        {
+            return true;
+        }
+
+        if(m_quad_failed)
+        {
+            return false;
+        }
+
+        GLuint const vsh = CompileShader(GL_VERTEX_SHADER,raintk_textured_quad_vert_glsl);
+        GLuint const fsh = CompileShader(GL_FRAGMENT_SHADER,raintk_textured_quad_frag_glsl);
+
+        if(vsh == 0 || fsh == 0)
+        {
+            glDeleteShader(vsh);
+            glDeleteShader(fsh);
+            m_quad_failed = true;
+            return false;
+        }
+
+        GLuint const prog = glCreateProgram();
+        glAttachShader(prog,vsh);
+        glAttachShader(prog,fsh);
+        glBindAttribLocation(prog,0,"a_v2_position");
+        glBindAttribLocation(prog,1,"a_v2_tex0");
+        glLinkProgram(prog);
+
+        // The shaders are freed along with the program
+        glDeleteShader(vsh);
+        glDeleteShader(fsh);
+
+        GLint status = GL_FALSE;
+        glGetProgramiv(prog,GL_LINK_STATUS,&status);
+        if(status != GL_TRUE)
+        {
+            rtklog.Warn() << "MainDrawStage: Failed to link "
+                             "the textured quad shader";
+
+            glDeleteProgram(prog);
+            m_quad_failed = true;
+            return false;
+        }
+
+        m_quad_prog = prog;
+        m_quad_u_pv = glGetUniformLocation(prog,"u_m4_pv");
+        m_quad_u_opacity = glGetUniformLocation(prog,"u_f_layer_opacity");
+        m_quad_u_tex0 = glGetUniformLocation(prog,"u_s_tex0");
+
+        glGenBuffers(1,&m_quad_vbo);
+
+        return true;
     }
 
     void MainDrawStage::setupState(glm::vec4 const &viewport,
@@ -153,6 +982,7 @@ namespace raintk
             auto const stencil_config_id = curr_key.GetStencilConfig();
             auto const texture_set_id = curr_key.GetTextureSet();
             auto const uniform_set_id = curr_key.GetUniformSet();
+            auto const layer_id = curr_key.GetLayer();
 
             if(prev_key.GetClip() != curr_key.GetClip())
             {
@@ -210,25 +1040,21 @@ namespace raintk
 
                 // TODO clip should consider viewport x,y; currently we
                 // only consider the width and height of the viewport
-                ks::gl::Scissor(
-                            clip_x0_px,
-                            clip_y0_px,
-                            clip_x1_px-clip_x0_px,
-                            clip_y1_px-clip_y0_px);
+                setScissor(clip_x0_px,clip_y0_px,clip_x1_px,clip_y1_px);
             }
 
             if(prev_key.GetShader() != curr_key.GetShader())
             {
                 auto& shader = p.list_shaders[shader_id];
 
-                glm::mat4 const u_m4_pv =
-                        camera.GetProjMatrix()*
-                        camera.GetViewMatrix();
-
                 shader->GLEnable(p.state_set);
-                shader->GLSetUniform("u_m4_pv",u_m4_pv);
+                setLayerUniforms(camera,shader.get(),layer_id);
                 this->m_stats.shader_switches++;
             }
+            else if(prev_key.GetLayer() != layer_id)
+            {
+                setLayerUniforms(camera,p.list_shaders[shader_id].get(),layer_id);
+            }
 
             if((prev_key.GetDepthConfig() != depth_config_id) && (depth_config_id > 0))
             {
@@ -274,6 +1100,24 @@ namespace raintk
             }
 
             prev_key = curr_key;
+
+            // Layers are always blended so that their opacity
+            // can be applied, even if their DrawData is opaque
+            if(layer_id != 0 && !curr_key.GetTransparency())
+            {
+                p.state_set->SetBlend(GL_TRUE);
+                p.state_set->SetBlendFunction(
+                            GL_ONE,
+                            GL_ONE_MINUS_SRC_ALPHA,
+                            GL_ONE,
+                            GL_ONE_MINUS_SRC_ALPHA);
+                p.state_set->SetDepthMask(GL_FALSE);
+
+                // Force the raster configs to be set
+                // again for the next draw call
+                prev_key.SetDepthConfig(0);
+                prev_key.SetBlendConfig(0);
+            }
         }
     }
 
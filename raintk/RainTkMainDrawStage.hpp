@@ -17,10 +17,13 @@
 #ifndef RAINTK_MAIN_DRAW_STAGE_HPP
 #define RAINTK_MAIN_DRAW_STAGE_HPP
 
+#include <atomic>
 #include <ks/gl/KsGLCamera.hpp>
 #include <ks/draw/KsDrawDrawStage.hpp>
 #include <raintk/RainTkDrawKey.hpp>
 #include <raintk/RainTkComponents.hpp>
+#include <raintk/RainTkCompositorAnimation.hpp>
+#include <raintk/RainTkDrawSnapshot.hpp>
 
 namespace raintk
 {
@@ -38,17 +41,111 @@ namespace raintk
         void SyncView(glm::vec4 const &viewport,
                       ks::gl::Camera<float> const &camera);
 
-        void SyncClipRegions(std::vector<BoundingBox> const &list_clip_regions);
+        // Swaps in the lists that were updated in @snapshot
+        // and clears its flags. The time this takes doesn't
+        // depend on the size of the lists.
+        void SyncSnapshot(DrawSnapshot &snapshot);
 
-        void SyncDrawOrder(std::vector<Id> const &list_opq_draw_order,
-                           std::vector<Id> const &list_xpr_draw_order);
+        void SyncLayers(std::vector<CompositorLayerUpdate> const &list_layer_updates);
 
         // Render must be called from the render thread
         void Render(ks::draw::DrawParams<DrawKey>& p);
 
+        // Returns true if a compositor animation is running,
+        // ie. frames need to be rendered even if nothing else
+        // changes. Can be called from any thread.
+        bool GetHasRunningLayers() const;
+
         void Reset();
 
     private:
+        // Render-side state for a compositor layer
+        struct Layer
+        {
+            CompositorAnimation animation;
+            bool running{false};
+            bool started{false};
+            TimePoint start_time;
+
+            glm::mat4 xf{1.0f};
+            float opacity{1.0f};
+        };
+
+        // Render-side state for a cached layer. The texture
+        // is only drawn to when the layer's version changes.
+        struct LayerCache
+        {
+            GLuint fbo{0};
+            GLuint texture{0};
+            uint width{0};
+            uint height{0};
+            u64 version{0};
+            bool ready{false};
+            bool drawn{false}; // drawn this frame
+        };
+
+        // The offscreen buffer the scene is drawn into with
+        // damage tracking, so that undamaged regions are kept
+        struct BackBuffer
+        {
+            GLuint fbo{0};
+            GLuint texture{0};
+            GLuint depth{0};
+            uint width{0};
+            uint height{0};
+        };
+
+        // Returns true if any layer was animated
+        bool updateLayers();
+
+        void updateLayerCaches(ks::draw::DrawParams<DrawKey>& p);
+
+        void clear(glm::vec4 const &viewport,
+                   ks::draw::DrawParams<DrawKey>& p);
+
+        // Draws everything that overlaps @region (in world
+        // space), or everything if @region is null
+        void drawScene(glm::vec4 const &viewport,
+                       ks::gl::Camera<float> const &camera,
+                       ks::draw::DrawParams<DrawKey>& p,
+                       BoundingBox const * region);
+
+        void renderDamage(glm::vec4 const &viewport,
+                          ks::gl::Camera<float> const &camera,
+                          ks::draw::DrawParams<DrawKey>& p,
+                          bool damage_all);
+
+        bool createBackBuffer(uint width, uint height);
+
+        void destroyBackBuffer();
+
+        // Sets the scissor box in window coordinates, limited
+        // to the region being redrawn
+        void setScissor(sint x0, sint y0, sint x1, sint y1);
+
+        bool renderLayerCache(ks::draw::DrawParams<DrawKey>& p,
+                              Id layer_id);
+
+        void drawLayerCache(glm::vec4 const &viewport,
+                            ks::gl::Camera<float> const &camera,
+                            ks::draw::DrawParams<DrawKey>& p,
+                            Id layer_id);
+
+        void destroyLayerCache(LayerCache& cache);
+
+        bool createTexturedQuad();
+
+        void drawTexturedQuad(ks::draw::DrawParams<DrawKey>& p,
+                              GLuint texture,
+                              glm::mat4 const &u_m4_pv,
+                              BoundingBox const &bbox,
+                              float opacity,
+                              bool blend);
+
+        void setLayerUniforms(ks::gl::Camera<float> const &camera,
+                              ks::gl::ShaderProgram* shader,
+                              Id layer_id);
+
         void setupState(glm::vec4 const &viewport,
                         ks::gl::Camera<float> const &camera,
                         ks::draw::DrawParams<DrawKey>& p,
@@ -63,6 +160,36 @@ namespace raintk
         std::vector<BoundingBox> m_list_clip_regions;
         std::vector<Id> m_list_opq_draw_order;
         std::vector<Id> m_list_xpr_draw_order;
+        std::vector<BoundingBox> m_list_opq_draw_bboxes;
+        std::vector<BoundingBox> m_list_xpr_draw_bboxes;
+
+        // Indices correspond to DrawKey layer id
+        std::vector<Layer> m_list_layers;
+        std::vector<CachedLayerDesc> m_list_cached_layers;
+        std::vector<LayerCache> m_list_layer_caches;
+        std::atomic<bool> m_layers_running{false};
+        CachedLayerStats m_cached_layer_stats;
+
+        // Set while a layer is drawn into its texture; the
+        // layer's transform and opacity are applied when the
+        // texture is drawn instead
+        bool m_rendering_layer_cache{false};
+
+        // Damage tracking
+        bool m_damage_tracking{false};
+        bool m_damage_all{false};
+        std::vector<BoundingBox> m_list_damage_regions;
+        BackBuffer m_back_buffer;
+        bool m_limit_scissor{false};
+        glm::ivec4 m_scissor_limit; // x0,y0,x1,y1
+
+        // Used to draw layer textures and the back buffer
+        GLuint m_quad_prog{0};
+        GLuint m_quad_vbo{0};
+        GLint m_quad_u_pv{-1};
+        GLint m_quad_u_opacity{-1};
+        GLint m_quad_u_tex0{-1};
+        bool m_quad_failed{false};
     };
 }
 
@@ -0,0 +1,488 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <raintk/RainTkProperty.hpp>
+#include <raintk/RainTkLog.hpp>
+
+namespace raintk
+{
+    namespace
+    {
+        u32 const k_invalid_index = std::numeric_limits<u32>::max();
+
+        // If bindings keep changing each other (ie. a binding
+        // loop) we give up after this many passes
+        uint const k_max_binding_passes = 64;
+
+        struct PendingNotify
+        {
+            PropertyBase* property;
+            PropertyTransaction::QueuedNotifyFn notify;
+        };
+
+        // Transaction state is kept per thread
+        thread_local uint g_transaction_depth{0};
+        thread_local bool g_flushing{false};
+        thread_local std::vector<PendingNotify> g_list_pending;
+        thread_local u64 g_change_count{0};
+
+        // Binding state
+        thread_local PropertyBase* g_capture{nullptr};
+        thread_local bool g_resolving{false};
+        thread_local uint g_visit_pass{0};
+        thread_local std::vector<PropertyBase*> g_list_bindings;
+        thread_local std::vector<PropertyBase*> g_list_order;
+    }
+
+    // ============================================================= //
+
+    struct PropertyBase::Links
+    {
+        // Properties read by this Property's binding
+        std::vector<PropertyBase*> list_inputs;
+
+        // Properties whose bindings read this Property
+        std::vector<PropertyBase*> list_outputs;
+
+        std::function<void()> evaluate;
+
+        // Set when an input has changed and the binding
+        // needs to be evaluated
+        bool dirty{false};
+
+        u32 binding_index{k_invalid_index};
+        u32 order_index{k_invalid_index};
+        uint visit_pass{0};
+    };
+
+    // ============================================================= //
+
+    PropertyTransaction::PropertyTransaction() :
+        m_committed(false)
+    {
+        g_transaction_depth++;
+    }
+
+    PropertyTransaction::~PropertyTransaction()
+    {
+        Commit();
+    }
+
+    void PropertyTransaction::Commit()
+    {
+        if(m_committed)
+        {
+            return;
+        }
+
+        m_committed = true;
+        g_transaction_depth--;
+
+        // Only the outermost transaction flushes. If we're already
+        // flushing, this transaction was opened by a notification
+        // handler and its changes were appended to the pending list
+        if(g_transaction_depth > 0 || g_flushing)
+        {
+            return;
+        }
+
+        flush();
+    }
+
+    bool PropertyTransaction::GetIsOpen()
+    {
+        return (g_transaction_depth > 0 || g_flushing);
+    }
+
+    u64 PropertyTransaction::GetChangeCount()
+    {
+        return g_change_count;
+    }
+
+    void PropertyTransaction::queueNotify(PropertyBase* property,
+                                          QueuedNotifyFn notify)
+    {
+        if(property->m_notify_index == k_invalid_index)
+        {
+            property->m_notify_index = g_list_pending.size();
+            g_list_pending.push_back(PendingNotify{property,notify});
+        }
+    }
+
+    void PropertyTransaction::cancelNotify(PropertyBase* property)
+    {
+        if(property->m_notify_index != k_invalid_index)
+        {
+            // Don't erase to keep indices valid while flushing
+            g_list_pending[property->m_notify_index].property = nullptr;
+            property->m_notify_index = k_invalid_index;
+        }
+    }
+
+    void PropertyTransaction::queueBinding(PropertyBase* property)
+    {
+        auto& links = property->getLinks();
+        if(!links.dirty)
+        {
+            links.dirty = true;
+            links.binding_index = g_list_bindings.size();
+            g_list_bindings.push_back(property);
+        }
+    }
+
+    void PropertyTransaction::cancelBinding(PropertyBase* property)
+    {
+        auto& links = property->getLinks();
+        links.dirty = false;
+
+        if(links.binding_index != k_invalid_index)
+        {
+            g_list_bindings[links.binding_index] = nullptr;
+            links.binding_index = k_invalid_index;
+        }
+
+        if(links.order_index != k_invalid_index)
+        {
+            g_list_order[links.order_index] = nullptr;
+            links.order_index = k_invalid_index;
+        }
+    }
+
+    void PropertyTransaction::resolveBindings()
+    {
+        // Bindings that change other Properties while being
+        // evaluated queue them; the loop below picks them up
+        if(g_resolving || g_list_bindings.empty())
+        {
+            return;
+        }
+
+        g_resolving = true;
+
+        struct ResolveScope
+        {
+            ~ResolveScope()
+            {
+                // If a binding threw, requeue the bindings that
+                // weren't evaluated so they aren't lost
+                for(auto property : g_list_order)
+                {
+                    if(property)
+                    {
+                        property->m_links->order_index = k_invalid_index;
+                        if(property->m_links->dirty &&
+                           property->m_links->binding_index == k_invalid_index)
+                        {
+                            property->m_links->binding_index = g_list_bindings.size();
+                            g_list_bindings.push_back(property);
+                        }
+                    }
+                }
+
+                g_list_order.clear();
+                g_resolving = false;
+            }
+        } scope;
+
+        for(uint pass=0; !g_list_bindings.empty(); pass++)
+        {
+            if(pass == k_max_binding_passes)
+            {
+                rtklog.Warn() << "PropertyTransaction: Binding loop, "
+                              << g_list_bindings.size()
+                              << " bindings left unevaluated";
+
+                for(auto property : g_list_bindings)
+                {
+                    if(property)
+                    {
+                        property->m_links->dirty = false;
+                        property->m_links->binding_index = k_invalid_index;
+                    }
+                }
+                g_list_bindings.clear();
+                break;
+            }
+
+            // Sort the queued bindings and everything downstream of
+            // them topologically so that each binding is evaluated
+            // after all of its inputs
+            g_visit_pass++;
+            g_list_order.clear();
+
+            for(std::size_t i=0; i < g_list_bindings.size(); i++)
+            {
+                PropertyBase* property = g_list_bindings[i];
+                if(property)
+                {
+                    property->m_links->binding_index = k_invalid_index;
+                    if(property->m_links->dirty)
+                    {
+                        visit(property);
+                    }
+                }
+            }
+            g_list_bindings.clear();
+
+            // g_list_order is in post order (outputs first)
+            for(std::size_t i=g_list_order.size(); i > 0; i--)
+            {
+                PropertyBase* property = g_list_order[i-1];
+                if(!property)
+                {
+                    continue;
+                }
+
+                auto& links = *(property->m_links);
+                links.order_index = k_invalid_index;
+
+                // Only bindings whose inputs actually changed are
+                // dirty; evaluating one marks its own outputs dirty
+                // if its value changes
+                if(links.dirty)
+                {
+                    links.dirty = false;
+                    property->evaluateBinding();
+                }
+            }
+        }
+    }
+
+    void PropertyTransaction::visit(PropertyBase* property)
+    {
+        auto& links = *(property->m_links);
+
+        // Also stops at cycles
+        if(links.visit_pass == g_visit_pass)
+        {
+            return;
+        }
+
+        links.visit_pass = g_visit_pass;
+
+        for(auto output : links.list_outputs)
+        {
+            visit(output);
+        }
+
+        links.order_index = g_list_order.size();
+        g_list_order.push_back(property);
+    }
+
+    void PropertyTransaction::flush()
+    {
+        g_flushing = true;
+
+        // Notification handlers may change other Properties
+        // which appends to g_list_pending, so we can't use
+        // iterators or references here
+        std::size_t i=0;
+
+        try
+        {
+            for(;;)
+            {
+                // Bindings affected by the changes so far are
+                // evaluated before anything is notified
+                resolveBindings();
+
+                if(i == g_list_pending.size())
+                {
+                    break;
+                }
+
+                // Clear the entry before notifying; the handler
+                // may change the property again (queueing it at
+                // a new index) and destroy it
+                PendingNotify const pending = g_list_pending[i];
+                g_list_pending[i].property = nullptr;
+                i++;
+
+                if(pending.property)
+                {
+                    pending.property->m_notify_index = k_invalid_index;
+                    pending.notify(pending.property);
+                }
+            }
+        }
+        catch(...)
+        {
+            // Sent notifications have been cleared, the rest
+            // keep their indices and go out with the next commit
+            g_flushing = false;
+            throw;
+        }
+
+        g_list_pending.clear();
+        g_flushing = false;
+    }
+
+    // ============================================================= //
+
+    PropertyBase::CaptureScope::CaptureScope(PropertyBase* property) :
+        m_prev(g_capture)
+    {
+        g_capture = property;
+    }
+
+    PropertyBase::CaptureScope::~CaptureScope()
+    {
+        g_capture = m_prev;
+    }
+
+    // ============================================================= //
+
+    PropertyBase::PropertyBase() :
+        m_notify_index(k_invalid_index)
+    {}
+
+    PropertyBase::~PropertyBase()
+    {
+        PropertyTransaction::cancelNotify(this);
+
+        if(!m_links)
+        {
+            return;
+        }
+
+        PropertyTransaction::cancelBinding(this);
+        clearInputs();
+
+        for(auto output : m_links->list_outputs)
+        {
+            auto& list_inputs = output->m_links->list_inputs;
+            list_inputs.erase(
+                        std::remove(list_inputs.begin(),list_inputs.end(),this),
+                        list_inputs.end());
+        }
+    }
+
+    void PropertyBase::captureAsInput() const
+    {
+        PropertyBase* binding = g_capture;
+        if(binding == nullptr || binding == this)
+        {
+            return;
+        }
+
+        PropertyBase* input = const_cast<PropertyBase*>(this);
+
+        auto& list_inputs = binding->getLinks().list_inputs;
+        if(std::find(list_inputs.begin(),list_inputs.end(),input) !=
+           list_inputs.end())
+        {
+            return;
+        }
+
+        list_inputs.push_back(input);
+        getLinks().list_outputs.push_back(binding);
+    }
+
+    void PropertyBase::setBinding(std::function<void()> evaluate)
+    {
+        auto& links = getLinks();
+        PropertyTransaction::cancelBinding(this);
+        links.evaluate = std::move(evaluate);
+        evaluateBinding();
+    }
+
+    void PropertyBase::clearBinding()
+    {
+        if(!m_links || !m_links->evaluate)
+        {
+            return;
+        }
+
+        PropertyTransaction::cancelBinding(this);
+        clearInputs();
+        m_links->evaluate = nullptr;
+    }
+
+    bool PropertyBase::queueChange(PropertyTransaction::QueuedNotifyFn notify)
+    {
+        g_change_count++;
+
+        bool const has_outputs =
+                (m_links && !m_links->list_outputs.empty());
+
+        if(PropertyTransaction::GetIsOpen())
+        {
+            PropertyTransaction::queueNotify(this,notify);
+            if(has_outputs)
+            {
+                queueOutputs();
+            }
+            return true;
+        }
+
+        if(!has_outputs)
+        {
+            return false;
+        }
+
+        // Dependent bindings are evaluated (and everything
+        // is notified) when this transaction commits
+        PropertyTransaction transaction;
+        PropertyTransaction::queueNotify(this,notify);
+        queueOutputs();
+
+        return true;
+    }
+
+    void PropertyBase::evaluateBinding()
+    {
+        // Inputs are captured again since they can differ
+        // between evaluations (ie. conditionals)
+        clearInputs();
+        m_links->evaluate();
+    }
+
+    void PropertyBase::queueOutputs()
+    {
+        for(auto output : m_links->list_outputs)
+        {
+            PropertyTransaction::queueBinding(output);
+        }
+    }
+
+    void PropertyBase::clearInputs()
+    {
+        for(auto input : m_links->list_inputs)
+        {
+            auto& list_outputs = input->m_links->list_outputs;
+            list_outputs.erase(
+                        std::remove(list_outputs.begin(),list_outputs.end(),this),
+                        list_outputs.end());
+        }
+
+        m_links->list_inputs.clear();
+    }
+
+    PropertyBase::Links& PropertyBase::getLinks() const
+    {
+        if(!m_links)
+        {
+            m_links = make_unique<Links>();
+        }
+
+        return *m_links;
+    }
+
+    // ============================================================= //
+}
@@ -18,20 +18,248 @@
 #define RAINTK_PROPERTY_HPP
 
 #include <raintk/RainTkGlobal.hpp>
+#include <functional>
 #include <ks/shared/KsDynamicProperty.hpp>
 
 namespace raintk
 {
     // ============================================================= //
 
+    // PropertyTransaction
+    // * Defers the signal_changed notifications of all Properties
+    //   modified while the transaction is open until it's committed
+    // * On commit, every Property that changed is notified exactly
+    //   once, in the order it was first changed, no matter how many
+    //   times it was assigned during the transaction
+    // * Bindings that depend on changed Properties are evaluated
+    //   once on commit, in dependency order, before any
+    //   notifications are sent, so neither bindings nor
+    //   observers see intermediate values
+    // * Notifications that cause further Property changes while
+    //   committing are flushed as part of the same commit
+    // * Transactions can be nested; only the outermost transaction
+    //   flushes notifications
+    // * Assigned values are updated immediately, only notifications
+    //   and binding evaluation are deferred (so a bound Property
+    //   keeps its previous value until the transaction commits)
+    // * Transactions are per-thread (Properties are expected to be
+    //   modified from the Scene's thread)
+    // * Layouts (ie. Row, Column and Grid) open one in update() so
+    //   that each child, and anything bound to it, is notified once
+    //   after the whole layout has been placed instead of once per
+    //   assignment
+
+    // Usage example:
+    // {
+    //     PropertyTransaction transaction;
+    //     widget->x = mm(10);
+    //     widget->y = mm(10);
+    //     widget->width = mm(20);
+    //     widget->height = mm(20);
+    // } // <-- each property is notified once here
+
+    class PropertyBase;
+
+    class PropertyTransaction
+    {
+    public:
+        using NotifyFn = void(*)(void*);
+        using QueuedNotifyFn = void(*)(PropertyBase*);
+
+        PropertyTransaction();
+        PropertyTransaction(PropertyTransaction const &) = delete;
+        PropertyTransaction& operator=(PropertyTransaction const &) = delete;
+
+        // Commits the transaction if Commit() hasn't
+        // been called already
+        ~PropertyTransaction();
+
+        void Commit();
+
+        // Returns true if there's an open transaction (or one
+        // that is currently being committed) on this thread
+        static bool GetIsOpen();
+
+        // Returns the number of Property changes made on this
+        // thread so far. The Scene compares it between frames
+        // to find out if anything changed.
+        static u64 GetChangeCount();
+
+    private:
+        friend class PropertyBase;
+
+        // * Queue @notify to be called with @property when
+        //   the outermost transaction is committed
+        // * Does nothing if @property is already queued
+        static void queueNotify(PropertyBase* property,
+                                QueuedNotifyFn notify);
+
+        // * Remove the queued notification for @property
+        //   (ie. if @property is destroyed before commit)
+        static void cancelNotify(PropertyBase* property);
+
+        // Queue @property's binding to be evaluated before
+        // the next notification is sent
+        static void queueBinding(PropertyBase* property);
+
+        static void cancelBinding(PropertyBase* property);
+
+        // Evaluate all queued bindings in dependency order
+        static void resolveBindings();
+
+        static void visit(PropertyBase* property);
+
+        static void flush();
+
+        bool m_committed;
+    };
+
+    // ============================================================= //
+
+    // PropertyBase
+    // * The type independent part of a Property: its owner
+    //   notifier, its queued notification and the dependencies
+    //   between bindings
+    // * Bindings are evaluated here rather than by
+    //   ks::DynamicProperty so that they can be scheduled by
+    //   PropertyTransaction. Reading a Property while a binding
+    //   is evaluated records it as an input of that binding.
+    // * Dependency links are only allocated for Properties that
+    //   have a binding or are read by one
+    class PropertyBase
+    {
+    public:
+        PropertyBase(PropertyBase const &) = delete;
+        PropertyBase& operator=(PropertyBase const &) = delete;
+
+    protected:
+        PropertyBase();
+        ~PropertyBase();
+
+        // Record this Property as an input of the binding
+        // that's currently being evaluated (if any)
+        void captureAsInput() const;
+
+        // Call @binding with this Property as the capture
+        // target so that the Properties it reads are recorded
+        // as inputs. Nothing else (ie. notifications caused by
+        // assigning the result) should run while capturing.
+        template<typename Fn>
+        auto captureInputs(Fn const &binding) -> decltype(binding())
+        {
+            CaptureScope scope(this);
+            return binding();
+        }
+
+        // * Set the function that evaluates this Property's
+        //   binding and evaluate it
+        // * @evaluate should assign the result of the binding
+        //   without calling clearBinding
+        void setBinding(std::function<void()> evaluate);
+
+        void clearBinding();
+
+        // * Called when the value of this Property changes
+        // * Queues @notify and any dependent bindings with the
+        //   open transaction (opening one if there are dependent
+        //   bindings) and returns true
+        // * Returns false if nothing was queued; the caller
+        //   should notify directly
+        bool queueChange(PropertyTransaction::QueuedNotifyFn notify);
+
+        void* m_owner{nullptr};
+        PropertyTransaction::NotifyFn m_owner_notify{nullptr};
+
+    private:
+        friend class PropertyTransaction;
+
+        struct Links;
+
+        class CaptureScope
+        {
+        public:
+            CaptureScope(PropertyBase* property);
+            ~CaptureScope();
+
+        private:
+            PropertyBase* m_prev;
+        };
+
+        void evaluateBinding();
+        void queueOutputs();
+        void clearInputs();
+        Links& getLinks() const;
+
+        mutable unique_ptr<Links> m_links;
+        u32 m_notify_index;
+    };
+
+    // ============================================================= //
+
+    // LazySignal
+    // * Wraps a ks::Signal that is only allocated the first time
+    //   something connects to it
+    // * Most Properties are never observed by anything other than
+    //   their owner, so this saves the cost of a ks::Signal for
+    //   each of them
+    // * Has the same Connect/Disconnect/Emit interface as ks::Signal
+    template<typename... Args>
+    class LazySignal
+    {
+    public:
+        template<typename... ConnectArgs>
+        Id Connect(ConnectArgs&&... args)
+        {
+            if(!m_signal)
+            {
+                m_signal = make_unique<ks::Signal<Args...>>();
+            }
+
+            return m_signal->Connect(
+                        std::forward<ConnectArgs>(args)...);
+        }
+
+        void Disconnect(Id connection_id)
+        {
+            if(m_signal)
+            {
+                m_signal->Disconnect(connection_id);
+            }
+        }
+
+        template<typename... EmitArgs>
+        void Emit(EmitArgs&&... args)
+        {
+            if(m_signal)
+            {
+                m_signal->Emit(std::forward<EmitArgs>(args)...);
+            }
+        }
+
+        bool GetIsAllocated() const
+        {
+            return (m_signal != nullptr);
+        }
+
+    private:
+        unique_ptr<ks::Signal<Args...>> m_signal;
+    };
+
+    // ============================================================= //
+
+    // DynamicPropertyPushNotify
+    // DynamicPropertyPullNotify
+    // * ks::DynamicProperty with transaction aware notifications,
+    //   an owner notifier and raintk scheduled bindings
+    // * The Push version passes the new value to signal_changed
+
     template<typename T>
-    class DynamicPropertyPushNotify : public ks::DynamicProperty<T>
+    class DynamicPropertyPushNotify :
+            public PropertyBase,
+            public ks::DynamicProperty<T>
     {
     public:
-        // Need to explicitly have this to prevent compiler
-        // generated assignment operators from overriding
-        // and hiding the one we want to call
-        using ks::DynamicProperty<T>::operator=;
+        using BindingFn = typename ks::DynamicProperty<T>::BindingFn;
 
         DynamicPropertyPushNotify()
         {
@@ -44,32 +272,98 @@ namespace raintk
             this->setupNotifier();
         }
 
-        DynamicPropertyPushNotify(
-                typename ks::DynamicProperty<T>::BindingFn binding) :
-            ks::DynamicProperty<T>(std::move(binding))
+        DynamicPropertyPushNotify(BindingFn binding)
         {
             this->setupNotifier();
+            this->Bind(std::move(binding));
+        }
+
+        ~DynamicPropertyPushNotify() = default;
+
+        mutable LazySignal<T> signal_changed;
+
+        T const & Get() const
+        {
+            this->captureAsInput();
+            return ks::DynamicProperty<T>::Get();
         }
 
-        mutable ks::Signal<T> signal_changed;
+        void Assign(T value)
+        {
+            this->clearBinding();
+            ks::DynamicProperty<T>::Assign(std::move(value));
+        }
+
+        void Bind(BindingFn binding)
+        {
+            this->setBinding(
+                        [this,binding](){
+                            T value = this->captureInputs(binding);
+                            ks::DynamicProperty<T>::Assign(std::move(value));
+                        });
+        }
+
+        void operator=(T value)
+        {
+            this->Assign(std::move(value));
+        }
+
+        void operator=(BindingFn binding)
+        {
+            this->Bind(std::move(binding));
+        }
+
+        // * Set a function that's called directly with @owner
+        //   whenever this Property changes, before signal_changed
+        //   is emitted
+        // * Meant for the object that owns this Property so that
+        //   its own change handlers don't need a Signal connection
+        // * @owner must outlive this Property (ie. it should be
+        //   the object this Property is a member of)
+        void SetOwnerNotifier(void* owner, PropertyTransaction::NotifyFn notify)
+        {
+            m_owner = owner;
+            m_owner_notify = notify;
+        }
 
     private:
         void setupNotifier()
         {
             this->SetNotifier(
                         [this](T const &v) {
-                            signal_changed.Emit(v);
+                            if(!this->queueChange(
+                                   &DynamicPropertyPushNotify::notifyQueued))
+                            {
+                                notify(v);
+                            }
                         });
         }
+
+        void notify(T const &v)
+        {
+            if(m_owner_notify)
+            {
+                m_owner_notify(m_owner);
+            }
+            signal_changed.Emit(v);
+        }
+
+        static void notifyQueued(PropertyBase* p)
+        {
+            auto property = static_cast<DynamicPropertyPushNotify*>(p);
+            property->notify(property->ks::DynamicProperty<T>::Get());
+        }
     };
 
     // ============================================================= //
 
     template<typename T>
-    class DynamicPropertyPullNotify : public ks::DynamicProperty<T>
+    class DynamicPropertyPullNotify :
+            public PropertyBase,
+            public ks::DynamicProperty<T>
     {
     public:
-        using ks::DynamicProperty<T>::operator=;
+        using BindingFn = typename ks::DynamicProperty<T>::BindingFn;
 
         DynamicPropertyPullNotify()
         {
@@ -82,25 +376,84 @@ namespace raintk
             this->setupNotifier();
         }
 
-        DynamicPropertyPullNotify(
-                typename ks::DynamicProperty<T>::BindingFn binding) :
-            ks::DynamicProperty<T>(std::move(binding))
+        DynamicPropertyPullNotify(BindingFn binding)
         {
             this->setupNotifier();
+            this->Bind(std::move(binding));
+        }
+
+        ~DynamicPropertyPullNotify() = default;
+
+        mutable LazySignal<> signal_changed;
+
+        T const & Get() const
+        {
+            this->captureAsInput();
+            return ks::DynamicProperty<T>::Get();
+        }
+
+        void Assign(T value)
+        {
+            this->clearBinding();
+            ks::DynamicProperty<T>::Assign(std::move(value));
+        }
+
+        void Bind(BindingFn binding)
+        {
+            this->setBinding(
+                        [this,binding](){
+                            T value = this->captureInputs(binding);
+                            ks::DynamicProperty<T>::Assign(std::move(value));
+                        });
+        }
+
+        void operator=(T value)
+        {
+            this->Assign(std::move(value));
+        }
+
+        void operator=(BindingFn binding)
+        {
+            this->Bind(std::move(binding));
         }
 
-        mutable ks::Signal<> signal_changed;
+        // * See DynamicPropertyPushNotify::SetOwnerNotifier
+        void SetOwnerNotifier(void* owner, PropertyTransaction::NotifyFn notify)
+        {
+            m_owner = owner;
+            m_owner_notify = notify;
+        }
 
     private:
         void setupNotifier()
         {
             this->SetNotifier(
                         [this](T const &) {
-                            signal_changed.Emit();
+                            if(!this->queueChange(
+                                   &DynamicPropertyPullNotify::notifyQueued))
+                            {
+                                notify();
+                            }
                         });
         }
+
+        void notify()
+        {
+            if(m_owner_notify)
+            {
+                m_owner_notify(m_owner);
+            }
+            signal_changed.Emit();
+        }
+
+        static void notifyQueued(PropertyBase* p)
+        {
+            static_cast<DynamicPropertyPullNotify*>(p)->notify();
+        }
     };
 
+    // ============================================================= //
+
     template<typename T>
     using Property = DynamicPropertyPullNotify<T>;
 
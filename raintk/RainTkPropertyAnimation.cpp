@@ -0,0 +1,384 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+#include <raintk/RainTkPropertyAnimation.hpp>
+
+namespace raintk
+{
+    namespace
+    {
+        // Avoids dividing by zero for tracks with no duration;
+        // they jump to their final value once their delay ends
+        float const k_min_duration_ms = 0.001f;
+
+        uint GetGroupIndex(Tween::Curve curve,
+                           Tween::Easing easing,
+                           uint component_count)
+        {
+            return ((static_cast<uint>(curve)*Tween::EasingCount)+
+                    static_cast<uint>(easing))*2 + (component_count-1);
+        }
+    }
+
+    // ============================================================= //
+
+    PropertyAnimationTrackNotFound::PropertyAnimationTrackNotFound(std::string msg) :
+        ks::Exception(ks::Exception::ErrorLevel::ERROR,std::move(msg),false)
+    {}
+
+    // ============================================================= //
+
+    PropertyAnimation::PropertyAnimation(ks::Object::Key const &key,
+                                         Scene* scene) :
+        Animation(key,scene),
+        m_list_groups(Tween::CurveCount*Tween::EasingCount*2),
+        m_next_track_id(1),
+        m_elapsed_ms(0.0f),
+        m_end_ms(0.0f)
+    {
+        for(uint c=0; c < Tween::CurveCount; c++)
+        {
+            for(uint e=0; e < Tween::EasingCount; e++)
+            {
+                for(uint n=1; n <= 2; n++)
+                {
+                    auto const curve = static_cast<Tween::Curve>(c);
+                    auto const easing = static_cast<Tween::Easing>(e);
+
+                    auto& group = m_list_groups[GetGroupIndex(curve,easing,n)];
+                    group.curve = curve;
+                    group.easing = easing;
+                    group.component_count = n;
+                }
+            }
+        }
+    }
+
+    void PropertyAnimation::Init(ks::Object::Key const &,
+                                 shared_ptr<PropertyAnimation> const &)
+    {}
+
+    PropertyAnimation::~PropertyAnimation()
+    {}
+
+    Id PropertyAnimation::AddTrack(Property<float>* property,
+                                   float initial,
+                                   float final,
+                                   float duration_ms,
+                                   Tween::Curve curve,
+                                   Tween::Easing easing,
+                                   float delay_ms)
+    {
+        auto& group = getGroup(curve,easing,1);
+        auto const slot = addTrack(group,&initial,&final,duration_ms,delay_ms);
+        group.list_float_props.push_back(property);
+
+        return group.list_ids[slot];
+    }
+
+    Id PropertyAnimation::AddTrack(Property<glm::vec2>* property,
+                                   glm::vec2 const &initial,
+                                   glm::vec2 const &final,
+                                   float duration_ms,
+                                   Tween::Curve curve,
+                                   Tween::Easing easing,
+                                   float delay_ms)
+    {
+        float const list_initial[2] = { initial.x, initial.y };
+        float const list_final[2] = { final.x, final.y };
+
+        auto& group = getGroup(curve,easing,2);
+        auto const slot = addTrack(group,list_initial,list_final,duration_ms,delay_ms);
+        group.list_vec2_props.push_back(property);
+
+        return group.list_ids[slot];
+    }
+
+    void PropertyAnimation::RemoveTrack(Id track_id)
+    {
+        auto lkup_it = m_lkup_track_location.find(track_id);
+        if(lkup_it == m_lkup_track_location.end())
+        {
+            throw PropertyAnimationTrackNotFound(
+                        "PropertyAnimation: Invalid track id: "+
+                        ks::ToString(track_id));
+        }
+
+        auto& group = m_list_groups[lkup_it->second.group];
+        std::size_t const slot = lkup_it->second.slot;
+        std::size_t const last = group.list_ids.size()-1;
+        uint const n = group.component_count;
+
+        m_lkup_track_location.erase(lkup_it);
+
+        // Move the last track into the removed slot so
+        // the arrays stay contiguous
+        if(slot != last)
+        {
+            group.list_ids[slot] = group.list_ids[last];
+            group.list_delay_ms[slot] = group.list_delay_ms[last];
+            group.list_duration_ms[slot] = group.list_duration_ms[last];
+            group.list_inv_duration[slot] = group.list_inv_duration[last];
+
+            for(uint c=0; c < n; c++)
+            {
+                group.list_initial[slot*n+c] = group.list_initial[last*n+c];
+                group.list_delta[slot*n+c] = group.list_delta[last*n+c];
+                group.list_value[slot*n+c] = group.list_value[last*n+c];
+            }
+
+            if(n == 1)
+            {
+                group.list_float_props[slot] = group.list_float_props[last];
+            }
+            else
+            {
+                group.list_vec2_props[slot] = group.list_vec2_props[last];
+            }
+
+            m_lkup_track_location[group.list_ids[slot]].slot = slot;
+        }
+
+        group.list_ids.pop_back();
+        group.list_delay_ms.pop_back();
+        group.list_duration_ms.pop_back();
+        group.list_inv_duration.pop_back();
+        group.list_k.pop_back();
+        group.list_initial.resize(last*n);
+        group.list_delta.resize(last*n);
+        group.list_value.resize(last*n);
+
+        if(n == 1)
+        {
+            group.list_float_props.pop_back();
+        }
+        else
+        {
+            group.list_vec2_props.pop_back();
+        }
+
+        calcEndTime();
+    }
+
+    void PropertyAnimation::ClearTracks()
+    {
+        for(auto& group : m_list_groups)
+        {
+            group.list_ids.clear();
+            group.list_delay_ms.clear();
+            group.list_duration_ms.clear();
+            group.list_inv_duration.clear();
+            group.list_k.clear();
+            group.list_initial.clear();
+            group.list_delta.clear();
+            group.list_value.clear();
+            group.list_float_props.clear();
+            group.list_vec2_props.clear();
+        }
+
+        m_lkup_track_location.clear();
+        m_end_ms = 0.0f;
+    }
+
+    std::size_t PropertyAnimation::GetTrackCount() const
+    {
+        return m_lkup_track_location.size();
+    }
+
+    void PropertyAnimation::start()
+    {
+        m_elapsed_ms = 0.0f;
+    }
+
+    bool PropertyAnimation::update(float delta_ms)
+    {
+        m_elapsed_ms += delta_ms;
+
+        for(auto& group : m_list_groups)
+        {
+            if(!group.list_ids.empty())
+            {
+                evalGroup(group,m_elapsed_ms);
+                writeGroup(group);
+            }
+        }
+
+        return (m_elapsed_ms >= m_end_ms);
+    }
+
+    void PropertyAnimation::complete()
+    {
+        // Jump to the final values
+        m_elapsed_ms = m_end_ms;
+
+        for(auto& group : m_list_groups)
+        {
+            if(!group.list_ids.empty())
+            {
+                evalGroup(group,m_elapsed_ms);
+                writeGroup(group);
+            }
+        }
+    }
+
+    PropertyAnimation::TrackGroup&
+    PropertyAnimation::getGroup(Tween::Curve curve,
+                                Tween::Easing easing,
+                                uint component_count)
+    {
+        return m_list_groups[GetGroupIndex(curve,easing,component_count)];
+    }
+
+    std::size_t PropertyAnimation::addTrack(TrackGroup& group,
+                                            float const * initial,
+                                            float const * final,
+                                            float duration_ms,
+                                            float delay_ms)
+    {
+        Id const track_id = m_next_track_id++;
+        std::size_t const slot = group.list_ids.size();
+
+        group.list_ids.push_back(track_id);
+        group.list_delay_ms.push_back(delay_ms);
+        group.list_duration_ms.push_back(duration_ms);
+        group.list_inv_duration.push_back(
+                    1.0f/std::max(duration_ms,k_min_duration_ms));
+        group.list_k.push_back(0.0f);
+
+        for(uint c=0; c < group.component_count; c++)
+        {
+            group.list_initial.push_back(initial[c]);
+            group.list_delta.push_back(final[c]-initial[c]);
+            group.list_value.push_back(initial[c]);
+        }
+
+        m_lkup_track_location.emplace(
+                    track_id,
+                    TrackLocation{
+                        GetGroupIndex(
+                            group.curve,
+                            group.easing,
+                            group.component_count),
+                        slot});
+
+        m_end_ms = std::max(m_end_ms,delay_ms+duration_ms);
+
+        return slot;
+    }
+
+    void PropertyAnimation::evalGroup(TrackGroup& group, float elapsed_ms)
+    {
+        std::size_t const track_count = group.list_ids.size();
+        uint const n = group.component_count;
+
+        float const * list_delay_ms = group.list_delay_ms.data();
+        float const * list_duration_ms = group.list_duration_ms.data();
+        float const * list_inv_duration = group.list_inv_duration.data();
+        float const * list_initial = group.list_initial.data();
+        float const * list_delta = group.list_delta.data();
+        float * list_k = group.list_k.data();
+        float * list_value = group.list_value.data();
+
+        // Normalized time
+        // * Measured back from the end time so that t is exactly
+        //   1 at delay+duration, which is also when the animation
+        //   ends (even for zero duration tracks)
+        for(std::size_t i=0; i < track_count; i++)
+        {
+            float const t =
+                    (elapsed_ms-list_delay_ms[i]-list_duration_ms[i])*
+                    list_inv_duration[i]+1.0f;
+
+            list_k[i] = std::min(std::max(t,0.0f),1.0f);
+        }
+
+        // Interpolation factor
+        Tween::EvalBatch(group.curve,group.easing,list_k,list_k,track_count);
+
+        // Values
+        if(n == 1)
+        {
+            for(std::size_t i=0; i < track_count; i++)
+            {
+                list_value[i] = list_initial[i]+(list_k[i]*list_delta[i]);
+            }
+        }
+        else
+        {
+            for(std::size_t i=0; i < track_count; i++)
+            {
+                list_value[2*i] = list_initial[2*i]+(list_k[i]*list_delta[2*i]);
+                list_value[2*i+1] = list_initial[2*i+1]+(list_k[i]*list_delta[2*i+1]);
+            }
+        }
+    }
+
+    void PropertyAnimation::writeGroup(TrackGroup const &group)
+    {
+        // Properties that haven't changed (ie. tracks that are
+        // delayed or finished) aren't assigned to avoid sending
+        // redundant notifications
+        if(group.component_count == 1)
+        {
+            for(std::size_t i=0; i < group.list_float_props.size(); i++)
+            {
+                float const value = group.list_value[i];
+                auto property = group.list_float_props[i];
+
+                if(property->Get() != value)
+                {
+                    property->Assign(value);
+                }
+            }
+        }
+        else
+        {
+            for(std::size_t i=0; i < group.list_vec2_props.size(); i++)
+            {
+                glm::vec2 const value{
+                    group.list_value[2*i],
+                    group.list_value[2*i+1]
+                };
+
+                auto property = group.list_vec2_props[i];
+
+                if(property->Get() != value)
+                {
+                    property->Assign(value);
+                }
+            }
+        }
+    }
+
+    void PropertyAnimation::calcEndTime()
+    {
+        m_end_ms = 0.0f;
+
+        for(auto const &group : m_list_groups)
+        {
+            for(std::size_t i=0; i < group.list_ids.size(); i++)
+            {
+                m_end_ms = std::max(
+                            m_end_ms,
+                            group.list_delay_ms[i]+
+                            group.list_duration_ms[i]);
+            }
+        }
+    }
+
+    // ============================================================= //
+}
@@ -0,0 +1,165 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef RAINTK_PROPERTY_ANIMATION_HPP
+#define RAINTK_PROPERTY_ANIMATION_HPP
+
+#include <vector>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include <ks/KsException.hpp>
+#include <raintk/RainTkProperty.hpp>
+#include <raintk/RainTkAnimation.hpp>
+#include <raintk/RainTkTween.hpp>
+
+namespace raintk
+{
+    // ============================================================= //
+
+    class PropertyAnimationTrackNotFound : public ks::Exception
+    {
+    public:
+        PropertyAnimationTrackNotFound(std::string msg);
+        ~PropertyAnimationTrackNotFound() = default;
+    };
+
+    // ============================================================= //
+
+    // PropertyAnimation
+    // * Tweens any number of float and vec2 Properties with a
+    //   single Animation
+    // * Tracks are stored in contiguous arrays grouped by their
+    //   curve, easing and type, and each group is evaluated as
+    //   one batch (see Tween::EvalBatch) before the results are
+    //   written back to the Properties in a single pass
+    // * Use this instead of an Animation per Property when there
+    //   are many Properties to animate (ie. particles or fading
+    //   in list items) since the per frame cost is then mostly
+    //   the tween maths rather than virtual calls and pointer
+    //   chasing
+    // * All tracks share the animation's clock. A track's delay
+    //   is relative to Start() and the animation completes once
+    //   every track has reached its final value
+    // * Properties must outlive the tracks that reference them
+
+    // Usage example:
+    // auto anim = ks::MakeObject<PropertyAnimation>(scene);
+    // for(auto& item : list_items) {
+    //     anim->AddTrack(&(item->opacity),0.0f,1.0f,250.0f,
+    //                    Tween::Curve::Quad,Tween::Easing::Out);
+    // }
+    // anim->Start();
+
+    class PropertyAnimation : public Animation
+    {
+    public:
+        using base_type = raintk::Animation;
+
+        PropertyAnimation(ks::Object::Key const &key,
+                          Scene* scene);
+
+        void Init(ks::Object::Key const &key,
+                  shared_ptr<PropertyAnimation> const &this_anim);
+
+        ~PropertyAnimation();
+
+        // Returns an id that can be used to remove the track
+        Id AddTrack(Property<float>* property,
+                    float initial,
+                    float final,
+                    float duration_ms,
+                    Tween::Curve curve=Tween::Curve::Linear,
+                    Tween::Easing easing=Tween::Easing::In,
+                    float delay_ms=0.0f);
+
+        Id AddTrack(Property<glm::vec2>* property,
+                    glm::vec2 const &initial,
+                    glm::vec2 const &final,
+                    float duration_ms,
+                    Tween::Curve curve=Tween::Curve::Linear,
+                    Tween::Easing easing=Tween::Easing::In,
+                    float delay_ms=0.0f);
+
+        void RemoveTrack(Id track_id);
+        void ClearTracks();
+
+        std::size_t GetTrackCount() const;
+
+    private:
+        void start() override;
+        bool update(float delta_ms) override;
+        void complete() override;
+
+        // Tracks with the same curve, easing and number of
+        // components. Per track data is indexed by slot and
+        // per component data by (slot*component_count)+c
+        struct TrackGroup
+        {
+            Tween::Curve curve;
+            Tween::Easing easing;
+            uint component_count;
+
+            std::vector<Id> list_ids;
+            std::vector<float> list_delay_ms;
+            std::vector<float> list_duration_ms;
+            std::vector<float> list_inv_duration;
+
+            // Scratch space for the interpolation factor
+            std::vector<float> list_k;
+
+            std::vector<float> list_initial;
+            std::vector<float> list_delta;
+            std::vector<float> list_value;
+
+            // Only one of these is used, based on component_count
+            std::vector<Property<float>*> list_float_props;
+            std::vector<Property<glm::vec2>*> list_vec2_props;
+        };
+
+        struct TrackLocation
+        {
+            uint group;
+            std::size_t slot;
+        };
+
+        TrackGroup& getGroup(Tween::Curve curve,
+                             Tween::Easing easing,
+                             uint component_count);
+
+        std::size_t addTrack(TrackGroup& group,
+                             float const * initial,
+                             float const * final,
+                             float duration_ms,
+                             float delay_ms);
+
+        void evalGroup(TrackGroup& group, float elapsed_ms);
+        void writeGroup(TrackGroup const &group);
+
+        void calcEndTime();
+
+        // Indexed by ((curve*EasingCount)+easing)*2 + (component_count-1)
+        std::vector<TrackGroup> m_list_groups;
+        std::unordered_map<Id,TrackLocation> m_lkup_track_location;
+
+        Id m_next_track_id;
+        float m_elapsed_ms;
+        float m_end_ms;
+    };
+
+    // ============================================================= //
+}
+
+#endif // RAINTK_PROPERTY_ANIMATION_HPP
@@ -103,18 +103,24 @@ namespace raintk
 
     void Rectangle::onColorChanged()
     {
+        m_upd_color = true;
+
         auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
         upd_data.update |= UpdateData::UpdateDrawables;
     }
 
     void Rectangle::onWidthChanged()
     {
+        m_upd_geometry = true;
+
         auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
         upd_data.update |= UpdateData::UpdateDrawables;
     }
 
     void Rectangle::onHeightChanged()
     {
+        m_upd_geometry = true;
+
         auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
         upd_data.update |= UpdateData::UpdateDrawables;
     }
@@ -125,14 +131,24 @@ namespace raintk
         draw_data.key.SetClip(m_clip_id);
     }
 
+    void Rectangle::onLayerIdUpdated()
+    {
+        auto& draw_data = m_cmlist_draw_data->GetComponent(m_entity_id);
+        draw_data.key.SetLayer(m_layer_id);
+    }
+
     void Rectangle::onTransformUpdated()
     {
+        m_upd_geometry = true;
+
         auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
         upd_data.update |= UpdateData::UpdateDrawables;
     }
 
     void Rectangle::onAccOpacityUpdated()
     {
+        m_upd_color = true;
+
         auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
         upd_data.update |= UpdateData::UpdateDrawables;
     }
@@ -141,7 +157,7 @@ namespace raintk
     {
         // Destroy DrawData if it already exists
         // (is this really necessary?)
-        if(m_scene->GetEntityHasComponents<DrawData>(m_entity_id))
+        if(m_cmlist_draw_data->GetHasComponent(m_entity_id))
         {
             destroyDrawables();
         }
@@ -157,6 +173,8 @@ namespace raintk
         // UpdateData
         m_cmlist_update_data->GetComponent(m_entity_id).
                 update |= UpdateData::UpdateDrawables;
+
+        m_upd_geometry = true;
     }
 
     void Rectangle::destroyDrawables()
@@ -166,17 +184,23 @@ namespace raintk
 
     void Rectangle::updateDrawables()
     {
-        updateGeometry();
+        if(m_upd_geometry)
+        {
+            updateGeometry();
+        }
+        else if(m_upd_color)
+        {
+            updateColor();
+        }
+
+        m_upd_geometry = false;
+        m_upd_color = false;
     }
 
-    void Rectangle::updateGeometry()
+    // Sets the opaque or transparent DrawKey depending on the
+    // final opacity and returns the premultiplied vertex color
+    glm::u8vec4 Rectangle::updateDrawKey(DrawData& draw_data)
     {
-        auto& draw_data = m_cmlist_draw_data->GetComponent(m_entity_id);
-        auto& list_vx = draw_data.vx_buffer;
-
-        list_vx->clear();
-        list_vx->reserve(6*sizeof(Vertex));
-
         auto const o = m_accumulated_opacity;
         glm::u8vec4 rgba = color.Get();
 
@@ -186,19 +210,49 @@ namespace raintk
         {
             draw_data.key = g_draw_key_xpr;
             draw_data.key.SetClip(m_clip_id);
+            draw_data.key.SetLayer(m_layer_id);
         }
         else
         {
             draw_data.key = g_draw_key_opq;
             draw_data.key.SetClip(m_clip_id);
+            draw_data.key.SetLayer(m_layer_id);
         }
 
-        glm::u8vec4 const c {
+        return glm::u8vec4{
             static_cast<u8>(rgba.r*final_opacity),
             static_cast<u8>(rgba.g*final_opacity),
             static_cast<u8>(rgba.b*final_opacity),
             static_cast<u8>(rgba.a*o)
         };
+    }
+
+    void Rectangle::updateColor()
+    {
+        auto& draw_data = m_cmlist_draw_data->GetComponent(m_entity_id);
+        glm::u8vec4 const c = updateDrawKey(draw_data);
+
+        Vertex* vx_buffer =
+                reinterpret_cast<Vertex*>(
+                    &(draw_data.vx_buffer->front()));
+
+        uint const vx_count = draw_data.vx_buffer->size()/sizeof(Vertex);
+
+        for(uint i=0; i < vx_count; i++)
+        {
+            vx_buffer[i].a_v4_color = c;
+        }
+    }
+
+    void Rectangle::updateGeometry()
+    {
+        auto& draw_data = m_cmlist_draw_data->GetComponent(m_entity_id);
+        auto& list_vx = draw_data.vx_buffer;
+
+        list_vx->clear();
+        list_vx->reserve(6*sizeof(Vertex));
+
+        glm::u8vec4 const c = updateDrawKey(draw_data);
 
         auto const w = width.Get();
         auto const h = height.Get();
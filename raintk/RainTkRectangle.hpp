@@ -48,6 +48,7 @@ namespace raintk
         void onHeightChanged() override;
 
         void onClipIdUpdated() override;
+        void onLayerIdUpdated() override;
         void onTransformUpdated() override;
         void onAccOpacityUpdated() override;
 
@@ -61,7 +62,14 @@ namespace raintk
 
     private:
         void updateGeometry();
+        void updateColor();
+        glm::u8vec4 updateDrawKey(DrawData& draw_data);
         static void setupTypeInit(Scene* scene);
+
+        // Color and opacity changes only rewrite the
+        // color of the existing vertices
+        bool m_upd_geometry{true};
+        bool m_upd_color{false};
     };
 }
 
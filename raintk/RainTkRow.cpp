@@ -22,7 +22,10 @@ namespace raintk
     Row::Row(ks::Object::Key const &key,
              Scene* scene,
              shared_ptr<Widget> parent) :
-        Widget(key,scene,parent)
+        Widget(key,scene,parent),
+        m_list_offsets(1,0.0f),
+        m_dirty_index(0),
+        m_rescan_height(false)
     {
 
     }
@@ -45,38 +48,45 @@ namespace raintk
 
     Row::~Row()
     {
-
+        // The child connections capture this Row so they
+        // must be removed in case the children outlive it
+        for(auto& item : m_list_items)
+        {
+            item.widget->width.signal_changed.Disconnect(item.cid_width);
+            item.widget->height.signal_changed.Disconnect(item.cid_height);
+        }
     }
 
     void Row::AddChild(shared_ptr<Widget> const &child)
     {
         Widget::AddChild(child);
 
-        shared_ptr<Row> this_row =
-                std::static_pointer_cast<Row>(
-                    shared_from_this());
+        Widget* child_ptr = child.get();
 
         Item new_item;
-        new_item.widget = child.get();
+        new_item.widget = child_ptr;
+        new_item.width = 0.0f;
+        new_item.height = 0.0f;
 
         new_item.cid_width =
                 child->width.signal_changed.Connect(
-                    this_row,
-                    &Row::onChildDimsChanged,
-                    ks::ConnectionType::Direct);
+                    [this,child_ptr](){
+                        onChildDimsChanged(child_ptr);
+                    });
 
         new_item.cid_height =
                 child->height.signal_changed.Connect(
-                    this_row,
-                    &Row::onChildDimsChanged,
-                    ks::ConnectionType::Direct);
+                    [this,child_ptr](){
+                        onChildDimsChanged(child_ptr);
+                    });
 
         // Save in row list
-        auto it = m_list_items.insert(
-                    m_list_items.end(),
-                    new_item);
+        std::size_t const index = m_list_items.size();
+        m_list_items.push_back(new_item);
+        m_list_offsets.push_back(m_list_offsets.back());
+        m_lkup_id_index.emplace(child->GetId(),index);
 
-        m_lkup_id_item_it.emplace(child->GetId(),it);
+        m_dirty_index = std::min(m_dirty_index,index);
 
         m_cmlist_update_data->GetComponent(m_entity_id).
                 update |= UpdateData::UpdateWidget;
@@ -84,16 +94,34 @@ namespace raintk
 
     void Row::RemoveChild(shared_ptr<Widget> const &child)
     {
-        auto lkup_it = m_lkup_id_item_it.find(child->GetId());
-        if(lkup_it != m_lkup_id_item_it.end())
+        auto lkup_it = m_lkup_id_index.find(child->GetId());
+        if(lkup_it != m_lkup_id_index.end())
         {
-            auto it = lkup_it->second;
+            std::size_t const index = lkup_it->second;
+            auto& item = m_list_items[index];
+
+            item.widget->width.signal_changed.Disconnect(item.cid_width);
+            item.widget->height.signal_changed.Disconnect(item.cid_height);
+
+            // If the removed item was the tallest one,
+            // children_height has to be recalculated
+            if(item.height >= children_height.Get())
+            {
+                m_rescan_height = true;
+            }
+
+            m_list_items.erase(m_list_items.begin()+index);
+            m_lkup_id_index.erase(lkup_it);
+
+            // Offsets after @index are recalculated in update()
+            m_list_offsets.pop_back();
 
-            it->widget->width.signal_changed.Disconnect(it->cid_width);
-            it->widget->height.signal_changed.Disconnect(it->cid_height);
+            for(std::size_t i=index; i < m_list_items.size(); i++)
+            {
+                m_lkup_id_index[m_list_items[i].widget->GetId()] = i;
+            }
 
-            m_list_items.erase(it);
-            m_lkup_id_item_it.erase(lkup_it);
+            m_dirty_index = std::min(m_dirty_index,index);
 
             m_cmlist_update_data->GetComponent(m_entity_id).
                     update |= UpdateData::UpdateWidget;
@@ -104,48 +132,106 @@ namespace raintk
 
     void Row::onSpacingChanged()
     {
+        m_dirty_index = 0;
+
         m_cmlist_update_data->GetComponent(m_entity_id).
                 update |= UpdateData::UpdateWidget;
     }
 
     void Row::onLayoutDirectionChanged()
     {
+        m_dirty_index = 0;
+
         m_cmlist_update_data->GetComponent(m_entity_id).
                 update |= UpdateData::UpdateWidget;
     }
 
-    void Row::onChildDimsChanged()
+    void Row::onChildDimsChanged(Widget* child)
     {
+        auto lkup_it = m_lkup_id_index.find(child->GetId());
+        if(lkup_it != m_lkup_id_index.end())
+        {
+            m_dirty_index = std::min(m_dirty_index,lkup_it->second);
+        }
+
         m_cmlist_update_data->GetComponent(m_entity_id).
                 update |= UpdateData::UpdateWidget;
     }
 
     void Row::update()
     {
+        // Notify children once (see PropertyTransaction)
+        PropertyTransaction transaction;
+
         float const spacing_val = spacing.Get();
-        float row_height=0;
-        float left = 0;
+        std::size_t const item_count = m_list_items.size();
+        std::size_t const dirty_index = m_dirty_index;
+        m_dirty_index = item_count;
 
-        for(auto& item : m_list_items)
+        // Only items from the first dirty index onward can have
+        // new dims, and only their offsets need to be recalculated
+        float row_height = (dirty_index == 0) ? 0.0f : children_height.Get();
+        bool rescan_height = m_rescan_height;
+        m_rescan_height = false;
+
+        for(std::size_t i=dirty_index; i < item_count; i++)
         {
-            item.widget->x = left;
-            left += (item.widget->width.Get()+spacing_val);
-            row_height = std::max(item.widget->height.Get(),row_height);
+            auto& item = m_list_items[i];
+            float const height = item.widget->height.Get();
+
+            if(height > row_height)
+            {
+                row_height = height;
+            }
+            else if(item.height == row_height && height < item.height)
+            {
+                // The tallest item shrank
+                rescan_height = true;
+            }
+
+            item.width = item.widget->width.Get();
+            item.height = height;
+
+            m_list_offsets[i+1] = m_list_offsets[i]+item.width+spacing_val;
+        }
+
+        if(rescan_height)
+        {
+            row_height = 0.0f;
+            for(auto const &item : m_list_items)
+            {
+                row_height = std::max(item.height,row_height);
+            }
+        }
+
+        float const row_width = m_list_offsets[item_count]-spacing_val;
+        bool const right_to_left =
+                (layout_direction.Get() == LayoutDirection::RightToLeft);
+
+        // Items are positioned relative to the right edge for
+        // RightToLeft so they all move if the row width changes
+        std::size_t first_moved = dirty_index;
+        if(right_to_left && row_width != children_width.Get())
+        {
+            first_moved = 0;
         }
 
-        float const row_width = left-spacing_val;
         children_width = row_width;
         children_height = row_height;
 
-        if(layout_direction.Get() == LayoutDirection::RightToLeft)
+        for(std::size_t i=first_moved; i < item_count; i++)
         {
-            for(auto& item : m_list_items)
+            auto const &item = m_list_items[i];
+
+            float x = m_list_offsets[i];
+            if(right_to_left)
             {
-                float right =
-                        item.widget->x.Get() +
-                        item.widget->width.Get();
+                x = ((x+item.width)*-1.0f)+row_width;
+            }
 
-                item.widget->x = (right*-1.0)+row_width;
+            if(item.widget->x.Get() != x)
+            {
+                item.widget->x = x;
             }
         }
     }
@@ -19,14 +19,21 @@
 #include <ks/gl/KsGLCommands.hpp>
 #include <ks/shared/KsImage.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 #include <raintk/RainTkLog.hpp>
 #include <raintk/RainTkUnits.hpp>
 #include <raintk/RainTkScene.hpp>
+#include <raintk/RainTkProperty.hpp>
 
 #include <raintk/RainTkInputSystem.hpp>
 #include <raintk/RainTkAnimationSystem.hpp>
 #include <raintk/RainTkTransformSystem.hpp>
 #include <raintk/RainTkDrawSystem.hpp>
+#include <raintk/RainTkFramePacer.hpp>
+#include <raintk/RainTkTextureShadow.hpp>
+#include <raintk/RainTkGlyphPageStore.hpp>
 
 #include <raintk/RainTkWidget.hpp>
 #include <raintk/RainTkMainDrawStage.hpp>
@@ -37,14 +44,64 @@
 
 namespace raintk
 {
+    namespace
+    {
+        // How often events are processed while there's
+        // nothing to update
+        Milliseconds const k_idle_poll_interval(16);
+    }
+
+    // ============================================================= //
+
+    // Removing the marker component from an entity removes its
+    // dense components. ks::ecs::Scene::RemoveEntity removes every
+    // component of the entity, so this can't be bypassed.
+    class Scene::DenseMarkerComponentList final :
+            public ks::ecs::ComponentList<SceneKey,DenseMarker>
+    {
+    public:
+        using base_type = ks::ecs::ComponentList<SceneKey,DenseMarker>;
+
+        DenseMarkerComponentList(
+                Scene& scene,
+                std::vector<DenseComponentListBase*> const &list_dense_cmlists) :
+            base_type(scene),
+            m_list_dense_cmlists(list_dense_cmlists)
+        {}
+
+        void Remove(Id ent_id) override
+        {
+            for(auto cmlist : m_list_dense_cmlists)
+            {
+                cmlist->Remove(ent_id);
+            }
+
+            base_type::Remove(ent_id);
+        }
+
+    private:
+        std::vector<DenseComponentListBase*> const &m_list_dense_cmlists;
+    };
+
+    // ============================================================= //
+
     Scene::Scene(ks::Object::Key const &key,
                  shared_ptr<ks::gui::Application> app,
-                 shared_ptr<ks::gui::Window> window) :
+                 shared_ptr<ks::gui::Window> window,
+                 std::string text_glyph_cache_path,
+                 u64 text_font_hash) :
         ks::ecs::Scene<SceneKey>(key,app->GetEventLoop()),
         m_app(app),
         m_window(window),
+        m_frame_arena(make_unique<FrameArena>()),
         m_running(false),
-        m_sync_pending(false)
+        m_sync_pending(false),
+        m_render_busy(false),
+        m_wait_for_render(false),
+        m_pending_frame(),
+        m_input_latched(false),
+        m_update_requested(true),
+        m_property_change_count(0)
     {
         if(window->swap_interval.Get() == 0)
         {
@@ -61,6 +118,22 @@ namespace raintk
                  list_screens.at(0)->ydpi.Get())*0.5;
 
         detail_units::px_per_mm = m_screen_dpi/25.4f;
+
+        this->template RegisterComponentList<DenseMarker>(
+                    make_unique<DenseMarkerComponentList>(
+                        *this,m_list_dense_cmlists));
+
+        m_cmlist_dense_markers =
+                static_cast<DenseMarkerComponentList*>(
+                    this->template GetComponentList<DenseMarker>());
+
+#ifdef RAINTK_TEXT_ENABLED
+        m_text_glyph_cache_path = std::move(text_glyph_cache_path);
+        m_text_font_hash = text_font_hash;
+#else
+        (void)text_glyph_cache_path;
+        (void)text_font_hash;
+#endif
     }
 
     void Scene::Init(ks::Object::Key const &,
@@ -85,6 +158,24 @@ namespace raintk
 
     }
 
+    void Scene::RegisterDenseComponentList(DenseComponentListBase* cmlist)
+    {
+        m_list_dense_cmlists.push_back(cmlist);
+
+        cmlist->SetCreatedCallback(
+                    [this](Id ent_id) {
+                        onDenseComponentCreated(ent_id);
+                    });
+    }
+
+    void Scene::onDenseComponentCreated(Id ent_id)
+    {
+        if(!GetEntityHasComponents<DenseMarker>(ent_id))
+        {
+            m_cmlist_dense_markers->Create(ent_id,DenseMarker{});
+        }
+    }
+
     InputSystem* Scene::GetInputSystem() const
     {
         return m_input_system.get();
@@ -105,6 +196,16 @@ namespace raintk
         return m_draw_system.get();
     }
 
+    FramePacer* Scene::GetFramePacer() const
+    {
+        return m_frame_pacer.get();
+    }
+
+    FrameArena* Scene::GetFrameArena() const
+    {
+        return m_frame_arena.get();
+    }
+
     shared_ptr<Widget> const & Scene::GetRootWidget() const
     {
         return m_root_widget;
@@ -146,11 +247,22 @@ namespace raintk
     {
         return m_sdf_res_px;
     }
+
+    Scene::TextUploadStats const &Scene::GetTextUploadStats() const
+    {
+        return m_text_upload_stats;
+    }
+
+    void Scene::SetTextUploadBudget(uint max_bytes)
+    {
+        m_text_upload_budget = max_bytes;
+    }
 #endif
 
     void Scene::SetShowDebugText(bool show)
     {
         m_render_system->ShowDebugText(show);
+        m_update_requested = true;
     }
 
     void Scene::onInitThis()
@@ -168,6 +280,7 @@ namespace raintk
         m_transform_system = make_unique<TransformSystem>(this);
         m_animation_system = make_unique<AnimationSystem>();
         m_draw_system = make_unique<DrawSystem>(this,m_render_system.get());
+        m_frame_pacer = make_unique<FramePacer>();
 
         // Add the main Draw Stage
         m_main_draw_stage = make_shared<MainDrawStage>();
@@ -210,6 +323,21 @@ namespace raintk
                     });
 
 
+        // Wait Timer
+        // Started by processEventsAt to process events at a
+        // later time without blocking this thread until then.
+        // It's stopped after firing once; the callback returns
+        // before the next onAppProcEvents can re-arm it.
+        m_wait_timer =
+                ks::MakeObject<ks::CallbackTimer>(
+                    this->GetEventLoop(),
+                    Milliseconds(1),
+                    [this](){
+                        m_wait_timer->Stop();
+                        m_signal_app_process_events.Emit();
+                    });
+
+
         // Text TODO: Allow these params to be changed?
 #ifdef RAINTK_TEXT_ENABLED
         m_text_manager =
@@ -217,6 +345,19 @@ namespace raintk
                     m_atlas_res_px,
                     m_glyph_res_px,
                     m_sdf_res_px);
+
+        // Atlas pages saved by an earlier run are uploaded
+        // whole as their atlases are created
+        if(!m_text_glyph_cache_path.empty())
+        {
+            m_text_glyph_store =
+                    make_unique<GlyphPageStore>(
+                        m_text_glyph_cache_path,
+                        m_atlas_res_px,
+                        m_glyph_res_px,
+                        m_sdf_res_px,
+                        m_text_font_hash);
+        }
 #endif
 
 
@@ -290,6 +431,7 @@ namespace raintk
     {
         rtklog.Trace() << "onAppPause (" << std::this_thread::get_id() << ")";
         m_running = false;
+        m_wait_for_render = false;
         m_idle_timer->Start();
     }
 
@@ -298,6 +440,7 @@ namespace raintk
         rtklog.Trace() << "onAppResume (" << std::this_thread::get_id() << ")";
         m_idle_timer->Stop();
         m_prev_upd_time = std::chrono::high_resolution_clock::now();
+        m_update_requested = true;
 
         if(m_running==false)
         {
@@ -311,6 +454,20 @@ namespace raintk
     {
         rtklog.Trace() << "onAppQuit";
         m_running = false;
+
+#ifdef RAINTK_TEXT_ENABLED
+        // Wait for an earlier save so that the last glyphs
+        // aren't lost; the store finishes this one before
+        // it's destroyed
+        if(m_text_glyph_store && m_text_glyph_store_dirty)
+        {
+            while(m_text_glyph_store->GetIsSaving())
+            {
+                std::this_thread::sleep_for(Milliseconds(1));
+            }
+            saveTextGlyphStore();
+        }
+#endif
     }
 
     void Scene::onAppGraphicsReset()
@@ -325,6 +482,9 @@ namespace raintk
         // Destroy all Drawables (TODO)
         // Clear the RenderSystem
         m_render_system->Reset();
+        m_draw_system->InvalidateRenderData();
+        m_frame_pacer->Reset();
+        m_update_requested = true;
         // Reset Renderable Init state (TODO)
         // Recreate Drawables (TODO)
     }
@@ -335,60 +495,198 @@ namespace raintk
         {
             auto win_ptr = m_window.lock().get();
 
-            if(m_sync_pending)
+            if(!m_sync_pending && !m_input_latched)
             {
-                // Sync
-                auto sync_task =
-                        make_shared<ks::Task>(
-                            [this,win_ptr](){
-                                if(win_ptr->SetContextCurrent())
-                                {
-                                    this->onSync();
-                                    m_sync_pending = false;
-                                }
-                            });
-
-                win_ptr->GetEventLoop()->PostTask(sync_task);
-                sync_task->Wait();
+                // Skip the frame if nothing changed. Events are still
+                // processed about once a frame so new input is seen,
+                // and sooner if a delayed animation is due before then
+                TimePoint const now = std::chrono::high_resolution_clock::now();
+                TimePoint wake_time;
+
+                if(!getUpdateNeeded(now,wake_time))
+                {
+                    TimePoint const poll_time = now+k_idle_poll_interval;
+                    processEventsAt(
+                                (wake_time > now) ?
+                                    std::min(wake_time,poll_time) : poll_time);
+                    return;
+                }
+
+                // Start the update as late as the measured frame
+                // cost allows, and process events once more before
+                // it so that the update sees the most recent input
+                TimePoint const next_upd_time =
+                        m_frame_pacer->GetNextUpdateTime();
+
+                if(next_upd_time > std::chrono::high_resolution_clock::now())
+                {
+                    // Wait with a timer instead of sleeping so the
+                    // event loop keeps running until then
+                    m_input_latched = true;
+                    processEventsAt(next_upd_time);
+                    return;
+                }
             }
-            else
+
+            m_input_latched = false;
+
+            if(!m_sync_pending)
             {
+                m_pending_frame =
+                        m_frame_pacer->BeginFrame(
+                            std::chrono::high_resolution_clock::now());
+
                 // Update
+                // * Changes made during the update are handled by
+                //   it, except for requests made while it runs (ie.
+                //   text that's still being uploaded)
+                m_update_requested = false;
                 this->onUpdate();
+                m_property_change_count =
+                        PropertyTransaction::GetChangeCount();
+
+                m_pending_frame.has_input =
+                        m_input_system->GetLastInputTime(
+                            m_pending_frame.input_time);
 
                 m_sync_pending = true;
+            }
 
-                // Sync
-                auto sync_task =
-                        make_shared<ks::Task>(
-                            [this,win_ptr](){
-                                if(win_ptr->SetContextCurrent())
-                                {
-                                    this->onSync();
-                                    m_sync_pending = false;
-                                }
-                            });
-
-                win_ptr->GetEventLoop()->PostTask(sync_task);
-                sync_task->Wait();
+            // The frame is only handed off once the render thread
+            // has finished the previous one, so this thread never
+            // waits for a frame to be rendered. Until then it
+            // returns to its event loop and onRenderDone resumes
+            // processing events.
+            if(m_render_busy)
+            {
+                m_wait_for_render = true;
+                return;
             }
 
-            // Render
-            auto render_task =
-                    make_shared<ks::Task>(
-                        [this,win_ptr](){
-                            if(win_ptr->SetContextCurrent())
-                            {
-                                this->onRender();
-                                win_ptr->SwapBuffers();
-                                ks::gl::Finish();
-                            }
-                        });
+            handOffFrame(win_ptr);
+
+            m_signal_app_process_events.Emit();
+        }
+    }
+
+    void Scene::RequestUpdate()
+    {
+        m_update_requested = true;
+    }
+
+    bool Scene::getUpdateNeeded(TimePoint const &now,
+                                TimePoint& wake_time) const
+    {
+        wake_time = now;
+
+        if(m_update_requested ||
+           m_property_change_count != PropertyTransaction::GetChangeCount() ||
+           m_input_system->GetHasPendingInputs() ||
+           m_main_draw_stage->GetHasRunningLayers())
+        {
+            return true;
+        }
 
-            win_ptr->GetEventLoop()->PostTask(render_task);
+        // Running animations need every frame, delayed ones
+        // only need a frame once they're due
+        TimePoint anim_wake_time;
+        if(m_animation_system->GetNextWakeUpTime(anim_wake_time))
+        {
+            if(anim_wake_time <= now)
+            {
+                return true;
+            }
 
+            wake_time = anim_wake_time;
+        }
+
+        return false;
+    }
+
+    void Scene::handOffFrame(ks::gui::Window* win_ptr)
+    {
+        m_render_busy = true;
+
+        // Sync
+        // * The render thread is idle, so the sync starts right
+        //   away. The scene can't change while it's read, so
+        //   this thread still waits for the sync itself, but
+        //   only RenderData and draw state that changed are
+        //   handed over.
+        auto sync_task =
+                make_shared<ks::Task>(
+                    [this,win_ptr](){
+                        if(win_ptr->SetContextCurrent())
+                        {
+                            this->onSync();
+                            m_sync_pending = false;
+                        }
+                    });
+
+        win_ptr->GetEventLoop()->PostTask(sync_task);
+        sync_task->Wait();
+
+        // Render
+        // * The FramePacer limits the number of frames the GPU
+        //   can fall behind by
+        // * The next update runs while this frame renders
+        FramePacer::Frame const frame = m_pending_frame;
+
+        auto render_task =
+                make_shared<ks::Task>(
+                    [this,win_ptr,frame](){
+                        if(win_ptr->SetContextCurrent())
+                        {
+                            m_frame_pacer->WaitForFrameSlot();
+                            this->onRender();
+                            win_ptr->SwapBuffers();
+                            m_frame_pacer->SubmitFrame(frame);
+                        }
+
+                        m_render_busy = false;
+
+                        this->GetEventLoop()->PostTask(
+                                    make_shared<ks::Task>(
+                                        [this](){
+                                            this->onRenderDone();
+                                        }));
+                    });
+
+        win_ptr->GetEventLoop()->PostTask(render_task);
+    }
+
+    void Scene::onRenderDone()
+    {
+        // Resume processing events if a frame is waiting
+        // to be handed off
+        if(m_wait_for_render)
+        {
+            m_wait_for_render = false;
+
+            if(m_running)
+            {
+                m_signal_app_process_events.Emit();
+            }
+        }
+    }
+
+    void Scene::processEventsAt(TimePoint const &time)
+    {
+        auto const delay =
+                std::chrono::duration_cast<Milliseconds>(
+                    time-std::chrono::high_resolution_clock::now());
+
+        if(delay.count() <= 0)
+        {
             m_signal_app_process_events.Emit();
+            return;
         }
+
+        // The same timer is re-armed for every wait instead
+        // of creating one each time
+        m_wait_timer->Stop();
+        m_wait_timer->SetInterval(delay);
+        m_wait_timer->Start();
     }
 
     void Scene::onWinSizeChanged(ks::gui::Window::Size win_size_px)
@@ -422,6 +720,8 @@ namespace raintk
                     -100.1,             // near (relative to camera eye)
                     0.1                 // far (relative to camera eye)
                     );
+
+        m_update_requested = true;
     }
 
 #ifdef RAINTK_TEXT_ENABLED
@@ -462,17 +762,42 @@ namespace raintk
                     ks::gl::Texture2D::Filter::Linear,
                     ks::gl::Texture2D::Filter::Linear);
 
-        ks::Image<ks::R8> blank_image(
+        auto& shadow_ptr = m_lkup_text_atlas_shadows[atlas_index];
+        shadow_ptr = make_unique<TextureShadow>(
+                    atlas_size_px,
+                    atlas_size_px);
+
+        // The atlas starts with the page saved for it, if any.
+        // Regions that TextManager hasn't written to yet are
+        // never sampled, and glyphs it writes that are already
+        // in the page aren't uploaded again.
+        u8 const * cached_page =
+                (m_text_glyph_store && atlas_size_px == m_atlas_res_px) ?
+                    m_text_glyph_store->GetPage(atlas_index) : nullptr;
+
+        if(cached_page)
+        {
+            shadow_ptr->Load(cached_page);
+        }
+
+        ks::Image<ks::R8> initial_image(
                     atlas_size_px,
                     atlas_size_px,
                     ks::R8{0});
 
+        if(cached_page)
+        {
+            std::memcpy(initial_image.GetData().data(),
+                        cached_page,
+                        atlas_size_px*atlas_size_px);
+        }
+
         atlas_data.atlas_texture->UpdateTexture(
                     ks::gl::Texture2D::Update{
                         ks::gl::Texture2D::Update::ReUpload,
                         glm::u16vec2(0,0),
                         shared_ptr<ks::ImageData>(
-                            blank_image.ConvertToImageDataPtr().release()
+                            initial_image.ConvertToImageDataPtr().release()
                         )
                     });
     }
@@ -488,14 +813,100 @@ namespace raintk
                         "Received glyph before atlas created");
         }
 
-        auto& atlas_data = *(m_lkup_text_atlas_data[atlas_index]);
+        m_text_upload_stats.glyph_count++;
 
-        atlas_data.atlas_texture->UpdateTexture(
-                    ks::gl::Texture2D::Update{
-                        ks::gl::Texture2D::Update::Defaults,
-                        offset,
-                        image_data
-                    });
+        auto& shadow = *(m_lkup_text_atlas_shadows[atlas_index]);
+        if(shadow.GetMatches(offset,*image_data))
+        {
+            // Already in the atlas, usually from a page
+            // loaded from the glyph cache
+            m_text_upload_stats.cached_glyph_count++;
+            return;
+        }
+
+        // Glyphs are uploaded from the shadow in flushTextAtlases
+        // instead of with one texture update each
+        shadow.Write(offset,*image_data);
+        m_text_glyph_store_dirty = (m_text_glyph_store != nullptr);
+
+        m_text_upload_stats.glyph_bytes +=
+                image_data->width*image_data->height;
+
+        m_update_requested = true;
+    }
+
+    void Scene::saveTextGlyphStore()
+    {
+        if(m_text_glyph_store->Save(m_lkup_text_atlas_shadows))
+        {
+            m_text_glyph_store_dirty = false;
+        }
+    }
+
+    void Scene::flushTextAtlases()
+    {
+        uint bytes = 0;
+
+        for(auto& shadow_it : m_lkup_text_atlas_shadows)
+        {
+            auto& shadow = *(shadow_it.second);
+            if(!shadow.GetIsDirty())
+            {
+                continue;
+            }
+
+            if(bytes >= m_text_upload_budget)
+            {
+                break;
+            }
+
+            auto list_updates =
+                    shadow.Flush(
+                        m_text_upload_budget-bytes,
+                        bytes);
+
+            auto& atlas_data =
+                    *(m_lkup_text_atlas_data[shadow_it.first]);
+
+            for(auto& update : list_updates)
+            {
+                atlas_data.atlas_texture->UpdateTexture(
+                            std::move(update));
+            }
+
+            // Text may have been drawn before some of its glyphs
+            // were uploaded
+            if(!list_updates.empty())
+            {
+                m_draw_system->OnTextureSetUpdated(
+                            atlas_data.texture_set_id);
+            }
+
+            m_text_upload_stats.upload_count += list_updates.size();
+        }
+
+        m_text_upload_stats.upload_bytes += bytes;
+
+        // Keep updating until all glyphs are uploaded
+        bool uploading = false;
+        for(auto const &shadow_it : m_lkup_text_atlas_shadows)
+        {
+            if(shadow_it.second->GetIsDirty())
+            {
+                m_update_requested = true;
+                uploading = true;
+                break;
+            }
+        }
+
+        // Pages are saved once a burst of new glyphs has been
+        // uploaded rather than after every frame of it, and not
+        // while an earlier save is still running
+        if(m_text_glyph_store_dirty && !uploading &&
+           !m_text_glyph_store->GetIsSaving())
+        {
+            saveTextGlyphStore();
+        }
     }
 #endif
 
@@ -509,11 +920,20 @@ namespace raintk
         TimePoint const curr_upd_time =
                 std::chrono::high_resolution_clock::now();
 
+        // Temporary data from the last frame is no longer used
+        m_frame_arena->Reset();
+
         // Update systems
         m_input_system->Update(m_prev_upd_time,curr_upd_time);
         m_animation_system->Update(m_prev_upd_time,curr_upd_time);
         m_transform_system->Update(m_prev_upd_time,curr_upd_time);
         m_draw_system->Update(m_prev_upd_time,curr_upd_time);
+
+#ifdef RAINTK_TEXT_ENABLED
+        // Upload the glyphs created during this update
+        flushTextAtlases();
+#endif
+
         m_render_system->Update(m_prev_upd_time,curr_upd_time);
 
         TimePoint const upd_end_time =
@@ -532,6 +952,15 @@ namespace raintk
 
         m_render_system->AddCustomDebugText(update_time_msg);
 
+        auto const frame_metrics = m_frame_pacer->GetMetrics();
+
+        m_render_system->AddCustomDebugText(
+                    "raintk frame: " +
+                    ks::ToStringFormat(frame_metrics.avg_frame_time_ms,3,7,'0') +
+                    "ms, input latency: " +
+                    ks::ToStringFormat(frame_metrics.avg_input_latency_ms,3,7,'0') +
+                    "ms");
+
         m_prev_upd_time = curr_upd_time;
 
 #ifdef RAINTK_BUILD_DEBUG
@@ -548,12 +977,13 @@ namespace raintk
         m_main_draw_stage->SyncView(
                     m_viewport,m_camera);
 
-        m_main_draw_stage->SyncClipRegions(
-                    m_draw_system->GetClipRegions());
+        // Only lists that changed are handed over, by swapping
+        // buffers, so this doesn't scale with the scene size
+        m_main_draw_stage->SyncSnapshot(
+                    m_draw_system->GetSnapshot());
 
-        m_main_draw_stage->SyncDrawOrder(
-                    m_draw_system->GetOpaqueDrawOrderList(),
-                    m_draw_system->GetTransparentDrawOrderList());
+        m_main_draw_stage->SyncLayers(
+                    m_draw_system->TakeLayerUpdates());
     }
 
     void Scene::onRender()
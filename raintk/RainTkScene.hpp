@@ -24,6 +24,8 @@
 #include <raintk/RainTkSceneKey.hpp>
 #include <raintk/RainTkDrawKey.hpp>
 #include <raintk/RainTkComponents.hpp>
+#include <raintk/RainTkFrameArena.hpp>
+#include <raintk/RainTkFramePacer.hpp>
 
 // For debugging
 #define RAINTK_TEXT_ENABLED
@@ -50,6 +52,8 @@ namespace raintk
     class AnimationSystem;
     class TransformSystem;
     class DrawSystem;
+    class TextureShadow;
+    class GlyphPageStore;
 
     class MainDrawStage;
 
@@ -58,9 +62,15 @@ namespace raintk
     public:
         using base_type = ks::ecs::Scene<SceneKey>;
 
+        // If @text_glyph_cache_path is set, text atlas pages
+        // are saved there and loaded back by the next Scene
+        // created with the same @text_font_hash; see
+        // GlyphPageStore
         Scene(ks::Object::Key const &key,
               shared_ptr<ks::gui::Application> app,
-              shared_ptr<ks::gui::Window> window);
+              shared_ptr<ks::gui::Window> window,
+              std::string text_glyph_cache_path=std::string(),
+              u64 text_font_hash=0);
 
         void Init(ks::Object::Key const &,
                   shared_ptr<raintk::Scene> const &);
@@ -72,6 +82,13 @@ namespace raintk
         AnimationSystem* GetAnimationSystem() const;
         TransformSystem* GetTransformSystem() const;
         DrawSystem* GetDrawSystem() const;
+        FramePacer* GetFramePacer() const;
+
+        // * Temporary data for the current frame; see FrameArena
+        // * Reset at the start of each update. Code that calls
+        //   the systems' Update functions directly (instead of
+        //   through the Scene) should Reset it between frames
+        FrameArena* GetFrameArena() const;
 
         shared_ptr<Widget> const &GetRootWidget() const;
         Id GetMainDrawStageId() const;
@@ -84,8 +101,39 @@ namespace raintk
         uint GetTextAtlasSizePx() const;
         uint GetTextGlyphSizePx() const;
         uint GetTextGlyphSDFSizePx() const;
+
+        // Counters for glyphs written to the text atlases
+        // and for the texture updates they were uploaded with
+        struct TextUploadStats
+        {
+            u64 glyph_count{0};
+            u64 glyph_bytes{0};
+            u64 upload_count{0};
+            u64 upload_bytes{0};
+
+            // Glyphs that were already in their atlas, usually
+            // from a page loaded from the glyph cache
+            u64 cached_glyph_count{0};
+        };
+
+        TextUploadStats const &GetTextUploadStats() const;
+
+        // New glyphs are copied into a CPU side shadow of their
+        // atlas and uploaded in merged regions once per frame.
+        // This sets the max number of bytes uploaded per frame;
+        // the rest is uploaded over the following frames.
+        void SetTextUploadBudget(uint max_bytes);
 #endif
 
+        // * Components in a DenseComponentList aren't known to
+        //   ks::ecs::Scene, so lists registered here have their
+        //   components removed when their entity is removed
+        // * Entities with a dense component are given a marker
+        //   component that ks::ecs::Scene::RemoveEntity removes
+        //   like any other, which removes the dense components
+        // * @cmlist must outlive any entities that are removed
+        void RegisterDenseComponentList(DenseComponentListBase* cmlist);
+
         template<typename... Args>
         bool GetEntityHasComponents(Id ent_id) const
         {
@@ -95,6 +143,23 @@ namespace raintk
 
         void SetShowDebugText(bool show);
 
+        // * The Scene skips updating and rendering frames while
+        //   nothing has changed. A frame is needed if a Property
+        //   changed, there are pending inputs, an animation is
+        //   running or a delayed animation is due, or a
+        //   compositor animation is running.
+        // * Any other change that affects what's drawn must call
+        //   this, or the Scene may keep skipping frames and the
+        //   change won't be seen until something else changes.
+        //   This covers state that's changed without going
+        //   through a Property, ie. adding or removing widgets,
+        //   compositor and cached layer changes and input focus.
+        //   Widget, DrawSystem and InputSystem already call it
+        //   for their own changes of this kind.
+        // * Calling it during an update schedules another frame
+        //   after the current one
+        void RequestUpdate();
+
 
 #ifdef RAINTK_BUILD_DEBUG
         ks::Signal<> signal_before_update;
@@ -119,8 +184,28 @@ namespace raintk
         void onNewTextGlyph(uint atlas_index,
                             glm::u16vec2 offset,
                             shared_ptr<ks::ImageData> image_data);
+
+        void flushTextAtlases();
+        void saveTextGlyphStore();
 #endif
 
+        // Returns true if the next frame needs to be updated.
+        // Otherwise sets @wake_time to the time a delayed
+        // animation is due, if there is one, or to @now.
+        bool getUpdateNeeded(TimePoint const &now,
+                             TimePoint& wake_time) const;
+
+        // Processes app events at @time without blocking
+        // this thread until then
+        void processEventsAt(TimePoint const &time);
+
+        // Syncs the updated frame and posts it to the render
+        // thread. The render thread must be idle.
+        void handOffFrame(ks::gui::Window* win_ptr);
+        void onRenderDone();
+
+        void onDenseComponentCreated(Id ent_id);
+
         void onUpdate();
         void onSync();
         void onRender();
@@ -132,19 +217,40 @@ namespace raintk
         float m_screen_dpi;
         glm::vec2 m_window_size_px;
 
+        // Owned by the systems
+        std::vector<DenseComponentListBase*> m_list_dense_cmlists;
+
+        // Marks the entities that have dense components
+        struct DenseMarker {};
+        class DenseMarkerComponentList;
+        DenseMarkerComponentList* m_cmlist_dense_markers;
+
+        // Used by the systems, so it must outlive them
+        unique_ptr<FrameArena> m_frame_arena;
+
         // Systems
         unique_ptr<InputSystem> m_input_system;
         unique_ptr<AnimationSystem> m_animation_system;
         unique_ptr<TransformSystem> m_transform_system;
         unique_ptr<DrawSystem> m_draw_system;
         unique_ptr<RenderSystem> m_render_system;
+        unique_ptr<FramePacer> m_frame_pacer;
 
         // App update loop
         ks::Signal<> m_signal_app_process_events;
         std::atomic<bool> m_running;
         std::atomic<bool> m_sync_pending;
+        std::atomic<bool> m_render_busy;
+        bool m_wait_for_render;
+        FramePacer::Frame m_pending_frame;
+        bool m_input_latched;
         TimePoint m_prev_upd_time;
         shared_ptr<ks::CallbackTimer> m_idle_timer;
+        shared_ptr<ks::CallbackTimer> m_wait_timer;
+
+        // Change tracking to skip frames where nothing changed
+        bool m_update_requested;
+        u64 m_property_change_count;
 
         // Root widget
         shared_ptr<Widget> m_root_widget;
@@ -164,6 +270,13 @@ namespace raintk
         uint const m_sdf_res_px{4};
         unique_ptr<ks::text::TextManager> m_text_manager;
         std::map<uint,unique_ptr<TextAtlasData>> m_lkup_text_atlas_data;
+        std::map<uint,unique_ptr<TextureShadow>> m_lkup_text_atlas_shadows;
+        uint m_text_upload_budget{256*1024};
+        TextUploadStats m_text_upload_stats;
+        std::string m_text_glyph_cache_path;
+        u64 m_text_font_hash;
+        unique_ptr<GlyphPageStore> m_text_glyph_store;
+        bool m_text_glyph_store_dirty{false};
 #endif
     };
 
@@ -87,6 +87,7 @@ namespace raintk
 
         void start() override
         {
+            m_speed_m_s = m_speed_i_m_s;
             m_position_m = 0;
             m_time_s = 0;
         }
@@ -115,6 +116,12 @@ namespace raintk
         void complete() override
         {}
 
+        // The current velocity in units/s
+        glm::vec2 GetVelocity() const
+        {
+            return m_unit_vec*m_speed_m_s*1000.0f;
+        }
+
     private:
         std::function<void(glm::vec2 const &)> m_upd_position;
         glm::vec2 const m_unit_vec;
@@ -192,6 +199,17 @@ namespace raintk
         return m_content_parent;
     }
 
+    glm::vec2 ScrollArea::GetFlickVelocity() const
+    {
+        if(m_flick_anim &&
+           m_flick_anim->GetState()==Animation::State::Running)
+        {
+            return m_flick_anim->GetVelocity();
+        }
+
+        return glm::vec2(0.0f,0.0f);
+    }
+
     Milliseconds ScrollArea::GetFlickStopDuration() const
     {
         return m_min_stop_duration_ms;
@@ -351,21 +369,7 @@ namespace raintk
 
                 if(stop_duration_ms < m_min_stop_duration_ms.count())
                 {
-                    // For the flick velocity, use the average velocity
-                    // over the interval of saved scroll points
-                    auto const &p0 = m_list_scroll_points.front(); // first
-                    auto const &p1 = m_list_scroll_points.back();  // last
-
-                    float flick_interval_ms =
-                            ks::CalcDuration<Microseconds>(
-                                p0.timestamp,
-                                p1.timestamp).
-                            count()/1000.0f;
-
-                    // Flick velocity is in m/s (mm/ms == m/s)
-                    glm::vec2 flick_velocity(
-                                (p1.x-p0.x)/flick_interval_ms,
-                                (p1.y-p0.y)/flick_interval_ms);
+                    glm::vec2 flick_velocity = calcFlickVelocity();
 
                     if(direction.Get() == Direction::Horizontal)
                     {
@@ -403,9 +407,9 @@ namespace raintk
     {
         m_list_scroll_points.push_back(m_point);
 
-        // With a size of 6 we probably average over
-        // 2 to 3 updates a frame
-        if(m_list_scroll_points.size() > 6)
+        // Moves are coalesced to one point per frame so
+        // this covers the last 2 to 3 frames
+        if(m_list_scroll_points.size() > 3)
         {
             m_list_scroll_points.erase(
                         m_list_scroll_points.begin());
@@ -421,6 +425,68 @@ namespace raintk
         requestContentPositionChange(ds);
     }
 
+    glm::vec2 ScrollArea::calcFlickVelocity()
+    {
+        auto const &p0 = m_list_scroll_points.front(); // first
+        auto const &p1 = m_list_scroll_points.back();  // last
+
+        // The InputSystem only dispatches one move per frame, so
+        // use every raw sample over the same interval if they're
+        // available and fit a line to them (least squares) to
+        // reduce jitter from high rate devices
+        std::vector<Point> list_samples;
+        m_scene->GetInputSystem()->GetInputHistory(
+                    p1.type,p0.timestamp,p1.timestamp,list_samples);
+
+        if(list_samples.size() > 2)
+        {
+            float const n = list_samples.size();
+            float sum_t=0.0f;
+            float sum_tt=0.0f;
+            glm::vec2 sum_p(0.0f,0.0f);
+            glm::vec2 sum_tp(0.0f,0.0f);
+
+            for(auto const &sample : list_samples)
+            {
+                float const t =
+                        ks::CalcDuration<Microseconds>(
+                            p0.timestamp,
+                            sample.timestamp).
+                        count()/1000.0f;
+
+                // Samples are in world coordinates
+                glm::vec2 const p =
+                        CalcLocalCoords(
+                            this,glm::vec2(sample.x,sample.y));
+
+                sum_t += t;
+                sum_tt += t*t;
+                sum_p += p;
+                sum_tp += t*p;
+            }
+
+            float const denom = n*sum_tt - sum_t*sum_t;
+            if(denom > 0.0f)
+            {
+                // Flick velocity is in m/s (mm/ms == m/s)
+                return (n*sum_tp - sum_t*sum_p)/denom;
+            }
+        }
+
+        // Otherwise use the average velocity over the
+        // interval of saved scroll points
+        float flick_interval_ms =
+                ks::CalcDuration<Microseconds>(
+                    p0.timestamp,
+                    p1.timestamp).
+                count()/1000.0f;
+
+        // Flick velocity is in m/s (mm/ms == m/s)
+        return glm::vec2(
+                    (p1.x-p0.x)/flick_interval_ms,
+                    (p1.y-p0.y)/flick_interval_ms);
+    }
+
     void ScrollArea::checkContentPositionChange()
     {
         requestContentPositionChange(glm::vec2(0.0f,0.0f));
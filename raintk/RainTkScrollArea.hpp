@@ -72,6 +72,11 @@ namespace raintk
         // and *not* the ScrollView
         shared_ptr<Widget> GetContentParent() const;
 
+        // The velocity that the content is currently moving
+        // at because of a flick, in px/s. Zero if there is
+        // no flick animation running.
+        glm::vec2 GetFlickVelocity() const;
+
         Milliseconds GetFlickStopDuration() const;
         float GetMinimumFlickSpeed() const;
         float GetDeceleration() const;
@@ -140,6 +145,10 @@ namespace raintk
 
         bool verifyScrollStart();
 
+        // The velocity of the scroll points that were just
+        // released in m/s. Needs at least two scroll points
+        glm::vec2 calcFlickVelocity();
+
         bool m_inside_drag{false};
         bool m_inside_scroll{false};
         float const m_scroll_threshold_mm{mm(2.0f)};
@@ -40,11 +40,14 @@ namespace raintk
             { "a_v2_highlight_index", AttrType::UShort, 2, false}
         };
 
+        // The max number of glyphs a single batch can hold
+        uint const k_max_batch_glyphs=Text::k_max_batch_glyphs;
+
         shared_ptr<GeometryLayout> g_geometry_layout(
                 new GeometryLayout{
                     g_vx_layout,
                     sizeof(Vertex),
-                    4096*sizeof(Vertex)*6 // buffer size in bytes
+                    k_max_batch_glyphs*sizeof(Vertex)*6 // buffer size in bytes
                 });
 
         // Draw setup
@@ -73,6 +76,10 @@ namespace raintk
         // The length of each UniformArray in a given batch
         uint const k_batch_array_size=12;
 
+        // The max number of utf16 chars shaped to estimate the
+        // size of paragraphs in virtualized text
+        uint const k_para_sample_size=256;
+
 
         std::map<Id,std::vector<GlyphBatchAvail>> g_lkup_glyph_batch_avail;
 
@@ -196,6 +203,323 @@ namespace raintk
                 }
             }
         }
+
+        // Glyphs without any area (ie. spaces) have no vertices
+        bool GetGlyphHasVertices(ks::text::Glyph const &glyph)
+        {
+            return !((glyph.x1==glyph.x0) && (glyph.y1==glyph.y0));
+        }
+
+        // Pushes the six vertices for @glyph to @list_vx
+        void PushGlyphVertices(std::vector<u8>& list_vx,
+                               ks::text::Glyph const &glyph,
+                               float x_shift,
+                               float baseline_y,
+                               float k_glyph,
+                               float k_div_atlas,
+                               float uniform_index)
+        {
+            uint const glyph_width = (glyph.x1-glyph.x0) + (2*glyph.sdf_x);
+            uint const glyph_height= (glyph.y1-glyph.y0) + (2*glyph.sdf_y);
+
+            float x0 = (glyph.x0-glyph.sdf_x + x_shift)*k_glyph;
+            float x1 = (glyph.x1+glyph.sdf_x + x_shift)*k_glyph;
+            float y0 = (baseline_y-(glyph.y0-glyph.sdf_y))*k_glyph;
+            float y1 = (baseline_y-(glyph.y1+glyph.sdf_y))*k_glyph;
+
+            float s0 = glyph.tex_x*k_div_atlas;
+            float s1 = (glyph.tex_x+glyph_width)*k_div_atlas;
+
+            // tex_y must be flipped
+            float t0 = glyph.tex_y*k_div_atlas;
+            float t1 = (glyph.tex_y+glyph_height)*k_div_atlas;
+
+            // BL
+            ks::gl::Buffer::PushElement<Vertex>(
+                        list_vx,
+                        Vertex{
+                            glm::vec2{x0,y0},
+                            glm::vec2{s0,t1},
+                            glm::u16vec2{0,uniform_index},
+                        });
+
+            // TR
+            ks::gl::Buffer::PushElement<Vertex>(
+                        list_vx,
+                        Vertex{
+                            glm::vec2{x1,y1},
+                            glm::vec2{s1,t0},
+                            glm::u16vec2{0,uniform_index},
+                        });
+
+            // TL
+            ks::gl::Buffer::PushElement<Vertex>(
+                        list_vx,
+                        Vertex{
+                            glm::vec2{x0,y1},
+                            glm::vec2{s0,t0},
+                            glm::u16vec2{0,uniform_index},
+                        });
+
+            // BL
+            ks::gl::Buffer::PushElement<Vertex>(
+                        list_vx,
+                        Vertex{
+                            glm::vec2{x0,y0},
+                            glm::vec2{s0,t1},
+                            glm::u16vec2{0,uniform_index}
+                        });
+
+            // BR
+            ks::gl::Buffer::PushElement<Vertex>(
+                        list_vx,
+                        Vertex{
+                            glm::vec2{x1,y0},
+                            glm::vec2{s1,t1},
+                            glm::u16vec2{0,uniform_index}
+                        });
+
+            // TR
+            ks::gl::Buffer::PushElement<Vertex>(
+                        list_vx,
+                        Vertex{
+                            glm::vec2{x1,y1},
+                            glm::vec2{s1,t0},
+                            glm::u16vec2{0,uniform_index}
+                        });
+        }
+
+        // Returns true if @b is @a shifted by @dx and @d_cluster.
+        // RTL glyphs never match since their clusters decrease
+        // along the line.
+        bool GetGlyphsMatch(ks::text::Glyph const &a,
+                            ks::text::Glyph const &b,
+                            sint dx,
+                            sint d_cluster)
+        {
+            return (!a.rtl && !b.rtl &&
+                    a.atlas == b.atlas &&
+                    a.tex_x == b.tex_x &&
+                    a.tex_y == b.tex_y &&
+                    a.sdf_x == b.sdf_x &&
+                    a.sdf_y == b.sdf_y &&
+                    a.y0 == b.y0 &&
+                    a.y1 == b.y1 &&
+                    sint(b.x0) == sint(a.x0)+dx &&
+                    sint(b.x1) == sint(a.x1)+dx &&
+                    sint(b.cluster) == sint(a.cluster)+d_cluster);
+        }
+
+        Text::GlyphEdit CalcGlyphEdit(ks::text::Line const &old_line,
+                                      ks::text::Line const &new_line,
+                                      uint old_utf16_size,
+                                      uint new_utf16_size)
+        {
+            Text::GlyphEdit edit;
+
+            // Glyph positions are relative to x_min, so all of
+            // them move if it changes
+            if(old_line.rtl || new_line.rtl ||
+               old_line.x_min != new_line.x_min)
+            {
+                return edit;
+            }
+
+            auto const &list_old_glyphs = old_line.list_glyphs;
+            auto const &list_new_glyphs = new_line.list_glyphs;
+
+            uint const max_common =
+                    std::min(list_old_glyphs.size(),
+                             list_new_glyphs.size());
+
+            uint prefix = 0;
+            while(prefix < max_common &&
+                  GetGlyphsMatch(list_old_glyphs[prefix],
+                                 list_new_glyphs[prefix],0,0))
+            {
+                prefix++;
+            }
+
+            uint suffix = 0;
+            sint dx = 0;
+            sint const d_cluster = sint(new_utf16_size)-sint(old_utf16_size);
+
+            if(prefix < max_common)
+            {
+                dx = sint(list_new_glyphs.back().x0)-
+                     sint(list_old_glyphs.back().x0);
+
+                while(suffix < (max_common-prefix) &&
+                      GetGlyphsMatch(
+                          list_old_glyphs[list_old_glyphs.size()-1-suffix],
+                          list_new_glyphs[list_new_glyphs.size()-1-suffix],
+                          dx,d_cluster))
+                {
+                    suffix++;
+                }
+            }
+
+            uint const old_middle_end = list_old_glyphs.size()-suffix;
+            uint const new_middle_end = list_new_glyphs.size()-suffix;
+
+            // Changed glyphs must be LTR as well so that the
+            // utf16 range they cover is contiguous
+            for(uint i=prefix; i < old_middle_end; i++)
+            {
+                if(list_old_glyphs[i].rtl)
+                {
+                    return edit;
+                }
+            }
+
+            for(uint i=prefix; i < new_middle_end; i++)
+            {
+                if(list_new_glyphs[i].rtl)
+                {
+                    return edit;
+                }
+            }
+
+            uint const old_start =
+                    (prefix < list_old_glyphs.size()) ?
+                        list_old_glyphs[prefix].cluster : old_utf16_size;
+
+            uint const new_start =
+                    (prefix < list_new_glyphs.size()) ?
+                        list_new_glyphs[prefix].cluster : new_utf16_size;
+
+            edit.utf16_start = std::min(old_start,new_start);
+
+            edit.utf16_old_end =
+                    (suffix > 0) ?
+                        list_old_glyphs[old_middle_end].cluster :
+                        old_utf16_size;
+
+            edit.utf16_new_end =
+                    (suffix > 0) ?
+                        list_new_glyphs[new_middle_end].cluster :
+                        new_utf16_size;
+
+            if(edit.utf16_start > edit.utf16_old_end ||
+               edit.utf16_start > edit.utf16_new_end)
+            {
+                return edit;
+            }
+
+            edit.valid = true;
+            edit.prefix_glyphs = prefix;
+            edit.suffix_glyphs = suffix;
+            edit.dx = dx;
+
+            return edit;
+        }
+
+        // Returns true if @b is @a with its glyphs' utf16
+        // indices shifted by @d_cluster
+        bool GetLinesMatch(ks::text::Line const &a,
+                           ks::text::Line const &b,
+                           sint d_cluster)
+        {
+            if(a.rtl != b.rtl ||
+               a.x_min != b.x_min ||
+               a.x_max != b.x_max ||
+               a.y_min != b.y_min ||
+               a.y_max != b.y_max ||
+               a.ascent != b.ascent ||
+               a.descent != b.descent ||
+               a.spacing != b.spacing ||
+               a.list_glyphs.size() != b.list_glyphs.size())
+            {
+                return false;
+            }
+
+            for(uint i=0; i < a.list_glyphs.size(); i++)
+            {
+                if(!GetGlyphsMatch(a.list_glyphs[i],b.list_glyphs[i],0,d_cluster))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Returns the lowest utf16 index of the glyphs of the
+        // first line from @index on that has any, or @utf16_size
+        uint GetLinesUTF16Start(std::vector<ks::text::Line> const &list_lines,
+                                uint index,
+                                uint utf16_size)
+        {
+            for(uint i=index; i < list_lines.size(); i++)
+            {
+                auto const &list_glyphs = list_lines[i].list_glyphs;
+                if(list_glyphs.empty())
+                {
+                    continue;
+                }
+
+                uint utf16_start = utf16_size;
+                for(auto const &glyph : list_glyphs)
+                {
+                    utf16_start = std::min<uint>(utf16_start,glyph.cluster);
+                }
+
+                return utf16_start;
+            }
+
+            return utf16_size;
+        }
+
+        // Finds the only line that differs between @list_old_lines
+        // and @list_new_lines and calculates its GlyphEdit. Not
+        // valid if any other line changed.
+        Text::GlyphEdit CalcLinesGlyphEdit(std::vector<ks::text::Line> const &list_old_lines,
+                                           std::vector<ks::text::Line> const &list_new_lines,
+                                           uint old_utf16_size,
+                                           uint new_utf16_size)
+        {
+            Text::GlyphEdit edit;
+
+            uint const line_count = list_new_lines.size();
+            if(line_count == 0 || list_old_lines.size() != line_count)
+            {
+                return edit;
+            }
+
+            uint line = 0;
+            while(line+1 < line_count &&
+                  GetLinesMatch(list_old_lines[line],list_new_lines[line],0))
+            {
+                line++;
+            }
+
+            sint const d_cluster = sint(new_utf16_size)-sint(old_utf16_size);
+            for(uint i=line+1; i < line_count; i++)
+            {
+                if(!GetLinesMatch(list_old_lines[i],list_new_lines[i],d_cluster))
+                {
+                    return edit;
+                }
+            }
+
+            // The lines after the edited one move if its
+            // spacing changed
+            if(line+1 < line_count &&
+               list_old_lines[line].spacing != list_new_lines[line].spacing)
+            {
+                return edit;
+            }
+
+            edit = CalcGlyphEdit(
+                        list_old_lines[line],
+                        list_new_lines[line],
+                        GetLinesUTF16Start(list_old_lines,line+1,old_utf16_size),
+                        GetLinesUTF16Start(list_new_lines,line+1,new_utf16_size));
+
+            edit.line = line;
+
+            return edit;
+        }
     }
 
     // ============================================================= //
@@ -286,6 +610,8 @@ namespace raintk
 
     ks::text::Hint& Text::GetTextHint()
     {
+        // The hint may be modified by the caller
+        m_layout_changed = true;
         return m_text_hint;
     }
 
@@ -302,6 +628,50 @@ namespace raintk
     void Text::SetKeepGlyphData(bool enabled)
     {
         m_keep_glyph_data = enabled;
+
+        if(!enabled)
+        {
+            m_list_para_lines.clear();
+            m_para_lines_u16_text.clear();
+        }
+    }
+
+    void Text::SetVirtualized(bool enabled)
+    {
+        if(m_virtualized == enabled)
+        {
+            return;
+        }
+
+        m_virtualized = enabled;
+        m_upd_paragraphs = enabled;
+        m_layout_changed = true;
+
+        if(enabled)
+        {
+            m_list_para_lines.clear();
+            m_para_lines_u16_text.clear();
+        }
+        else
+        {
+            m_list_paragraphs.clear();
+            m_list_paragraph_tops.clear();
+            m_list_shaped_paragraphs.clear();
+        }
+
+        // Existing drawables are for the other mode
+        m_paras_drawn = false;
+        m_lines_drawn = false;
+        m_list_drawn_lines = nullptr;
+
+        auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
+        upd_data.update |= UpdateData::UpdateWidget;
+        m_scene->RequestUpdate();
+    }
+
+    Text::GlyphEdit const &Text::GetGlyphEdit() const
+    {
+        return m_glyph_edit;
     }
 
     void Text::SetHighlightedText(std::vector<uint> const &utf16_indices)
@@ -312,6 +682,7 @@ namespace raintk
 
         auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
         upd_data.update |= UpdateData::UpdateDrawables;
+        m_scene->RequestUpdate();
     }
 
     void Text::onColorChanged()
@@ -333,7 +704,13 @@ namespace raintk
     void Text::onTextChanged()
     {
         m_u16_text = ks::text::TextManager::ConvertStringUTF8ToUTF16(text.Get());
-        m_utf16_highlight.clear();
+        m_upd_paragraphs = m_virtualized;
+
+        if(!m_utf16_highlight.empty())
+        {
+            m_utf16_highlight.clear();
+            m_upd_highlight = true;
+        }
 
         auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
         upd_data.update |= UpdateData::UpdateWidget;
@@ -348,30 +725,40 @@ namespace raintk
         m_text_hint.list_prio_fonts =
                 new_text_hint.list_prio_fonts;
 
+        m_layout_changed = true;
+
         auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
         upd_data.update |= UpdateData::UpdateWidget;
     }
 
     void Text::onSizeChanged()
     {
+        m_layout_changed = true;
+
         auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
         upd_data.update |= UpdateData::UpdateWidget;
     }
 
     void Text::onLineWidthChanged()
     {
+        m_layout_changed = true;
+
         auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
         upd_data.update |= UpdateData::UpdateWidget;
     }
 
     void Text::onAlignmentChanged()
     {
+        m_layout_changed = true;
+
         auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
         upd_data.update |= UpdateData::UpdateWidget;
     }
 
     void Text::onHeightCalcChanged()
     {
+        m_layout_changed = true;
+
         auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
         upd_data.update |= UpdateData::UpdateWidget;
     }
@@ -398,6 +785,25 @@ namespace raintk
 
             draw_data.key.SetClip(m_clip_id);
         }
+
+        // The visible paragraphs depend on the clip region
+        if(m_virtualized)
+        {
+            auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
+            upd_data.update |= UpdateData::UpdateDrawables;
+        }
+    }
+
+    void Text::onLayerIdUpdated()
+    {
+        for(auto& glyph_batch : m_list_glyph_batches)
+        {
+            auto& draw_data =
+                    m_cmlist_draw_data->GetComponent(
+                        glyph_batch.entity_id);
+
+            draw_data.key.SetLayer(m_layer_id);
+        }
     }
 
     void Text::onTransformUpdated()
@@ -419,31 +825,98 @@ namespace raintk
 
     void Text::update()
     {
+        if(m_virtualized)
+        {
+            // Paragraphs only need to be recreated if the
+            // text or its layout changed. Otherwise this is
+            // an update to the size after paragraphs were
+            // measured.
+            bool const recreate =
+                    (m_upd_paragraphs || m_layout_changed);
+
+            if(recreate)
+            {
+                createParagraphs();
+            }
+
+            m_list_lines = nullptr;
+            m_lines_utf16_size = 0;
+            m_list_drawn_lines = nullptr;
+            m_lines_drawn = false;
+            m_glyph_edit = GlyphEdit();
+
+            if(!m_list_paragraphs.empty())
+            {
+                float const k_scale =
+                        size.Get()/m_scene->GetTextGlyphSizePx();
+
+                // See the FontBounds height calculation below
+                float const baseline_bottom =
+                        m_para_ascent+
+                        m_list_paragraph_tops.back()-
+                        m_para_spacing;
+
+                height = (baseline_bottom+m_para_descent)*k_scale;
+                width = m_para_width*k_scale;
+            }
+            else
+            {
+                height = 0.0f;
+                width = 0.0f;
+            }
+
+            // Only left aligned glyphs stay in place when
+            // the width changes
+            auto const this_alignment = alignment.Get();
+            if(recreate ||
+               (this_alignment != Alignment::Auto &&
+                this_alignment != Alignment::Left))
+            {
+                m_upd_recreate = true;
+            }
+
+            auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
+            upd_data.update |= UpdateData::UpdateDrawables;
+
+            signal_glyph_data_changed.Emit();
+            return;
+        }
+
         // Calculate dimensions
 
         if(!text.Get().empty())
         {
-            // The max line width must be scaled by the
-            // size of the text but watch out for the
-            // float->uint cast overflow
-            float scaled_line_width =
-                    line_width.Get()*
-                    (m_scene->GetTextGlyphSizePx()/size.Get());
+            std::unique_ptr<std::vector<ks::text::Line>> list_prev_lines =
+                    std::move(m_list_lines);
 
-            if(scaled_line_width < float(k_max_line_width))
-            {
-                m_text_hint.max_line_width_px =
-                        uint(scaled_line_width);
-            }
+            uint const prev_utf16_size = m_lines_utf16_size;
 
-            // Get/generate the glyphs from the TextManager
-            m_list_lines =
-                    m_scene->GetTextManager()->GetGlyphs(
-                        m_u16_text,
-                        m_text_hint);
+            m_list_lines = shapeLines();
+            m_lines_utf16_size = m_u16_text.size();
 
             auto& list_lines = *m_list_lines;
 
+            m_glyph_edit = GlyphEdit();
+
+            if(list_prev_lines && !m_layout_changed)
+            {
+                m_glyph_edit =
+                        CalcLinesGlyphEdit(
+                            *list_prev_lines,
+                            list_lines,
+                            prev_utf16_size,
+                            m_lines_utf16_size);
+            }
+
+            // Keep the glyph data the drawables were created from
+            // so that they can be patched in updateDrawables
+            if(m_lines_drawn)
+            {
+                m_list_drawn_lines = std::move(list_prev_lines);
+                m_drawn_utf16_size = prev_utf16_size;
+                m_lines_drawn = false;
+            }
+
             float new_height = 0.0f;
             float new_width = 0.0f;
 
@@ -486,6 +959,12 @@ namespace raintk
         {
             height = 0.0f;
             width = 0.0f;
+
+            m_list_lines = nullptr;
+            m_lines_utf16_size = 0;
+            m_list_drawn_lines = nullptr;
+            m_lines_drawn = false;
+            m_glyph_edit = GlyphEdit();
         }
 
         // Indicate drawables must be updated
@@ -526,25 +1005,7 @@ namespace raintk
 
         if(m_list_lines==nullptr)
         {
-            // The max line width must be scaled by the
-            // size of the text but watch out for the
-            // float->uint cast overflow
-            float scaled_line_width =
-                    line_width.Get()*
-                    (m_scene->GetTextGlyphSizePx()/size.Get());
-
-            if(scaled_line_width < float(k_max_line_width))
-            {
-                m_text_hint.max_line_width_px =
-                        uint(scaled_line_width);
-            }
-
-            // Get/generate the glyphs from the TextManager
-            m_list_lines =
-                    m_scene->GetTextManager()->GetGlyphs(
-                        m_u16_text,
-                        m_text_hint);
-
+            m_list_lines = shapeLines();
             signal_glyph_data_changed.Emit();
         }
 
@@ -560,36 +1021,41 @@ namespace raintk
             }
         }
 
-        // Acquire a GlyphBatchIndex for each required atlas
-        std::vector<GlyphBatchIndex> list_glyph_batch_indices(
-                    list_atlas_idxs.back()+1);
+        acquireBatches(list_atlas_idxs);
+    }
 
+    // Should only be called from createDrawables/removeDrawables.
+    // Creates a batch for each entry in @list_atlas_idxs, which
+    // must be sorted and not be empty. An atlas may be listed
+    // more than once if its glyphs need more than one batch.
+    void Text::acquireBatches(std::vector<uint> const &list_atlas_idxs)
+    {
         auto const & lkup_text_atlas_data =
                 m_scene->GetTextAtlasData();
 
         for(auto atlas_idx : list_atlas_idxs)
         {
-            list_glyph_batch_indices[atlas_idx] =
+            Id const texture_set_id =
+                    lkup_text_atlas_data.at(atlas_idx)->texture_set_id;
+
+            // Acquire a GlyphBatchIndex and create the
+            // corresponding entity
+            GlyphBatchIndex const glyph_batch_index =
                     AcquireGlyphBatchIndex(
                         m_scene->GetDrawSystem(),
-                        lkup_text_atlas_data.at(atlas_idx)->
                         texture_set_id);
-        }
 
-        // Create GlyphBatches and corresponding entities
-        for(auto atlas_idx : list_atlas_idxs)
-        {
             auto const ent_id = m_scene->CreateEntity();
 
             // Save GlyphBatch
             m_list_glyph_batches.emplace_back(
                         GlyphBatch{
                             ent_id,
-                            list_glyph_batch_indices[atlas_idx].uniform_set,
-                            list_glyph_batch_indices[atlas_idx].index,
+                            glyph_batch_index.uniform_set,
+                            glyph_batch_index.index,
                             atlas_idx,
-                            list_glyph_batch_indices[atlas_idx].uniform_set_id,
-                            lkup_text_atlas_data.at(atlas_idx)->texture_set_id
+                            glyph_batch_index.uniform_set_id,
+                            texture_set_id
                         });
         }
     }
@@ -643,14 +1109,44 @@ namespace raintk
 
         findNonZeroGlyph(list_lines);
 
-        // Create DrawData and TransformData for each batch
+        // There's one batch per atlas
+        std::vector<UPtrBuffer> list_batch_vx_buffs;
+        for(auto const &batch : m_list_glyph_batches)
+        {
+            list_batch_vx_buffs.push_back(
+                        std::move(list_glyph_vx_buffs[batch.atlas_index]));
+        }
+
+        createBatchDrawData(list_batch_vx_buffs);
+
+        updateTransformUniforms();
+        updateColorUniforms();
+        updateHighlight();
+
+        m_upd_xf = false;
+        m_upd_color = false;
+        m_upd_highlight = false;
+
+        if(!m_keep_glyph_data)
+        {
+            m_list_lines = nullptr;
+            signal_glyph_data_changed.Emit();
+        }
+    }
 
+    // Creates DrawData and TransformData for each batch.
+    // @list_batch_vx_buffs has the vertices of each batch
+    // in m_list_glyph_batches.
+    void Text::createBatchDrawData(std::vector<UPtrBuffer>& list_batch_vx_buffs)
+    {
         auto xf_data_copy =
                 m_cmlist_xf_data->
                 GetComponent(m_entity_id);
 
-        for(auto& batch : m_list_glyph_batches)
+        for(uint i=0; i < m_list_glyph_batches.size(); i++)
         {
+            auto const &batch = m_list_glyph_batches[i];
+
             m_cmlist_xf_data->Create(
                         batch.entity_id,
                         xf_data_copy);
@@ -660,27 +1156,30 @@ namespace raintk
                         batch.entity_id,
                         DrawData{
                             g_base_draw_key,
-                            std::move(list_glyph_vx_buffs[batch.atlas_index]),
+                            std::move(list_batch_vx_buffs[i]),
                             visible.Get()
                         });
 
             draw_data.key.SetClip(m_clip_id);
+            draw_data.key.SetLayer(m_layer_id);
             draw_data.key.SetTextureSet(batch.texture_set_id);
             draw_data.key.SetUniformSet(batch.uniform_set_id);
         }
+    }
 
-        updateTransformUniforms();
-        updateColorUniforms();
-        updateHighlight();
-
-        m_upd_xf = false;
-        m_upd_color = false;
-        m_upd_highlight = false;
-
-        if(!m_keep_glyph_data)
+    void Text::updateLineWidthHint()
+    {
+        // The max line width must be scaled by the
+        // size of the text but watch out for the
+        // float->uint cast overflow
+        float scaled_line_width =
+                line_width.Get()*
+                (m_scene->GetTextGlyphSizePx()/size.Get());
+
+        if(scaled_line_width < float(k_max_line_width))
         {
-            m_list_lines = nullptr;
-            signal_glyph_data_changed.Emit();
+            m_text_hint.max_line_width_px =
+                    uint(scaled_line_width);
         }
     }
 
@@ -689,9 +1188,24 @@ namespace raintk
         releaseBatches();
     }
 
+    void Text::getDrawDataIds(std::vector<Id>& list_ent_ids) const
+    {
+        // The glyphs are drawn by the batch entities
+        for(auto const &batch : m_list_glyph_batches)
+        {
+            list_ent_ids.push_back(batch.entity_id);
+        }
+    }
+
     void Text::updateDrawables()
     {
-        if(m_upd_recreate)
+        bool recreated = false;
+
+        if(m_virtualized)
+        {
+            recreated = updateVirtualDrawables();
+        }
+        else if(m_upd_recreate && !patchDrawables())
         {
             destroyDrawables();
 
@@ -699,8 +1213,11 @@ namespace raintk
             {
                 createDrawables();
             }
+
+            recreated = true;
         }
-        else
+
+        if(!recreated)
         {
             if(m_upd_xf)
             {
@@ -718,10 +1235,289 @@ namespace raintk
             }
         }
 
+        if(m_upd_recreate)
+        {
+            m_list_drawn_lines = nullptr;
+            m_lines_drawn = (m_list_lines != nullptr);
+        }
+
         m_upd_recreate = false;
         m_upd_xf = false;
         m_upd_color = false;
         m_upd_highlight = false;
+        m_layout_changed = false;
+    }
+
+    // Patches the vertex buffers of the existing drawables after
+    // an edit that only changed one line of text. Only the vertices
+    // of changed glyphs are generated; the vertices of the glyphs
+    // after them are moved, and shifted if they're on the same line.
+    // Returns false if the drawables have to be recreated instead.
+    bool Text::patchDrawables()
+    {
+        if(m_layout_changed ||
+           m_list_glyph_batches.empty() ||
+           m_list_drawn_lines == nullptr ||
+           m_list_lines == nullptr)
+        {
+            return false;
+        }
+
+        // Glyphs in text that isn't left aligned move when
+        // the extents of the text change
+        auto const this_alignment = alignment.Get();
+        if(this_alignment != Alignment::Auto &&
+           this_alignment != Alignment::Left)
+        {
+            return false;
+        }
+
+        auto const &list_old_lines = *m_list_drawn_lines;
+        auto const &list_new_lines = *m_list_lines;
+
+        GlyphEdit const edit =
+                CalcLinesGlyphEdit(
+                    list_old_lines,
+                    list_new_lines,
+                    m_drawn_utf16_size,
+                    m_lines_utf16_size);
+
+        if(!edit.valid)
+        {
+            return false;
+        }
+
+        auto const &old_line = list_old_lines[edit.line];
+        auto const &new_line = list_new_lines[edit.line];
+
+        // The first line positions all of the text vertically
+        if(edit.line == 0)
+        {
+            if(old_line.ascent != new_line.ascent)
+            {
+                return false;
+            }
+
+            if(height_calc.Get() == HeightCalc::GlyphBounds &&
+               old_line.y_max != new_line.y_max)
+            {
+                return false;
+            }
+        }
+
+        // The existing batches must cover exactly the
+        // atlases that are needed
+        std::vector<uint> list_batch_atlas_idxs;
+        for(auto const &batch : m_list_glyph_batches)
+        {
+            OrderedUniqueInsert<uint>(list_batch_atlas_idxs,batch.atlas_index);
+        }
+
+        std::vector<uint> list_new_atlas_idxs;
+        for(auto const &line : list_new_lines)
+        {
+            for(auto atlas : line.list_atlases)
+            {
+                OrderedUniqueInsert<uint>(list_new_atlas_idxs,atlas);
+            }
+        }
+
+        if(list_batch_atlas_idxs != list_new_atlas_idxs)
+        {
+            return false;
+        }
+
+        // Texture scaling factor
+        float const k_div_atlas =
+                1.0f/m_scene->GetTextAtlasSizePx();
+
+        // Glyph scaling factor
+        float const k_glyph =
+                size.Get()/m_scene->GetTextGlyphSizePx();
+
+        // See genGlyphVertexBuffers
+        float const x_shift = 0.0f-new_line.x_min;
+        float baseline_y = list_new_lines[0].ascent;
+        for(uint i=0; i < edit.line; i++)
+        {
+            baseline_y += list_new_lines[i].spacing;
+        }
+
+        if(height_calc.Get() == HeightCalc::GlyphBounds)
+        {
+            baseline_y += list_new_lines[0].y_max-list_new_lines[0].ascent;
+        }
+
+        auto const &list_old_glyphs = old_line.list_glyphs;
+        auto const &list_new_glyphs = new_line.list_glyphs;
+
+        uint const old_middle_end = list_old_glyphs.size()-edit.suffix_glyphs;
+        uint const new_middle_end = list_new_glyphs.size()-edit.suffix_glyphs;
+
+        // Returns the size of the vertices in @atlas_index of
+        // the glyphs [first,last) of @line
+        auto const calc_vx_bytes =
+                [](ks::text::Line const &line,
+                   uint atlas_index,
+                   uint first,
+                   uint last)
+                {
+                    uint vx_bytes = 0;
+                    for(uint i=first; i < last; i++)
+                    {
+                        auto const &glyph = line.list_glyphs[i];
+                        if(glyph.atlas == atlas_index &&
+                           GetGlyphHasVertices(glyph))
+                        {
+                            vx_bytes += 6*sizeof(Vertex);
+                        }
+                    }
+
+                    return vx_bytes;
+                };
+
+        // Replace the utf16 lookup entries of the changed range
+        m_lkup_utf16_vertex.erase(
+                    m_lkup_utf16_vertex.begin()+edit.utf16_start,
+                    m_lkup_utf16_vertex.begin()+edit.utf16_old_end);
+
+        m_lkup_utf16_vertex.insert(
+                    m_lkup_utf16_vertex.begin()+edit.utf16_start,
+                    edit.utf16_new_end-edit.utf16_start,
+                    std::pair<std::vector<u8>*,uint>(nullptr,0));
+
+        // The change in the byte offset of the unchanged
+        // glyphs after the edit for each buffer
+        std::vector<std::pair<std::vector<u8>*,sint>> list_buff_offsets;
+
+        std::vector<u8> list_middle_vx;
+
+        for(auto& batch : m_list_glyph_batches)
+        {
+            auto& draw_data =
+                    m_cmlist_draw_data->GetComponent(
+                        batch.entity_id);
+
+            auto& list_vx = *(draw_data.vx_buffer);
+
+            // Vertices are in line order
+            uint prefix_bytes =
+                    calc_vx_bytes(
+                        old_line,
+                        batch.atlas_index,
+                        0,
+                        edit.prefix_glyphs);
+
+            for(uint i=0; i < edit.line; i++)
+            {
+                auto const &line = list_old_lines[i];
+                prefix_bytes +=
+                        calc_vx_bytes(
+                            line,
+                            batch.atlas_index,
+                            0,
+                            line.list_glyphs.size());
+            }
+
+            uint const line_suffix_bytes =
+                    calc_vx_bytes(
+                        old_line,
+                        batch.atlas_index,
+                        old_middle_end,
+                        list_old_glyphs.size());
+
+            uint suffix_bytes = line_suffix_bytes;
+            for(uint i=edit.line+1; i < list_old_lines.size(); i++)
+            {
+                auto const &line = list_old_lines[i];
+                suffix_bytes +=
+                        calc_vx_bytes(
+                            line,
+                            batch.atlas_index,
+                            0,
+                            line.list_glyphs.size());
+            }
+
+            // Generate vertices for the changed glyphs
+            list_middle_vx.clear();
+
+            for(uint i=edit.prefix_glyphs; i < new_middle_end; i++)
+            {
+                auto const &glyph = list_new_glyphs[i];
+                if(glyph.atlas != batch.atlas_index ||
+                   !GetGlyphHasVertices(glyph))
+                {
+                    continue;
+                }
+
+                m_lkup_utf16_vertex[glyph.cluster] =
+                    {&list_vx, (prefix_bytes+list_middle_vx.size())};
+
+                PushGlyphVertices(
+                            list_middle_vx,
+                            glyph,
+                            x_shift,
+                            baseline_y,
+                            k_glyph,
+                            k_div_atlas,
+                            static_cast<float>(batch.index));
+            }
+
+            // Splice them in
+            uint const old_middle_bytes =
+                    list_vx.size()-prefix_bytes-suffix_bytes;
+
+            list_vx.erase(
+                        list_vx.begin()+prefix_bytes,
+                        list_vx.begin()+prefix_bytes+old_middle_bytes);
+
+            list_vx.insert(
+                        list_vx.begin()+prefix_bytes,
+                        list_middle_vx.begin(),
+                        list_middle_vx.end());
+
+            // Shift the glyphs after the edit on the same line
+            if(edit.dx != 0 && line_suffix_bytes > 0)
+            {
+                Vertex* vx_buffer =
+                        reinterpret_cast<Vertex*>(
+                            &(list_vx[list_vx.size()-suffix_bytes]));
+
+                uint const vx_count = line_suffix_bytes/sizeof(Vertex);
+                float const dx = edit.dx*k_glyph;
+
+                for(uint i=0; i < vx_count; i++)
+                {
+                    vx_buffer[i].a_v2_position.x += dx;
+                }
+            }
+
+            list_buff_offsets.emplace_back(
+                        &list_vx,
+                        sint(list_middle_vx.size())-sint(old_middle_bytes));
+        }
+
+        // Update the lookup entries of the glyphs after the edit
+        for(uint i=edit.utf16_new_end; i < m_lkup_utf16_vertex.size(); i++)
+        {
+            auto& buff_vx = m_lkup_utf16_vertex[i];
+
+            for(auto const &buff_offset : list_buff_offsets)
+            {
+                if(buff_vx.first == buff_offset.first)
+                {
+                    buff_vx.second += buff_offset.second;
+                    break;
+                }
+            }
+        }
+
+        // The glyph used to calculate the texture res may
+        // have changed
+        findNonZeroGlyph(*m_list_lines);
+        m_upd_xf = true;
+
+        return true;
     }
 
     void Text::updateColorUniforms()
@@ -854,6 +1650,14 @@ namespace raintk
         // Highlight the required glyphs
         for(auto utf16_index : m_utf16_highlight)
         {
+            // Glyphs without vertices (and all glyphs in
+            // virtualized text) have no lookup entry
+            if(utf16_index >= m_lkup_utf16_vertex.size() ||
+               m_lkup_utf16_vertex[utf16_index].first == nullptr)
+            {
+                continue;
+            }
+
             auto& buff_vx = m_lkup_utf16_vertex[utf16_index];
 
             auto& vx_buffer = *(buff_vx.first);
@@ -937,36 +1741,15 @@ namespace raintk
 
             for(ks::text::Glyph const &glyph : line.list_glyphs)
             {
-                // Original glyph dimensions (without any SDF
-                // borders)
-                uint const o_glyph_width = glyph.x1-glyph.x0;
-                uint const o_glyph_height= glyph.y1-glyph.y0;
-
                 auto& list_vx = list_glyph_vx_buffs[glyph.atlas];
 
-
                 // Do I really need this check? Would it be
                 // cheaper to leave it out?
-                if(o_glyph_width==0 && o_glyph_height==0)
+                if(!GetGlyphHasVertices(glyph))
                 {
                     continue;
                 }
 
-                uint const glyph_width = o_glyph_width + (2*glyph.sdf_x);
-                uint const glyph_height= o_glyph_height + (2*glyph.sdf_y);
-
-                float x0 = (glyph.x0-glyph.sdf_x + alignment_shift)*k_glyph;
-                float x1 = (glyph.x1+glyph.sdf_x + alignment_shift)*k_glyph;
-                float y0 = (baseline_y-(glyph.y0-glyph.sdf_y) + y_shift)*k_glyph;
-                float y1 = (baseline_y-(glyph.y1+glyph.sdf_y) + y_shift)*k_glyph;
-
-                float s0 = glyph.tex_x*k_div_atlas;
-                float s1 = (glyph.tex_x+glyph_width)*k_div_atlas;
-
-                // tex_y must be flipped
-                float t0 = glyph.tex_y*k_div_atlas;
-                float t1 = (glyph.tex_y+glyph_height)*k_div_atlas;
-
                 float uniform_index =
                         static_cast<float>(
                             list_glyph_batches[glyph.atlas]->index);
@@ -974,59 +1757,14 @@ namespace raintk
                 m_lkup_utf16_vertex[glyph.cluster] =
                     {list_vx.get(), (list_vx->size())};
 
-                // BL
-                ks::gl::Buffer::PushElement<Vertex>(
-                            *list_vx,
-                            Vertex{
-                                glm::vec2{x0,y0},
-                                glm::vec2{s0,t1},
-                                glm::u16vec2{0,uniform_index},
-                            });
-
-                // TR
-                ks::gl::Buffer::PushElement<Vertex>(
-                            *list_vx,
-                            Vertex{
-                                glm::vec2{x1,y1},
-                                glm::vec2{s1,t0},
-                                glm::u16vec2{0,uniform_index},
-                            });
-
-                // TL
-                ks::gl::Buffer::PushElement<Vertex>(
-                            *list_vx,
-                            Vertex{
-                                glm::vec2{x0,y1},
-                                glm::vec2{s0,t0},
-                                glm::u16vec2{0,uniform_index},
-                            });
-
-                // BL
-                ks::gl::Buffer::PushElement<Vertex>(
+                PushGlyphVertices(
                             *list_vx,
-                            Vertex{
-                                glm::vec2{x0,y0},
-                                glm::vec2{s0,t1},
-                                glm::u16vec2{0,uniform_index}
-                            });
-
-                // BR
-                ks::gl::Buffer::PushElement<Vertex>(
-                            *list_vx,
-                            Vertex{
-                                glm::vec2{x1,y0},
-                                glm::vec2{s1,t1},
-                                glm::u16vec2{0,uniform_index}
-                            });
-
-                // TR
-                ks::gl::Buffer::PushElement<Vertex>(
-                            *list_vx,
-                            Vertex{
-                                glm::vec2{x1,y1},
-                                glm::vec2{s1,t0},
-                                glm::u16vec2{0,uniform_index}
-                            });
+                            glyph,
+                            alignment_shift,
+                            baseline_y + y_shift,
+                            k_glyph,
+                            k_div_atlas,
+                            uniform_index);
             }
 
             // Move baseline down to next line
@@ -1102,6 +1840,755 @@ namespace raintk
         m_nz_glyph_br.a_v2_position.y = 0;
     }
 
+    // Splits the text into paragraphs with estimated sizes
+    // Shapes m_u16_text one paragraph at a time and returns
+    // the lines of all paragraphs. Paragraphs that are the same
+    // as in the text shaped last time are reused if glyph data
+    // is kept, so an edit only reshapes the paragraphs it touched.
+    std::unique_ptr<std::vector<ks::text::Line>> Text::shapeLines()
+    {
+        updateLineWidthHint();
+
+        if(m_layout_changed || !m_keep_glyph_data)
+        {
+            m_list_para_lines.clear();
+            m_para_lines_u16_text.clear();
+        }
+
+        std::vector<ParagraphLines> list_para_lines;
+
+        uint utf16_start = 0;
+        for(uint i=0; i <= m_u16_text.size(); i++)
+        {
+            if(i == m_u16_text.size() || m_u16_text[i] == u'\n')
+            {
+                list_para_lines.emplace_back(
+                            ParagraphLines{
+                                utf16_start,
+                                i-utf16_start,
+                                std::vector<ks::text::Line>()
+                            });
+
+                utf16_start = i+1;
+            }
+        }
+
+        // Reuse the paragraphs at the start and the end
+        // that didn't change. The old paragraphs are taken
+        // out first so that nothing stale is left behind
+        // if shaping throws.
+        std::vector<ParagraphLines> list_old_para_lines;
+        list_old_para_lines.swap(m_list_para_lines);
+
+        std::u16string old_u16_text;
+        old_u16_text.swap(m_para_lines_u16_text);
+
+        auto const para_equal =
+                [this,&old_u16_text](ParagraphLines const &old_para,
+                                     ParagraphLines const &new_para)
+                {
+                    return (old_para.utf16_size == new_para.utf16_size &&
+                            old_u16_text.compare(
+                                old_para.utf16_start,
+                                old_para.utf16_size,
+                                m_u16_text,
+                                new_para.utf16_start,
+                                new_para.utf16_size) == 0);
+                };
+
+        uint const max_common =
+                std::min(list_old_para_lines.size(),
+                         list_para_lines.size());
+
+        uint prefix = 0;
+        while(prefix < max_common &&
+              para_equal(list_old_para_lines[prefix],
+                         list_para_lines[prefix]))
+        {
+            list_para_lines[prefix].list_lines =
+                    std::move(list_old_para_lines[prefix].list_lines);
+            prefix++;
+        }
+
+        uint suffix = 0;
+        while(suffix < (max_common-prefix))
+        {
+            auto& old_para =
+                    list_old_para_lines[list_old_para_lines.size()-1-suffix];
+
+            auto& new_para =
+                    list_para_lines[list_para_lines.size()-1-suffix];
+
+            if(!para_equal(old_para,new_para))
+            {
+                break;
+            }
+
+            new_para.list_lines = std::move(old_para.list_lines);
+            suffix++;
+        }
+
+        // Shape the rest
+        std::unique_ptr<std::vector<ks::text::Line>> list_empty_lines;
+
+        for(uint i=prefix; i < list_para_lines.size()-suffix; i++)
+        {
+            auto& para = list_para_lines[i];
+
+            if(para.utf16_size > 0)
+            {
+                auto list_lines =
+                        m_scene->GetTextManager()->GetGlyphs(
+                            m_u16_text.substr(
+                                para.utf16_start,
+                                para.utf16_size),
+                            m_text_hint);
+
+                para.list_lines = std::move(*list_lines);
+            }
+
+            if(para.list_lines.empty())
+            {
+                // An empty line, with the metrics of a space
+                if(!list_empty_lines)
+                {
+                    list_empty_lines =
+                            m_scene->GetTextManager()->GetGlyphs(
+                                std::u16string(u" "),
+                                m_text_hint);
+
+                    list_empty_lines->resize(1);
+                    auto& line = list_empty_lines->front();
+                    line.list_glyphs.clear();
+                    line.list_atlases.clear();
+                    line.x_max = line.x_min;
+                }
+
+                para.list_lines = *list_empty_lines;
+            }
+        }
+
+        // Combine the lines of all paragraphs
+        uint line_count = 0;
+        for(auto const &para : list_para_lines)
+        {
+            line_count += para.list_lines.size();
+        }
+
+        auto list_lines = make_unique<std::vector<ks::text::Line>>();
+        list_lines->reserve(line_count);
+
+        for(auto const &para : list_para_lines)
+        {
+            for(auto const &line : para.list_lines)
+            {
+                list_lines->push_back(line);
+
+                for(auto& glyph : list_lines->back().list_glyphs)
+                {
+                    glyph.cluster += para.utf16_start;
+                }
+            }
+        }
+
+        if(m_keep_glyph_data)
+        {
+            m_list_para_lines = std::move(list_para_lines);
+            m_para_lines_u16_text = m_u16_text;
+        }
+
+        return list_lines;
+    }
+
+    void Text::createParagraphs()
+    {
+        m_upd_paragraphs = false;
+        m_list_paragraphs.clear();
+        m_list_paragraph_tops.clear();
+        m_list_shaped_paragraphs.clear();
+        m_paras_drawn = false;
+        m_para_width = 0.0f;
+
+        if(m_u16_text.empty())
+        {
+            return;
+        }
+
+        updateLineWidthHint();
+
+        uint utf16_start = 0;
+        for(uint i=0; i <= m_u16_text.size(); i++)
+        {
+            if(i == m_u16_text.size() || m_u16_text[i] == u'\n')
+            {
+                m_list_paragraphs.emplace_back();
+                m_list_paragraphs.back().utf16_start = utf16_start;
+                m_list_paragraphs.back().utf16_size = i-utf16_start;
+                utf16_start = i+1;
+            }
+        }
+
+        // Shape a sample from the first non empty paragraph
+        // to get the metrics used for estimates
+        std::u16string sample(u"M");
+        for(auto const &para : m_list_paragraphs)
+        {
+            if(para.utf16_size > 0)
+            {
+                sample = m_u16_text.substr(
+                            para.utf16_start,
+                            std::min(para.utf16_size,k_para_sample_size));
+                break;
+            }
+        }
+
+        auto list_sample_lines =
+                m_scene->GetTextManager()->GetGlyphs(
+                    sample,
+                    m_text_hint);
+
+        m_para_ascent = list_sample_lines->front().ascent;
+        m_para_descent = std::abs(list_sample_lines->back().descent);
+        m_para_spacing = list_sample_lines->front().spacing;
+
+        float sample_width = 0.0f;
+        for(auto const &line : *list_sample_lines)
+        {
+            sample_width += (line.x_max-line.x_min);
+        }
+
+        m_para_advance = sample_width/sample.size();
+
+        // Estimate the number of lines in each paragraph
+        float const scaled_line_width =
+                line_width.Get()*
+                (m_scene->GetTextGlyphSizePx()/size.Get());
+
+        bool const wrapped =
+                (scaled_line_width < float(k_max_line_width)) &&
+                (scaled_line_width > 0.0f);
+
+        for(auto& para : m_list_paragraphs)
+        {
+            uint line_count = 1;
+            if(wrapped)
+            {
+                line_count =
+                        std::max<uint>(
+                            1,uint(std::ceil(para.utf16_size*m_para_advance/
+                                             scaled_line_width)));
+            }
+
+            para.height = line_count*m_para_spacing;
+        }
+
+        m_list_paragraph_tops.resize(m_list_paragraphs.size()+1,0.0f);
+        updateParagraphTops(0);
+    }
+
+    // Shapes the paragraph at @index if it doesn't have glyph
+    // data. Returns true if its height changed.
+    bool Text::shapeParagraph(uint index)
+    {
+        auto& para = m_list_paragraphs[index];
+        if(para.list_lines)
+        {
+            return false;
+        }
+
+        float const prev_height = para.height;
+
+        if(para.utf16_size > 0)
+        {
+            para.list_lines =
+                    m_scene->GetTextManager()->GetGlyphs(
+                        m_u16_text.substr(
+                            para.utf16_start,
+                            para.utf16_size),
+                        m_text_hint);
+        }
+
+        if(para.list_lines && !para.list_lines->empty())
+        {
+            para.height = 0.0f;
+            para.width = 0.0f;
+            para.glyph_count = 0;
+
+            for(auto const &line : *(para.list_lines))
+            {
+                para.height += line.spacing;
+                para.width = std::max<float>(para.width,line.x_max-line.x_min);
+                para.glyph_count += line.list_glyphs.size();
+            }
+
+            m_list_shaped_paragraphs.push_back(index);
+        }
+        else
+        {
+            // An empty line
+            para.list_lines = nullptr;
+            para.height = m_para_spacing;
+            para.width = 0.0f;
+            para.glyph_count = 0;
+        }
+
+        para.measured = true;
+        m_para_width = std::max(m_para_width,para.width);
+
+        return (para.height != prev_height);
+    }
+
+    void Text::updateParagraphTops(uint from)
+    {
+        for(uint i=from; i < m_list_paragraphs.size(); i++)
+        {
+            m_list_paragraph_tops[i+1] =
+                    m_list_paragraph_tops[i]+
+                    m_list_paragraphs[i].height;
+        }
+    }
+
+    // Gets the part of the clip region of this Text that can be
+    // seen, in glyph px relative to the top left of the text.
+    // Returns false if there's no clip region.
+    bool Text::calcVisibleRegion(BoundingBox& region) const
+    {
+        auto const &list_clip_regions =
+                m_scene->GetDrawSystem()->GetClipRegions();
+
+        if(m_clip_id >= list_clip_regions.size())
+        {
+            region = BoundingBox{0.0f,0.0f,0.0f,0.0f};
+            return false;
+        }
+
+        // Get the extents of the clip region in
+        // local coordinates
+        auto const &clip = list_clip_regions[m_clip_id];
+        Widget* this_widget = const_cast<Text*>(this);
+
+        std::array<glm::vec2,4> const list_corners{{
+            CalcLocalCoords(this_widget,glm::vec2(clip.x0,clip.y0)),
+            CalcLocalCoords(this_widget,glm::vec2(clip.x1,clip.y0)),
+            CalcLocalCoords(this_widget,glm::vec2(clip.x0,clip.y1)),
+            CalcLocalCoords(this_widget,glm::vec2(clip.x1,clip.y1))
+        }};
+
+        region.x0 = std::numeric_limits<float>::max();
+        region.y0 = std::numeric_limits<float>::max();
+        region.x1 = std::numeric_limits<float>::lowest();
+        region.y1 = std::numeric_limits<float>::lowest();
+
+        for(auto const &corner : list_corners)
+        {
+            region.x0 = std::min(region.x0,corner.x);
+            region.y0 = std::min(region.y0,corner.y);
+            region.x1 = std::max(region.x1,corner.x);
+            region.y1 = std::max(region.y1,corner.y);
+        }
+
+        // Convert to glyph px
+        float const k_div_glyph =
+                m_scene->GetTextGlyphSizePx()/size.Get();
+
+        region.x0 *= k_div_glyph;
+        region.y0 *= k_div_glyph;
+        region.x1 *= k_div_glyph;
+        region.y1 *= k_div_glyph;
+
+        return true;
+    }
+
+    // Finds the range of paragraphs [first,last) that
+    // intersect @region (in glyph px)
+    void Text::calcParagraphRange(BoundingBox const &region,
+                                  uint& first,
+                                  uint& last) const
+    {
+        // Pad by a line since glyphs can extend
+        // past their paragraph
+        float const y_min = region.y0 - m_para_spacing;
+        float const y_max = region.y1 + m_para_spacing;
+
+        // Paragraph i spans [tops[i],tops[i+1])
+        auto const &tops = m_list_paragraph_tops;
+        uint const count = m_list_paragraphs.size();
+
+        first = std::upper_bound(tops.begin()+1,tops.end(),y_min)-
+                (tops.begin()+1);
+
+        last = std::lower_bound(tops.begin(),tops.begin()+count,y_max)-
+                tops.begin();
+
+        last = std::max(first,last);
+    }
+
+    // Recreates drawables if the visible region isn't
+    // covered by the existing ones. Returns true if they
+    // were recreated.
+    bool Text::updateVirtualDrawables()
+    {
+        if(m_list_paragraphs.empty())
+        {
+            destroyDrawables();
+            m_paras_drawn = false;
+            m_drawn_glyph_count = 0;
+            return true;
+        }
+
+        // Measuring paragraphs moves the ones after them,
+        // so repeat until the visible range settles
+        BoundingBox region;
+        bool has_region = false;
+        uint first = 0;
+        uint last = 0;
+        bool resized = false;
+
+        uint const max_measure_passes = 4;
+        for(uint pass=0; pass < max_measure_passes; pass++)
+        {
+            has_region = calcVisibleRegion(region);
+            if(has_region)
+            {
+                calcParagraphRange(region,first,last);
+            }
+
+            uint changed_from = m_list_paragraphs.size();
+            for(uint i=first; i < last; i++)
+            {
+                if(!m_list_paragraphs[i].measured && shapeParagraph(i))
+                {
+                    changed_from = std::min(changed_from,i);
+                }
+            }
+
+            if(changed_from == m_list_paragraphs.size())
+            {
+                break;
+            }
+
+            updateParagraphTops(changed_from);
+            resized = true;
+        }
+
+        if(!m_upd_recreate && m_paras_drawn &&
+           region.x0 >= m_drawn_region.x0 &&
+           region.y0 >= m_drawn_region.y0 &&
+           region.x1 <= m_drawn_region.x1 &&
+           region.y1 <= m_drawn_region.y1)
+        {
+            return false;
+        }
+
+        // Also draw the glyphs around the visible ones, up to
+        // the size of the visible region in each direction, so
+        // that scrolling doesn't recreate drawables every frame.
+        // Only glyphs within this region are drawn, so the glyph
+        // count depends on the size of the region and not on
+        // the size of the paragraphs in it.
+        float const margin_x = region.x1-region.x0;
+        float const margin_y = region.y1-region.y0;
+
+        BoundingBox const draw_region{
+            region.x0-margin_x,
+            region.y0-margin_y,
+            region.x1+margin_x,
+            region.y1+margin_y
+        };
+
+        uint draw_first = 0;
+        uint draw_last = 0;
+        if(has_region)
+        {
+            calcParagraphRange(draw_region,draw_first,draw_last);
+        }
+
+        uint changed_from = m_list_paragraphs.size();
+        for(uint i=draw_first; i < draw_last; i++)
+        {
+            if(shapeParagraph(i))
+            {
+                changed_from = std::min(changed_from,i);
+            }
+        }
+
+        if(changed_from < m_list_paragraphs.size())
+        {
+            updateParagraphTops(changed_from);
+            resized = true;
+        }
+
+        destroyDrawables();
+        m_lkup_utf16_vertex.clear();
+
+        m_paras_drawn = true;
+        m_paras_drawn_first = draw_first;
+        m_paras_drawn_last = draw_last;
+        m_drawn_region = draw_region;
+
+        genParagraphDrawables(draw_first,draw_last,draw_region);
+
+        // Drop the glyph data of paragraphs that are far
+        // from the ones that were drawn
+        uint const keep_span = draw_last-draw_first;
+        uint const keep_first = (draw_first > keep_span) ? (draw_first-keep_span) : 0;
+        uint const keep_last = draw_last+keep_span;
+
+        auto it = std::remove_if(
+                    m_list_shaped_paragraphs.begin(),
+                    m_list_shaped_paragraphs.end(),
+                    [&](uint index)
+                    {
+                        if(index < keep_first || index >= keep_last)
+                        {
+                            m_list_paragraphs[index].list_lines = nullptr;
+                            return true;
+                        }
+                        return false;
+                    });
+
+        m_list_shaped_paragraphs.erase(it,m_list_shaped_paragraphs.end());
+
+        // The size of this Text must be updated after
+        // paragraphs were measured
+        if(resized)
+        {
+            auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
+            upd_data.update |= UpdateData::UpdateWidget;
+        }
+
+        return true;
+    }
+
+    // Creates drawables for the glyphs of the paragraphs
+    // [first,last) that intersect @region (in glyph px).
+    // Glyphs are split into as many batches per atlas as
+    // needed to stay within k_max_batch_glyphs.
+    void Text::genParagraphDrawables(uint first,
+                                     uint last,
+                                     BoundingBox const &region)
+    {
+        struct PlacedGlyph
+        {
+            ks::text::Glyph const * glyph;
+            float x_shift;
+            float baseline_y;
+        };
+
+        std::vector<PlacedGlyph> list_placed_glyphs;
+        std::vector<uint> list_atlas_glyph_counts;
+
+        // Lines are aligned within the widest paragraph
+        // that has been measured
+        float const text_width = m_para_width;
+
+        std::array<float,4> list_alignment_shifts;
+
+        for(uint i=first; i < last; i++)
+        {
+            auto const &para = m_list_paragraphs[i];
+            if(!para.list_lines)
+            {
+                continue;
+            }
+
+            auto const &list_lines = *(para.list_lines);
+
+            auto this_alignment = alignment.Get();
+            if(this_alignment == Alignment::Auto)
+            {
+                this_alignment = (list_lines[0].rtl) ?
+                            Alignment::Right : Alignment::Left;
+            }
+
+            // The first baseline is 'ascent' pixels below
+            // the top of the text
+            float baseline_y = m_para_ascent+m_list_paragraph_tops[i];
+
+            for(auto const &line : list_lines)
+            {
+                // Lines are at most one line spacing from
+                // their baseline
+                if(baseline_y-line.spacing > region.y1)
+                {
+                    break;
+                }
+
+                if(baseline_y+line.spacing < region.y0)
+                {
+                    baseline_y += line.spacing;
+                    continue;
+                }
+
+                list_alignment_shifts[1] = 0.0f-line.x_min; // Left
+                list_alignment_shifts[2] = text_width-line.x_max; // Right
+                list_alignment_shifts[3] = list_alignment_shifts[2]*0.5f; // Center
+
+                float const alignment_shift =
+                        list_alignment_shifts[
+                            static_cast<uint>(this_alignment)];
+
+                for(ks::text::Glyph const &glyph : line.list_glyphs)
+                {
+                    if(!GetGlyphHasVertices(glyph))
+                    {
+                        continue;
+                    }
+
+                    // Skip glyphs outside of the region
+                    if(alignment_shift+glyph.x1 < region.x0 ||
+                       alignment_shift+glyph.x0 > region.x1 ||
+                       baseline_y-glyph.y1 > region.y1 ||
+                       baseline_y-glyph.y0 < region.y0)
+                    {
+                        continue;
+                    }
+
+                    if(glyph.atlas >= list_atlas_glyph_counts.size())
+                    {
+                        list_atlas_glyph_counts.resize(glyph.atlas+1,0);
+                    }
+
+                    list_atlas_glyph_counts[glyph.atlas]++;
+
+                    list_placed_glyphs.push_back(
+                                PlacedGlyph{
+                                    &glyph,
+                                    alignment_shift,
+                                    baseline_y
+                                });
+                }
+
+                baseline_y += line.spacing;
+            }
+        }
+
+        m_drawn_glyph_count = list_placed_glyphs.size();
+
+        if(list_placed_glyphs.empty())
+        {
+            return;
+        }
+
+        // Acquire batches. The batches of each atlas are
+        // next to each other in m_list_glyph_batches.
+        std::vector<uint> list_atlas_idxs;
+        std::vector<uint> list_atlas_first_batch(
+                    list_atlas_glyph_counts.size(),0);
+
+        for(uint atlas=0; atlas < list_atlas_glyph_counts.size(); atlas++)
+        {
+            uint const glyph_count = list_atlas_glyph_counts[atlas];
+            uint const batch_count =
+                    (glyph_count+k_max_batch_glyphs-1)/k_max_batch_glyphs;
+
+            list_atlas_first_batch[atlas] = list_atlas_idxs.size();
+            list_atlas_idxs.insert(list_atlas_idxs.end(),batch_count,atlas);
+        }
+
+        acquireBatches(list_atlas_idxs);
+
+        std::vector<UPtrBuffer> list_batch_vx_buffs;
+        for(uint i=0; i < m_list_glyph_batches.size(); i++)
+        {
+            list_batch_vx_buffs.push_back(make_unique<std::vector<u8>>());
+        }
+
+        // Generate vertices
+        float const k_div_atlas =
+                1.0f/m_scene->GetTextAtlasSizePx();
+
+        float const k_glyph =
+                size.Get()/m_scene->GetTextGlyphSizePx();
+
+        // Reuse the counts for the number of glyphs
+        // added to each atlas so far
+        std::fill(list_atlas_glyph_counts.begin(),
+                  list_atlas_glyph_counts.end(),
+                  0);
+
+        for(auto const &placed : list_placed_glyphs)
+        {
+            uint const atlas = placed.glyph->atlas;
+
+            uint const batch_index =
+                    list_atlas_first_batch[atlas]+
+                    (list_atlas_glyph_counts[atlas]/k_max_batch_glyphs);
+
+            list_atlas_glyph_counts[atlas]++;
+
+            auto const &batch = m_list_glyph_batches[batch_index];
+
+            PushGlyphVertices(
+                        *(list_batch_vx_buffs[batch_index]),
+                        *(placed.glyph),
+                        placed.x_shift,
+                        placed.baseline_y,
+                        k_glyph,
+                        k_div_atlas,
+                        static_cast<float>(batch.index));
+        }
+
+        for(uint i=first; i < last; i++)
+        {
+            auto const &para = m_list_paragraphs[i];
+            if(para.list_lines)
+            {
+                findNonZeroGlyph(*(para.list_lines));
+
+                if(m_nz_glyph_br.a_v2_position.x !=
+                   m_nz_glyph_tl.a_v2_position.x)
+                {
+                    break;
+                }
+            }
+        }
+
+        createBatchDrawData(list_batch_vx_buffs);
+
+        updateTransformUniforms();
+        updateColorUniforms();
+    }
+
+    Text::VirtualizedStats Text::GetVirtualizedStats() const
+    {
+        VirtualizedStats stats;
+        stats.paragraph_count = m_list_paragraphs.size();
+
+        if(m_paras_drawn)
+        {
+            stats.drawn_first = m_paras_drawn_first;
+            stats.drawn_last = m_paras_drawn_last;
+            stats.drawn_glyph_count = m_drawn_glyph_count;
+        }
+
+        for(auto const &batch : m_list_glyph_batches)
+        {
+            auto const &draw_data =
+                    m_cmlist_draw_data->GetComponent(
+                        batch.entity_id);
+
+            stats.max_batch_glyph_count =
+                    std::max<uint>(
+                        stats.max_batch_glyph_count,
+                        draw_data.vx_buffer->size()/(6*sizeof(Vertex)));
+        }
+
+        stats.shaped_first = stats.paragraph_count;
+        for(auto index : m_list_shaped_paragraphs)
+        {
+            stats.shaped_first = std::min(stats.shaped_first,index);
+            stats.shaped_last = std::max(stats.shaped_last,index+1);
+        }
+
+        if(m_list_shaped_paragraphs.empty())
+        {
+            stats.shaped_first = 0;
+        }
+
+        return stats;
+    }
+
     void Text::setupTypeInit(Scene* scene)
     {
         static_assert(sizeof(Vertex) == 20,
@@ -70,6 +70,35 @@ namespace raintk
             //     transform and color information
             glm::u16vec2 a_v2_highlight_index; // 4
         };
+
+        // A run of text between line breaks ('\n') in a
+        // virtualized Text
+        struct Paragraph
+        {
+            uint utf16_start{0};
+            uint utf16_size{0};
+
+            // Dimensions in glyph px. The height is estimated
+            // until the paragraph has been shaped once.
+            bool measured{false};
+            float height{0.0f};
+            float width{0.0f};
+            uint glyph_count{0};
+
+            // Only kept while the paragraph is near the
+            // region that's drawn
+            std::unique_ptr<std::vector<ks::text::Line>> list_lines;
+        };
+
+        // The shaped lines of a paragraph of Text that isn't
+        // virtualized. Glyph clusters are relative to the start
+        // of the paragraph.
+        struct ParagraphLines
+        {
+            uint utf16_start;
+            uint utf16_size;
+            std::vector<ks::text::Line> list_lines;
+        };
     }
 
     // ============================================================= //
@@ -80,6 +109,9 @@ namespace raintk
         static uint const k_max_line_width{
             std::numeric_limits<uint>::max()/2};
 
+        // The max number of glyphs drawn by a single batch
+        static uint const k_max_batch_glyphs{4096};
+
         enum class Alignment : u8
         {
             Auto=0,
@@ -122,9 +154,74 @@ namespace raintk
         // used to create drawables.
         void SetKeepGlyphData(bool enabled);
 
+        // Only generates glyphs for the paragraphs of text that
+        // intersect the clip region of this Text, for documents
+        // that are too large to be drawn at once (ie. a log
+        // inside a ScrollArea)
+        // * Paragraphs are shaped the first time they come near
+        //   the clip region. Until then their size is estimated,
+        //   so the width and height of this Text may change as
+        //   it's scrolled through
+        // * The height is always calculated from font bounds
+        // * Glyph data and highlighting aren't available
+        void SetVirtualized(bool enabled);
+
+        // Describes what a virtualized Text currently draws
+        // and which paragraphs have glyph data
+        // * Glyphs are only drawn within a region around the
+        //   clip region, so @drawn_glyph_count doesn't depend
+        //   on the size of the paragraphs in [drawn_first,
+        //   drawn_last)
+        // * [shaped_first,shaped_last) spans the paragraphs
+        //   that have glyph data
+        struct VirtualizedStats
+        {
+            uint paragraph_count{0};
+            uint drawn_first{0};
+            uint drawn_last{0};
+            uint drawn_glyph_count{0};
+            uint max_batch_glyph_count{0};
+            uint shaped_first{0};
+            uint shaped_last{0};
+        };
+
+        VirtualizedStats GetVirtualizedStats() const;
+
         // Sets the list of characters to render with highlight_color
         void SetHighlightedText(std::vector<uint> const &utf16_indices);
 
+        // Describes what changed between the previous and the
+        // current glyph data after the text was edited, if the
+        // edit only changed a single left-to-right line
+        // * Only the glyphs of @line changed. The lines after it
+        //   are unchanged except that their utf16 indices are
+        //   shifted by (utf16_new_end-utf16_old_end).
+        // * The first @prefix_glyphs glyphs of @line are unchanged
+        // * The last @suffix_glyphs glyphs of @line are unchanged
+        //   except that they're shifted by @dx (in glyph px) and
+        //   their utf16 indices by (utf16_new_end-utf16_old_end)
+        // * Glyphs in between correspond to the utf16 range
+        //   [utf16_start,utf16_old_end) in the previous text and
+        //   [utf16_start,utf16_new_end) in the current text
+        // * Not valid if anything other than the text changed,
+        //   if the number of lines changed or if glyph data isn't
+        //   kept (see SetKeepGlyphData)
+        struct GlyphEdit
+        {
+            bool valid{false};
+            uint line{0};
+            uint prefix_glyphs{0};
+            uint suffix_glyphs{0};
+            uint utf16_start{0};
+            uint utf16_old_end{0};
+            uint utf16_new_end{0};
+            sint dx{0};
+        };
+
+        // Describes the most recent change to the glyph data.
+        // Can be used from signal_glyph_data_changed.
+        GlyphEdit const &GetGlyphEdit() const;
+
 
         // Properties
         Property<glm::u8vec4> color {
@@ -174,18 +271,25 @@ namespace raintk
         void onHeightCalcChanged();
         void onVisibilityChanged() override;
         void onClipIdUpdated() override;
+        void onLayerIdUpdated() override;
         void onTransformUpdated() override;
         void onAccOpacityUpdated() override;
         void update() override;
         void createDrawables() override;
         void destroyDrawables() override;
         void updateDrawables() override;
+        void getDrawDataIds(std::vector<Id>& list_ent_ids) const override;
         void releaseBatches();
         void acquireBatches();
+        void acquireBatches(std::vector<uint> const &list_atlas_idxs);
+        void createBatchDrawData(std::vector<UPtrBuffer>& list_batch_vx_buffs);
+        void updateLineWidthHint();
         void updateColorUniforms();
         void updateTransformUniforms();
         void updateHighlight();
 
+        bool patchDrawables();
+
         void genGlyphVertexBuffers(
                 std::vector<ks::text::Line> const &list_lines,
                 std::vector<text_detail::GlyphBatch*> const &list_glyph_batches,
@@ -194,6 +298,21 @@ namespace raintk
         void findNonZeroGlyph(
                 std::vector<ks::text::Line> const &list_lines);
 
+        std::unique_ptr<std::vector<ks::text::Line>> shapeLines();
+
+        void createParagraphs();
+        bool shapeParagraph(uint index);
+        void updateParagraphTops(uint from);
+        bool calcVisibleRegion(BoundingBox& region) const;
+        void calcParagraphRange(BoundingBox const &region,
+                                uint& first,
+                                uint& last) const;
+        bool updateVirtualDrawables();
+
+        void genParagraphDrawables(uint first,
+                                   uint last,
+                                   BoundingBox const &region);
+
         static void setupTypeInit(Scene* scene);
 
         DrawDataComponentList* const m_cmlist_draw_data;
@@ -225,6 +344,52 @@ namespace raintk
         text_detail::Vertex m_nz_glyph_br;
 
         std::unique_ptr<std::vector<ks::text::Line>> m_list_lines;
+        uint m_lines_utf16_size{0};
+
+        // The text is shaped one paragraph (run of text between
+        // line breaks) at a time. If glyph data is kept, the
+        // lines of each paragraph are kept as well so that only
+        // the paragraphs an edit changed are shaped again.
+        std::vector<text_detail::ParagraphLines> m_list_para_lines;
+        std::u16string m_para_lines_u16_text;
+
+        // Edits to single line text patch the vertices of the
+        // glyphs that changed instead of recreating drawables.
+        // This needs the glyph data the drawables were created
+        // from, so it's only done if glyph data is kept.
+        bool m_layout_changed{true};
+        bool m_lines_drawn{false};
+        std::unique_ptr<std::vector<ks::text::Line>> m_list_drawn_lines;
+        uint m_drawn_utf16_size{0};
+        GlyphEdit m_glyph_edit;
+
+        // Virtualized text (see SetVirtualized)
+        bool m_virtualized{false};
+        bool m_upd_paragraphs{false};
+        std::vector<text_detail::Paragraph> m_list_paragraphs;
+
+        // The top of each paragraph in glyph px with an extra
+        // entry for the bottom of the last one
+        std::vector<float> m_list_paragraph_tops;
+
+        // Indices of paragraphs that have list_lines
+        std::vector<uint> m_list_shaped_paragraphs;
+
+        // Metrics from a sample of the text, in glyph px
+        float m_para_ascent{0.0f};
+        float m_para_descent{0.0f};
+        float m_para_spacing{0.0f};
+        float m_para_advance{0.0f};
+        float m_para_width{0.0f};
+
+        // The range of paragraphs [first,last) and the region
+        // (in glyph px) that the current drawables were created
+        // for, and the number of glyphs drawn
+        bool m_paras_drawn{false};
+        uint m_paras_drawn_first{0};
+        uint m_paras_drawn_last{0};
+        BoundingBox m_drawn_region{0.0f,0.0f,0.0f,0.0f};
+        uint m_drawn_glyph_count{0};
 
         bool m_keep_glyph_data;
     };
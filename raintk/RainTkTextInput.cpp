@@ -538,6 +538,14 @@ namespace raintk
 
     void TextInput::onGlyphDataChanged()
     {
+        // Only update the dims of glyphs that changed if
+        // the text was edited
+        if(!m_input_text->text.Get().empty() && patchGlyphDims())
+        {
+            onCursorPositionChanged();
+            return;
+        }
+
         m_list_glyph_dims.clear();
 
         if(m_input_text->text.Get().empty())
@@ -578,21 +586,106 @@ namespace raintk
                         };
             }
 
-            m_list_glyph_dims.push_back(m_list_glyph_dims.back());
-            auto& sentinel = m_list_glyph_dims.back();
+            addSentinelGlyphDims();
+        }
 
-            if(sentinel.rtl)
-            {
-                sentinel.x1 = sentinel.x0-cursor_width.Get();
-            }
-            else
+        // Reposition cursor
+        onCursorPositionChanged();
+    }
+
+    bool TextInput::patchGlyphDims()
+    {
+        auto const &edit = m_input_text->GetGlyphEdit();
+        auto const list_lines = m_input_text->GetGlyphData();
+
+        if(!edit.valid ||
+           m_list_glyph_dims.empty() ||
+           list_lines == nullptr ||
+           list_lines->size() != 1)
+        {
+            return false;
+        }
+
+        // The dims (without the sentinel) must correspond
+        // to the text before the edit
+        uint const old_size = m_list_glyph_dims.size()-1;
+        uint const new_size = m_input_text->GetUTF16Text().size();
+
+        if(edit.utf16_old_end > old_size ||
+           (old_size-edit.utf16_old_end) != (new_size-edit.utf16_new_end))
+        {
+            return false;
+        }
+
+        m_utf16_text = &(m_input_text->GetUTF16Text());
+        m_text_line = &(list_lines->at(0));
+
+        float const k_glyph =
+                m_input_text->size.Get()/
+                m_scene->GetTextGlyphSizePx();
+
+        m_list_glyph_dims.pop_back();
+
+        m_list_glyph_dims.erase(
+                    m_list_glyph_dims.begin()+edit.utf16_start,
+                    m_list_glyph_dims.begin()+edit.utf16_old_end);
+
+        m_list_glyph_dims.insert(
+                    m_list_glyph_dims.begin()+edit.utf16_start,
+                    edit.utf16_new_end-edit.utf16_start,
+                    GlyphDims{false,false,0,0});
+
+        // Changed glyphs
+        auto const &list_glyphs = m_text_line->list_glyphs;
+        uint const middle_end = list_glyphs.size()-edit.suffix_glyphs;
+
+        for(uint i=edit.prefix_glyphs; i < middle_end; i++)
+        {
+            auto const &glyph = list_glyphs[i];
+
+            m_list_glyph_dims[glyph.cluster] =
+                    GlyphDims{
+                        true,
+                        glyph.rtl,
+                        (glyph.x0-m_text_line->x_min)*k_glyph,
+                        (glyph.x1-m_text_line->x_min)*k_glyph
+                    };
+        }
+
+        // Glyphs after the edit
+        float const dx = edit.dx*k_glyph;
+
+        if(dx != 0.0f)
+        {
+            for(uint i=edit.utf16_new_end; i < m_list_glyph_dims.size(); i++)
             {
-                sentinel.x0 = sentinel.x1+cursor_width.Get();
+                auto& glyph_dims = m_list_glyph_dims[i];
+                if(glyph_dims.valid)
+                {
+                    glyph_dims.x0 += dx;
+                    glyph_dims.x1 += dx;
+                }
             }
         }
 
-        // Reposition cursor
-        onCursorPositionChanged();
+        addSentinelGlyphDims();
+
+        return true;
+    }
+
+    void TextInput::addSentinelGlyphDims()
+    {
+        m_list_glyph_dims.push_back(m_list_glyph_dims.back());
+        auto& sentinel = m_list_glyph_dims.back();
+
+        if(sentinel.rtl)
+        {
+            sentinel.x1 = sentinel.x0-cursor_width.Get();
+        }
+        else
+        {
+            sentinel.x0 = sentinel.x1+cursor_width.Get();
+        }
     }
 
     void TextInput::onCursorWidthChanged()
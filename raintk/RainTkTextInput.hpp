@@ -94,6 +94,8 @@ namespace raintk
         void deleteNext();
 
         void onGlyphDataChanged();
+        bool patchGlyphDims();
+        void addSentinelGlyphDims();
         void onCursorWidthChanged();
         void onCursorColorChanged();
         void onCursorPositionChanged();
@@ -0,0 +1,286 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <ks/KsException.hpp>
+#include <ks/shared/KsImage.hpp>
+#include <raintk/RainTkTextureShadow.hpp>
+
+namespace raintk
+{
+    namespace
+    {
+        // Two rects are merged if the merged rect doesn't
+        // have more than this much wasted area
+        float const k_merge_area_factor = 1.5f;
+
+        // If there are more dirty rects than this, new rects
+        // are merged into whichever rect grows the least
+        uint const k_max_dirty_rects = 16;
+
+        template<typename Rect>
+        uint CalcArea(Rect const &a)
+        {
+            return (a.x1-a.x0)*(a.y1-a.y0);
+        }
+
+        template<typename Rect>
+        Rect CalcUnion(Rect const &a, Rect const &b)
+        {
+            return Rect{
+                std::min(a.x0,b.x0),
+                std::min(a.y0,b.y0),
+                std::max(a.x1,b.x1),
+                std::max(a.y1,b.y1)
+            };
+        }
+    }
+
+    // ============================================================= //
+
+    TextureShadow::TextureShadow(uint width_px, uint height_px) :
+        m_width_px(width_px),
+        m_height_px(height_px),
+        m_data(width_px*height_px,0)
+    {}
+
+    TextureShadow::~TextureShadow()
+    {}
+
+    uint TextureShadow::GetWidthPx() const
+    {
+        return m_width_px;
+    }
+
+    uint TextureShadow::GetHeightPx() const
+    {
+        return m_height_px;
+    }
+
+    bool TextureShadow::GetIsDirty() const
+    {
+        return !m_list_dirty_rects.empty();
+    }
+
+    uint TextureShadow::GetDirtyRectCount() const
+    {
+        return m_list_dirty_rects.size();
+    }
+
+    u8 const * TextureShadow::GetData() const
+    {
+        return m_data.data();
+    }
+
+    void TextureShadow::Load(u8 const * data)
+    {
+        std::memcpy(m_data.data(),data,m_data.size());
+        m_list_dirty_rects.clear();
+    }
+
+    bool TextureShadow::GetMatches(glm::u16vec2 offset,
+                                   ks::ImageData const &image_data) const
+    {
+        uint const x1 = offset.x+image_data.width;
+        uint const y1 = offset.y+image_data.height;
+
+        if(x1 > m_width_px || y1 > m_height_px)
+        {
+            return false;
+        }
+
+        u8 const * src = static_cast<u8 const *>(image_data.data_ptr);
+        uint const row_bytes = image_data.width;
+
+        for(uint y=offset.y; y < y1; y++)
+        {
+            if(std::memcmp(&(m_data[y*m_width_px + offset.x]),
+                           src,
+                           row_bytes) != 0)
+            {
+                return false;
+            }
+
+            src += row_bytes;
+        }
+
+        return true;
+    }
+
+    void TextureShadow::Write(glm::u16vec2 offset,
+                              ks::ImageData const &image_data)
+    {
+        Rect const rect{
+            offset.x,
+            offset.y,
+            offset.x+image_data.width,
+            offset.y+image_data.height
+        };
+
+        if(rect.x1 > m_width_px || rect.y1 > m_height_px)
+        {
+            throw ks::Exception(
+                        ks::Exception::ErrorLevel::ERROR,
+                        "TextureShadow: Write out of bounds: (" +
+                        ks::ToString(rect.x1) + "," +
+                        ks::ToString(rect.y1) + ")");
+        }
+
+        if(rect.x0 == rect.x1 || rect.y0 == rect.y1)
+        {
+            return;
+        }
+
+        u8 const * src = static_cast<u8 const *>(image_data.data_ptr);
+        uint const row_bytes = image_data.width;
+
+        for(uint y=rect.y0; y < rect.y1; y++)
+        {
+            std::memcpy(&(m_data[y*m_width_px + rect.x0]),
+                        src,
+                        row_bytes);
+
+            src += row_bytes;
+        }
+
+        addDirtyRect(rect);
+    }
+
+    std::vector<ks::gl::Texture2D::Update>
+    TextureShadow::Flush(uint max_bytes, uint& bytes)
+    {
+        std::vector<ks::gl::Texture2D::Update> list_updates;
+
+        uint remaining_bytes = max_bytes;
+        uint flushed_rects = 0;
+
+        for(auto& rect : m_list_dirty_rects)
+        {
+            uint const width = rect.x1-rect.x0;
+            uint const rect_bytes = CalcArea(rect);
+
+            // Upload as many whole rows as fit in the budget,
+            // but at least one row for the first update
+            uint rows = rect.y1-rect.y0;
+            if(rect_bytes > remaining_bytes)
+            {
+                rows = remaining_bytes/width;
+                if(rows == 0)
+                {
+                    if(!list_updates.empty())
+                    {
+                        break;
+                    }
+                    rows = 1;
+                }
+            }
+
+            ks::Image<ks::R8> image(width,rows,ks::R8{0});
+            u8* dst = reinterpret_cast<u8*>(image.GetData().data());
+
+            for(uint y=rect.y0; y < rect.y0+rows; y++)
+            {
+                std::memcpy(dst,
+                            &(m_data[y*m_width_px + rect.x0]),
+                            width);
+
+                dst += width;
+            }
+
+            list_updates.push_back(
+                        ks::gl::Texture2D::Update{
+                            ks::gl::Texture2D::Update::Defaults,
+                            glm::u16vec2(rect.x0,rect.y0),
+                            shared_ptr<ks::ImageData>(
+                                image.ConvertToImageDataPtr().release())
+                        });
+
+            uint const update_bytes = width*rows;
+            bytes += update_bytes;
+            remaining_bytes -= std::min(remaining_bytes,update_bytes);
+
+            rect.y0 += rows;
+            if(rect.y0 < rect.y1)
+            {
+                // Partially uploaded
+                break;
+            }
+
+            flushed_rects++;
+        }
+
+        m_list_dirty_rects.erase(
+                    m_list_dirty_rects.begin(),
+                    m_list_dirty_rects.begin()+flushed_rects);
+
+        return list_updates;
+    }
+
+    void TextureShadow::addDirtyRect(Rect rect)
+    {
+        // Keep merging until the rect doesn't overlap or
+        // sit close to any of the existing rects
+        bool merged = true;
+        while(merged)
+        {
+            merged = false;
+
+            for(auto it = m_list_dirty_rects.begin();
+                it != m_list_dirty_rects.end(); ++it)
+            {
+                Rect const merged_rect = CalcUnion(rect,*it);
+
+                float const max_area =
+                        (CalcArea(rect)+CalcArea(*it))*k_merge_area_factor;
+
+                if(CalcArea(merged_rect) <= max_area)
+                {
+                    rect = merged_rect;
+                    m_list_dirty_rects.erase(it);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+
+        if(m_list_dirty_rects.size() < k_max_dirty_rects)
+        {
+            m_list_dirty_rects.push_back(rect);
+            return;
+        }
+
+        // Merge with the rect that grows the least
+        auto min_it = m_list_dirty_rects.begin();
+        uint min_growth = std::numeric_limits<uint>::max();
+
+        for(auto it = m_list_dirty_rects.begin();
+            it != m_list_dirty_rects.end(); ++it)
+        {
+            uint const growth =
+                    CalcArea(CalcUnion(rect,*it))-CalcArea(*it);
+
+            if(growth < min_growth)
+            {
+                min_growth = growth;
+                min_it = it;
+            }
+        }
+
+        *min_it = CalcUnion(rect,*min_it);
+    }
+}
@@ -0,0 +1,102 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef RAINTK_TEXTURE_SHADOW_HPP
+#define RAINTK_TEXTURE_SHADOW_HPP
+
+#include <vector>
+#include <ks/gl/KsGLTexture2D.hpp>
+#include <raintk/RainTkGlobal.hpp>
+
+namespace ks
+{
+    struct ImageData;
+}
+
+namespace raintk
+{
+    // TextureShadow
+    // * A CPU side copy of a single channel (one byte per
+    //   pixel) texture, such as a text atlas
+    // * Writes are copied into the shadow and the regions
+    //   they cover are tracked as dirty rectangles. Nearby
+    //   rectangles are merged so that many small writes are
+    //   uploaded as a few larger texture updates.
+    // * Flush creates the texture updates for the dirty
+    //   rectangles, limited to a number of bytes per call.
+    //   Anything over the limit stays dirty until the next
+    //   Flush.
+    class TextureShadow final
+    {
+    public:
+        TextureShadow(uint width_px, uint height_px);
+        ~TextureShadow();
+
+        uint GetWidthPx() const;
+        uint GetHeightPx() const;
+        bool GetIsDirty() const;
+        uint GetDirtyRectCount() const;
+
+        // Returns the width*height bytes of the shadow
+        u8 const * GetData() const;
+
+        // Replaces the whole shadow with the width*height bytes
+        // at @data without marking anything dirty. For contents
+        // that were already uploaded, ie. as the initial image.
+        void Load(u8 const * data);
+
+        // Returns true if the region at @offset already holds
+        // @image_data, so writing it wouldn't change anything
+        bool GetMatches(glm::u16vec2 offset,
+                        ks::ImageData const &image_data) const;
+
+        // Copies @image_data, which must have one byte per
+        // pixel, to @offset. Throws if the image doesn't fit
+        // within the shadow.
+        void Write(glm::u16vec2 offset,
+                   ks::ImageData const &image_data);
+
+        // * Returns texture updates for the dirty rectangles
+        //   that fit within @max_bytes
+        // * A rectangle that is larger than what remains of
+        //   @max_bytes is split into bands of rows. At least
+        //   one row is always returned so that the shadow
+        //   can't stay dirty forever
+        // * Adds the number of bytes in the returned updates
+        //   to @bytes
+        std::vector<ks::gl::Texture2D::Update>
+        Flush(uint max_bytes, uint& bytes);
+
+    private:
+        // (x0,y0) is inclusive, (x1,y1) is exclusive
+        struct Rect
+        {
+            uint x0;
+            uint y0;
+            uint x1;
+            uint y1;
+        };
+
+        void addDirtyRect(Rect rect);
+
+        uint const m_width_px;
+        uint const m_height_px;
+        std::vector<u8> m_data;
+        std::vector<Rect> m_list_dirty_rects;
+    };
+}
+
+#endif // RAINTK_TEXTURE_SHADOW_HPP
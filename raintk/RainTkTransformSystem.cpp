@@ -20,6 +20,7 @@
 #include <raintk/RainTkWidget.hpp>
 #include <raintk/RainTkLog.hpp>
 #include <raintk/RainTkAnimation.hpp>
+#include <raintk/RainTkAnchorLayout.hpp>
 
 #include <glm/gtx/transform.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -47,6 +48,8 @@ namespace raintk
         m_cmlist_xf_data =
                 static_cast<TransformDataComponentList*>(
                     m_scene->template GetComponentList<TransformData>());
+
+        m_anchor_layout = make_unique<AnchorLayout>();
     }
 
     TransformSystem::~TransformSystem()
@@ -65,6 +68,16 @@ namespace raintk
         return m_cmlist_xf_data;
     }
 
+    AnchorLayout* TransformSystem::GetAnchorLayout() const
+    {
+        return m_anchor_layout.get();
+    }
+
+    void TransformSystem::AddOpacityUpdate(Id entity_id)
+    {
+        m_list_opacity_updates.push_back(entity_id);
+    }
+
     void TransformSystem::Update(TimePoint const &/*prev_time*/,
                                  TimePoint const &/*curr_time*/)
     {
@@ -106,6 +119,15 @@ namespace raintk
                 }
             }
 
+            // Anchors are resolved after widget updates since
+            // those can change the size of anchored widgets.
+            // Moving widgets can in turn trigger more updates
+            if(m_anchor_layout->GetDirty())
+            {
+                m_anchor_layout->Resolve();
+                updated_widgets = true;
+            }
+
             if(!updated_widgets)
             {
                 break;
@@ -128,16 +150,70 @@ namespace raintk
         updateWidgetTransforms(
                     m_scene->GetRootWidget().get(),
                     m_cmlist_upd_data,
-                    m_cmlist_xf_data);
+                    m_cmlist_xf_data,
+                    m_scene->GetFrameArena());
 
         updateWidgetClips(
                     m_scene->GetRootWidget().get(),
                     m_cmlist_upd_data,
-                    m_cmlist_xf_data);
+                    m_cmlist_xf_data,
+                    m_scene->GetFrameArena());
 
-        updateWidgetOpacities(
-                    m_scene->GetRootWidget().get(),
-                    1.0f);
+        updateOpacities();
+    }
+
+    void TransformSystem::updateOpacities()
+    {
+        // Only the subtrees of widgets whose opacity changed
+        // (or that were just created) are visited. A descendant
+        // may be visited before its ancestor; the ancestor's
+        // update then visits it again with the new accumulated
+        // opacity.
+        auto const &list_entities = m_scene->GetEntityList();
+
+        auto const updatable_mask =
+                m_scene->template GetComponentMask<
+                    UpdateData>();
+
+        auto& list_upd_data = m_cmlist_upd_data->GetSparseList();
+
+        // Widgets are only added to the list when the flag is
+        // first set, so swap it out in case this adds any more
+        std::vector<Id> list_opacity_updates;
+        std::swap(list_opacity_updates,m_list_opacity_updates);
+
+        for(Id ent_id : list_opacity_updates)
+        {
+            // The entity may have been removed since
+            if(ent_id >= list_entities.size() ||
+               (list_entities[ent_id].mask & updatable_mask) != updatable_mask)
+            {
+                continue;
+            }
+
+            auto& upd_data = list_upd_data[ent_id];
+
+            if(upd_data.update & UpdateData::UpdateOpacity)
+            {
+                Widget* widget = upd_data.widget;
+                auto parent = widget->GetParent();
+
+                float const parent_opacity =
+                        (parent) ? parent->m_accumulated_opacity : 1.0f;
+
+                updateWidgetOpacities(
+                            widget,
+                            parent_opacity,
+                            m_cmlist_upd_data);
+            }
+        }
+
+        // Keep the capacity around for the next update
+        list_opacity_updates.clear();
+        if(m_list_opacity_updates.empty())
+        {
+            std::swap(list_opacity_updates,m_list_opacity_updates);
+        }
     }
 
     void TransformSystem::updateAnimations()
@@ -160,13 +236,18 @@ namespace raintk
         // after TransformSystem) will only update Animations
         // that have m_ready set to true
 
+        // Only running animations are visited; delayed ones
+        // have m_ready reset when they're woken up
         auto const &list_animations =
                 m_scene->GetAnimationSystem()->
-                GetListAnimations();
+                GetListActiveAnimations();
 
         for(Animation* animation : list_animations)
         {
-            animation->m_ready = true;
+            if(animation)
+            {
+                animation->m_ready = true;
+            }
         }
     }
 
@@ -237,6 +318,10 @@ namespace raintk
         // expect both to be CCW order
         std::vector<glm::vec2> g_poly_temp;
 
+        // Copy of the root's polygon used as the base of the
+        // clip stack, kept to reuse its memory between frames
+        std::vector<glm::vec2> g_clip_stack_base;
+
         // * Calculate the result of clipping @poly_subj against @poly_clip
         // * Expects CCW polygons
         // * No special consideration given to numerical robustness
@@ -443,18 +528,19 @@ namespace raintk
     void TransformSystem::updateWidgetClips(
             Widget* root,
             UpdateDataComponentList* cmlist_upd_data,
-            TransformDataComponentList* cmlist_xf_data)
+            TransformDataComponentList* cmlist_xf_data,
+            FrameArena* frame_arena)
     {
 
         // Create the depth first traversal stack
-        std::vector<UpdClipStackFrame> dfs_stack;
+        FrameVector<UpdClipStackFrame> dfs_stack(frame_arena);
         dfs_stack.push_back(
                     UpdClipStackFrame{
                         root,0
                     });
 
         // Create the clip stack
-        std::vector<std::vector<glm::vec2>*> clip_stack;
+        FrameVector<std::vector<glm::vec2>*> clip_stack(frame_arena);
 
         // The root's poly_vx has already been filled
         // by updateTransforms()
@@ -463,7 +549,8 @@ namespace raintk
                 cmlist_xf_data->GetComponent(
                     root->GetEntityId());
 
-        auto clip_stack_base = root_xf_data.poly_vx;
+        auto& clip_stack_base = g_clip_stack_base;
+        clip_stack_base = root_xf_data.poly_vx;
         clip_stack.push_back(&clip_stack_base);
 
 
@@ -537,7 +624,8 @@ namespace raintk
     void TransformSystem::updateWidgetTransforms(
             Widget* root,
             UpdateDataComponentList* cmlist_upd_data,
-            TransformDataComponentList* cmlist_xf_data)
+            TransformDataComponentList* cmlist_xf_data,
+            FrameArena* frame_arena)
     {
         // Fill out the correct TransformData for the root
         auto& root_xf_data =
@@ -547,7 +635,7 @@ namespace raintk
         SetRootTransformData(root,root_xf_data);
 
         // Create the depth first traversal stack
-        std::vector<UpdXFStackFrame> dfs_stack;
+        FrameVector<UpdXFStackFrame> dfs_stack(frame_arena);
         dfs_stack.push_back(
                     UpdXFStackFrame{
                         root,0,&(root_xf_data.world_xf)
@@ -645,18 +733,34 @@ namespace raintk
     // * The final accumulated opacity of a widget is the
     //   product of its own opacity with the opacity of all
     //   the widget's ancestors
-    void TransformSystem::updateWidgetOpacities(Widget* widget,float opacity)
+    void TransformSystem::updateWidgetOpacities(
+            Widget* widget,
+            float opacity,
+            UpdateDataComponentList* cmlist_upd_data)
     {
+        auto& upd_data =
+                cmlist_upd_data->GetComponent(
+                    widget->GetEntityId());
+
+        upd_data.update &= ~(UpdateData::UpdateOpacity);
+
+        // If the accumulated opacity didn't change, it
+        // didn't change for any descendants either
         opacity *= widget->opacity.Get();
-        if(widget->m_accumulated_opacity != opacity)
+        if(widget->m_accumulated_opacity == opacity)
         {
-            widget->m_accumulated_opacity = opacity;
-            widget->onAccOpacityUpdated();
+            return;
         }
 
+        widget->m_accumulated_opacity = opacity;
+        widget->onAccOpacityUpdated();
+
         for(auto& child : widget->GetChildren())
         {
-            updateWidgetOpacities(child.get(),opacity);
+            updateWidgetOpacities(
+                        child.get(),
+                        opacity,
+                        cmlist_upd_data);
         }
     }
 }
@@ -20,11 +20,13 @@
 #include <ks/draw/KsDrawSystem.hpp>
 #include <raintk/RainTkGlobal.hpp>
 #include <raintk/RainTkComponents.hpp>
+#include <raintk/RainTkFrameArena.hpp>
 
 namespace raintk
 {
     class Scene;
     class DrawableWidget;
+    class AnchorLayout;
 
     class TransformSystem : public ks::draw::System
     {
@@ -38,31 +40,47 @@ namespace raintk
         TransformDataComponentList*
         GetTransformDataComponentList() const;
 
+        AnchorLayout* GetAnchorLayout() const;
+
         void Update(TimePoint const &prev_time,
                     TimePoint const &curr_time) override;
 
+        // Queues an update of the accumulated opacity of the
+        // widget with @entity_id and its descendants. Called
+        // when UpdateData::UpdateOpacity is set on a widget.
+        void AddOpacityUpdate(Id entity_id);
+
     private:
         void updateLayout();
         void updateTransforms();
+        void updateOpacities();
         void updateAnimations();
 
         static void updateWidgetTransforms(
                 Widget* widget,
                 UpdateDataComponentList* cmlist_upd_data,
-                TransformDataComponentList* cmlist_xf_data);
+                TransformDataComponentList* cmlist_xf_data,
+                FrameArena* frame_arena);
 
         static void updateWidgetClips(
                 Widget* widget,
                 UpdateDataComponentList* cmlist_upd_data,
-                TransformDataComponentList* cmlist_xf_data);
+                TransformDataComponentList* cmlist_xf_data,
+                FrameArena* frame_arena);
 
         static void updateWidgetOpacities(
                 Widget* widget,
-                float opacity);
+                float opacity,
+                UpdateDataComponentList* cmlist_upd_data);
 
         Scene* const m_scene;
         UpdateDataComponentList* m_cmlist_upd_data;
         TransformDataComponentList* m_cmlist_xf_data;
+        unique_ptr<AnchorLayout> m_anchor_layout;
+
+        // Entities that had UpdateOpacity set since the last
+        // update. May contain entities that were removed since.
+        std::vector<Id> m_list_opacity_updates;
     };
 }
 
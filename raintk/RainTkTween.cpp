@@ -17,6 +17,7 @@
 #include <raintk/RainTkTween.hpp>
 #include <raintk/RainTkLog.hpp>
 #include <cmath>
+#include <cstring>
 
 namespace raintk
 {
@@ -112,5 +113,183 @@ namespace raintk
         {
             return (k*delta)+initial;
         }
+
+
+        // Batch evaluation
+
+        namespace
+        {
+            // Curves as types so they're inlined into the batch
+            // loops instead of being called through a pointer
+            struct LinearCurve {
+                static float Eval(float t) { return t; }
+            };
+
+            struct QuadCurve {
+                static float Eval(float t) { return t*t; }
+            };
+
+            struct CubicCurve {
+                static float Eval(float t) { return t*t*t; }
+            };
+
+            struct QuarticCurve {
+                static float Eval(float t) { return t*t*t*t; }
+            };
+
+            struct QuinticCurve {
+                static float Eval(float t) { return t*t*t*t*t; }
+            };
+
+            // The Sine, Circle and Expo curves use approximations
+            // made of arithmetic only (no calls to cos, sqrt or
+            // exp2) so the batch loops can be vectorized. They're
+            // accurate to about 1e-6 over [0,1].
+
+            float AsFloat(u32 bits)
+            {
+                float f;
+                std::memcpy(&f,&bits,sizeof(f));
+                return f;
+            }
+
+            u32 AsBits(float f)
+            {
+                u32 bits;
+                std::memcpy(&bits,&f,sizeof(bits));
+                return bits;
+            }
+
+            struct SineCurve {
+                static float Eval(float t) {
+                    // Taylor series of cos(y) up to y^10; the first
+                    // omitted term is under 5e-7 for y <= pi/2
+                    float const y = t*float(k_pi_div2);
+                    float const y2 = y*y;
+                    float const cos_y =
+                            1.0f+y2*(-1.0f/2.0f+
+                                 y2*(1.0f/24.0f+
+                                 y2*(-1.0f/720.0f+
+                                 y2*(1.0f/40320.0f+
+                                 y2*(-1.0f/3628800.0f)))));
+
+                    return 1.0f-cos_y;
+                }
+            };
+
+            struct CircleCurve {
+                static float Eval(float t) {
+                    // sqrt(a) as a*rsqrt(a), with rsqrt(a) from the
+                    // usual bit level estimate refined by three
+                    // Newton steps (a == 0 stays finite and gives 0).
+                    // fabs instead of a clamp keeps the loop branch
+                    // free; 1-t^2 is only negative for t outside [0,1]
+                    float const a = std::fabs(1.0f-(t*t));
+                    float r = AsFloat(0x5f3759df-(AsBits(a) >> 1));
+                    r = r*(1.5f-0.5f*a*r*r);
+                    r = r*(1.5f-0.5f*a*r*r);
+                    r = r*(1.5f-0.5f*a*r*r);
+
+                    return 1.0f-(a*r);
+                }
+            };
+
+            struct ExpoCurve {
+                static float Eval(float t) {
+                    // 2^x = 2^n * 2^f with an integer n and
+                    // f in [-0.5,0.5]. 2^f = e^(f*ln2) uses a
+                    // Taylor series up to the 6th power and 2^n
+                    // is built directly from the exponent bits.
+                    float const x = 10.0f*(t-1.0f);
+
+                    float const x_round = x+0.5f;
+                    s32 n = static_cast<s32>(x_round);
+                    n -= (static_cast<float>(n) > x_round) ? 1 : 0;
+
+                    float const y = (x-static_cast<float>(n))*0.69314718f;
+                    float const exp_y =
+                            1.0f+y*(1.0f+
+                                 y*(1.0f/2.0f+
+                                 y*(1.0f/6.0f+
+                                 y*(1.0f/24.0f+
+                                 y*(1.0f/120.0f+
+                                 y*(1.0f/720.0f))))));
+
+                    return exp_y*AsFloat(static_cast<u32>(n+127) << 23);
+                }
+            };
+
+            template<typename CurveType>
+            void evalBatchCurve(Easing easing,
+                                float const * list_t,
+                                float * list_k,
+                                std::size_t count)
+            {
+                if(easing == Easing::In)
+                {
+                    for(std::size_t i=0; i < count; i++)
+                    {
+                        list_k[i] = CurveType::Eval(list_t[i]);
+                    }
+                }
+                else if(easing == Easing::Out)
+                {
+                    for(std::size_t i=0; i < count; i++)
+                    {
+                        list_k[i] = 1.0f-CurveType::Eval(1.0f-list_t[i]);
+                    }
+                }
+                else
+                {
+                    // Same piece wise function as EaseInOut, written
+                    // without branches: u is 2t for the first half
+                    // and 2-2t for the second, and the second half
+                    // is mirrored about 0.5
+                    for(std::size_t i=0; i < count; i++)
+                    {
+                        float const t = list_t[i];
+                        float const u = 1.0f-std::fabs((t*2.0f)-1.0f);
+                        float const v = 0.5f*CurveType::Eval(u);
+                        float const sign = (t < 0.5f) ? 1.0f : -1.0f;
+                        list_k[i] = 0.5f+sign*(v-0.5f);
+                    }
+                }
+            }
+        }
+
+        void EvalBatch(Curve curve,
+                       Easing easing,
+                       float const * list_t,
+                       float * list_k,
+                       std::size_t count)
+        {
+            switch(curve)
+            {
+                case Curve::Linear:
+                    evalBatchCurve<LinearCurve>(easing,list_t,list_k,count);
+                    break;
+                case Curve::Quad:
+                    evalBatchCurve<QuadCurve>(easing,list_t,list_k,count);
+                    break;
+                case Curve::Cubic:
+                    evalBatchCurve<CubicCurve>(easing,list_t,list_k,count);
+                    break;
+                case Curve::Quartic:
+                    evalBatchCurve<QuarticCurve>(easing,list_t,list_k,count);
+                    break;
+                case Curve::Quintic:
+                    evalBatchCurve<QuinticCurve>(easing,list_t,list_k,count);
+                    break;
+                case Curve::Sine:
+                    evalBatchCurve<SineCurve>(easing,list_t,list_k,count);
+                    break;
+                case Curve::Circle:
+                    evalBatchCurve<CircleCurve>(easing,list_t,list_k,count);
+                    break;
+                case Curve::Expo:
+                    evalBatchCurve<ExpoCurve>(easing,list_t,list_k,count);
+                    break;
+            }
+        }
     }
 }
@@ -66,6 +66,48 @@ namespace raintk
 
         // delta: The difference: (final value - intial value)
         float EvalDelta(float k, float initial, float delta);
+
+
+        // Batch evaluation
+
+        enum class Curve : u8
+        {
+            Linear = 0,
+            Quad,
+            Cubic,
+            Quartic,
+            Quintic,
+            Sine,
+            Circle,
+            Expo
+        };
+
+        enum class Easing : u8
+        {
+            In = 0,
+            Out,
+            InOut
+        };
+
+        uint const CurveCount = 8;
+        uint const EasingCount = 3;
+
+        // Evaluates @curve with @easing for @count interpolation
+        // factors in @list_t and writes the results to @list_k
+        // * Matches calling Ease[In|Out|InOut] with the matching
+        //   curve function on each value to within about 1e-6 for
+        //   @list_t in [0,1]
+        // * The curve and easing are only resolved once per batch
+        //   and the inner loops are branch free and don't call any
+        //   math library functions (Sine, Circle and Expo use
+        //   polynomial approximations), so the compiler can
+        //   vectorize them
+        // * @list_t and @list_k may point to the same array
+        void EvalBatch(Curve curve,
+                       Easing easing,
+                       float const * list_t,
+                       float * list_k,
+                       std::size_t count);
     }
 
 
@@ -17,7 +17,9 @@
 #include <raintk/RainTkWidget.hpp>
 #include <raintk/RainTkScene.hpp>
 #include <raintk/RainTkTransformSystem.hpp>
+#include <raintk/RainTkAnchorLayout.hpp>
 #include <raintk/RainTkInputSystem.hpp>
+#include <raintk/RainTkDrawSystem.hpp>
 
 #include <raintk/thirdparty/pnpoly.hpp>
 
@@ -33,6 +35,19 @@ namespace raintk
 
     // ============================================================= //
 
+    namespace
+    {
+        // Adapts a Widget change handler to the plain function
+        // pointer expected by Property::SetOwnerNotifier
+        template<void (Widget::*Handler)()>
+        void callOwnerHandler(void* widget)
+        {
+            (static_cast<Widget*>(widget)->*Handler)();
+        }
+    }
+
+    // ============================================================= //
+
     Widget::Widget(ks::Object::Key const &key,
                    Scene* scene,
                    shared_ptr<Widget> parent) :
@@ -46,6 +61,8 @@ namespace raintk
             static_cast<TransformDataComponentList*>(
                 m_scene->template GetComponentList<TransformData>())),
         m_clip_id(0),
+        m_layer_id(0),
+        m_layer_root_id(0),
         m_accumulated_opacity(1.0f)
     {}
 
@@ -103,80 +120,68 @@ namespace raintk
         // the initial bounding box
         update_data.update |= UpdateData::UpdateTransform;
 
+        // Queue an update to inherit the parent's opacity
+        update_data.update |= UpdateData::UpdateOpacity;
+        m_scene->GetTransformSystem()->AddOpacityUpdate(m_entity_id);
+
 
         // Connect Properties
-        m_cid_width =
-                width.signal_changed.Connect(
-                    this_widget,
-                    &Widget::onWidthChanged,
-                    ks::ConnectionType::Direct);
-
-        m_cid_height =
-                height.signal_changed.Connect(
-                    this_widget,
-                    &Widget::onHeightChanged,
-                    ks::ConnectionType::Direct);
-
-        m_cid_x =
-                x.signal_changed.Connect(
-                    this_widget,
-                    &Widget::onXChanged,
-                    ks::ConnectionType::Direct);
-
-        m_cid_y =
-                y.signal_changed.Connect(
-                    this_widget,
-                    &Widget::onYChanged,
-                    ks::ConnectionType::Direct);
-
-        m_cid_z =
-                z.signal_changed.Connect(
-                    this_widget,
-                    &Widget::onZChanged,
-                    ks::ConnectionType::Direct);
-
-        m_cid_rotation =
-                rotation.signal_changed.Connect(
-                    this_widget,
-                    &Widget::onRotationChanged,
-                    ks::ConnectionType::Direct);
-
-        m_cid_scale =
-                scale.signal_changed.Connect(
-                    this_widget,
-                    &Widget::onScaleChanged,
-                    ks::ConnectionType::Direct);
-
-        m_cid_origin =
-                origin.signal_changed.Connect(
-                    this_widget,
-                    &Widget::onOriginChanged,
-                    ks::ConnectionType::Direct);
-
-        m_cid_clip =
-                clip.signal_changed.Connect(
-                    this_widget,
-                    &Widget::onClipChanged,
-                    ks::ConnectionType::Direct);
-
-//        m_cid_opacity =
-//                opacity.signal_changed.Connect(
-//                    this_widget,
-//                    &Widget::onOpacityChanged,
-//                    ks::ConnectionType::Direct);
-
-        m_cid_input_focus =
-                input_focus.signal_changed.Connect(
-                    this_widget,
-                    &Widget::onInputFocusChanged,
-                    ks::ConnectionType::Direct);
+        // * The Widget's own handlers are called directly by each
+        //   Property instead of through signal_changed so that
+        //   no Signal or connection is allocated for them
+        width.SetOwnerNotifier(
+                    this,&callOwnerHandler<&Widget::onWidthChanged>);
+
+        height.SetOwnerNotifier(
+                    this,&callOwnerHandler<&Widget::onHeightChanged>);
+
+        x.SetOwnerNotifier(
+                    this,&callOwnerHandler<&Widget::onXChanged>);
+
+        y.SetOwnerNotifier(
+                    this,&callOwnerHandler<&Widget::onYChanged>);
+
+        z.SetOwnerNotifier(
+                    this,&callOwnerHandler<&Widget::onZChanged>);
+
+        rotation.SetOwnerNotifier(
+                    this,&callOwnerHandler<&Widget::onRotationChanged>);
+
+        scale.SetOwnerNotifier(
+                    this,&callOwnerHandler<&Widget::onScaleChanged>);
+
+        origin.SetOwnerNotifier(
+                    this,&callOwnerHandler<&Widget::onOriginChanged>);
+
+        clip.SetOwnerNotifier(
+                    this,&callOwnerHandler<&Widget::onClipChanged>);
+
+        opacity.SetOwnerNotifier(
+                    this,&callOwnerHandler<&Widget::onOpacityChanged>);
+
+        input_focus.SetOwnerNotifier(
+                    this,&callOwnerHandler<&Widget::onInputFocusChanged>);
+
+        layer.SetOwnerNotifier(
+                    this,&callOwnerHandler<&Widget::onLayerChanged>);
     }
 
     Widget::~Widget()
     {
         signal_destroying_widget.Emit(this);
 
+        if(m_layer_root_id != 0)
+        {
+            m_scene->GetDrawSystem()->RemoveLayer(m_layer_root_id);
+        }
+
+        if(m_anchored)
+        {
+            m_scene->GetTransformSystem()->GetAnchorLayout()->Remove(this);
+        }
+
         m_scene->RemoveEntity(m_entity_id);
+        m_scene->RequestUpdate();
     }
 
     Scene* Widget::GetScene() const
@@ -204,6 +209,11 @@ namespace raintk
         return m_clip_id;
     }
 
+    Id Widget::GetLayerId() const
+    {
+        return m_layer_id;
+    }
+
     bool Widget::GetIsDrawable() const
     {
         return false;
@@ -215,6 +225,15 @@ namespace raintk
         this->onClipIdUpdated();
     }
 
+    void Widget::SetLayerId(Id layer_id)
+    {
+        if(m_layer_id != layer_id)
+        {
+            m_layer_id = layer_id;
+            this->onLayerIdUpdated();
+        }
+    }
+
     void Widget::AddChild(shared_ptr<Widget> const &child)
     {
         if(!(m_list_children.insert(child).second))
@@ -231,6 +250,8 @@ namespace raintk
                     shared_from_this());
 
         child->m_parent = this_widget;
+        m_scene->GetDrawSystem()->OnWidgetParentChanged();
+        m_scene->RequestUpdate();
     }
 
     void Widget::RemoveChild(shared_ptr<Widget> const &child)
@@ -245,6 +266,8 @@ namespace raintk
         }
 
         child->m_parent.reset();
+        m_scene->GetDrawSystem()->OnWidgetParentChanged();
+        m_scene->RequestUpdate();
     }
 
     namespace
@@ -438,6 +461,16 @@ namespace raintk
         upd_data.update |= UpdateData::UpdateClip;
     }
 
+    void Widget::onOpacityChanged()
+    {
+        auto& upd_data = m_cmlist_update_data->GetComponent(m_entity_id);
+        if(!(upd_data.update & UpdateData::UpdateOpacity))
+        {
+            upd_data.update |= UpdateData::UpdateOpacity;
+            m_scene->GetTransformSystem()->AddOpacityUpdate(m_entity_id);
+        }
+    }
+
     void Widget::onInputFocusChanged()
     {
         shared_ptr<Widget> this_widget =
@@ -459,11 +492,21 @@ namespace raintk
         }
     }
 
+    void Widget::onLayerChanged()
+    {
+        m_scene->GetDrawSystem()->SetLayerCached(this,layer.Get());
+    }
+
     void Widget::onClipIdUpdated()
     {
         // Do nothing for base widget
     }
 
+    void Widget::onLayerIdUpdated()
+    {
+        // Do nothing for base widget
+    }
+
     void Widget::onTransformUpdated()
     {
         // Do nothing for base widget
@@ -63,6 +63,8 @@ namespace raintk
 
         friend class TransformSystem;
         friend class InputListener;
+        friend class DrawSystem;
+        friend class AnchorLayout;
 
         // Only the Scene should be able to create a root widget
         class RootWidgetKey {
@@ -91,10 +93,12 @@ namespace raintk
         ListChildren const &GetChildren() const;
         Id GetEntityId() const;       
         Id GetClipId() const;
+        Id GetLayerId() const;
 
         virtual bool GetIsDrawable() const;
 
         void SetClipId(Id clip_id);
+        void SetLayerId(Id layer_id);
         virtual void AddChild(shared_ptr<Widget> const &child);
         virtual void RemoveChild(shared_ptr<Widget> const &child);
 
@@ -176,6 +180,13 @@ namespace raintk
             false
         };
 
+        // Draws this widget and its descendants into a texture
+        // that is only redrawn when something in it changes
+        // (see DrawSystem::SetLayerCached)
+        Property<bool> layer{
+            false
+        };
+
         // signal that is emitted from within the
         // destructor of this Widget
         ks::Signal<Widget*> signal_destroying_widget;
@@ -190,9 +201,12 @@ namespace raintk
         virtual void onScaleChanged();
         virtual void onOriginChanged();
         virtual void onClipChanged();
+        virtual void onOpacityChanged();
         virtual void onInputFocusChanged();
+        virtual void onLayerChanged();
 
         virtual void onClipIdUpdated();
+        virtual void onLayerIdUpdated();
         virtual void onTransformUpdated();
         virtual void onAccOpacityUpdated();
 
@@ -209,24 +223,24 @@ namespace raintk
         UpdateDataComponentList* const m_cmlist_update_data;
         TransformDataComponentList* const m_cmlist_xf_data;
 
-        Id m_cid_width;
-        Id m_cid_height;
-        Id m_cid_x;
-        Id m_cid_y;
-        Id m_cid_z;
-        Id m_cid_rotation;
-        Id m_cid_scale;
-        Id m_cid_origin;
-        Id m_cid_clip;
-        Id m_cid_opacity;
-        Id m_cid_input_focus;
-
         Id m_clip_id;
 
+        // The compositor layer this widget is drawn in
+        Id m_layer_id;
+
+        // Set if this widget is the root of a compositor
+        // layer (see DrawSystem::CreateLayer)
+        Id m_layer_root_id;
+
 #ifdef RAINTK_TEST_OPACITY_HIERARCHY
     public:
 #endif
         float m_accumulated_opacity;
+
+    private:
+        // Set if this widget has been used with the
+        // AnchorLayout so its constraints can be removed
+        bool m_anchored{false};
     };
 
     // ============================================================= //
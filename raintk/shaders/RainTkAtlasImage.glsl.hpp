@@ -36,11 +36,12 @@ std::string const raintk_atlas_image_frag_glsl = R"___DELIM___(
 
 varying lowp vec3 v_v3_tex0_opacity;
 uniform lowp sampler2D u_s_tex0;
+uniform lowp float u_f_layer_opacity;
 
 void main()
 {
     vec4 color = texture2D(u_s_tex0,v_v3_tex0_opacity.xy)*v_v3_tex0_opacity.z;
-    gl_FragColor = color;
+    gl_FragColor = color*u_f_layer_opacity;
 }
 
 )___DELIM___";
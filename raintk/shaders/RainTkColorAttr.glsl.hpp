@@ -35,10 +35,11 @@ std::string const color_attr_frag_glsl = R"___DELIM___(
 #endif
 
 varying lowp vec4 v_v4_color;
+uniform lowp float u_f_layer_opacity;
 
 void main(void)
 {
-    gl_FragColor = v_v4_color;
+    gl_FragColor = v_v4_color*u_f_layer_opacity;
 }
 
 )___DELIM___";
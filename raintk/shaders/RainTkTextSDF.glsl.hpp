@@ -77,6 +77,7 @@ varying lowp vec4 v_v4_color;
 
 // uniforms
 uniform highp sampler2D u_s_tex0;
+uniform lowp float u_f_layer_opacity;
 
 // dist
 // The distance field value for this fragment:
@@ -138,7 +139,7 @@ void main()
     // Weighted average
     alpha = (alpha + weight*sum_samples) / (1.0 + 4.0*weight);
 
-    gl_FragColor = v_v4_color*alpha; // premultiplied alpha
+    gl_FragColor = v_v4_color*(alpha*u_f_layer_opacity); // premultiplied alpha
 }
 
 // Default
@@ -93,6 +93,7 @@ varying float v_f_glyph_sm_width;
 
 // uniforms
 uniform highp sampler2D u_s_tex0;
+uniform lowp float u_f_layer_opacity;
 
 // dist
 // The distance field value for this fragment:
@@ -108,7 +109,7 @@ void main()
                              glyph_center+v_f_glyph_sm_width,
                              dist);
 
-    gl_FragColor = v_v4_color*alpha; // premultiplied alpha
+    gl_FragColor = v_v4_color*(alpha*u_f_layer_opacity); // premultiplied alpha
 }
 
 // Debug
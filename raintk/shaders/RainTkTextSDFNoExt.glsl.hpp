@@ -75,6 +75,7 @@ varying float v_f_res;
 
 // uniforms
 uniform highp sampler2D u_s_tex0;
+uniform lowp float u_f_layer_opacity;
 
 // dist
 // The distance field value for this fragment:
@@ -143,7 +144,7 @@ void main()
     // Weighted average
     alpha = (alpha + weight*sum_samples) / (1.0 + 4.0*weight);
 
-    gl_FragColor = v_v4_color*alpha; // premultiplied alpha
+    gl_FragColor = v_v4_color*(alpha*u_f_layer_opacity); // premultiplied alpha
 }
 
 // Debug
@@ -0,0 +1,47 @@
+std::string const raintk_textured_quad_vert_glsl = R"___DELIM___(
+
+#ifdef GL_ES
+    //
+#else
+    #define lowp
+    #define mediump
+    #define highp
+#endif
+
+attribute vec2 a_v2_position;
+attribute vec2 a_v2_tex0;
+
+uniform mat4 u_m4_pv;
+
+varying mediump vec2 v_v2_tex0;
+
+void main()
+{
+    v_v2_tex0 = a_v2_tex0;
+    gl_Position = u_m4_pv*vec4(a_v2_position,0.0,1.0);
+}
+
+)___DELIM___";
+
+
+std::string const raintk_textured_quad_frag_glsl = R"___DELIM___(
+
+#ifdef GL_ES
+    precision mediump float;
+#else
+    #define lowp
+    #define mediump
+    #define highp
+#endif
+
+varying mediump vec2 v_v2_tex0;
+uniform lowp sampler2D u_s_tex0;
+uniform lowp float u_f_layer_opacity;
+
+void main()
+{
+    // Textures are expected to be premultiplied
+    gl_FragColor = texture2D(u_s_tex0,v_v2_tex0)*u_f_layer_opacity;
+}
+
+)___DELIM___";
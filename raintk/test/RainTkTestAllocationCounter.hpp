@@ -0,0 +1,89 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef RAINTK_TEST_ALLOCATION_COUNTER_HPP
+#define RAINTK_TEST_ALLOCATION_COUNTER_HPP
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new and delete to count heap
+// allocations made by the whole program. Only include this in
+// the one source file of a test that needs it.
+
+namespace raintk
+{
+    namespace test
+    {
+        struct AllocationCount
+        {
+            std::size_t count;
+            std::size_t bytes;
+        };
+
+        inline std::atomic<std::size_t>& GetAllocationCountAtomic()
+        {
+            static std::atomic<std::size_t> count{0};
+            return count;
+        }
+
+        inline std::atomic<std::size_t>& GetAllocationBytesAtomic()
+        {
+            static std::atomic<std::size_t> bytes{0};
+            return bytes;
+        }
+
+        // Allocations made by the program so far. Take the
+        // difference between two calls to count the allocations
+        // made by some section of code.
+        inline AllocationCount GetAllocationCount()
+        {
+            return AllocationCount{
+                GetAllocationCountAtomic().load(),
+                GetAllocationBytesAtomic().load()
+            };
+        }
+
+        inline AllocationCount operator - (AllocationCount const &a,
+                                           AllocationCount const &b)
+        {
+            return AllocationCount{a.count-b.count,a.bytes-b.bytes};
+        }
+    }
+}
+
+// The array and nothrow versions call these by default
+void* operator new(std::size_t size_bytes)
+{
+    raintk::test::GetAllocationCountAtomic()++;
+    raintk::test::GetAllocationBytesAtomic() += size_bytes;
+
+    void* ptr = std::malloc(size_bytes > 0 ? size_bytes : 1);
+    if(ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+#endif // RAINTK_TEST_ALLOCATION_COUNTER_HPP
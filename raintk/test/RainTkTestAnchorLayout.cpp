@@ -0,0 +1,335 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkWidget.hpp>
+#include <raintk/RainTkAlignment.hpp>
+#include <raintk/RainTkAnchorLayout.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
+
+#include <cassert>
+
+using namespace raintk;
+
+namespace
+{
+    using AlignFn = void(*)(Widget*,Widget*);
+
+    struct AlignFnPair
+    {
+        std::string name;
+        AlignFn assign;
+        AlignFn anchor;
+    };
+
+    bool Near(float a, float b)
+    {
+        return (fabs(a-b) < 1E-3);
+    }
+
+    bool SamePosition(shared_ptr<Widget> const &a,
+                      shared_ptr<Widget> const &b)
+    {
+        return (Near(a->x.Get(),b->x.Get()) &&
+                Near(a->y.Get(),b->y.Get()));
+    }
+
+    template<typename Fn>
+    bool Throws(Fn fn)
+    {
+        try
+        {
+            fn();
+        }
+        catch(WidgetAlignmentInvalid const &)
+        {
+            return true;
+        }
+        return false;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c(600,800);
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+    auto layout = scene->GetTransformSystem()->GetAnchorLayout();
+
+    auto update =
+            [scene]()
+            {
+                TimePoint const t = std::chrono::high_resolution_clock::now();
+                scene->GetTransformSystem()->Update(t,t);
+            };
+
+    std::vector<AlignFnPair> list_fns = {
+        {"CenterToAnchorCenter",
+         Align::AssignCenterToAnchorCenter,
+         Align::AnchorCenterToAnchorCenter},
+        {"HCenterToAnchorHCenter",
+         Align::AssignHCenterToAnchorHCenter,
+         Align::AnchorHCenterToAnchorHCenter},
+        {"RightToAnchorLeft",
+         Align::AssignRightToAnchorLeft,
+         Align::AnchorRightToAnchorLeft},
+        {"LeftToAnchorLeft",
+         Align::AssignLeftToAnchorLeft,
+         Align::AnchorLeftToAnchorLeft},
+        {"LeftToAnchorRight",
+         Align::AssignLeftToAnchorRight,
+         Align::AnchorLeftToAnchorRight},
+        {"RightToAnchorRight",
+         Align::AssignRightToAnchorRight,
+         Align::AnchorRightToAnchorRight},
+        {"VCenterToAnchorVCenter",
+         Align::AssignVCenterToAnchorVCenter,
+         Align::AnchorVCenterToAnchorVCenter},
+        {"BottomToAnchorTop",
+         Align::AssignBottomToAnchorTop,
+         Align::AnchorBottomToAnchorTop},
+        {"TopToAnchorTop",
+         Align::AssignTopToAnchorTop,
+         Align::AnchorTopToAnchorTop},
+        {"BottomToAnchorBottom",
+         Align::AssignBottomToAnchorBottom,
+         Align::AnchorBottomToAnchorBottom},
+        {"TopToAnchorBottom",
+         Align::AssignTopToAnchorBottom,
+         Align::AnchorTopToAnchorBottom}
+    };
+
+    // Anchors end up where assigning the same alignment
+    // again after each change would, for both parent and
+    // sibling anchors. The bindings aren't used as a
+    // reference here since some of them only assign once
+    for(auto const &fns : list_fns)
+    {
+        shared_ptr<Widget> list_parents[2];
+        shared_ptr<Widget> list_siblings[2];
+        shared_ptr<Widget> list_widgets[2];
+
+        for(uint i=0; i < 2; i++)
+        {
+            list_parents[i] = MakeWidget<Widget>(scene,root);
+            list_parents[i]->width = mm(80);
+            list_parents[i]->height = mm(60);
+
+            list_siblings[i] = MakeWidget<Widget>(scene,list_parents[i]);
+            list_siblings[i]->x = mm(15);
+            list_siblings[i]->y = mm(25);
+            list_siblings[i]->width = mm(20);
+            list_siblings[i]->height = mm(10);
+
+            list_widgets[i] = MakeWidget<Widget>(scene,list_parents[i]);
+            list_widgets[i]->width = mm(8);
+            list_widgets[i]->height = mm(6);
+        }
+
+        // Parent
+        fns.anchor(list_widgets[1].get(),list_parents[1].get());
+        fns.assign(list_widgets[0].get(),list_parents[0].get());
+        update();
+        assert(SamePosition(list_widgets[0],list_widgets[1]));
+
+        // Resizing either widget
+        for(uint i=0; i < 2; i++)
+        {
+            list_parents[i]->width = mm(50);
+            list_parents[i]->height = mm(70);
+            list_widgets[i]->width = mm(12);
+            list_widgets[i]->height = mm(4);
+        }
+        fns.assign(list_widgets[0].get(),list_parents[0].get());
+        update();
+        assert(SamePosition(list_widgets[0],list_widgets[1]));
+
+        // Sibling
+        fns.anchor(list_widgets[1].get(),list_siblings[1].get());
+        fns.assign(list_widgets[0].get(),list_siblings[0].get());
+        update();
+        assert(SamePosition(list_widgets[0],list_widgets[1]));
+
+        // Moving and resizing the sibling
+        for(uint i=0; i < 2; i++)
+        {
+            list_siblings[i]->x = mm(5);
+            list_siblings[i]->y = mm(40);
+            list_siblings[i]->width = mm(30);
+            list_siblings[i]->height = mm(3);
+        }
+        fns.assign(list_widgets[0].get(),list_siblings[0].get());
+        update();
+        assert(SamePosition(list_widgets[0],list_widgets[1]));
+
+        rtklog.Trace() << fns.name << ": OK";
+
+        root->RemoveChild(list_parents[0]);
+        root->RemoveChild(list_parents[1]);
+    }
+
+    // Destroying the widgets removes their constraints
+    assert(layout->GetConstraintCount() == 0);
+
+    // Chains of siblings resolve in a single pass
+    {
+        uint const chain_length = 40;
+
+        shared_ptr<Widget> list_parents[2];
+        std::vector<shared_ptr<Widget>> list_chains[2];
+
+        for(uint i=0; i < 2; i++)
+        {
+            list_parents[i] = MakeWidget<Widget>(scene,root);
+            list_parents[i]->width = mm(400);
+            list_parents[i]->height = mm(40);
+
+            for(uint j=0; j < chain_length; j++)
+            {
+                auto field = MakeWidget<Widget>(scene,list_parents[i]);
+                field->width = mm(10);
+                field->height = mm(5);
+                list_chains[i].push_back(field);
+            }
+        }
+
+        // Add the links from the end of the chain so that
+        // each widget is added before its anchor
+        for(uint j=chain_length-1; j > 0; j--)
+        {
+            Align::BindLeftToAnchorRight(
+                        list_chains[0][j].get(),
+                        list_chains[0][j-1].get());
+
+            Align::AnchorLeftToAnchorRight(
+                        list_chains[1][j].get(),
+                        list_chains[1][j-1].get());
+        }
+
+        Align::BindLeftToAnchorLeft(
+                    list_chains[0][0].get(),
+                    list_parents[0].get());
+
+        Align::AnchorLeftToAnchorLeft(
+                    list_chains[1][0].get(),
+                    list_parents[1].get());
+
+        assert(layout->GetConstraintCount() == chain_length);
+        assert(layout->GetDirty());
+
+        update();
+        assert(!layout->GetDirty());
+
+        for(uint j=0; j < chain_length; j++)
+        {
+            assert(SamePosition(list_chains[0][j],list_chains[1][j]));
+            assert(Near(list_chains[1][j]->x.Get(),j*mm(10)));
+        }
+
+        // Resizing the first field moves every field after it
+        list_chains[0][0]->width = mm(25);
+        list_chains[1][0]->width = mm(25);
+        assert(layout->GetDirty());
+
+        layout->Resolve();
+        assert(!layout->GetDirty());
+
+        for(uint j=0; j < chain_length; j++)
+        {
+            assert(SamePosition(list_chains[0][j],list_chains[1][j]));
+        }
+
+        // Changes made while resolving don't need another pass
+        layout->Resolve();
+        assert(!layout->GetDirty());
+
+        // Time relayouts of both chains
+        uint const relayout_count = 1000;
+
+        auto const t0 = std::chrono::high_resolution_clock::now();
+
+        for(uint k=0; k < relayout_count; k++)
+        {
+            list_chains[0][0]->width = mm(10+(k%5));
+        }
+
+        auto const t1 = std::chrono::high_resolution_clock::now();
+
+        for(uint k=0; k < relayout_count; k++)
+        {
+            list_chains[1][0]->width = mm(10+(k%5));
+            layout->Resolve();
+        }
+
+        auto const t2 = std::chrono::high_resolution_clock::now();
+
+        rtklog.Trace() << "Chain of " << chain_length << " fields, "
+                       << relayout_count << " relayouts: bindings: "
+                       << ks::CalcDuration<Microseconds>(t0,t1).count()
+                       << "us, anchors: "
+                       << ks::CalcDuration<Microseconds>(t1,t2).count()
+                       << "us";
+
+        assert(SamePosition(list_chains[0].back(),list_chains[1].back()));
+
+        // Circular dependencies are rejected
+        auto first = list_chains[1][0].get();
+        auto last = list_chains[1].back().get();
+        assert(Throws([&](){ Align::AnchorRightToAnchorLeft(first,last); }));
+
+        auto a = list_chains[1][1].get();
+        assert(Throws([&](){ Align::AnchorCenterToAnchorCenter(a,a); }));
+
+        // Edges on different axes are rejected
+        assert(Throws([&](){
+            layout->Add(a,AnchorLayout::Edge::Left,
+                        first,AnchorLayout::Edge::Top);
+        }));
+
+        (void)first;
+        (void)last;
+        (void)a;
+
+        // The other axis can still depend the other way
+        Align::AnchorTopToAnchorBottom(first,last);
+        assert(layout->GetConstraintCount() == chain_length+1);
+
+        // Removing a widget removes its constraints and the
+        // constraints anchored to it
+        list_parents[1]->RemoveChild(list_chains[1][20]);
+        list_chains[1][20].reset();
+        assert(layout->GetConstraintCount() == chain_length-1);
+
+        Align::ClearAnchors(list_chains[1][30].get());
+        assert(layout->GetConstraintCount() == chain_length-3);
+
+        root->RemoveChild(list_parents[0]);
+        root->RemoveChild(list_parents[1]);
+        list_chains[0].clear();
+        list_chains[1].clear();
+
+        assert(layout->GetConstraintCount() == 0);
+    }
+
+    rtklog.Trace() << "AnchorLayout: OK";
+
+    c.app->Run();
+
+    return 0;
+}
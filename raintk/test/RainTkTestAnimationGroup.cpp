@@ -0,0 +1,157 @@
+/*
+  Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <cmath>
+#include <algorithm>
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkAnimationGroup.hpp>
+#include <raintk/RainTkAnimationSystem.hpp>
+#include <raintk/RainTkPropertyAnimation.hpp>
+
+using namespace raintk;
+
+namespace
+{
+    bool IsNear(float a, float b)
+    {
+        return (std::fabs(a-b) < 0.01f);
+    }
+
+    bool IsActive(Scene* scene, Animation* animation)
+    {
+        auto const &list_active =
+                scene->GetAnimationSystem()->GetListActiveAnimations();
+
+        return (std::find(
+                    list_active.begin(),
+                    list_active.end(),
+                    animation) != list_active.end());
+    }
+
+    shared_ptr<PropertyAnimation> MakeTween(Scene* scene,
+                                            Property<float>* property)
+    {
+        auto anim = ks::MakeObject<PropertyAnimation>(scene);
+        anim->AddTrack(property,0.0f,100.0f,100.0f);
+        return anim;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+    auto scene = c.scene.get();
+
+    Property<float> a{0.0f};
+    Property<float> b{0.0f};
+
+    // Sequential
+    {
+        auto group =
+                ks::MakeObject<AnimationGroup>(
+                    scene,AnimationGroup::Mode::Sequential);
+
+        auto anim_a = MakeTween(scene,&a);
+        auto anim_b = MakeTween(scene,&b);
+        group->Add(anim_a);
+        group->Add(anim_b);
+        group->SetKeepOnComplete(true);
+        group->Start();
+
+        // Only the group is updated by the AnimationSystem
+        assert(IsActive(scene,group.get()));
+        assert(!IsActive(scene,anim_a.get()));
+        assert(!IsActive(scene,anim_b.get()));
+
+        group->Update(50.0f);
+        assert(IsNear(a.Get(),50.0f));
+        assert(IsNear(b.Get(),0.0f));
+
+        group->Update(50.0f);
+        assert(IsNear(a.Get(),100.0f));
+
+        group->Update(50.0f);
+        assert(IsNear(b.Get(),50.0f));
+
+        group->Update(50.0f);
+        assert(group->GetState() == Animation::State::Stopped);
+        assert(IsNear(b.Get(),100.0f));
+    }
+
+    // Staggered
+    {
+        a = 0.0f;
+        b = 0.0f;
+
+        auto group =
+                ks::MakeObject<AnimationGroup>(
+                    scene,AnimationGroup::Mode::Staggered,25.0f);
+
+        group->Add(MakeTween(scene,&a));
+        group->Add(MakeTween(scene,&b));
+        group->SetKeepOnComplete(true);
+        group->Start();
+
+        group->Update(50.0f);
+        assert(IsNear(a.Get(),50.0f));
+        assert(IsNear(b.Get(),25.0f));
+
+        group->Complete();
+        assert(IsNear(a.Get(),100.0f));
+        assert(IsNear(b.Get(),100.0f));
+    }
+
+    // Delayed animations are parked until they're due
+    {
+        a = 0.0f;
+
+        auto anim_a = MakeTween(scene,&a);
+        anim_a->SetKeepOnComplete(true);
+        anim_a->SetDelay(100.0f);
+        anim_a->Start();
+
+        auto anim_system = scene->GetAnimationSystem();
+        assert(!IsActive(scene,anim_a.get()));
+
+        TimePoint const t0 = std::chrono::high_resolution_clock::now();
+        anim_system->Update(t0,t0+Milliseconds(50));
+        assert(!IsActive(scene,anim_a.get()));
+
+        TimePoint wake_time;
+        bool const waiting = anim_system->GetNextWakeUpTime(wake_time);
+        assert(waiting);
+        assert(wake_time > t0+Milliseconds(50));
+
+        anim_system->Update(t0+Milliseconds(50),t0+Milliseconds(120));
+        assert(IsActive(scene,anim_a.get()));
+
+        // Paused animations aren't visited
+        anim_a->Pause();
+        assert(!IsActive(scene,anim_a.get()));
+        anim_a->Resume();
+        assert(IsActive(scene,anim_a.get()));
+    }
+
+    rtklog.Trace() << "AnimationGroup: OK";
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}
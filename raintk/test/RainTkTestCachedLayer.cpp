@@ -0,0 +1,185 @@
+/*
+  Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <cmath>
+#include <limits>
+#include <ks/shared/KsCallbackTimer.hpp>
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkRectangle.hpp>
+#include <raintk/RainTkText.hpp>
+#include <raintk/RainTkDrawSystem.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
+
+using namespace raintk;
+
+// The layer textures only use GLES 2 framebuffers, so this
+// can be run without a GPU, ie with LIBGL_ALWAYS_SOFTWARE=1
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+    auto draw_system = scene->GetDrawSystem();
+
+    auto update =
+            [scene]()
+            {
+                TimePoint const t = std::chrono::high_resolution_clock::now();
+                scene->GetTransformSystem()->Update(t,t);
+                scene->GetDrawSystem()->Update(t,t);
+            };
+
+    // A static panel made up of many draw calls
+    auto panel = MakeWidget<Rectangle>(scene,root);
+    panel->x = mm(10);
+    panel->y = mm(10);
+    panel->width = mm(80);
+    panel->height = mm(50);
+    panel->color = glm::u8vec4(40,40,40,255);
+
+    std::vector<shared_ptr<Rectangle>> list_ticks;
+    for(uint i=0; i < 40; i++)
+    {
+        auto tick = MakeWidget<Rectangle>(scene,panel);
+        tick->x = mm(2)+i*mm(1.9f);
+        tick->y = mm(2);
+        tick->width = mm(0.5f);
+        tick->height = (i%5 == 0) ? mm(6) : mm(3);
+        tick->color = glm::u8vec4(255,255,255,200);
+        list_ticks.push_back(tick);
+    }
+
+    auto label = MakeWidget<Text>(scene,panel);
+    label->font = "FiraSansMinimal.ttf";
+    label->color = glm::u8vec4(255,255,255,255);
+    label->size = mm(5);
+    label->text = "Cached Layer";
+    label->x = mm(4);
+    label->y = mm(20);
+    label->z = 0.1f;
+
+    panel->layer = true;
+    update();
+
+    Id const layer_id = panel->GetLayerId();
+    assert(layer_id != 0);
+    assert(list_ticks[0]->GetLayerId() == layer_id);
+
+    auto get_desc =
+            [draw_system,layer_id]()
+            {
+                return draw_system->GetSnapshot().list_cached_layers[layer_id];
+            };
+
+    // The layer covers the panel in whole pixels
+    auto const desc0 = get_desc();
+    assert(desc0.cached);
+    assert(desc0.bbox.x0 <= panel->x.Get());
+    assert(desc0.bbox.x1 >= panel->x.Get()+panel->width.Get());
+    assert(desc0.bbox.x0 == std::floor(desc0.bbox.x0));
+    (void)desc0;
+
+    // Nothing changed so the layer isn't redrawn
+    update();
+    assert(get_desc().version == desc0.version);
+
+    // Uploading to a texture only redraws the layers drawn
+    // with it, ie. the label's text atlas
+    Id const atlas_texture_set_id =
+            scene->GetTextAtlasData().begin()->second->texture_set_id;
+
+    draw_system->OnTextureSetUpdated(std::numeric_limits<Id>::max());
+    assert(get_desc().version == desc0.version);
+
+    draw_system->OnTextureSetUpdated(atlas_texture_set_id);
+    assert(get_desc().version > desc0.version);
+    (void)atlas_texture_set_id;
+
+    // Changing a descendant invalidates the layer
+    auto const desc_uploaded = get_desc();
+    list_ticks[3]->color = glm::u8vec4(255,0,0,255);
+    update();
+    auto const desc1 = get_desc();
+    assert(desc1.version > desc_uploaded.version);
+    (void)desc_uploaded;
+    (void)desc1;
+
+    // So does hiding one
+    list_ticks[4]->visible = false;
+    update();
+    assert(get_desc().version > desc1.version);
+    list_ticks[4]->visible = true;
+    update();
+
+    // Layers that don't fit in the budget are drawn uncached
+    draw_system->SetLayerCacheBudget(1024);
+    update();
+    assert(!get_desc().cached);
+
+    draw_system->SetLayerCacheBudget(16*1024*1024);
+    update();
+    assert(get_desc().cached);
+
+    // Turning the layer off removes it
+    panel->layer = false;
+    update();
+    assert(panel->GetLayerId() == 0);
+    assert(!get_desc().cached);
+
+    panel->layer = true;
+    update();
+
+    // Change the panel now and then; the layer should only
+    // be redrawn when it does
+    uint tick_index = 0;
+    ks::shared_ptr<ks::CallbackTimer> change_timer =
+            ks::MakeObject<ks::CallbackTimer>(
+                scene->GetEventLoop(),
+                ks::Milliseconds(2000),
+                [&]()
+                {
+                    list_ticks[tick_index]->color = glm::u8vec4(255,255,255,200);
+                    tick_index = (tick_index+1)%list_ticks.size();
+                    list_ticks[tick_index]->color = glm::u8vec4(255,0,0,255);
+                });
+
+    change_timer->Start();
+
+    ks::shared_ptr<ks::CallbackTimer> stats_timer =
+            ks::MakeObject<ks::CallbackTimer>(
+                scene->GetEventLoop(),
+                ks::Milliseconds(1000),
+                [&]()
+                {
+                    auto const &stats = draw_system->GetCachedLayerStats();
+                    rtklog.Trace() << "layer hits: " << stats.hits
+                                   << ", renders: " << stats.renders
+                                   << ", bytes: " << stats.bytes;
+                });
+
+    stats_timer->Start();
+
+    rtklog.Trace() << "CachedLayer: OK";
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}
@@ -0,0 +1,173 @@
+/*
+  Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <ks/shared/KsCallbackTimer.hpp>
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkRectangle.hpp>
+#include <raintk/RainTkText.hpp>
+#include <raintk/RainTkDrawSystem.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
+
+using namespace raintk;
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+    auto draw_system = scene->GetDrawSystem();
+
+    // A panel with some content that slides in and fades
+    auto panel = MakeWidget<Rectangle>(scene,root);
+    panel->x = mm(20);
+    panel->y = mm(20);
+    panel->width = mm(60);
+    panel->height = mm(40);
+    panel->color = glm::u8vec4(51,102,255,255);
+
+    auto inner = MakeWidget<Rectangle>(scene,panel);
+    inner->x = mm(5);
+    inner->y = mm(5);
+    inner->width = mm(20);
+    inner->height = mm(20);
+    inner->color = glm::u8vec4(255,255,255,255);
+
+    auto label = MakeWidget<Text>(scene,panel);
+    label->font = "FiraSansMinimal.ttf";
+    label->color = glm::u8vec4(255,255,255,255);
+    label->size = mm(5);
+    label->text = "Compositor";
+    label->x = mm(30);
+    label->y = mm(10);
+    label->z = 0.1f;
+
+    // A widget outside the layer
+    auto other = MakeWidget<Rectangle>(scene,root);
+    other->x = mm(90);
+    other->y = mm(20);
+    other->width = mm(20);
+    other->height = mm(20);
+    other->color = glm::u8vec4(255,128,0,255);
+
+    Id const layer_id = draw_system->CreateLayer(panel.get());
+    assert(layer_id != 0);
+    assert(draw_system->CreateLayer(panel.get()) == layer_id);
+
+    TimePoint const t0 = std::chrono::high_resolution_clock::now();
+    scene->GetTransformSystem()->Update(t0,t0);
+    draw_system->Update(t0,t0);
+
+    // The layer id is inherited by descendants
+    assert(panel->GetLayerId() == layer_id);
+    assert(inner->GetLayerId() == layer_id);
+    assert(label->GetLayerId() == layer_id);
+    assert(other->GetLayerId() == 0);
+
+    // Moving a widget into or out of the layer changes its
+    // layer id in the next Update
+    root->RemoveChild(other);
+    panel->AddChild(other);
+    draw_system->Update(t0,t0);
+    assert(other->GetLayerId() == layer_id);
+
+    panel->RemoveChild(other);
+    root->AddChild(other);
+    draw_system->Update(t0,t0);
+    assert(other->GetLayerId() == 0);
+
+    // Destroying the root widget of a layer removes the layer
+    // and its id can be reused
+    auto extra = MakeWidget<Widget>(scene,root);
+    Id const extra_layer_id = draw_system->CreateLayer(extra.get());
+    assert(extra_layer_id != layer_id);
+
+    root->RemoveChild(extra);
+    extra.reset();
+    auto const list_removed = draw_system->TakeLayerUpdates();
+    assert(list_removed.size() == 1);
+    assert(list_removed[0].layer_id == extra_layer_id);
+
+    extra = MakeWidget<Widget>(scene,root);
+    Id const reused_layer_id = draw_system->CreateLayer(extra.get());
+    assert(reused_layer_id == extra_layer_id);
+    draw_system->RemoveLayer(reused_layer_id);
+    draw_system->TakeLayerUpdates();
+
+    // Starting an animation doesn't update any widgets
+    bool toggle = true;
+    auto start_animation =
+            [&]()
+            {
+                CompositorAnimation anim;
+                anim.curve = Tween::Curve::Cubic;
+                anim.easing = Tween::Easing::InOut;
+                anim.duration_ms = 800.0f;
+                anim.translation_from = glm::vec2(toggle ? mm(-30) : 0.0f,0.0f);
+                anim.translation_to = glm::vec2(toggle ? 0.0f : mm(-30),0.0f);
+                anim.opacity_from = toggle ? 0.0f : 1.0f;
+                anim.opacity_to = toggle ? 1.0f : 0.0f;
+                anim.scale_from = glm::vec2(toggle ? 0.8f : 1.0f);
+                anim.scale_to = glm::vec2(toggle ? 1.0f : 0.8f);
+
+                draw_system->StartLayerAnimation(layer_id,anim);
+                toggle = !toggle;
+            };
+
+    start_animation();
+
+    auto cmlist_upd_data =
+            static_cast<UpdateDataComponentList*>(
+                scene->GetComponentList<UpdateData>());
+
+    for(auto widget : {static_cast<Widget*>(panel.get()),
+                       static_cast<Widget*>(inner.get()),
+                       static_cast<Widget*>(label.get())})
+    {
+        auto const &upd_data =
+                cmlist_upd_data->GetComponent(widget->GetEntityId());
+
+        assert(upd_data.update == UpdateData::NoUpdates);
+        (void)upd_data;
+    }
+
+    auto const list_started = draw_system->TakeLayerUpdates();
+    assert(list_started.size() == 1);
+    assert(list_started[0].type == CompositorLayerUpdate::Type::Start);
+    (void)list_started;
+    (void)list_removed;
+    (void)reused_layer_id;
+
+    start_animation();
+
+    // Restart the animation periodically
+    ks::shared_ptr<ks::CallbackTimer> anim_timer =
+            ks::MakeObject<ks::CallbackTimer>(
+                scene->GetEventLoop(),
+                ks::Milliseconds(1500),
+                start_animation);
+
+    anim_timer->Start();
+
+    rtklog.Trace() << "CompositorAnimation: OK";
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+/*
+  Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <ks/shared/KsCallbackTimer.hpp>
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkRectangle.hpp>
+#include <raintk/RainTkText.hpp>
+#include <raintk/RainTkDrawSystem.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
+
+using namespace raintk;
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+    auto draw_system = scene->GetDrawSystem();
+
+    auto cmlist_xf_data =
+            static_cast<TransformDataComponentList*>(
+                scene->GetComponentList<TransformData>());
+
+    auto update =
+            [scene]()
+            {
+                TimePoint const t = std::chrono::high_resolution_clock::now();
+                scene->GetTransformSystem()->Update(t,t);
+                scene->GetDrawSystem()->Update(t,t);
+            };
+
+    // Takes the damage like the MainDrawStage would during Sync
+    auto& snapshot = draw_system->GetSnapshot();
+    bool damage_all = false;
+    std::vector<BoundingBox> list_damage;
+
+    auto take_damage =
+            [&]()
+            {
+                damage_all = snapshot.damage_all;
+                list_damage = snapshot.list_damage_regions;
+                snapshot.list_damage_regions.clear();
+                snapshot.damage_all = false;
+                snapshot.damage_updated = false;
+            };
+
+    auto contains =
+            [](BoundingBox const &a, BoundingBox const &b)
+            {
+                return (a.x0 <= b.x0 && a.y0 <= b.y0 &&
+                        a.x1 >= b.x1 && a.y1 >= b.y1);
+            };
+
+    // A mostly static screen
+    std::vector<shared_ptr<Rectangle>> list_rects;
+    for(uint i=0; i < 6; i++)
+    {
+        auto rect = MakeWidget<Rectangle>(scene,root);
+        rect->x = mm(5)+i*mm(25);
+        rect->y = mm(10);
+        rect->width = mm(20);
+        rect->height = mm(20);
+        rect->color = glm::u8vec4(40+i*30,80,160,255);
+        list_rects.push_back(rect);
+    }
+
+    // A blinking cursor
+    auto cursor = MakeWidget<Rectangle>(scene,root);
+    cursor->x = mm(20);
+    cursor->y = mm(40);
+    cursor->width = mm(0.5f);
+    cursor->height = mm(6);
+    cursor->color = glm::u8vec4(255,255,255,255);
+
+    draw_system->SetDamageTrackingEnabled(true);
+    update();
+
+    // Everything is damaged when tracking is enabled
+    take_damage();
+    assert(damage_all);
+
+    // The draw calls have bounds
+    assert(snapshot.list_opq_draw_bboxes.size() ==
+           snapshot.list_opq_draw_order.size());
+
+    // No changes, no damage
+    update();
+    take_damage();
+    assert(!damage_all);
+    assert(list_damage.empty());
+
+    // Only the changed drawable is damaged
+    auto const cursor_bbox =
+            cmlist_xf_data->GetComponent(cursor->GetEntityId()).bbox;
+
+    cursor->visible = false;
+    update();
+    take_damage();
+    assert(!damage_all);
+    assert(list_damage.size() == 1);
+    assert(contains(list_damage[0],cursor_bbox));
+    assert(list_damage[0].x1-list_damage[0].x0 < mm(2));
+
+    cursor->visible = true;
+    update();
+    take_damage();
+    assert(list_damage.size() == 1);
+
+    // Moving damages the old and new bounds
+    auto const rect0_bbox =
+            cmlist_xf_data->GetComponent(list_rects[0]->GetEntityId()).bbox;
+
+    list_rects[0]->y = mm(50);
+    update();
+    take_damage();
+    assert(list_damage.size() == 2);
+    assert(contains(list_damage[0],rect0_bbox) ||
+           contains(list_damage[1],rect0_bbox));
+
+    // Overlapping damage is merged
+    list_rects[0]->y = mm(52);
+    update();
+    take_damage();
+    assert(list_damage.size() == 1);
+
+    // Uploading glyphs only damages the text drawn with
+    // their atlas
+    auto label = MakeWidget<Text>(scene,root);
+    label->font = "FiraSansMinimal.ttf";
+    label->color = glm::u8vec4(255,255,255,255);
+    label->size = mm(5);
+    label->text = "Damage";
+    label->x = mm(5);
+    label->y = mm(70);
+    update();
+    take_damage();
+
+    Id const atlas_texture_set_id =
+            scene->GetTextAtlasData().begin()->second->texture_set_id;
+
+    draw_system->OnTextureSetUpdated(atlas_texture_set_id);
+    take_damage();
+    assert(!damage_all);
+    assert(!list_damage.empty());
+
+    auto const rect1_bbox =
+            cmlist_xf_data->GetComponent(list_rects[1]->GetEntityId()).bbox;
+
+    for(auto const &region : list_damage)
+    {
+        assert(region.y0 >= rect1_bbox.y1);
+        (void)region;
+    }
+
+    (void)cursor_bbox;
+    (void)rect0_bbox;
+    (void)rect1_bbox;
+    (void)contains;
+
+    // Blink the cursor; only it should be redrawn
+    ks::shared_ptr<ks::CallbackTimer> blink_timer =
+            ks::MakeObject<ks::CallbackTimer>(
+                scene->GetEventLoop(),
+                ks::Milliseconds(500),
+                [&]()
+                {
+                    cursor->visible = !cursor->visible.Get();
+                });
+
+    blink_timer->Start();
+
+    rtklog.Trace() << "DamageRegions: OK";
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}
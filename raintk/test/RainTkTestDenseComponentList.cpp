@@ -0,0 +1,234 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkDenseComponentList.hpp>
+#include <raintk/RainTkInputSystem.hpp>
+#include <raintk/RainTkDrawSystem.hpp>
+#include <raintk/RainTkRectangle.hpp>
+
+#include <cassert>
+
+using namespace raintk;
+
+namespace
+{
+    struct TestData
+    {
+        uint value;
+        float weight;
+    };
+
+    // Sparse layout: a component slot and a mask bit
+    // for every entity, like ks::ecs::ComponentList
+    struct SparseTestDataList
+    {
+        std::vector<TestData> list_components;
+        std::vector<bool> list_has_component;
+    };
+
+    uint SumDense(DenseComponentList<TestData> const &cmlist)
+    {
+        uint sum=0;
+        for(auto const &data : cmlist.GetDenseList())
+        {
+            sum += data.value;
+        }
+
+        return sum;
+    }
+
+    uint SumSparse(SparseTestDataList const &cmlist)
+    {
+        uint sum=0;
+        for(uint ent_id=0; ent_id < cmlist.list_components.size(); ent_id++)
+        {
+            if(cmlist.list_has_component[ent_id])
+            {
+                sum += cmlist.list_components[ent_id].value;
+            }
+        }
+
+        return sum;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    // Create, Remove and lookups
+    {
+        DenseComponentList<TestData> cmlist;
+
+        for(uint ent_id=0; ent_id < 10; ent_id+=2)
+        {
+            cmlist.Create(ent_id,TestData{ent_id,0.0f});
+        }
+
+        assert(cmlist.GetSize() == 5);
+        assert(cmlist.GetHasComponent(4));
+        assert(!cmlist.GetHasComponent(5));
+        assert(!cmlist.GetHasComponent(1000));
+
+        // Creating again replaces the component
+        cmlist.Create(4,TestData{40,0.0f});
+        assert(cmlist.GetSize() == 5);
+        assert(cmlist.GetComponent(4).value == 40);
+
+        // Removing moves the last component into the gap
+        cmlist.Remove(2);
+        assert(cmlist.GetSize() == 4);
+        assert(!cmlist.GetHasComponent(2));
+        assert(cmlist.GetDenseIds()[1] == 8);
+        assert(cmlist.GetComponent(8).value == 8);
+        assert(cmlist.GetEntityId(&cmlist.GetComponent(8)) == 8);
+
+        // Removing an entity without a component does nothing
+        cmlist.Remove(3);
+        cmlist.Remove(1000);
+        assert(cmlist.GetSize() == 4);
+
+        // Removing the last component
+        cmlist.Remove(8);
+        assert(cmlist.GetSize() == 3);
+        for(uint i=0; i < cmlist.GetSize(); i++)
+        {
+            Id const ent_id = cmlist.GetDenseIds()[i];
+            assert(&cmlist.GetComponent(ent_id) == &cmlist.GetDenseList()[i]);
+            (void)ent_id;
+        }
+
+        cmlist.Create(2,TestData{2,0.0f});
+        assert(cmlist.GetComponent(2).value == 2);
+        assert(SumDense(cmlist) == 0+40+6+2);
+    }
+
+    rtklog.Trace() << "DenseComponentList: OK";
+
+    TestContext c;
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+
+    // Removing an entity through the Scene removes its
+    // components from the registered dense lists
+    {
+        auto cmlist_input_data = scene->GetInputSystem()->GetInputDataComponentList();
+        auto cmlist_draw_data = scene->GetDrawSystem()->GetDrawDataComponentList();
+
+        uint const input_data_count = cmlist_input_data->GetSize();
+        uint const draw_data_count = cmlist_draw_data->GetSize();
+
+        Id const ent_id = scene->CreateEntity();
+        cmlist_input_data->Create(ent_id,InputData{true,nullptr});
+        assert(cmlist_input_data->GetSize() == input_data_count+1);
+
+        scene->RemoveEntity(ent_id);
+        assert(!cmlist_input_data->GetHasComponent(ent_id));
+        assert(cmlist_input_data->GetSize() == input_data_count);
+
+        // Also when removed through ks::ecs::Scene directly
+        Id const other_ent_id = scene->CreateEntity();
+        cmlist_input_data->Create(other_ent_id,InputData{true,nullptr});
+        static_cast<Scene::base_type*>(scene)->RemoveEntity(other_ent_id);
+        assert(!cmlist_input_data->GetHasComponent(other_ent_id));
+        assert(cmlist_input_data->GetSize() == input_data_count);
+
+        // Drawables remove their DrawData when destroyed
+        auto rect = MakeWidget<Rectangle>(scene,root);
+        rect->width = mm(10);
+        rect->height = mm(10);
+
+        TimePoint const t = std::chrono::high_resolution_clock::now();
+        scene->GetDrawSystem()->Update(t,t);
+        assert(cmlist_draw_data->GetSize() == draw_data_count+1);
+
+        root->RemoveChild(rect);
+        rect.reset();
+        assert(cmlist_draw_data->GetSize() == draw_data_count);
+
+        (void)input_data_count;
+        (void)draw_data_count;
+    }
+
+    rtklog.Trace() << "Scene::RemoveEntity: OK";
+
+    // Memory and iteration time with a sparse layout vs
+    // a DenseComponentList when only a few of the entities
+    // have the component
+    {
+        uint const entity_count = 100000;
+        uint const component_stride = 50;
+        uint const iteration_count = 100;
+
+        SparseTestDataList sparse_cmlist;
+        sparse_cmlist.list_components.resize(entity_count);
+        sparse_cmlist.list_has_component.resize(entity_count,false);
+
+        DenseComponentList<TestData> dense_cmlist;
+
+        for(uint ent_id=0; ent_id < entity_count; ent_id+=component_stride)
+        {
+            sparse_cmlist.list_components[ent_id] = TestData{ent_id,1.0f};
+            sparse_cmlist.list_has_component[ent_id] = true;
+            dense_cmlist.Create(ent_id,TestData{ent_id,1.0f});
+        }
+
+        std::size_t const sparse_size_bytes =
+                sparse_cmlist.list_components.capacity()*sizeof(TestData)+
+                sparse_cmlist.list_has_component.capacity()/8;
+
+        std::size_t const dense_size_bytes =
+                dense_cmlist.GetSizeBytes();
+
+        uint sparse_sum=0;
+        uint dense_sum=0;
+
+        auto const t0 = std::chrono::high_resolution_clock::now();
+
+        for(uint i=0; i < iteration_count; i++)
+        {
+            sparse_sum += SumSparse(sparse_cmlist);
+        }
+
+        auto const t1 = std::chrono::high_resolution_clock::now();
+
+        for(uint i=0; i < iteration_count; i++)
+        {
+            dense_sum += SumDense(dense_cmlist);
+        }
+
+        auto const t2 = std::chrono::high_resolution_clock::now();
+
+        assert(sparse_sum == dense_sum);
+        assert(dense_size_bytes < sparse_size_bytes);
+        (void)sparse_sum;
+        (void)dense_sum;
+
+        rtklog.Trace() << entity_count << " entities, "
+                       << dense_cmlist.GetSize() << " components: "
+                       << "sparse: " << sparse_size_bytes << " bytes, "
+                       << ks::CalcDuration<Microseconds>(t0,t1).count()
+                       << "us, dense: " << dense_size_bytes << " bytes, "
+                       << ks::CalcDuration<Microseconds>(t1,t2).count()
+                       << "us (" << iteration_count << " iterations)";
+    }
+
+    c.app->Run();
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*
+  Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkRectangle.hpp>
+#include <raintk/RainTkDrawSystem.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
+#include <raintk/RainTkMainDrawStage.hpp>
+
+using namespace raintk;
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+    auto draw_system = scene->GetDrawSystem();
+    auto transform_system = scene->GetTransformSystem();
+
+    auto& snapshot = draw_system->GetSnapshot();
+
+    auto rect = MakeWidget<Rectangle>(scene,root);
+    rect->width = mm(20);
+    rect->height = mm(20);
+    rect->color = glm::u8vec4(51,102,255,255);
+
+    auto update =
+            [&]()
+            {
+                TimePoint const t = std::chrono::high_resolution_clock::now();
+                transform_system->Update(t,t);
+                draw_system->Update(t,t);
+            };
+
+    // The first update writes everything
+    update();
+    assert(snapshot.clip_regions_updated);
+    assert(snapshot.draw_order_updated);
+
+    // Syncing swaps the lists into the stage and clears
+    // the flags
+    MainDrawStage stage;
+    stage.SyncSnapshot(snapshot);
+    assert(!snapshot.clip_regions_updated);
+    assert(!snapshot.draw_order_updated);
+
+    // Nothing that affects clipping changed
+    update();
+    assert(!snapshot.clip_regions_updated);
+    stage.SyncSnapshot(snapshot);
+
+    // A new clip region is written
+    auto clip = MakeWidget<Widget>(scene,root);
+    clip->width = mm(10);
+    clip->height = mm(10);
+    clip->clip = true;
+
+    update();
+    assert(snapshot.clip_regions_updated);
+    assert(snapshot.list_clip_regions.size() == 2);
+    stage.SyncSnapshot(snapshot);
+
+    // A new drawable changes the draw order
+    auto rect2 = MakeWidget<Rectangle>(scene,clip);
+    rect2->width = mm(5);
+    rect2->height = mm(5);
+    rect2->color = glm::u8vec4(255,128,0,255);
+
+    update();
+    assert(snapshot.draw_order_updated);
+    stage.SyncSnapshot(snapshot);
+
+    // RenderData is kept between frames and only the
+    // geometry of changed drawables is rebuilt
+    update();
+    assert(!snapshot.draw_order_updated);
+    assert(draw_system->GetRebuiltRenderDataCount() == 0);
+
+    rect->color = glm::u8vec4(255,255,255,255);
+    update();
+    assert(!snapshot.draw_order_updated);
+    assert(draw_system->GetRebuiltRenderDataCount() == 1);
+
+    draw_system->InvalidateRenderData();
+    update();
+    assert(draw_system->GetRebuiltRenderDataCount() == 2);
+    stage.SyncSnapshot(snapshot);
+
+    rtklog.Trace() << "DrawSnapshot: OK";
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/test/RainTkTestAllocationCounter.hpp>
+#include <raintk/RainTkFrameArena.hpp>
+#include <raintk/RainTkRectangle.hpp>
+#include <raintk/RainTkInputSystem.hpp>
+#include <raintk/RainTkAnimationSystem.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
+#include <raintk/RainTkDrawSystem.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+using namespace raintk;
+
+namespace
+{
+    bool IsAligned(void const *ptr, std::size_t align)
+    {
+        return (reinterpret_cast<std::uintptr_t>(ptr)%align == 0);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    // FrameArena and FrameVector
+    {
+        auto const alloc_start = test::GetAllocationCount();
+        FrameArena arena(256);
+        assert(arena.GetBlockAllocationCount() == 0);
+        assert((test::GetAllocationCount()-alloc_start).count > 0);
+        (void)alloc_start;
+        assert(arena.GetCapacityBytes() == 256);
+
+        // Allocations are aligned
+        arena.Allocate(1,1);
+        void* ptr = arena.Allocate(sizeof(double),alignof(double));
+        assert(IsAligned(ptr,alignof(double)));
+        (void)ptr;
+
+        // The most recent allocation can be given back
+        std::size_t const used_bytes = arena.GetUsedBytes();
+        void* last_ptr = arena.Allocate(32,4);
+        arena.Deallocate(last_ptr,32);
+        assert(arena.GetUsedBytes() == used_bytes);
+        (void)used_bytes;
+        (void)last_ptr;
+
+        // Containers that outgrow the arena add blocks
+        // for the first frame only
+        for(uint f=0; f < 3; f++)
+        {
+            arena.Reset();
+            assert(arena.GetUsedBytes() == 0);
+
+            FrameVector<uint> list_values(&arena);
+            for(uint i=0; i < 500; i++)
+            {
+                list_values.push_back(i);
+            }
+
+            FrameVector<FrameVector<double>> list_groups(&arena);
+            for(uint i=0; i < 10; i++)
+            {
+                list_groups.emplace_back(&arena);
+                list_groups.back().resize(i+1,1.0);
+                assert(IsAligned(list_groups.back().data(),alignof(double)));
+            }
+
+            FrameVector<bool> list_flags(100,false,&arena);
+            list_flags[50] = true;
+
+            assert(list_values.back() == 499);
+            assert(list_groups.back().size() == 10);
+            assert(list_flags[50]);
+
+            if(f == 0)
+            {
+                assert(arena.GetBlockAllocationCount() > 0);
+            }
+            else
+            {
+                assert(arena.GetBlockAllocationCount() == 0);
+            }
+        }
+    }
+
+    rtklog.Trace() << "FrameArena: OK";
+
+    // A steady state frame doesn't allocate temporaries
+    TestContext c;
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+    auto frame_arena = scene->GetFrameArena();
+
+    auto clip = MakeWidget<Widget>(scene,root);
+    clip->width = mm(80);
+    clip->height = mm(80);
+    clip->clip = true;
+
+    std::vector<shared_ptr<Rectangle>> list_rects;
+    for(uint i=0; i < 200; i++)
+    {
+        auto rect = MakeWidget<Rectangle>(scene,clip);
+        rect->x = mm(i%20)*4;
+        rect->y = mm(i/20)*8;
+        rect->width = mm(3);
+        rect->height = mm(3);
+        rect->color = glm::u8vec4(20,120,200,(i%2) ? 255 : 128);
+        list_rects.push_back(rect);
+    }
+
+    // Run the systems in the same order as Scene::onUpdate
+    TimePoint t0 = std::chrono::high_resolution_clock::now();
+    auto update =
+            [&]()
+            {
+                TimePoint const t1 = t0+Milliseconds(16);
+                frame_arena->Reset();
+                scene->GetInputSystem()->Update(t0,t1);
+                scene->GetAnimationSystem()->Update(t0,t1);
+                scene->GetTransformSystem()->Update(t0,t1);
+                scene->GetDrawSystem()->Update(t0,t1);
+                t0 = t1;
+            };
+
+    for(uint f=0; f < 3; f++)
+    {
+        update();
+    }
+
+    // Frame temporaries come from the arena and RenderData is
+    // kept between frames. The only heap allocation a frame
+    // may still make is the merged vertex buffer of the batch
+    // with the moved widget, which a Scene hands off to the
+    // render thread when it syncs. Nothing syncs here, so the
+    // buffer is reused.
+    auto draw_system = scene->GetDrawSystem();
+    test::AllocationCount max_frame_alloc{0,0};
+
+    for(uint f=0; f < 10; f++)
+    {
+        // Move a widget so each frame has some work
+        list_rects[f]->x = list_rects[f]->x.Get()+mm(1);
+
+        auto const alloc_start = test::GetAllocationCount();
+        update();
+        auto const alloc = test::GetAllocationCount()-alloc_start;
+
+        assert(frame_arena->GetUsedBytes() > 0);
+        assert(frame_arena->GetBlockAllocationCount() == 0);
+        assert(draw_system->GetRebuiltRenderDataCount() == 1);
+        assert(alloc.count <= draw_system->GetRebuiltRenderDataCount());
+
+        max_frame_alloc.count = std::max(max_frame_alloc.count,alloc.count);
+        max_frame_alloc.bytes = std::max(max_frame_alloc.bytes,alloc.bytes);
+    }
+
+    rtklog.Trace() << "Steady state frame: "
+                   << frame_arena->GetUsedBytes() << " of "
+                   << frame_arena->GetCapacityBytes()
+                   << " arena bytes used, at most "
+                   << max_frame_alloc.count << " heap allocations ("
+                   << max_frame_alloc.bytes << " bytes)";
+
+    (void)draw_system;
+
+    rtklog.Trace() << "FrameArena steady state: OK";
+
+    list_rects.clear();
+    root->RemoveChild(clip);
+
+    c.app->Run();
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+/*
+  Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <ks/shared/KsCallbackTimer.hpp>
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkRectangle.hpp>
+#include <raintk/RainTkMouseArea.hpp>
+#include <raintk/RainTkFramePacer.hpp>
+
+using namespace raintk;
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+
+    auto frame_pacer = scene->GetFramePacer();
+    frame_pacer->SetMaxFramesInFlight(0);
+    assert(frame_pacer->GetMaxFramesInFlight() == 1);
+    frame_pacer->SetMaxFramesInFlight(2);
+
+    // Without any completed frames, updates start immediately
+    TimePoint const now = std::chrono::high_resolution_clock::now();
+    assert(frame_pacer->GetNextUpdateTime() >= now);
+    assert(frame_pacer->GetNextUpdateTime() <= now+Milliseconds(1));
+    (void)now;
+
+    // A cursor that follows the mouse; the lag between the
+    // pointer and the cursor should be small with late updates
+    auto mouse_area = MakeWidget<MouseArea>(scene,root);
+    mouse_area->width = root->width.Get();
+    mouse_area->height = root->height.Get();
+    mouse_area->hover = true;
+
+    auto cursor = MakeWidget<Rectangle>(scene,root);
+    cursor->width = mm(5);
+    cursor->height = mm(5);
+    cursor->color = glm::u8vec4(255,80,80,255);
+    cursor->x.Bind([&](){
+        return mouse_area->mouse.Get().x - 0.5f*cursor->width.Get();
+    });
+    cursor->y.Bind([&](){
+        return mouse_area->mouse.Get().y - 0.5f*cursor->height.Get();
+    });
+
+    // Toggle late updates every few seconds to compare
+    bool late_update = true;
+    uint ticks = 0;
+
+    ks::shared_ptr<ks::CallbackTimer> metrics_timer =
+            ks::MakeObject<ks::CallbackTimer>(
+                scene->GetEventLoop(),
+                ks::Milliseconds(1000),
+                [&]()
+                {
+                    auto const metrics = frame_pacer->GetMetrics();
+                    assert(metrics.frames_in_flight <= 2);
+
+                    rtklog.Trace() << "late update: " << late_update
+                                   << ", frame: " << metrics.avg_frame_time_ms
+                                   << "ms, cpu: " << metrics.avg_cpu_cost_ms
+                                   << "ms, input latency: " << metrics.avg_input_latency_ms
+                                   << "ms, in flight: " << metrics.frames_in_flight;
+
+                    if(++ticks % 5 == 0)
+                    {
+                        late_update = !late_update;
+                        frame_pacer->SetLateUpdateEnabled(late_update);
+                    }
+                });
+
+    metrics_timer->Start();
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <ks/shared/KsImage.hpp>
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkTextureShadow.hpp>
+#include <raintk/RainTkGlyphPageStore.hpp>
+
+using namespace raintk;
+
+namespace
+{
+    void WaitForSave(GlyphPageStore const &store)
+    {
+        while(store.GetIsSaving())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+
+    std::string const path = "raintk_test_glyph_page_store.bin";
+    std::remove(path.c_str());
+
+    uint const atlas_size_px = 64;
+    u64 const font_hash = 1234;
+
+    std::map<uint,unique_ptr<TextureShadow>> lkup_shadows;
+    lkup_shadows[0] = make_unique<TextureShadow>(atlas_size_px,atlas_size_px);
+    lkup_shadows[2] = make_unique<TextureShadow>(atlas_size_px,atlas_size_px);
+
+    ks::Image<ks::R8> glyph(8,8,ks::R8{200});
+    auto glyph_data = glyph.ConvertToImageDataPtr();
+    lkup_shadows[0]->Write(glm::u16vec2(0,0),*glyph_data);
+    lkup_shadows[2]->Write(glm::u16vec2(8,16),*glyph_data);
+
+    // Nothing saved yet
+    {
+        GlyphPageStore store(path,atlas_size_px,32,4,font_hash);
+        assert(store.GetPageCount() == 0);
+        assert(store.GetPage(0) == nullptr);
+
+        assert(store.Save(lkup_shadows));
+        WaitForSave(store);
+    }
+
+    // The pages are loaded back as they were saved
+    {
+        GlyphPageStore store(path,atlas_size_px,32,4,font_hash);
+        assert(store.GetPageCount() == 2);
+        assert(store.GetPage(1) == nullptr);
+
+        for(auto const &shadow_it : lkup_shadows)
+        {
+            u8 const * page = store.GetPage(shadow_it.first);
+            assert(page != nullptr);
+            assert(std::memcmp(page,
+                               shadow_it.second->GetData(),
+                               atlas_size_px*atlas_size_px) == 0);
+            (void)page;
+        }
+
+        // Saving only some of the atlases keeps the
+        // pages of the others
+        std::map<uint,unique_ptr<TextureShadow>> lkup_new_shadows;
+        lkup_new_shadows[1] = make_unique<TextureShadow>(atlas_size_px,atlas_size_px);
+        lkup_new_shadows[1]->Write(glm::u16vec2(32,32),*glyph_data);
+
+        assert(store.Save(lkup_new_shadows));
+        WaitForSave(store);
+    }
+
+    {
+        GlyphPageStore store(path,atlas_size_px,32,4,font_hash);
+        assert(store.GetPageCount() == 3);
+
+        TextureShadow shadow(atlas_size_px,atlas_size_px);
+        shadow.Load(store.GetPage(2));
+        assert(shadow.GetMatches(glm::u16vec2(8,16),*glyph_data));
+        assert(!shadow.GetIsDirty());
+    }
+
+    // A different font hash or SDF size ignores the file
+    {
+        GlyphPageStore store(path,atlas_size_px,32,4,font_hash+1);
+        assert(store.GetPageCount() == 0);
+    }
+    {
+        GlyphPageStore store(path,atlas_size_px,32,8,font_hash);
+        assert(store.GetPageCount() == 0);
+    }
+
+    std::remove(path.c_str());
+
+    rtklog.Trace() << "GlyphPageStore: OK";
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}
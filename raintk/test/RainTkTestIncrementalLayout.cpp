@@ -0,0 +1,213 @@
+/*
+  Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <cmath>
+#include <algorithm>
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkRectangle.hpp>
+#include <raintk/RainTkColumn.hpp>
+#include <raintk/RainTkRow.hpp>
+#include <raintk/RainTkGrid.hpp>
+
+using namespace raintk;
+
+namespace
+{
+    // Offsets are accumulated so allow for some rounding
+    bool IsNear(float a, float b)
+    {
+        return (std::fabs(a-b) < 0.001f*std::max(1.0f,std::fabs(b)));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+
+    auto root = c.scene->GetRootWidget();
+    auto scene = c.scene.get();
+
+    // Column
+    auto column = MakeWidget<Column>(scene,root);
+    column->spacing = mm(1);
+
+    std::size_t const item_count = 2000;
+    std::vector<shared_ptr<Rectangle>> list_items;
+    std::vector<uint> list_y_count(item_count,0);
+
+    for(std::size_t i=0; i < item_count; i++)
+    {
+        auto item = MakeWidget<Rectangle>(scene,column);
+        item->width = mm(10);
+        item->height = mm(2);
+
+        item->y.signal_changed.Connect(
+                    [&list_y_count,i](){ list_y_count[i]++; });
+
+        list_items.push_back(item);
+    }
+
+    column->UpdateHierarchy();
+
+    assert(IsNear(column->children_height.Get(),item_count*mm(3)-mm(1)));
+    assert(IsNear(list_items.back()->y.Get(),(item_count-1)*mm(3)));
+
+    // Resizing an item should only move the items after it
+    std::fill(list_y_count.begin(),list_y_count.end(),0);
+
+    std::size_t const resized_index = 1500;
+    list_items[resized_index]->height = mm(4);
+    column->UpdateHierarchy();
+
+    for(std::size_t i=0; i < item_count; i++)
+    {
+        assert(list_y_count[i] == ((i > resized_index) ? 1 : 0));
+    }
+
+    assert(IsNear(list_items.back()->y.Get(),(item_count-1)*mm(3)+mm(2)));
+
+    // Widening one item updates children_width without
+    // moving anything
+    std::fill(list_y_count.begin(),list_y_count.end(),0);
+
+    list_items[10]->width = mm(20);
+    column->UpdateHierarchy();
+
+    assert(IsNear(column->children_width.Get(),mm(20)));
+    for(auto count : list_y_count)
+    {
+        assert(count == 0);
+    }
+
+    list_items[10]->width = mm(10);
+    column->UpdateHierarchy();
+    assert(IsNear(column->children_width.Get(),mm(10)));
+
+    // Removing the last item shouldn't move anything
+    std::fill(list_y_count.begin(),list_y_count.end(),0);
+
+    column->RemoveChild(list_items.back());
+    list_items.pop_back();
+    column->UpdateHierarchy();
+
+    for(auto count : list_y_count)
+    {
+        assert(count == 0);
+    }
+
+    // Row
+    auto row = MakeWidget<Row>(scene,root);
+    row->y = mm(20);
+
+    std::vector<shared_ptr<Rectangle>> list_row_items;
+    for(uint i=0; i < 5; i++)
+    {
+        auto item = MakeWidget<Rectangle>(scene,row);
+        item->width = mm(5);
+        item->height = mm(5+i);
+        list_row_items.push_back(item);
+    }
+
+    row->UpdateHierarchy();
+    assert(IsNear(row->children_width.Get(),mm(25)));
+    assert(IsNear(row->children_height.Get(),mm(9)));
+
+    // Removing the tallest item rescans the height
+    row->RemoveChild(list_row_items.back());
+    list_row_items.pop_back();
+    row->UpdateHierarchy();
+
+    assert(IsNear(row->children_width.Get(),mm(20)));
+    assert(IsNear(row->children_height.Get(),mm(8)));
+
+    // Right to left
+    row->layout_direction = Row::LayoutDirection::RightToLeft;
+    row->UpdateHierarchy();
+    assert(IsNear(list_row_items[0]->x.Get(),mm(15)));
+    assert(IsNear(list_row_items[3]->x.Get(),0));
+
+    // Grid
+    auto grid = MakeWidget<Grid>(scene,root);
+    grid->y = mm(40);
+    grid->cols = 10;
+
+    std::size_t const grid_item_count = 200;
+    std::vector<shared_ptr<Rectangle>> list_grid_items;
+    std::vector<uint> list_xy_count(grid_item_count,0);
+
+    for(std::size_t i=0; i < grid_item_count; i++)
+    {
+        auto item = MakeWidget<Rectangle>(scene,grid);
+        item->width = mm(2);
+        item->height = mm(2);
+
+        item->x.signal_changed.Connect(
+                    [&list_xy_count,i](){ list_xy_count[i]++; });
+
+        item->y.signal_changed.Connect(
+                    [&list_xy_count,i](){ list_xy_count[i]++; });
+
+        list_grid_items.push_back(item);
+    }
+
+    grid->UpdateHierarchy();
+    assert(IsNear(grid->children_width.Get(),mm(20)));
+    assert(IsNear(grid->children_height.Get(),mm(40)));
+
+    // Making an item taller should only move the rows
+    // after it
+    std::fill(list_xy_count.begin(),list_xy_count.end(),0);
+
+    list_grid_items[155]->height = mm(3);
+    grid->UpdateHierarchy();
+
+    for(std::size_t i=0; i < grid_item_count; i++)
+    {
+        assert(list_xy_count[i] == ((i >= 160) ? 1 : 0));
+    }
+
+    assert(IsNear(grid->children_height.Get(),mm(41)));
+
+    // Making it shorter again rescans its row
+    list_grid_items[155]->height = mm(2);
+    grid->UpdateHierarchy();
+    assert(IsNear(grid->children_height.Get(),mm(40)));
+    assert(IsNear(list_grid_items.back()->y.Get(),mm(38)));
+
+    // Widening an item in the last column doesn't move
+    // anything else
+    std::fill(list_xy_count.begin(),list_xy_count.end(),0);
+
+    list_grid_items[19]->width = mm(4);
+    grid->UpdateHierarchy();
+
+    for(auto count : list_xy_count)
+    {
+        assert(count == 0);
+    }
+
+    assert(IsNear(grid->children_width.Get(),mm(22)));
+
+    rtklog.Trace() << "IncrementalLayout: OK";
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}
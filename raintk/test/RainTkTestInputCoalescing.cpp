@@ -0,0 +1,245 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkInputArea.hpp>
+#include <raintk/RainTkInputSystem.hpp>
+#include <raintk/RainTkAnimationSystem.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
+
+namespace raintk
+{
+    // =========================================================== //
+
+    class InputLog : public InputArea
+    {
+    public:
+        using base_type = raintk::InputArea;
+
+        InputLog(ks::Object::Key const &key,
+                 Scene* scene,
+                 shared_ptr<Widget> parent) :
+            InputArea(key,scene,parent)
+        {}
+
+        void Init(ks::Object::Key const &,
+                  shared_ptr<InputLog> const &)
+        {}
+
+        ~InputLog()
+        {}
+
+        std::vector<Point> list_points;
+
+    private:
+        Response handleInput(Point const &pt_local,bool inside) override
+        {
+            if(!inside)
+            {
+                return Response::Ignore;
+            }
+
+            list_points.push_back(pt_local);
+            return Response::Accept;
+        }
+
+        void cancelInput() override
+        {}
+    };
+
+    // =========================================================== //
+}
+
+using namespace raintk;
+
+namespace
+{
+    using Type = InputArea::Point::Type;
+    using Action = InputArea::Point::Action;
+
+    struct ReplayPoint
+    {
+        uint frame;
+        Type type;
+        Action action;
+        float x;
+    };
+
+    // Writes points in the format InputSystem::StartInputPlayback
+    // reads: frame,frame time,timestamp,type,button,action,x,y
+    void WriteReplay(std::string const &path,
+                     std::vector<ReplayPoint> const &list_points)
+    {
+        std::ofstream file(path);
+        file << std::setprecision(9);
+
+        uint timestamp_ms=1000;
+        for(auto const &point : list_points)
+        {
+            file << point.frame << ","
+                 << 1000+point.frame*16 << ","
+                 << timestamp_ms++ << ","
+                 << static_cast<uint>(point.type) << ","
+                 << static_cast<uint>(InputArea::Point::Button::None) << ","
+                 << static_cast<uint>(point.action) << ","
+                 << point.x << ","
+                 << mm(10) << "\n";
+        }
+    }
+
+    bool Near(float a, float b)
+    {
+        return (fabs(a-b) < 1E-3);
+    }
+
+    std::vector<InputArea::Point> GetPointsOfType(
+            std::vector<InputArea::Point> const &list_points,
+            Type type)
+    {
+        std::vector<InputArea::Point> list_type_points;
+        for(auto const &point : list_points)
+        {
+            if(point.type == type)
+            {
+                list_type_points.push_back(point);
+            }
+        }
+
+        return list_type_points;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+
+    auto input_log = MakeWidget<InputLog>(scene,root);
+    input_log->width = mm(100);
+    input_log->height = mm(50);
+
+    // Frame 1 has hover moves, then a drag with a high rate
+    // mouse interleaved with a touch point. Frame 2 is outside
+    // of the InputLog so the end of the replay is ignored.
+    std::vector<ReplayPoint> list_replay_points;
+    for(uint i=0; i < 3; i++)
+    {
+        list_replay_points.push_back({1,Type::Mouse,Action::None,mm(1+i)});
+    }
+
+    list_replay_points.push_back({1,Type::Mouse,Action::Press,mm(5)});
+    list_replay_points.push_back({1,Type::Touch0,Action::Press,mm(40)});
+
+    for(uint i=0; i < 30; i++)
+    {
+        list_replay_points.push_back({1,Type::Mouse,Action::None,mm(5)+mm(0.5f)*i});
+        if(i%3 == 0)
+        {
+            list_replay_points.push_back({1,Type::Touch0,Action::None,mm(40)+mm(0.5f)*i});
+        }
+    }
+
+    list_replay_points.push_back({1,Type::Mouse,Action::Release,mm(20)});
+    list_replay_points.push_back({2,Type::Mouse,Action::None,mm(200)});
+
+    std::string const path = "raintk_test_input_coalescing.txt";
+    WriteReplay(path,list_replay_points);
+
+    scene->GetInputSystem()->StartInputPlayback(path);
+
+    // Run the systems in the same order as Scene::onUpdate
+    TimePoint t0 = std::chrono::high_resolution_clock::now();
+    for(uint f=0; f < 6; f++)
+    {
+        TimePoint const t1 = t0+Milliseconds(16);
+        scene->GetInputSystem()->Update(t0,t1);
+        scene->GetAnimationSystem()->Update(t0,t1);
+        scene->GetTransformSystem()->Update(t0,t1);
+        t0 = t1;
+    }
+
+    scene->GetInputSystem()->StopInputPlayback();
+    std::remove(path.c_str());
+
+    // Each run of moves is coalesced into its last move
+    // and presses and releases are kept in order
+    auto const list_mouse_points = GetPointsOfType(input_log->list_points,Type::Mouse);
+    assert(list_mouse_points.size() == 4);
+    assert(list_mouse_points[0].action == Action::None);
+    assert(Near(list_mouse_points[0].x,mm(3)));
+    assert(list_mouse_points[1].action == Action::Press);
+    assert(list_mouse_points[2].action == Action::None);
+    assert(Near(list_mouse_points[2].x,mm(5)+mm(0.5f)*29));
+    assert(list_mouse_points[3].action == Action::Release);
+
+    auto const list_touch_points = GetPointsOfType(input_log->list_points,Type::Touch0);
+    assert(list_touch_points.size() == 2);
+    assert(list_touch_points[0].action == Action::Press);
+    assert(list_touch_points[1].action == Action::None);
+    assert(Near(list_touch_points[1].x,mm(40)+mm(0.5f)*27));
+
+    (void)list_mouse_points;
+    (void)list_touch_points;
+
+    rtklog.Trace() << "InputCoalescing: OK";
+
+    // Moving the mouse over the window logs how many raw
+    // samples each dispatched move stands for
+    input_log->list_points.clear();
+    input_log->width = px(c.window->GetSize().first);
+    input_log->height = px(c.window->GetSize().second);
+
+    auto timer =
+            ks::MakeObject<ks::CallbackTimer>(
+                scene->GetEventLoop(),
+                Milliseconds(500),
+                [&](){
+                    if(input_log->list_points.empty())
+                    {
+                        return;
+                    }
+
+                    auto const &last_point = input_log->list_points.back();
+
+                    std::vector<InputArea::Point> list_samples;
+                    scene->GetInputSystem()->GetInputHistory(
+                                last_point.type,
+                                last_point.timestamp-Milliseconds(16),
+                                last_point.timestamp,
+                                list_samples);
+
+                    rtklog.Trace() << input_log->list_points.size()
+                                   << " points dispatched, "
+                                   << list_samples.size()
+                                   << " raw samples in the last frame";
+
+                    input_log->list_points.clear();
+                });
+
+    timer->SetRepeating(true);
+    timer->Start();
+
+    c.app->Run();
+
+    return 0;
+}
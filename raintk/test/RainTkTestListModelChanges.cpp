@@ -0,0 +1,356 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkListModelSTLVector.hpp>
+#include <raintk/RainTkListDelegate.hpp>
+#include <raintk/RainTkListView.hpp>
+#include <raintk/RainTkRectangle.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
+
+// =========================================================== //
+// =========================================================== //
+
+namespace raintk
+{
+    class TestDelegate;
+}
+
+namespace
+{
+    uint g_created_count=0;
+    uint g_destroyed_count=0;
+
+    // The delegate for each model index that has one
+    std::map<uint,raintk::TestDelegate*> g_lkup_delegates;
+}
+
+namespace raintk
+{
+    struct TestItem
+    {
+        uint value;
+    };
+
+    class TestDelegate : public ListDelegate
+    {
+    public:
+        TestDelegate(ks::Object::Key const &key,
+                     Scene* scene,
+                     shared_ptr<Widget> parent) :
+            ListDelegate(key,scene,parent),
+            m_index(0),
+            m_has_index(false),
+            m_value(0)
+        {
+            g_created_count++;
+        }
+
+        void Init(ks::Object::Key const &,
+                  shared_ptr<TestDelegate> const &this_delegate)
+        {
+            m_rect = MakeWidget<Rectangle>(m_scene,this_delegate);
+            m_rect->width = this->GetParent()->width.Get();
+            m_rect->height = mm(10);
+
+            width = m_rect->width.Get();
+            height = m_rect->height.Get();
+        }
+
+        ~TestDelegate()
+        {
+            g_destroyed_count++;
+            forget();
+        }
+
+        void SetIndex(uint index)
+        {
+            forget();
+            m_index = index;
+            m_has_index = true;
+            g_lkup_delegates[m_index] = this;
+        }
+
+        uint GetIndex() const
+        {
+            return m_index;
+        }
+
+        void SetData(TestItem const &item)
+        {
+            m_value = item.value;
+        }
+
+        uint GetValue() const
+        {
+            return m_value;
+        }
+
+    private:
+        void forget()
+        {
+            if(m_has_index)
+            {
+                auto it = g_lkup_delegates.find(m_index);
+                if(it != g_lkup_delegates.end() && it->second == this)
+                {
+                    g_lkup_delegates.erase(it);
+                }
+            }
+        }
+
+        uint m_index;
+        bool m_has_index;
+        uint m_value;
+        shared_ptr<Rectangle> m_rect;
+    };
+}
+
+// =========================================================== //
+// =========================================================== //
+
+using namespace raintk;
+
+namespace
+{
+    void TestChangeSet()
+    {
+        // Adjacent changes are merged
+        ListModelChangeSet change_set;
+        change_set.AddInsert(10,1);
+        change_set.AddInsert(11,1);
+        change_set.AddInsert(10,2);
+        change_set.AddRemove(30,31);
+        change_set.AddRemove(30,32);
+        change_set.AddRemove(28,30);
+        change_set.AddUpdate(4);
+        change_set.AddUpdate(5);
+        change_set.AddUpdate(3);
+
+        auto const &list_changes = change_set.GetChanges();
+        assert(list_changes.size() == 3);
+
+        assert(list_changes[0].type == ListModelChange::Type::Insert);
+        assert(list_changes[0].index == 10);
+        assert(list_changes[0].count == 4);
+
+        assert(list_changes[1].type == ListModelChange::Type::Remove);
+        assert(list_changes[1].index == 28);
+        assert(list_changes[1].count == 5);
+
+        assert(list_changes[2].type == ListModelChange::Type::Update);
+        assert(list_changes[2].index == 3);
+        assert(list_changes[2].count == 3);
+        (void)list_changes;
+
+        // Mapping indices
+        auto map_index =
+                [&](uint index, bool& updated) -> sint
+                {
+                    updated = false;
+                    return change_set.MapIndex(index,updated) ? sint(index) : -1;
+                };
+
+        bool updated=false;
+        assert(map_index(3,updated) == 3 && updated);
+        assert(map_index(9,updated) == 9 && !updated);
+        assert(map_index(10,updated) == 14 && !updated);
+        assert(map_index(23,updated) == 27);
+        assert(map_index(24,updated) == -1);
+        assert(map_index(28,updated) == -1);
+        assert(map_index(29,updated) == 28);
+        (void)map_index;
+        (void)updated;
+
+        // Moves
+        ListModelChangeSet move_set;
+        move_set.AddMove(5,7,1); // [0,5,6,1,2,3,4,7..]
+
+        uint index=0;
+        bool moved_updated=false;
+        uint const expect[] = {0,3,4,5,6,1,2,7};
+        for(uint i=0; i < 8; i++)
+        {
+            index = i;
+            bool ok = move_set.MapIndex(index,moved_updated);
+            assert(ok && index == expect[i]);
+            (void)ok;
+        }
+        (void)expect;
+        (void)moved_updated;
+    }
+
+    void TestModel()
+    {
+        auto list_model = make_shared<ListModelSTLVector<TestItem>>();
+
+        uint item_signal_count=0;
+        list_model->signal_added_items.Connect(
+                    [&](uint,uint){ item_signal_count++; },
+                    nullptr,
+                    ks::ConnectionType::Direct);
+
+        list_model->signal_data_changed.Connect(
+                    [&](uint){ item_signal_count++; },
+                    nullptr,
+                    ks::ConnectionType::Direct);
+
+        std::vector<shared_ptr<ListModelChangeSet const>> list_change_sets;
+        list_model->signal_changes.Connect(
+                    [&](shared_ptr<ListModelChangeSet const> change_set){
+                        list_change_sets.push_back(change_set);
+                    },
+                    nullptr,
+                    ks::ConnectionType::Direct);
+
+        // A batch of appends is emitted as a single insert
+        list_model->BeginChanges();
+        for(uint i=0; i < 500; i++)
+        {
+            list_model->PushBack(TestItem{i});
+        }
+        list_model->SetData(250,TestItem{1000});
+        list_model->EndChanges();
+
+        assert(item_signal_count == 0);
+        assert(list_change_sets.size() == 1);
+        assert(list_change_sets[0]->GetChanges().size() == 2);
+        assert(list_change_sets[0]->GetChanges()[0].count == 500);
+
+        // Outside of a batch the item signals are used...
+        list_model->SetData(0,TestItem{0});
+        assert(item_signal_count == 1);
+        assert(list_change_sets.size() == 1);
+
+        // ...except for moves
+        list_model->Move(10,12,2);
+        assert(list_change_sets.size() == 2);
+        assert(list_model->GetData(2).value == 10);
+        assert(list_model->GetData(3).value == 11);
+        assert(list_model->GetData(4).value == 2);
+        assert(list_model->GetData(12).value == 12);
+
+        list_model->Move(2,4,10);
+        for(uint i=0; i < 20; i++)
+        {
+            assert(list_model->GetData(i).value == i);
+        }
+
+        // Unbalanced EndChanges
+        bool threw=false;
+        try
+        {
+            list_model->EndChanges();
+        }
+        catch(ListModelInvalidChanges const &)
+        {
+            threw = true;
+        }
+        assert(threw);
+        (void)threw;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestChangeSet();
+    TestModel();
+
+    TestContext c(600,800);
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+
+    auto update =
+            [scene]()
+            {
+                TimePoint const t = std::chrono::high_resolution_clock::now();
+                scene->GetTransformSystem()->Update(t,t);
+            };
+
+    auto list_model = make_shared<ListModelSTLVector<TestItem>>();
+    for(uint i=0; i < 100; i++)
+    {
+        list_model->PushBack(TestItem{i});
+    }
+
+    auto list_view =
+            MakeWidget<ListView<TestItem,TestDelegate>>(
+                scene,root);
+
+    list_view->width = mm(60);
+    list_view->height = mm(100);
+    list_view->SetPrefetchBudget(Milliseconds(100));
+    list_view->SetListModel(list_model);
+    update();
+
+    uint const delegate_count = list_view->GetDelegateCount();
+    assert(delegate_count == g_lkup_delegates.size());
+    assert(g_lkup_delegates.count(0) == 1);
+    assert(g_lkup_delegates.count(9) == 1);
+
+    TestDelegate* delegate_3 = g_lkup_delegates[3];
+    TestDelegate* delegate_6 = g_lkup_delegates[6];
+    TestDelegate* delegate_7 = g_lkup_delegates[7];
+
+    uint const created_count = g_created_count;
+    uint const destroyed_count = g_destroyed_count;
+
+    // Apply a diff as a single change set
+    list_model->BeginChanges();
+    list_model->Erase(2);
+    list_model->Insert(5,TestItem{500});
+    list_model->SetData(7,TestItem{700});
+    list_model->EndChanges();
+
+    // Only the new item got a delegate and only the removed
+    // item's delegate was destroyed
+    assert(g_created_count == created_count+1);
+    assert(g_destroyed_count == destroyed_count+1);
+    assert(list_view->GetDelegateCount() == delegate_count);
+
+    // The other delegates were kept and moved
+    assert(g_lkup_delegates[2] == delegate_3);
+    assert(g_lkup_delegates[6] == delegate_6);
+    assert(g_lkup_delegates[7] == delegate_7);
+    assert(g_lkup_delegates[7]->GetValue() == 700);
+    assert(g_lkup_delegates[5]->GetValue() == 500);
+
+    for(uint i=0; i < 10; i++)
+    {
+        assert(fabs(g_lkup_delegates[i]->y.Get()-i*mm(10)) < 1E-3);
+    }
+
+    update();
+    assert(list_view->GetDelegateCount() == delegate_count);
+    (void)delegate_count;
+    (void)delegate_3;
+    (void)delegate_6;
+    (void)delegate_7;
+    (void)created_count;
+    (void)destroyed_count;
+
+    rtklog.Trace() << "ListModelChanges: OK";
+
+    root->width = px(c.window->GetSize().first);
+    root->height = px(c.window->GetSize().second);
+
+    c.app->Run();
+
+    return 0;
+}
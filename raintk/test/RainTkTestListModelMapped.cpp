@@ -0,0 +1,173 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <cstdio>
+#include <fstream>
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkListModelMapped.hpp>
+
+using namespace raintk;
+
+namespace
+{
+    struct AuditRecord
+    {
+        u32 id;
+        u32 severity;
+        s64 time_ms;
+        ListModelMappedString message;
+    };
+
+    // The file starts with a header of this size, followed
+    // by the records and then the strings they reference
+    u64 const header_size = 64;
+
+    std::string MakeMessage(uint i)
+    {
+        return "event "+std::to_string(i)+std::string(i%7,'!');
+    }
+
+    void WriteAuditLog(std::string const &path, uint record_count)
+    {
+        std::ofstream file(path,std::ios::binary);
+
+        std::vector<char> header(header_size,0);
+        file.write(header.data(),header.size());
+
+        u64 string_offset = header_size+u64(record_count)*sizeof(AuditRecord);
+        for(uint i=0; i < record_count; i++)
+        {
+            AuditRecord record;
+            record.id = i;
+            record.severity = i%4;
+            record.time_ms = s64(i)*1000;
+            record.message.offset = string_offset;
+            record.message.size = MakeMessage(i).size();
+            string_offset += record.message.size;
+
+            file.write(reinterpret_cast<char const*>(&record),sizeof(record));
+        }
+
+        for(uint i=0; i < record_count; i++)
+        {
+            std::string const message = MakeMessage(i);
+            file.write(message.data(),message.size());
+        }
+    }
+
+    template<typename Fn>
+    bool Throws(Fn fn)
+    {
+        try
+        {
+            fn();
+        }
+        catch(ListModelMappedFileError const &)
+        {
+            return true;
+        }
+        return false;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+
+    std::string const path = "raintk_test_list_model_mapped.bin";
+    uint const record_count = 1000000;
+    WriteAuditLog(path,record_count);
+
+    {
+        auto const t0 = std::chrono::high_resolution_clock::now();
+
+        auto list_model =
+                make_shared<ListModelMapped<AuditRecord>>(
+                    path,header_size,record_count);
+
+        auto const t1 = std::chrono::high_resolution_clock::now();
+
+        rtklog.Trace() << "opened " << record_count << " records in "
+                       << ks::CalcDuration<Microseconds>(t0,t1).count()
+                       << "us";
+
+        assert(list_model->GetSize() == record_count);
+
+        // Records are read straight from the mapping
+        auto const &first = list_model->GetData(0);
+        auto const &second = list_model->GetData(1);
+        assert(reinterpret_cast<u8 const*>(&second)-
+               reinterpret_cast<u8 const*>(&first) == sizeof(AuditRecord));
+        (void)first;
+        (void)second;
+
+        for(uint i : {0u,1u,6u,500000u,record_count-1})
+        {
+            auto const &record = list_model->GetData(i);
+            assert(record.id == i);
+            assert(record.severity == i%4);
+            assert(record.time_ms == s64(i)*1000);
+            assert(list_model->GetString(record.message) == MakeMessage(i));
+            (void)record;
+        }
+
+        list_model->SetViewRange(1000,1020);
+
+        // Read only
+        bool const read_only =
+                [&](){
+                    try
+                    {
+                        list_model->SetData(0,AuditRecord());
+                    }
+                    catch(ListModelItemsAreReadOnly const &)
+                    {
+                        return true;
+                    }
+                    return false;
+                }();
+        assert(read_only);
+        (void)read_only;
+
+        // Strings outside of the file
+        ListModelMappedString bad_string{u64(1) << 40,4};
+        assert(Throws([&](){ list_model->GetString(bad_string); }));
+        (void)bad_string;
+    }
+
+    // Without a count the records run to the end of the file
+    {
+        ListModelMapped<AuditRecord> list_model(path,header_size);
+        assert(list_model.GetSize() >= record_count);
+        assert(list_model.GetData(record_count-1).id == record_count-1);
+        (void)list_model;
+    }
+
+    assert(Throws([&](){ ListModelMapped<AuditRecord>(path,4); }));
+    assert(Throws([&](){ ListModelMapped<AuditRecord>(path,header_size,record_count*2); }));
+    assert(Throws([&](){ ListModelMapped<AuditRecord>("raintk_test_missing.bin"); }));
+
+    std::remove(path.c_str());
+
+    rtklog.Trace() << "ListModelMapped: OK";
+
+    c.app->Run();
+
+    return 0;
+}
@@ -0,0 +1,289 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkListModelPaged.hpp>
+#include <raintk/RainTkListDelegate.hpp>
+#include <raintk/RainTkListView.hpp>
+#include <raintk/RainTkRectangle.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
+
+// =========================================================== //
+// =========================================================== //
+
+namespace
+{
+    // The value shown by the delegate for each model index
+    std::map<uint,sint> g_lkup_values;
+}
+
+namespace raintk
+{
+    struct TestItem
+    {
+        sint value;
+    };
+
+    class TestDelegate : public ListDelegate
+    {
+    public:
+        TestDelegate(ks::Object::Key const &key,
+                     Scene* scene,
+                     shared_ptr<Widget> parent) :
+            ListDelegate(key,scene,parent),
+            m_index(0)
+        {}
+
+        void Init(ks::Object::Key const &,
+                  shared_ptr<TestDelegate> const &this_delegate)
+        {
+            m_rect = MakeWidget<Rectangle>(m_scene,this_delegate);
+            m_rect->width = this->GetParent()->width.Get();
+            m_rect->height = mm(10);
+
+            width = m_rect->width.Get();
+            height = m_rect->height.Get();
+        }
+
+        void SetIndex(uint index)
+        {
+            m_index = index;
+        }
+
+        uint GetIndex() const
+        {
+            return m_index;
+        }
+
+        void SetData(TestItem const &item)
+        {
+            g_lkup_values[m_index] = item.value;
+        }
+
+    private:
+        uint m_index;
+        shared_ptr<Rectangle> m_rect;
+    };
+
+    // Reads fixed size records from a file
+    class TestFileSource : public ListModelPageSource<TestItem>
+    {
+    public:
+        TestFileSource(std::string path, uint size) :
+            m_path(std::move(path)),
+            m_size(size)
+        {}
+
+        uint GetSize() override
+        {
+            return m_size;
+        }
+
+        void Fetch(uint idx_first,
+                   uint idx_end,
+                   std::vector<TestItem>& list_items) override
+        {
+            std::ifstream file(m_path,std::ios::binary);
+            file.seekg(idx_first*sizeof(sint));
+
+            for(uint i=idx_first; i < idx_end; i++)
+            {
+                sint value;
+                file.read(reinterpret_cast<char*>(&value),sizeof(sint));
+                list_items.push_back(TestItem{value});
+            }
+        }
+
+    private:
+        std::string const m_path;
+        uint const m_size;
+    };
+}
+
+// =========================================================== //
+// =========================================================== //
+
+using namespace raintk;
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c(600,800);
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+
+    // Write out the records
+    std::string const path = "raintk_test_list_model_paged.bin";
+    uint const item_count = 10000;
+    {
+        std::ofstream file(path,std::ios::binary);
+        for(uint i=0; i < item_count; i++)
+        {
+            sint const value = i*3;
+            file.write(reinterpret_cast<char const*>(&value),sizeof(sint));
+        }
+    }
+
+    // Runs the scene's event loop until @done returns
+    // true, or gives up after a few seconds
+    auto wait_until =
+            [scene](std::function<bool()> done)
+            {
+                auto const t0 = std::chrono::high_resolution_clock::now();
+                while(!done())
+                {
+                    scene->GetEventLoop()->ProcessEvents();
+                    std::this_thread::sleep_for(Milliseconds(1));
+
+                    auto const t1 = std::chrono::high_resolution_clock::now();
+                    if(ks::CalcDuration<Milliseconds>(t0,t1).count() > 5000)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+    auto source = make_shared<TestFileSource>(path,item_count);
+
+    // Loading on demand
+    {
+        auto list_model =
+                make_shared<ListModelPaged<TestItem>>(
+                    scene->GetEventLoop(),
+                    source,
+                    TestItem{-1},
+                    50,
+                    4);
+
+        uint data_changed_count=0;
+        list_model->signal_data_changed.Connect(
+                    [&](uint){ data_changed_count++; },
+                    nullptr,
+                    ks::ConnectionType::Direct);
+
+        // Each loaded page is a single Update change
+        std::vector<ListModelChange> list_changes;
+        list_model->signal_changes.Connect(
+                    [&](shared_ptr<ListModelChangeSet const> change_set){
+                        for(auto const &change : change_set->GetChanges())
+                        {
+                            list_changes.push_back(change);
+                        }
+                    },
+                    nullptr,
+                    ks::ConnectionType::Direct);
+
+        assert(list_model->GetSize() == item_count);
+        assert(list_model->GetData(10).value == -1);
+        assert(!list_model->GetLoaded(10));
+
+        bool ok = wait_until([&](){ return list_model->GetLoaded(10); });
+        assert(ok);
+        assert(list_model->GetData(10).value == 30);
+        assert(list_model->GetData(49).value == 147);
+        assert(data_changed_count == 0);
+        assert(list_changes.size() == 1);
+        assert(list_changes[0].type == ListModelChange::Type::Update);
+        assert(list_changes[0].index == 0);
+        assert(list_changes[0].count == 50);
+
+        // The view range requests its pages and a page on
+        // either side of them
+        list_model->SetViewRange(500,520);
+        ok = wait_until([&](){ return list_model->GetLoadedPageCount() == 4; });
+        assert(ok);
+        assert(list_model->GetLoaded(450));
+        assert(list_model->GetLoaded(500));
+        assert(list_model->GetLoaded(550));
+
+        // Moving the view range far away evicts the least
+        // recently used pages outside of it
+        list_model->SetViewRange(5000,5020);
+        ok = wait_until([&](){ return list_model->GetLoaded(5050); });
+        assert(ok);
+        assert(list_model->GetLoadedPageCount() <= 4);
+        assert(list_model->GetLoaded(4950));
+        assert(list_model->GetLoaded(5000));
+        assert(!list_model->GetLoaded(10));
+        assert(list_model->GetData(5000).value == 15000);
+
+        // Requests that leave the view range before they're
+        // handed back are dropped
+        list_model->SetViewRange(7000,7020);
+        list_model->SetViewRange(9000,9020);
+        ok = wait_until([&](){ return list_model->GetLoaded(9050); });
+        assert(ok);
+        assert(!list_model->GetLoaded(7000));
+        (void)ok;
+    }
+
+    // Driven by a ListView
+    auto list_model =
+            make_shared<ListModelPaged<TestItem>>(
+                scene->GetEventLoop(),
+                source,
+                TestItem{-1},
+                16,
+                8);
+
+    auto list_view =
+            MakeWidget<ListView<TestItem,TestDelegate>>(
+                scene,root);
+
+    list_view->width = mm(60);
+    list_view->height = mm(100);
+    list_view->SetPrefetchBudget(Milliseconds(100));
+    list_view->SetListModel(list_model);
+
+    TimePoint const t = std::chrono::high_resolution_clock::now();
+    scene->GetTransformSystem()->Update(t,t);
+
+    // The delegates start out with the placeholder...
+    assert(g_lkup_values.size() > 0);
+    assert(g_lkup_values[0] == -1);
+
+    // ...and get the loaded data as pages arrive
+    bool ok = wait_until(
+                [&](){
+                    for(auto const &index_value : g_lkup_values)
+                    {
+                        if(index_value.second != sint(index_value.first*3))
+                        {
+                            return false;
+                        }
+                    }
+                    return true;
+                });
+    assert(ok);
+    (void)ok;
+
+    std::remove(path.c_str());
+
+    rtklog.Trace() << "ListModelPaged: OK";
+
+    root->width = px(c.window->GetSize().first);
+    root->height = px(c.window->GetSize().second);
+
+    c.app->Run();
+
+    return 0;
+}
@@ -0,0 +1,412 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkListModelSTLVector.hpp>
+#include <raintk/RainTkListModelSortFilterProxy.hpp>
+
+using namespace raintk;
+
+namespace
+{
+    struct Alarm
+    {
+        uint id;
+        uint priority;
+        std::string name;
+    };
+
+    using Proxy = ListModelSortFilterProxy<Alarm>;
+
+    // Follows a model only through the signals it emits, the
+    // way a view would, so the emitted changes can be checked
+    class ModelMirror
+    {
+    public:
+        ModelMirror(shared_ptr<ListModel<Alarm>> model) :
+            m_model(model)
+        {
+            for(uint i=0; i < m_model->GetSize(); i++)
+            {
+                m_list_ids.push_back(m_model->GetData(i).id);
+            }
+
+            m_model->signal_added_items.Connect(
+                        [this](uint first, uint end){
+                            for(uint i=first; i < end; i++)
+                            {
+                                m_list_ids.insert(
+                                            std::next(m_list_ids.begin(),i),
+                                            m_model->GetData(i).id);
+                            }
+                            signal_count++;
+                        },
+                        nullptr,
+                        ks::ConnectionType::Direct);
+
+            m_model->signal_before_removing_items.Connect(
+                        [this](uint first, uint end){
+                            m_list_ids.erase(
+                                        std::next(m_list_ids.begin(),first),
+                                        std::next(m_list_ids.begin(),end));
+                            signal_count++;
+                        },
+                        nullptr,
+                        ks::ConnectionType::Direct);
+
+            m_model->signal_data_changed.Connect(
+                        [this](uint){
+                            signal_count++;
+                        },
+                        nullptr,
+                        ks::ConnectionType::Direct);
+
+            m_model->signal_layout_changed.Connect(
+                        [this](){
+                            m_list_ids.clear();
+                            for(uint i=0; i < m_model->GetSize(); i++)
+                            {
+                                m_list_ids.push_back(m_model->GetData(i).id);
+                            }
+                            layout_count++;
+                        },
+                        nullptr,
+                        ks::ConnectionType::Direct);
+
+            m_model->signal_changes.Connect(
+                        [this](shared_ptr<ListModelChangeSet const> change_set){
+                            applyChanges(*change_set);
+                            change_set_count++;
+                        },
+                        nullptr,
+                        ks::ConnectionType::Direct);
+        }
+
+        bool Matches() const
+        {
+            if(m_list_ids.size() != m_model->GetSize())
+            {
+                return false;
+            }
+
+            for(uint i=0; i < m_list_ids.size(); i++)
+            {
+                if(m_list_ids[i] != m_model->GetData(i).id)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        uint signal_count{0};
+        uint layout_count{0};
+        uint change_set_count{0};
+
+    private:
+        void applyChanges(ListModelChangeSet const &change_set)
+        {
+            // Inserted items are unknown until the end
+            sint const unknown = -1;
+            std::vector<sint> list_ids(m_list_ids.begin(),m_list_ids.end());
+
+            for(auto const &change : change_set.GetChanges())
+            {
+                auto it_first = std::next(list_ids.begin(),change.index);
+                auto it_end = std::next(it_first,change.count);
+
+                switch(change.type)
+                {
+                    case ListModelChange::Type::Insert:
+                    {
+                        list_ids.insert(it_first,change.count,unknown);
+                        break;
+                    }
+                    case ListModelChange::Type::Remove:
+                    {
+                        list_ids.erase(it_first,it_end);
+                        break;
+                    }
+                    case ListModelChange::Type::Move:
+                    {
+                        std::vector<sint> list_moved(it_first,it_end);
+                        list_ids.erase(it_first,it_end);
+                        list_ids.insert(
+                                    std::next(list_ids.begin(),change.index_to),
+                                    list_moved.begin(),
+                                    list_moved.end());
+                        break;
+                    }
+                    case ListModelChange::Type::Update:
+                    {
+                        break;
+                    }
+                }
+            }
+
+            m_list_ids.clear();
+            for(uint i=0; i < list_ids.size(); i++)
+            {
+                m_list_ids.push_back(
+                            (list_ids[i]==unknown) ?
+                                m_model->GetData(i).id : list_ids[i]);
+            }
+        }
+
+        shared_ptr<ListModel<Alarm>> m_model;
+        std::vector<uint> m_list_ids;
+    };
+
+    bool ByPriority(Alarm const &a, Alarm const &b)
+    {
+        return a.priority < b.priority;
+    }
+
+    // Recalculates what the proxy should contain from scratch
+    bool CheckProxy(shared_ptr<ListModelSTLVector<Alarm>> const &source,
+                    shared_ptr<Proxy> const &proxy,
+                    std::function<bool(Alarm const &)> const &accept)
+    {
+        std::vector<Alarm> list_expected;
+        for(uint i=0; i < source->GetSize(); i++)
+        {
+            if(accept(source->GetData(i)))
+            {
+                list_expected.push_back(source->GetData(i));
+            }
+        }
+
+        std::stable_sort(list_expected.begin(),
+                         list_expected.end(),
+                         ByPriority);
+
+        if(list_expected.size() != proxy->GetSize())
+        {
+            return false;
+        }
+
+        for(uint i=0; i < list_expected.size(); i++)
+        {
+            if(list_expected[i].id != proxy->GetData(i).id)
+            {
+                return false;
+            }
+
+            uint const source_index = proxy->GetSourceIndex(i);
+            if(proxy->GetProxyIndex(source_index) != sint(i))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::string MakeName(uint i)
+    {
+        // Some pseudo random letters
+        std::string name;
+        uint x = i*2654435761u;
+        for(uint j=0; j < 6; j++)
+        {
+            name.push_back('a'+(x%26));
+            x /= 26;
+        }
+        return name;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+
+    // Incremental updates
+    {
+        auto source = make_shared<ListModelSTLVector<Alarm>>();
+        for(uint i=0; i < 50; i++)
+        {
+            source->PushBack(Alarm{i,(i*7)%10,MakeName(i)});
+        }
+
+        auto proxy = make_shared<Proxy>(source);
+        ModelMirror mirror(proxy);
+
+        auto accept_all = [](Alarm const &){ return true; };
+        auto accept_high = [](Alarm const &a){ return a.priority >= 5; };
+
+        // Sorting emits the reordering as Moves in a
+        // single change set
+        proxy->SetComparator(ByPriority);
+        assert(mirror.layout_count == 0);
+        assert(mirror.change_set_count == 1);
+        assert(CheckProxy(source,proxy,accept_all));
+        assert(mirror.Matches());
+
+        // Setting the same comparator again moves nothing
+        proxy->SetComparator(ByPriority);
+        assert(mirror.change_set_count == 1);
+        assert(mirror.Matches());
+
+        // Filtering emits a single change set
+        proxy->SetFilter(accept_high);
+        assert(mirror.change_set_count == 2);
+        assert(CheckProxy(source,proxy,accept_high));
+        assert(mirror.Matches());
+
+        // Source inserts and removes
+        source->Insert(10,Alarm{100,9,"x"});
+        source->Insert(0,Alarm{101,1,"y"}); // filtered out
+        source->Insert(20,3,Alarm{102,7,"z"});
+        assert(CheckProxy(source,proxy,accept_high));
+        assert(mirror.Matches());
+
+        source->Erase(5);
+        source->Erase(10,30);
+        assert(CheckProxy(source,proxy,accept_high));
+        assert(mirror.Matches());
+
+        // Data changes that move items, filter them
+        // in and filter them out
+        uint const signal_count = mirror.signal_count;
+        source->SetData(3,Alarm{source->GetData(3).id,9,"a"});
+        source->SetData(4,Alarm{source->GetData(4).id,0,"b"});
+        source->SetData(6,Alarm{source->GetData(6).id,6,"c"});
+        assert(mirror.signal_count > signal_count);
+        assert(CheckProxy(source,proxy,accept_high));
+        assert(mirror.Matches());
+        (void)signal_count;
+
+        // Writing through the proxy
+        proxy->SetData(0,Alarm{proxy->GetData(0).id,8,"d"});
+        assert(CheckProxy(source,proxy,accept_high));
+        assert(mirror.Matches());
+
+        // Widening and narrowing the filter
+        proxy->SetFilter(accept_all);
+        assert(CheckProxy(source,proxy,accept_all));
+        assert(mirror.Matches());
+
+        auto accept_top = [](Alarm const &a){ return a.priority >= 8; };
+        proxy->NarrowFilter(accept_top);
+        assert(CheckProxy(source,proxy,accept_top));
+        assert(mirror.Matches());
+
+        // Batched source changes are mapped to a single
+        // change set without rebuilding the proxy
+        uint const layout_count = mirror.layout_count;
+        uint const change_set_count = mirror.change_set_count;
+        source->BeginChanges();
+        source->Insert(0,Alarm{200,9,"e"});
+        source->Erase(3);
+        source->SetData(5,Alarm{source->GetData(5).id,9,"f"});
+        source->SetData(6,Alarm{source->GetData(6).id,1,"g"});
+        source->Insert(8,2,Alarm{201,8,"h"});
+        source->EndChanges();
+        assert(mirror.layout_count == layout_count);
+        assert(mirror.change_set_count == change_set_count+1);
+        assert(CheckProxy(source,proxy,accept_top));
+        assert(mirror.Matches());
+
+        // Source moves only change the order of equal items
+        source->Move(0,3,10);
+        assert(mirror.layout_count == layout_count);
+        assert(CheckProxy(source,proxy,accept_top));
+        assert(mirror.Matches());
+
+        source->BeginChanges();
+        source->Move(12,15,1);
+        source->SetData(1,Alarm{source->GetData(1).id,8,"i"});
+        source->Erase(0,2);
+        source->EndChanges();
+        assert(mirror.layout_count == layout_count);
+        assert(CheckProxy(source,proxy,accept_top));
+        assert(mirror.Matches());
+
+        // Changes that don't affect the accepted items
+        // don't emit anything
+        uint const unchanged_count = mirror.change_set_count;
+        source->BeginChanges();
+        source->SetData(source->GetSize()-1,Alarm{300,0,"j"});
+        source->Insert(0,Alarm{301,2,"k"});
+        source->EndChanges();
+        assert(mirror.change_set_count == unchanged_count);
+        assert(CheckProxy(source,proxy,accept_top));
+        assert(mirror.Matches());
+
+        // Clearing the comparator moves the items back
+        // into source order
+        proxy->SetComparator(nullptr);
+        assert(mirror.layout_count == layout_count);
+        assert(mirror.change_set_count == unchanged_count+1);
+        for(uint i=1; i < proxy->GetSize(); i++)
+        {
+            assert(proxy->GetSourceIndex(i-1) < proxy->GetSourceIndex(i));
+        }
+        assert(mirror.Matches());
+        (void)layout_count;
+        (void)change_set_count;
+        (void)unchanged_count;
+    }
+
+    // Live filtering of a large list
+    {
+        auto source = make_shared<ListModelSTLVector<Alarm>>();
+        source->Reserve(200000);
+
+        std::vector<Alarm> list_alarms;
+        list_alarms.reserve(200000);
+        for(uint i=0; i < 200000; i++)
+        {
+            list_alarms.push_back(Alarm{i,i%5,MakeName(i)});
+        }
+        source->Insert(0,list_alarms);
+
+        auto proxy = make_shared<Proxy>(source);
+        proxy->SetComparator(ByPriority);
+
+        std::string const search = MakeName(1234);
+        for(uint i=1; i <= search.size(); i++)
+        {
+            std::string const prefix = search.substr(0,i);
+
+            auto const t0 = std::chrono::high_resolution_clock::now();
+
+            proxy->NarrowFilter(
+                        [prefix](Alarm const &a){
+                            return (a.name.compare(0,prefix.size(),prefix) == 0);
+                        });
+
+            auto const t1 = std::chrono::high_resolution_clock::now();
+
+            rtklog.Trace() << "filter '" << prefix << "': "
+                           << proxy->GetSize() << " items in "
+                           << ks::CalcDuration<Microseconds>(t0,t1).count()/1000.0
+                           << "ms";
+        }
+
+        assert(proxy->GetSize() >= 1);
+    }
+
+    rtklog.Trace() << "ListModelSortFilterProxy: OK";
+
+    c.app->Run();
+
+    return 0;
+}
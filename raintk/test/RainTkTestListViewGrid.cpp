@@ -0,0 +1,299 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <map>
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkListModelSTLVector.hpp>
+#include <raintk/RainTkListDelegate.hpp>
+#include <raintk/RainTkListView.hpp>
+#include <raintk/RainTkRectangle.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
+
+// =========================================================== //
+// =========================================================== //
+
+namespace raintk
+{
+    class TestDelegate;
+}
+
+namespace
+{
+    // The delegate for each model index that has one
+    std::map<uint,raintk::TestDelegate*> g_lkup_delegates;
+}
+
+namespace raintk
+{
+    struct TestItem
+    {
+        glm::u8vec4 color;
+    };
+
+    class TestDelegate : public ListDelegate
+    {
+    public:
+        TestDelegate(ks::Object::Key const &key,
+                     Scene* scene,
+                     shared_ptr<Widget> parent) :
+            ListDelegate(key,scene,parent),
+            m_index(0),
+            m_has_index(false)
+        {}
+
+        void Init(ks::Object::Key const &,
+                  shared_ptr<TestDelegate> const &this_delegate)
+        {
+            m_rect = MakeWidget<Rectangle>(m_scene,this_delegate);
+            m_rect->width = mm(18);
+            m_rect->height = mm(20);
+
+            width = m_rect->width.Get();
+            height = m_rect->height.Get();
+        }
+
+        ~TestDelegate()
+        {
+            forget();
+        }
+
+        void SetIndex(uint index)
+        {
+            forget();
+            m_index = index;
+            m_has_index = true;
+            g_lkup_delegates[m_index] = this;
+        }
+
+        uint GetIndex() const
+        {
+            return m_index;
+        }
+
+        void SetData(TestItem const &item)
+        {
+            m_rect->color = item.color;
+        }
+
+    private:
+        void forget()
+        {
+            if(m_has_index)
+            {
+                auto it = g_lkup_delegates.find(m_index);
+                if(it != g_lkup_delegates.end() && it->second == this)
+                {
+                    g_lkup_delegates.erase(it);
+                }
+            }
+        }
+
+        uint m_index;
+        bool m_has_index;
+        shared_ptr<Rectangle> m_rect;
+    };
+}
+
+// =========================================================== //
+// =========================================================== //
+
+using namespace raintk;
+
+namespace
+{
+    // Positions far into the list lose some precision
+    bool Near(float a, float b)
+    {
+        return (fabs(a-b) < 5E-2);
+    }
+
+    // Returns true if there's a delegate for every index in
+    // [idx_first,idx_end) and nothing else far outside of it
+    bool HasDelegates(uint idx_first, uint idx_end, uint margin)
+    {
+        for(uint i=idx_first; i < idx_end; i++)
+        {
+            if(g_lkup_delegates.count(i) == 0)
+            {
+                return false;
+            }
+        }
+
+        for(auto const &index_delegate : g_lkup_delegates)
+        {
+            if(index_delegate.first+margin < idx_first ||
+               index_delegate.first >= idx_end+margin)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c(600,800);
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+
+    auto update =
+            [scene]()
+            {
+                TimePoint const t = std::chrono::high_resolution_clock::now();
+                scene->GetTransformSystem()->Update(t,t);
+            };
+
+    auto list_model = make_shared<ListModelSTLVector<TestItem>>();
+    list_model->Reserve(100000);
+    for(uint i=0; i < 100000; i++)
+    {
+        list_model->PushBack(TestItem{glm::u8vec4{96,200,90,255}});
+    }
+
+    // Row
+    {
+        auto list_view =
+                MakeWidget<ListView<TestItem,TestDelegate>>(
+                    scene,root);
+
+        list_view->layout = ListViewProperties::Layout::Row;
+        list_view->width = mm(100);
+        list_view->height = mm(20);
+        list_view->spacing = mm(2);
+        list_view->SetPrefetchBudget(Milliseconds(100));
+        list_view->SetListModel(list_model);
+        update();
+
+        // Delegates are placed left to right
+        assert(HasDelegates(0,5,3));
+        for(uint i=0; i < 5; i++)
+        {
+            assert(Near(g_lkup_delegates[i]->x.Get(),i*mm(20)));
+            assert(Near(g_lkup_delegates[i]->y.Get(),0.0f));
+        }
+
+        assert(list_view->GetContentParent()->width.Get() > mm(20)*99999);
+
+        // Only what's around the view exists after a jump
+        list_view->SetContentX(-mm(20)*500);
+        update();
+        assert(HasDelegates(500,505,3));
+        assert(Near(g_lkup_delegates[501]->x.Get()-
+                    g_lkup_delegates[500]->x.Get(),mm(20)));
+
+        root->RemoveChild(list_view);
+    }
+
+    g_lkup_delegates.clear();
+
+    // Grid
+    auto list_view =
+            MakeWidget<ListView<TestItem,TestDelegate>>(
+                scene,root);
+
+    list_view->layout = ListViewProperties::Layout::Grid;
+    list_view->grid_columns = 5;
+    list_view->width = mm(100);
+    list_view->height = mm(100);
+    list_view->spacing = mm(2);
+    list_view->SetPrefetchBudget(Milliseconds(100));
+    list_view->SetListModel(list_model);
+    update();
+
+    // The visible lines and a line or two past the
+    // delegate extents are filled
+    assert(HasDelegates(0,25,25));
+    assert(list_view->GetDelegateCount() == g_lkup_delegates.size());
+    assert(list_view->GetDelegateCount() % 5 == 0);
+
+    for(uint i=0; i < 25; i++)
+    {
+        auto delegate = g_lkup_delegates[i];
+        assert(Near(delegate->x.Get(),(i%5)*mm(102)/5.0f));
+        assert(Near(delegate->y.Get(),(i/5)*mm(22)));
+        (void)delegate;
+    }
+
+    // The content is sized by lines
+    assert(list_view->GetContentParent()->height.Get() > mm(22)*19999);
+    assert(list_view->GetContentParent()->height.Get() < mm(22)*20001);
+
+    // Narrowing the grid relayouts the cells
+    list_view->grid_columns = 4;
+    update();
+    assert(Near(g_lkup_delegates[5]->x.Get(),mm(102)/4.0f));
+    assert(Near(g_lkup_delegates[5]->y.Get(),mm(22)));
+
+    list_view->grid_columns = 5;
+    update();
+
+    // Benchmark scrolling through the grid
+    uint const frame_count = 600;
+    float const frame_step = mm(7);
+    uint max_delegate_count = 0;
+
+    auto const t0 = std::chrono::high_resolution_clock::now();
+
+    for(uint f=0; f < frame_count; f++)
+    {
+        list_view->SetContentY(-frame_step*f);
+        update();
+
+        max_delegate_count =
+                std::max<uint>(max_delegate_count,
+                               list_view->GetDelegateCount());
+    }
+
+    auto const t1 = std::chrono::high_resolution_clock::now();
+
+    rtklog.Trace() << "Grid: " << list_model->GetSize() << " items, "
+                   << frame_count << " frames: "
+                   << ks::CalcDuration<Microseconds>(t0,t1).count()/frame_count
+                   << "us per frame, at most "
+                   << max_delegate_count << " delegates";
+
+    // Only the cells around the view exist
+    assert(max_delegate_count <= 60);
+
+    uint const first_line = uint(frame_step*(frame_count-1)/mm(22));
+    assert(HasDelegates(first_line*5,(first_line+4)*5,25));
+
+    // Jumping far into the grid
+    list_view->SetContentY(-mm(22)*15000);
+    update();
+    assert(HasDelegates(75000,75025,25));
+    (void)first_line;
+
+    // Model changes relayout the cells around the view
+    list_model->Erase(75002);
+    update();
+    assert(HasDelegates(75000,75025,25));
+    assert(Near(g_lkup_delegates[75004]->x.Get(),4*mm(102)/5.0f));
+
+    rtklog.Trace() << "ListViewGrid: OK";
+
+    root->width = px(c.window->GetSize().first);
+    root->height = px(c.window->GetSize().second);
+
+    c.app->Run();
+
+    return 0;
+}
@@ -0,0 +1,217 @@
+/*
+   Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include <set>
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkListModelSTLVector.hpp>
+#include <raintk/RainTkListDelegate.hpp>
+#include <raintk/RainTkListView.hpp>
+#include <raintk/RainTkRectangle.hpp>
+#include <raintk/RainTkAnimationSystem.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
+
+// =========================================================== //
+// =========================================================== //
+
+namespace
+{
+    // The model indices of all delegates that currently exist
+    std::multiset<uint> g_live_indices;
+}
+
+namespace raintk
+{
+    struct TestItem
+    {
+        glm::u8vec4 color;
+    };
+
+    class TestDelegate : public ListDelegate
+    {
+    public:
+        TestDelegate(ks::Object::Key const &key,
+                     Scene* scene,
+                     shared_ptr<Widget> parent) :
+            ListDelegate(key,scene,parent),
+            m_index(0),
+            m_has_index(false)
+        {}
+
+        void Init(ks::Object::Key const &,
+                  shared_ptr<TestDelegate> const &this_delegate)
+        {
+            m_rect = MakeWidget<Rectangle>(m_scene,this_delegate);
+            m_rect->width = this->GetParent()->width.Get();
+            m_rect->height = mm(10);
+
+            width = m_rect->width.Get();
+            height = m_rect->height.Get();
+        }
+
+        ~TestDelegate()
+        {
+            if(m_has_index)
+            {
+                g_live_indices.erase(g_live_indices.find(m_index));
+            }
+        }
+
+        void SetIndex(uint index)
+        {
+            if(m_has_index)
+            {
+                g_live_indices.erase(g_live_indices.find(m_index));
+            }
+
+            m_index = index;
+            m_has_index = true;
+            g_live_indices.insert(m_index);
+        }
+
+        uint GetIndex() const
+        {
+            return m_index;
+        }
+
+        void SetData(TestItem const &item)
+        {
+            m_rect->color = item.color;
+        }
+
+    private:
+        uint m_index;
+        bool m_has_index;
+        shared_ptr<Rectangle> m_rect;
+    };
+}
+
+// =========================================================== //
+// =========================================================== //
+
+using namespace raintk;
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c(600,800);
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+
+    TimePoint t = std::chrono::high_resolution_clock::now();
+
+    auto update =
+            [scene,&t]()
+            {
+                TimePoint const t_next = t+Milliseconds(16);
+                scene->GetAnimationSystem()->Update(t,t_next);
+                scene->GetTransformSystem()->Update(t,t_next);
+                t = t_next;
+            };
+
+    auto list_model = make_shared<ListModelSTLVector<TestItem>>();
+    for(uint i=0; i < 200; i++)
+    {
+        list_model->PushBack(TestItem{glm::u8vec4{96,200,90,255}});
+    }
+
+    auto list_view =
+            MakeWidget<ListView<TestItem,TestDelegate>>(
+                scene,root);
+
+    list_view->width = mm(60);
+    list_view->height = mm(100);
+    list_view->delegate_extents = mm(25);
+
+    // Leave no time for prefetching so that a single
+    // delegate outside of the view is created per frame
+    list_view->SetPrefetchBudget(Microseconds(0));
+    list_view->SetListModel(list_model);
+
+    // Nothing is flicking the view
+    assert(list_view->GetFlickVelocity() == glm::vec2(0.0f,0.0f));
+
+    // Everything within the view is created in the first frame
+    update();
+
+    auto view_is_filled =
+            [&](uint first_index, uint last_index)
+            {
+                for(uint i=first_index; i <= last_index; i++)
+                {
+                    if(g_live_indices.count(i) != 1)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+    assert(view_is_filled(0,9));
+    assert(list_view->GetPrefetchPending());
+
+    uint delegate_count = list_view->GetDelegateCount();
+    assert(delegate_count == g_live_indices.size());
+
+    // The rest of the delegate bounds are filled one
+    // delegate at a time over the following frames
+    uint frame_count=0;
+    while(list_view->GetPrefetchPending())
+    {
+        update();
+        frame_count++;
+
+        uint const next_delegate_count = list_view->GetDelegateCount();
+        assert(next_delegate_count == delegate_count+1);
+        delegate_count = next_delegate_count;
+
+        assert(frame_count < 10);
+    }
+    (void)delegate_count;
+    (void)frame_count;
+
+    // The trailing delegate extents are filled
+    assert(g_live_indices.count(12) == 1);
+
+    // Jumping to the middle of the list creates the newly
+    // visible delegates right away
+    list_view->SetContentY(-mm(500));
+    update();
+
+    assert(view_is_filled(50,59));
+    assert(list_view->GetPrefetchPending());
+
+    // With a budget, the delegate bounds are filled in one frame
+    list_view->SetPrefetchBudget(Milliseconds(100));
+    list_view->SetContentY(-mm(1000));
+    update();
+
+    assert(view_is_filled(100,109));
+    assert(!list_view->GetPrefetchPending());
+    assert(g_live_indices.count(97) == 1);
+    assert(g_live_indices.count(112) == 1);
+    (void)view_is_filled;
+
+    rtklog.Trace() << "ListViewPrefetch: OK";
+
+    root->width = px(c.window->GetSize().first);
+    root->height = px(c.window->GetSize().second);
+
+    c.app->Run();
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+  Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#define RAINTK_TEST_OPACITY_HIERARCHY
+
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkRectangle.hpp>
+#include <raintk/RainTkDrawSystem.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
+#include <raintk/RainTkPropertyAnimation.hpp>
+
+using namespace raintk;
+
+namespace
+{
+    // Counts accumulated opacity updates
+    class CountingRectangle : public Rectangle
+    {
+    public:
+        using base_type = Rectangle;
+
+        CountingRectangle(ks::Object::Key const &key,
+                          Scene* scene,
+                          shared_ptr<Widget> parent) :
+            Rectangle(key,scene,parent)
+        {}
+
+        void Init(ks::Object::Key const &,
+                  shared_ptr<CountingRectangle> const &)
+        {}
+
+        ~CountingRectangle() = default;
+
+        uint opacity_updates{0};
+
+    private:
+        void onAccOpacityUpdated() override
+        {
+            opacity_updates++;
+            Rectangle::onAccOpacityUpdated();
+        }
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+
+    auto update =
+            [&]()
+            {
+                TimePoint const t = std::chrono::high_resolution_clock::now();
+                scene->GetTransformSystem()->Update(t,t);
+                scene->GetDrawSystem()->Update(t,t);
+            };
+
+    // Two sibling subtrees
+    auto a = MakeWidget<CountingRectangle>(scene,root);
+    a->x = mm(10);
+    a->y = mm(10);
+    a->opacity = 0.5f;
+
+    auto a_child = MakeWidget<CountingRectangle>(scene,a);
+    a_child->x = mm(5);
+    a_child->y = mm(5);
+    a_child->color = glm::u8vec4(80,200,80,255);
+
+    auto b = MakeWidget<CountingRectangle>(scene,root);
+    b->x = mm(50);
+    b->y = mm(10);
+
+    auto b_child = MakeWidget<CountingRectangle>(scene,b);
+    b_child->x = mm(5);
+    b_child->y = mm(5);
+    b_child->color = glm::u8vec4(80,80,200,255);
+
+    update();
+
+    // New widgets inherit their parent's opacity
+    assert(a->m_accumulated_opacity == 0.5f);
+    assert(a_child->m_accumulated_opacity == 0.5f);
+    assert(b->m_accumulated_opacity == 1.0f);
+    assert(b_child->m_accumulated_opacity == 1.0f);
+
+    // Changing one subtree doesn't visit the other
+    uint const b_updates = b->opacity_updates;
+    uint const b_child_updates = b_child->opacity_updates;
+
+    a->opacity = 0.25f;
+    update();
+
+    assert(a_child->m_accumulated_opacity == 0.25f);
+    assert(b->opacity_updates == b_updates);
+    assert(b_child->opacity_updates == b_child_updates);
+
+    // Changing a descendant and its ancestor together
+    a_child->opacity = 0.5f;
+    a->opacity = 1.0f;
+    update();
+
+    assert(a->m_accumulated_opacity == 1.0f);
+    assert(a_child->m_accumulated_opacity == 0.5f);
+
+    // Nothing changed, nothing is visited
+    uint const a_child_updates = a_child->opacity_updates;
+    update();
+    assert(a_child->opacity_updates == a_child_updates);
+
+    (void)b_updates;
+    (void)b_child_updates;
+    (void)a_child_updates;
+
+    rtklog.Trace() << "OpacityIncremental: OK";
+
+    // Fade b's subtree out; only vertex colors are
+    // rewritten while it animates
+    auto fade = ks::MakeObject<PropertyAnimation>(scene);
+    fade->AddTrack(&(b->opacity),1.0f,0.0f,2000.0f);
+    fade->Start();
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+/*
+  Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <cmath>
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkPropertyAnimation.hpp>
+#include <raintk/RainTkTween.hpp>
+
+namespace raintk
+{
+    // The per-object path: one Animation per Property
+    class TweenAnimation : public raintk::Animation
+    {
+    public:
+        using base_type = raintk::Animation;
+
+        TweenAnimation(ks::Object::Key const &key,
+                       Scene* scene,
+                       Property<float>* property,
+                       Tween::EaseFnPtr ease,
+                       Tween::CurveFnPtr curve,
+                       float duration_ms,
+                       float from,
+                       float to) :
+            raintk::Animation(key,scene),
+            m_property(property),
+            m_ease(ease),
+            m_curve(curve),
+            m_duration_ms(duration_ms),
+            m_from(from),
+            m_to(to)
+        {}
+
+        void Init(ks::Object::Key const &,
+                  shared_ptr<TweenAnimation> const &)
+        {}
+
+        ~TweenAnimation()
+        {}
+
+        void start() override
+        {
+            m_elapsed_ms = 0.0f;
+        }
+
+        bool update(float delta_ms) override
+        {
+            m_elapsed_ms += delta_ms;
+            bool completed = false;
+            float time = m_elapsed_ms/m_duration_ms;
+            if(time > 1.0f)
+            {
+                completed = true;
+                time = 1.0f;
+            }
+
+            m_property->Assign(
+                        Tween::Eval(
+                            (*m_ease)(m_curve,time),
+                            m_from,
+                            m_to));
+
+            return completed;
+        }
+
+        void complete() override
+        {}
+
+    private:
+        Property<float>* m_property;
+        Tween::EaseFnPtr m_ease;
+        Tween::CurveFnPtr m_curve;
+        float m_duration_ms;
+        float m_from;
+        float m_to;
+
+        float m_elapsed_ms;
+    };
+}
+
+using namespace raintk;
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+    auto scene = c.scene.get();
+
+    uint const property_count = 5000;
+    uint const frame_count = 100;
+    float const frame_ms = 16.0f;
+    float const duration_ms = 2000.0f;
+
+    std::vector<unique_ptr<Property<float>>> list_props_a;
+    std::vector<unique_ptr<Property<float>>> list_props_b;
+
+    for(uint i=0; i < property_count; i++)
+    {
+        list_props_a.push_back(make_unique<Property<float>>(0.0f));
+        list_props_b.push_back(make_unique<Property<float>>(0.0f));
+    }
+
+    // Per-object Animations
+    std::vector<shared_ptr<TweenAnimation>> list_anims;
+    for(uint i=0; i < property_count; i++)
+    {
+        list_anims.push_back(
+                    ks::MakeObject<TweenAnimation>(
+                        scene,
+                        list_props_a[i].get(),
+                        &Tween::EaseInOut,
+                        &Tween::Quad,
+                        duration_ms,
+                        0.0f,
+                        float(i)));
+
+        list_anims.back()->SetKeepOnComplete(true);
+        list_anims.back()->Start();
+    }
+
+    // Single PropertyAnimation
+    auto prop_anim = ks::MakeObject<PropertyAnimation>(scene);
+    prop_anim->SetKeepOnComplete(true);
+
+    for(uint i=0; i < property_count; i++)
+    {
+        prop_anim->AddTrack(
+                    list_props_b[i].get(),
+                    0.0f,
+                    float(i),
+                    duration_ms,
+                    Tween::Curve::Quad,
+                    Tween::Easing::InOut);
+    }
+
+    prop_anim->Start();
+
+    // Benchmark
+    auto start = std::chrono::steady_clock::now();
+    for(uint f=0; f < frame_count; f++)
+    {
+        PropertyTransaction transaction;
+        for(auto& anim : list_anims)
+        {
+            anim->Update(frame_ms);
+        }
+    }
+    auto const per_object_us =
+            std::chrono::duration_cast<Microseconds>(
+                std::chrono::steady_clock::now()-start).count();
+
+    start = std::chrono::steady_clock::now();
+    for(uint f=0; f < frame_count; f++)
+    {
+        PropertyTransaction transaction;
+        prop_anim->Update(frame_ms);
+    }
+    auto const batched_us =
+            std::chrono::duration_cast<Microseconds>(
+                std::chrono::steady_clock::now()-start).count();
+
+    rtklog.Trace() << property_count << " properties, "
+                   << frame_count << " frames: "
+                   << "Animation per property: " << per_object_us << "us, "
+                   << "PropertyAnimation: " << batched_us << "us";
+
+    // Both paths should produce the same values
+    for(uint i=0; i < property_count; i++)
+    {
+        float const a = list_props_a[i]->Get();
+        float const b = list_props_b[i]->Get();
+        assert(std::fabs(a-b) <= 0.001f*std::max(1.0f,std::fabs(a)));
+    }
+
+    // Track removal and completion
+    assert(prop_anim->GetTrackCount() == property_count);
+    prop_anim->Complete();
+    assert(list_props_b.back()->Get() == float(property_count-1));
+
+    prop_anim->ClearTracks();
+    assert(prop_anim->GetTrackCount() == 0);
+
+    glm::vec2 const vec_from{0.0f,10.0f};
+    glm::vec2 const vec_to{10.0f,0.0f};
+    Property<glm::vec2> vec_prop{vec_from};
+
+    Id const track_id =
+            prop_anim->AddTrack(
+                &vec_prop,
+                vec_from,
+                vec_to,
+                100.0f,
+                Tween::Curve::Linear,
+                Tween::Easing::In,
+                50.0f);
+
+    prop_anim->Start();
+    prop_anim->Update(100.0f);
+    assert(vec_prop.Get() == glm::vec2(5.0f,5.0f));
+
+    prop_anim->RemoveTrack(track_id);
+    assert(prop_anim->GetTrackCount() == 0);
+
+    // A zero duration track ends after its delay, whether
+    // the end time is found when adding or removing tracks
+    Property<float> step_prop{0.0f};
+    prop_anim->AddTrack(
+                &step_prop,0.0f,1.0f,0.0f,
+                Tween::Curve::Linear,Tween::Easing::In,50.0f);
+
+    Id const long_track_id =
+            prop_anim->AddTrack(
+                &step_prop,0.0f,1.0f,100.0f,
+                Tween::Curve::Linear,Tween::Easing::In);
+
+    prop_anim->RemoveTrack(long_track_id);
+
+    prop_anim->Stop();
+    prop_anim->Start();
+    prop_anim->Update(50.0f);
+    assert(step_prop.Get() == 1.0f);
+    assert(prop_anim->GetState() == Animation::State::Stopped);
+
+    prop_anim->ClearTracks();
+
+    rtklog.Trace() << "PropertyAnimation: OK";
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*
+  Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkRectangle.hpp>
+
+using namespace raintk;
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+
+    auto root = c.scene->GetRootWidget();
+    auto scene = c.scene.get();
+
+    auto rect = MakeWidget<Rectangle>(scene,root);
+
+    // A binding that depends on several properties
+    uint area_eval_count=0;
+    std::vector<std::pair<float,float>> list_area_inputs;
+
+    Property<float> area{
+        [&](){
+            area_eval_count++;
+            list_area_inputs.emplace_back(
+                        rect->width.Get(),rect->height.Get());
+
+            return rect->width.Get()*rect->height.Get();
+        }
+    };
+
+    uint x_count=0;
+    uint width_count=0;
+    uint area_count=0;
+    std::vector<float> list_area_values;
+
+    rect->x.signal_changed.Connect(
+                [&](){ x_count++; });
+
+    rect->width.signal_changed.Connect(
+                [&](){ width_count++; });
+
+    area.signal_changed.Connect(
+                [&](){
+                    area_count++;
+                    list_area_values.push_back(area.Get());
+                });
+
+    // Without a transaction, every assignment notifies
+    rect->x = mm(1);
+    rect->x = mm(2);
+    assert(x_count == 2);
+
+    // With a transaction, each changed property is notified
+    // once on commit and values are readable immediately
+    x_count = 0;
+    width_count = 0;
+    area_count = 0;
+    area_eval_count = 0;
+    list_area_values.clear();
+    list_area_inputs.clear();
+
+    {
+        PropertyTransaction transaction;
+        rect->x = mm(3);
+        rect->x = mm(4);
+        rect->x = mm(5);
+        rect->width = mm(10);
+        rect->height = mm(20);
+        rect->width = mm(10);
+
+        assert(rect->x.Get() == mm(5));
+        assert(x_count == 0);
+        assert(width_count == 0);
+        assert(area_count == 0);
+
+        // Bindings are evaluated on commit
+        assert(area_eval_count == 0);
+    }
+
+    assert(x_count == 1);
+    assert(width_count == 1);
+    assert(area_count == 1);
+
+    // The binding is evaluated once and never sees an
+    // intermediate width or height
+    assert(area_eval_count == 1);
+    assert(list_area_inputs.size() == 1);
+    assert(list_area_inputs[0].first == mm(10));
+    assert(list_area_inputs[0].second == mm(20));
+
+    // Observers never see an intermediate area
+    assert(list_area_values.size() == 1);
+    assert(list_area_values[0] == mm(10)*mm(20));
+
+    // Without a transaction, a binding is evaluated once
+    // per change of one of its inputs
+    area_eval_count = 0;
+    rect->height = mm(30);
+    assert(area_eval_count == 1);
+    assert(area.Get() == mm(10)*mm(30));
+
+    // Bindings that depend on other bindings (a diamond) are
+    // evaluated after all of their inputs, once per commit
+    uint sum_eval_count=0;
+    Property<float> half_width{[&](){ return rect->width.Get()*0.5f; }};
+    Property<float> twice_width{[&](){ return rect->width.Get()*2.0f; }};
+    Property<float> sum{
+        [&](){
+            sum_eval_count++;
+            return half_width.Get()+twice_width.Get()+area.Get();
+        }
+    };
+
+    sum_eval_count = 0;
+    {
+        PropertyTransaction transaction;
+        rect->width = mm(4);
+        rect->height = mm(5);
+    }
+    assert(sum_eval_count == 1);
+    assert(sum.Get() == mm(4)*0.5f+mm(4)*2.0f+mm(4)*mm(5));
+
+    sum_eval_count = 0;
+    rect->width = mm(6);
+    assert(sum_eval_count == 1);
+    assert(sum.Get() == mm(6)*0.5f+mm(6)*2.0f+mm(6)*mm(5));
+
+    // Assigning a value removes the binding
+    area_eval_count = 0;
+    area = 1.0f;
+    rect->width = mm(7);
+    assert(area_eval_count == 0);
+    assert(area.Get() == 1.0f);
+
+    // Nested transactions only flush on the outermost commit
+    x_count = 0;
+    {
+        PropertyTransaction outer;
+        {
+            PropertyTransaction inner;
+            rect->x = mm(6);
+        }
+        assert(x_count == 0);
+        rect->x = mm(7);
+    }
+    assert(x_count == 1);
+
+    // Destroying a property with a pending notification
+    {
+        PropertyTransaction transaction;
+        auto temp = make_unique<Property<float>>(0.0f);
+        temp->Assign(1.0f);
+        temp.reset();
+    }
+
+    // A handler that changes a property again after its
+    // notification was sent (queueing it a second time)
+    // and then destroys it
+    {
+        auto temp = make_unique<Property<float>>(0.0f);
+        Property<float> trigger{0.0f};
+
+        trigger.signal_changed.Connect(
+                    [&](){
+                        if(temp)
+                        {
+                            temp->Assign(2.0f);
+                            temp.reset();
+                        }
+                    });
+
+        {
+            PropertyTransaction transaction;
+            temp->Assign(1.0f);
+            trigger.Assign(1.0f);
+        }
+
+        assert(!temp);
+    }
+
+    rtklog.Trace() << "PropertyTransaction: OK";
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}
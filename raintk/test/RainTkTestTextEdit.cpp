@@ -0,0 +1,131 @@
+/*
+  Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkTextInput.hpp>
+#include <raintk/RainTkDrawSystem.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
+
+using namespace raintk;
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+
+    auto update =
+            [&]()
+            {
+                TimePoint const t = std::chrono::high_resolution_clock::now();
+                scene->GetTransformSystem()->Update(t,t);
+                scene->GetDrawSystem()->Update(t,t);
+            };
+
+    auto text = MakeWidget<Text>(scene,root);
+    text->SetKeepGlyphData(true);
+    text->font = "FiraSansMinimal.ttf";
+    text->color = glm::u8vec4(255,255,255,255);
+    text->size = mm(6);
+    text->x = mm(10);
+    text->y = mm(10);
+    text->text = "hello world";
+    update();
+
+    // The first layout isn't an edit
+    assert(!text->GetGlyphEdit().valid);
+
+    // Insert a word in the middle
+    text->text = "hello brave world";
+    update();
+    {
+        auto const &edit = text->GetGlyphEdit();
+        assert(edit.valid);
+        assert(edit.utf16_start == 6);
+        assert(edit.utf16_new_end-edit.utf16_old_end == 6);
+        assert(edit.dx > 0);
+        (void)edit;
+    }
+
+    // Delete it again
+    text->text = "hello world";
+    update();
+    {
+        auto const &edit = text->GetGlyphEdit();
+        assert(edit.valid);
+        assert(edit.utf16_start == 6);
+        assert(edit.utf16_old_end-edit.utf16_new_end == 6);
+        assert(edit.dx < 0);
+        (void)edit;
+    }
+
+    // Changing anything besides the text requires a new layout
+    text->size = mm(8);
+    text->text = "hello world!";
+    update();
+    assert(!text->GetGlyphEdit().valid);
+
+    // Editing one paragraph of multi line text only changes
+    // its line
+    text->text = "first line\nhello world\nlast line";
+    update();
+    assert(text->GetGlyphData()->size() == 3);
+
+    text->text = "first line\nhello brave world\nlast line";
+    update();
+    {
+        auto const &edit = text->GetGlyphEdit();
+        assert(edit.valid);
+        assert(edit.line == 1);
+        assert(edit.utf16_start == 17);
+        assert(edit.utf16_new_end-edit.utf16_old_end == 6);
+        (void)edit;
+    }
+
+    // Adding a line break changes the number of lines
+    text->text = "first line\nhello brave\nworld\nlast line";
+    update();
+    assert(!text->GetGlyphEdit().valid);
+
+    // Type into a TextInput with a long line of text
+    std::string long_text;
+    for(uint i=0; i < 100; i++)
+    {
+        long_text += "The quick brown fox jumps over the lazy dog. ";
+    }
+
+    auto text_input = MakeWidget<TextInput>(scene,root);
+    text_input->width = mm(100);
+    text_input->height = mm(12);
+    text_input->x = mm(10);
+    text_input->y = mm(30);
+    text_input->cursor_color = glm::u8vec4(80,80,170,255);
+    text_input->GetInputText()->font = "FiraSansMinimal.ttf";
+    text_input->GetInputText()->color = glm::u8vec4{250,250,250,255};
+    text_input->GetInputText()->size = mm(8);
+    text_input->GetInputText()->text = long_text;
+    text_input->input_focus = true;
+
+    rtklog.Trace() << "TextEdit: OK";
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}
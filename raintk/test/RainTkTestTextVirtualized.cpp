@@ -0,0 +1,161 @@
+/*
+  Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkText.hpp>
+#include <raintk/RainTkScrollArea.hpp>
+#include <raintk/RainTkDrawSystem.hpp>
+#include <raintk/RainTkTransformSystem.hpp>
+
+using namespace raintk;
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+
+    auto update =
+            [&]()
+            {
+                TimePoint const t = std::chrono::high_resolution_clock::now();
+                scene->GetTransformSystem()->Update(t,t);
+                scene->GetDrawSystem()->Update(t,t);
+            };
+
+    // A document with far more glyphs than a single
+    // batch can hold
+    std::string document;
+    for(uint i=0; i < 20000; i++)
+    {
+        document += "Line " + ks::ToString(i) +
+                ": the quick brown fox jumps over the lazy dog\n";
+    }
+
+    auto scroll_area = MakeWidget<ScrollArea>(scene,root);
+    scroll_area->width = root->width.Get();
+    scroll_area->height = root->height.Get();
+    scroll_area->clip = true;
+    scroll_area->direction = ScrollArea::Direction::Vertical;
+
+    auto content = scroll_area->GetContentParent();
+
+    auto text = MakeWidget<Text>(scene,content);
+    text->SetVirtualized(true);
+    text->font = "FiraSansMinimal.ttf";
+    text->color = glm::u8vec4(255,255,255,255);
+    text->size = mm(4);
+    text->text = document;
+
+    content->width.Bind([&](){ return text->width.Get(); });
+    content->height.Bind([&](){ return text->height.Get(); });
+
+    update();
+    update();
+
+    // Each line is its own paragraph
+    float const doc_height = text->height.Get();
+    assert(doc_height > scroll_area->height.Get()*100);
+    assert(text->GetGlyphData() == nullptr);
+    (void)doc_height;
+
+    // The number of glyphs drawn depends on the size of the
+    // clip region and stays bounded while scrolling
+    uint const start_glyph_count =
+            text->GetVirtualizedStats().drawn_glyph_count;
+
+    assert(start_glyph_count > 0);
+
+    for(uint i=0; i < 50; i++)
+    {
+        scroll_area->SetContentY(-1.0f*scroll_area->height.Get()*0.4f*i);
+        update();
+
+        auto const stats = text->GetVirtualizedStats();
+        assert(stats.drawn_glyph_count <= start_glyph_count*2);
+        assert(stats.max_batch_glyph_count <= Text::k_max_batch_glyphs);
+        (void)stats;
+    }
+
+    // Scrolling to the end only generates the lines
+    // that come into view and releases the glyph data
+    // of the paragraphs that are far away
+    scroll_area->SetContentY(scroll_area->height.Get()-doc_height);
+    update();
+    update();
+    {
+        auto const stats = text->GetVirtualizedStats();
+        assert(stats.drawn_last == stats.paragraph_count);
+        assert(stats.drawn_glyph_count <= start_glyph_count*2);
+        assert(stats.shaped_first > 0);
+        assert(stats.shaped_first+
+               (stats.drawn_last-stats.drawn_first) >= stats.drawn_first);
+        (void)stats;
+    }
+    (void)start_glyph_count;
+
+    // Wrapped paragraphs are estimated until measured,
+    // so the height can change as they're scrolled to
+    text->line_width = mm(40);
+    update();
+    update();
+    assert(text->height.Get() > doc_height);
+
+    scroll_area->SetContentY(0.0f);
+    update();
+
+    // A single paragraph with far more glyphs than a batch
+    // can hold is split into batches and only the part of it
+    // in view is drawn
+    std::string paragraph;
+    for(uint i=0; i < 2000; i++)
+    {
+        paragraph += "the quick brown fox jumps over the lazy dog ";
+    }
+
+    text->text = paragraph;
+    update();
+    update();
+    {
+        auto const stats = text->GetVirtualizedStats();
+        assert(stats.paragraph_count == 1);
+        assert(stats.drawn_glyph_count > 0);
+        assert(stats.drawn_glyph_count < paragraph.size()/2);
+        assert(stats.max_batch_glyph_count <= Text::k_max_batch_glyphs);
+        (void)stats;
+    }
+
+    // Also when it's all in view
+    text->line_width = root->width.Get();
+    text->size = mm(0.5f);
+    update();
+    update();
+    {
+        auto const stats = text->GetVirtualizedStats();
+        assert(stats.max_batch_glyph_count <= Text::k_max_batch_glyphs);
+        (void)stats;
+    }
+
+    rtklog.Trace() << "TextVirtualized: OK";
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*
+  Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <ks/shared/KsImage.hpp>
+#include <ks/shared/KsCallbackTimer.hpp>
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/RainTkText.hpp>
+#include <raintk/RainTkTextureShadow.hpp>
+
+using namespace raintk;
+
+namespace
+{
+    unique_ptr<ks::ImageData> CreateGlyph(uint size_px)
+    {
+        ks::Image<ks::R8> image(size_px,size_px,ks::R8{255});
+        return image.ConvertToImageDataPtr();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+    auto scene = c.scene.get();
+    auto root = scene->GetRootWidget();
+
+    // A row of adjacent glyphs is merged into one rect
+    {
+        TextureShadow shadow(256,256);
+        auto glyph = CreateGlyph(16);
+
+        for(uint i=0; i < 16; i++)
+        {
+            shadow.Write(glm::u16vec2(i*16,0),*glyph);
+        }
+        assert(shadow.GetDirtyRectCount() == 1);
+
+        uint bytes = 0;
+        auto const list_updates = shadow.Flush(1024*1024,bytes);
+        assert(list_updates.size() == 1);
+        assert(bytes == 256*16);
+        assert(!shadow.GetIsDirty());
+        (void)list_updates;
+    }
+
+    // Distant glyphs stay separate but the number of
+    // rects is bounded
+    {
+        TextureShadow shadow(1024,1024);
+        auto glyph = CreateGlyph(8);
+
+        for(uint i=0; i < 64; i++)
+        {
+            shadow.Write(glm::u16vec2((i%8)*128,(i/8)*128),*glyph);
+        }
+        assert(shadow.GetDirtyRectCount() <= 16);
+    }
+
+    // The budget splits large rects into bands of rows
+    {
+        TextureShadow shadow(256,256);
+        auto glyph = CreateGlyph(64);
+
+        for(uint i=0; i < 4; i++)
+        {
+            shadow.Write(glm::u16vec2(i*64,0),*glyph);
+        }
+
+        uint bytes = 0;
+        auto const list_updates0 = shadow.Flush(256*16,bytes);
+        assert(list_updates0.size() == 1);
+        assert(bytes == 256*16);
+        assert(shadow.GetIsDirty());
+
+        uint flushes = 1;
+        while(shadow.GetIsDirty())
+        {
+            shadow.Flush(256*16,bytes);
+            flushes++;
+        }
+        assert(flushes == 4);
+        assert(bytes == 256*64);
+        (void)list_updates0;
+        (void)flushes;
+    }
+
+    // Loaded contents aren't dirty and writing the same
+    // bytes again can be skipped
+    {
+        auto glyph = CreateGlyph(8);
+
+        TextureShadow shadow(64,64);
+        shadow.Write(glm::u16vec2(8,8),*glyph);
+
+        TextureShadow loaded(64,64);
+        loaded.Load(shadow.GetData());
+        assert(!loaded.GetIsDirty());
+        assert(loaded.GetMatches(glm::u16vec2(8,8),*glyph));
+        assert(!loaded.GetMatches(glm::u16vec2(16,8),*glyph));
+        assert(!loaded.GetMatches(glm::u16vec2(60,60),*glyph));
+    }
+
+    // Glyphs from Text are counted
+    auto text = MakeWidget<Text>(scene,root);
+    text->font = "FiraSansMinimal.ttf";
+    text->color = glm::u8vec4(255,255,255,255);
+    text->size = mm(6);
+    text->x = mm(10);
+    text->y = mm(10);
+    text->text = "The quick brown fox jumps over the lazy dog";
+
+    ks::shared_ptr<ks::CallbackTimer> stats_timer =
+            ks::MakeObject<ks::CallbackTimer>(
+                scene->GetEventLoop(),
+                ks::Milliseconds(1000),
+                [&]()
+                {
+                    auto const &stats = scene->GetTextUploadStats();
+                    rtklog.Trace() << "glyphs: " << stats.glyph_count
+                                   << " (" << stats.glyph_bytes
+                                   << " bytes), uploads: " << stats.upload_count
+                                   << " (" << stats.upload_bytes << " bytes)";
+                });
+
+    stats_timer->Start();
+
+    rtklog.Trace() << "TextureShadow: OK";
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}
@@ -0,0 +1,186 @@
+/*
+  Copyright (C) 2016 Preet Desai (preet.desai@gmail.com)
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+*/
+
+#include <raintk/test/RainTkTestContext.hpp>
+#include <raintk/test/RainTkTestAllocationCounter.hpp>
+#include <raintk/RainTkWidget.hpp>
+
+using namespace raintk;
+
+namespace
+{
+    // Widget that counts calls to one of its own change handlers
+    class CountingWidget : public Widget
+    {
+    public:
+        using base_type = Widget;
+
+        CountingWidget(ks::Object::Key const &key,
+                       Scene* scene,
+                       shared_ptr<Widget> parent) :
+            Widget(key,scene,parent)
+        {}
+
+        void Init(ks::Object::Key const &key,
+                  shared_ptr<CountingWidget> const &this_widget)
+        {
+            Widget::Init(key,this_widget);
+        }
+
+        ~CountingWidget() = default;
+
+        uint width_count{0};
+
+    protected:
+        void onWidthChanged() override
+        {
+            width_count++;
+            Widget::onWidthChanged();
+        }
+    };
+
+    // Makes the connection Widget::Init used to make for
+    // each of its own change handlers
+    template<typename T>
+    void ConnectBaseline(Property<T>& property)
+    {
+        property.signal_changed.Connect(
+                    [](T const &){},
+                    nullptr,
+                    ks::ConnectionType::Direct);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    TestContext c;
+
+    auto root = c.scene->GetRootWidget();
+    auto scene = c.scene.get();
+
+    // Owner handlers are still called (and deferred by
+    // transactions) without allocating signal_changed
+    auto counting_widget = MakeWidget<CountingWidget>(scene,root);
+    counting_widget->width = mm(10);
+    assert(counting_widget->width_count == 1);
+    assert(!counting_widget->width.signal_changed.GetIsAllocated());
+
+    {
+        PropertyTransaction transaction;
+        counting_widget->width = mm(20);
+        counting_widget->width = mm(30);
+        assert(counting_widget->width_count == 1);
+    }
+    assert(counting_widget->width_count == 2);
+
+    // External connections allocate the signal
+    uint external_count=0;
+    Id cid = counting_widget->width.signal_changed.Connect(
+                [&](){ external_count++; });
+
+    assert(counting_widget->width.signal_changed.GetIsAllocated());
+
+    counting_widget->width = mm(40);
+    assert(counting_widget->width_count == 3);
+    assert(external_count == 1);
+
+    counting_widget->width.signal_changed.Disconnect(cid);
+
+    // Sizes
+    rtklog.Trace() << "sizeof(ks::Signal<>): " << sizeof(ks::Signal<>);
+    rtklog.Trace() << "sizeof(LazySignal<>): " << sizeof(LazySignal<>);
+    rtklog.Trace() << "sizeof(Property<float>): " << sizeof(Property<float>);
+    rtklog.Trace() << "sizeof(Widget): " << sizeof(Widget);
+
+    // Construction time and heap use
+    std::size_t const widget_count = 50000;
+    std::vector<shared_ptr<Widget>> list_widgets;
+    list_widgets.reserve(widget_count);
+
+    auto const alloc_start = test::GetAllocationCount();
+    auto const start = std::chrono::steady_clock::now();
+
+    for(std::size_t i=0; i < widget_count; i++)
+    {
+        list_widgets.push_back(MakeWidget<Widget>(scene,root));
+    }
+
+    auto const end = std::chrono::steady_clock::now();
+    auto const alloc = test::GetAllocationCount()-alloc_start;
+
+    rtklog.Trace() << "Constructed " << widget_count << " widgets in "
+                   << std::chrono::duration_cast<Milliseconds>(
+                          end-start).count() << "ms";
+
+    // Bytes allocated include the Widget itself, its shared_ptr control block
+    // and any per-widget component or entity storage
+    std::size_t const bytes_per_widget = alloc.bytes/widget_count;
+    double const allocs_per_widget = double(alloc.count)/widget_count;
+
+    // Baseline: Widget::Init used to connect its own handlers to ten
+    // of its Properties with Direct connections, which allocated each
+    // Signal's connection state
+    auto const baseline_alloc_start = test::GetAllocationCount();
+
+    for(auto const &widget : list_widgets)
+    {
+        ConnectBaseline(widget->width);
+        ConnectBaseline(widget->height);
+        ConnectBaseline(widget->x);
+        ConnectBaseline(widget->y);
+        ConnectBaseline(widget->z);
+        ConnectBaseline(widget->rotation);
+        ConnectBaseline(widget->scale);
+        ConnectBaseline(widget->origin);
+        ConnectBaseline(widget->clip);
+        ConnectBaseline(widget->input_focus);
+    }
+
+    auto const baseline_alloc = test::GetAllocationCount()-baseline_alloc_start;
+
+    std::size_t const baseline_bytes_per_widget =
+            bytes_per_widget+baseline_alloc.bytes/widget_count;
+
+    double const baseline_allocs_per_widget =
+            allocs_per_widget+double(baseline_alloc.count)/widget_count;
+
+    rtklog.Trace() << "Heap use per widget: "
+                   << bytes_per_widget << " bytes in "
+                   << allocs_per_widget << " allocations (was "
+                   << baseline_bytes_per_widget << " bytes in "
+                   << baseline_allocs_per_widget << " allocations)";
+
+    // Upper bounds so that a regression fails. Component lists grow
+    // geometrically, so their share per widget is amortized.
+    std::size_t const max_bytes_per_widget = sizeof(Widget)+1024;
+    double const max_allocs_per_widget = 4.0;
+
+    assert(bytes_per_widget <= max_bytes_per_widget);
+    assert(allocs_per_widget <= max_allocs_per_widget);
+    assert(baseline_allocs_per_widget >= allocs_per_widget+10.0);
+
+    (void)max_bytes_per_widget;
+    (void)max_allocs_per_widget;
+    (void)baseline_bytes_per_widget;
+
+    // Run!
+    c.app->Run();
+
+    return 0;
+}